@@ -40,6 +40,7 @@ public class PGAI : ModuleRules
 		var enginePrivateDependencyModuleNames = new string[] 
 		{
 			"PhysicsCore",
+			"Json",
 		};
 
 		PrivateDependencyModuleNames.AddRange(enginePrivateDependencyModuleNames);
@@ -0,0 +1,369 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+
+#include "Commandlets/GolfAIShotAtlasCommandlet.h"
+
+#include "Controller/GolfAIController.h"
+#include "Components/GolfAIShotComponent.h"
+#include "Components/GolfControllerCommonComponent.h"
+#include "Pawn/PaperGolfPawn.h"
+#include "Interfaces/FocusableActor.h"
+
+#include "Data/GolfAIShotAtlas.h"
+#include "Library/PaperGolfTrajectorySolver.h"
+
+#include "Logging/LoggingUtils.h"
+#include "PGAILogging.h"
+#include "Utils/CollisionUtils.h"
+#include "Utils/CommandletUtils.h"
+#include "Utils/ObjectUtils.h"
+
+#include "Engine/World.h"
+#include "Kismet/GameplayStatics.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(GolfAIShotAtlasCommandlet)
+
+#if WITH_EDITOR
+namespace
+{
+	struct FShotAtlasBakeParams
+	{
+		FString MapPackageName{};
+		FString AtlasPackageName{};
+		TSubclassOf<AGolfAIController> ControllerClass{};
+		TSubclassOf<APaperGolfPawn> PawnClass{};
+		float CellSize{ 1000.0f };
+		float Margin{ 2000.0f };
+		TArray<int32> HoleNumbers{};
+	};
+
+	struct FHoleFocusActors
+	{
+		AActor* GolfHole{};
+		TArray<AActor*> FocusActors{};
+	};
+
+	struct FShotAtlasBakeContext
+	{
+		UWorld& World;
+		APaperGolfPawn& Pawn;
+		UGolfAIShotComponent& ShotComponent;
+		const UGolfControllerCommonComponent& ControllerCommonComponent;
+		FBox StaticCollisionBounds;
+	};
+
+	TOptional<FShotAtlasBakeParams> ParseBakeParams(const FString& Params);
+
+	TSortedMap<int32, FHoleFocusActors> GatherHoleFocusActors(UWorld& World);
+	TArray<FShotFocusScores> ScoreFocusActors(const FShotAtlasBakeContext& Context, const FHoleFocusActors& HoleFocusActors);
+
+	FGolfAIShotAtlasHole BakeHole(const FShotAtlasBakeContext& Context, const FShotAtlasBakeParams& BakeParams, int32 HoleNumber, const FHoleFocusActors& HoleFocusActors);
+}
+#endif
+
+UGolfAIShotAtlasCommandlet::UGolfAIShotAtlasCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+
+	HelpDescription = TEXT("Bakes the AI shot atlas for a course map");
+	HelpUsage = TEXT("-run=GolfAIShotAtlas -Map=<map package> -Atlas=<atlas package> -Controller=<AI controller class> -Pawn=<pawn class> [-CellSize=1000] [-Margin=2000] [-Holes=1+2+3]");
+}
+
+int32 UGolfAIShotAtlasCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	const auto BakeParams = ParseBakeParams(Params);
+	if (!BakeParams)
+	{
+		UE_LOG(LogPGAI, Error, TEXT("GolfAIShotAtlas: Invalid arguments. Usage: %s"), *HelpUsage);
+		return 1;
+	}
+
+	const auto ControllerCDO = BakeParams->ControllerClass->GetDefaultObject<AGolfAIController>();
+	const auto ShotComponentTemplate = PG::ObjectUtils::FindDefaultComponentByClass<UGolfAIShotComponent>(ControllerCDO);
+	const auto ControllerCommonComponentTemplate = PG::ObjectUtils::FindDefaultComponentByClass<UGolfControllerCommonComponent>(ControllerCDO);
+
+	if (!ShotComponentTemplate || !ControllerCommonComponentTemplate)
+	{
+		UE_LOG(LogPGAI, Error, TEXT("GolfAIShotAtlas: Controller=%s is missing its shot or controller common component"), *LoggingUtils::GetName(BakeParams->ControllerClass));
+		return 1;
+	}
+
+	auto World = PG::CommandletUtils::LoadWorld(BakeParams->MapPackageName);
+	if (!World)
+	{
+		UE_LOG(LogPGAI, Error, TEXT("GolfAIShotAtlas: Could not load Map=%s"), *BakeParams->MapPackageName);
+		return 1;
+	}
+
+	auto Atlas = PG::CommandletUtils::LoadOrCreateAsset<UGolfAIShotAtlas>(BakeParams->AtlasPackageName);
+	check(Atlas);
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParams.ObjectFlags |= RF_Transient;
+
+	auto Pawn = World->SpawnActor<APaperGolfPawn>(BakeParams->PawnClass, FTransform::Identity, SpawnParams);
+	if (!Pawn)
+	{
+		UE_LOG(LogPGAI, Error, TEXT("GolfAIShotAtlas: Could not spawn Pawn=%s"), *LoggingUtils::GetName(BakeParams->PawnClass));
+		PG::CommandletUtils::UnloadWorld(*World);
+		return 1;
+	}
+
+	// The world is never played so begin play is only dispatched for the pawn to finish initializing it
+	Pawn->DispatchBeginPlay();
+
+	auto ShotComponent = NewObject<UGolfAIShotComponent>(Pawn, ShotComponentTemplate->GetClass(), NAME_None, RF_Transient, ShotComponentTemplate);
+	check(ShotComponent);
+
+	const FShotAtlasBakeContext Context
+	{
+		.World = *World,
+		.Pawn = *Pawn,
+		.ShotComponent = *ShotComponent,
+		.ControllerCommonComponent = *ControllerCommonComponentTemplate,
+		.StaticCollisionBounds = PG::CollisionUtils::GetStaticCollisionBounds(*World, PG::CollisionChannel::FlickTraceType)
+	};
+
+	const auto StartTimeSeconds = FPlatformTime::Seconds();
+
+	for (const auto& [HoleNumber, HoleFocusActors] : GatherHoleFocusActors(*World))
+	{
+		if (!BakeParams->HoleNumbers.IsEmpty() && !BakeParams->HoleNumbers.Contains(HoleNumber))
+		{
+			continue;
+		}
+
+		if (!HoleFocusActors.GolfHole)
+		{
+			UE_LOG(LogPGAI, Warning, TEXT("GolfAIShotAtlas: Skipping HoleNumber=%d as it has no golf hole"), HoleNumber);
+			continue;
+		}
+
+		Atlas->SetHole(BakeHole(Context, *BakeParams, HoleNumber, HoleFocusActors));
+	}
+
+	UE_LOG(LogPGAI, Display, TEXT("GolfAIShotAtlas: Baked %d cell%s in %.1fs"),
+		Atlas->GetNumCells(), LoggingUtils::Pluralize(Atlas->GetNumCells()), FPlatformTime::Seconds() - StartTimeSeconds);
+
+	Pawn->Destroy();
+	PG::CommandletUtils::UnloadWorld(*World);
+
+	if (!PG::CommandletUtils::SaveAsset(*Atlas))
+	{
+		UE_LOG(LogPGAI, Error, TEXT("GolfAIShotAtlas: Could not save Atlas=%s"), *BakeParams->AtlasPackageName);
+		return 1;
+	}
+
+	return 0;
+#else
+	UE_LOG(LogPGAI, Error, TEXT("GolfAIShotAtlas: Only supported in editor builds"));
+	return 1;
+#endif
+}
+
+#if WITH_EDITOR
+namespace
+{
+	TOptional<FShotAtlasBakeParams> ParseBakeParams(const FString& Params)
+	{
+		FShotAtlasBakeParams BakeParams;
+
+		FString ControllerClassPath, PawnClassPath;
+
+		if (!FParse::Value(*Params, TEXT("Map="), BakeParams.MapPackageName) ||
+			!FParse::Value(*Params, TEXT("Atlas="), BakeParams.AtlasPackageName) ||
+			!FParse::Value(*Params, TEXT("Controller="), ControllerClassPath) ||
+			!FParse::Value(*Params, TEXT("Pawn="), PawnClassPath))
+		{
+			return {};
+		}
+
+		FParse::Value(*Params, TEXT("CellSize="), BakeParams.CellSize);
+		FParse::Value(*Params, TEXT("Margin="), BakeParams.Margin);
+
+		if (FString HolesString; FParse::Value(*Params, TEXT("Holes="), HolesString))
+		{
+			TArray<FString> HoleStrings;
+			HolesString.ParseIntoArray(HoleStrings, TEXT("+"));
+
+			for (const auto& HoleString : HoleStrings)
+			{
+				BakeParams.HoleNumbers.Add(FCString::Atoi(*HoleString));
+			}
+		}
+
+		BakeParams.ControllerClass = LoadClass<AGolfAIController>(nullptr, *ControllerClassPath);
+		BakeParams.PawnClass = LoadClass<APaperGolfPawn>(nullptr, *PawnClassPath);
+
+		if (!BakeParams.ControllerClass || !BakeParams.PawnClass || BakeParams.CellSize <= 0)
+		{
+			return {};
+		}
+
+		return BakeParams;
+	}
+
+	TSortedMap<int32, FHoleFocusActors> GatherHoleFocusActors(UWorld& World)
+	{
+		TSortedMap<int32, FHoleFocusActors> HoleFocusActors;
+
+		TArray<AActor*> InterfaceActors;
+		UGameplayStatics::GetAllActorsWithInterface(&World, UFocusableActor::StaticClass(), InterfaceActors);
+
+		for (auto Actor : InterfaceActors)
+		{
+			auto& HoleActors = HoleFocusActors.FindOrAdd(IFocusableActor::Execute_GetHoleNumber(Actor));
+
+			if (IFocusableActor::Execute_IsHole(Actor))
+			{
+				HoleActors.GolfHole = Actor;
+			}
+			else
+			{
+				HoleActors.FocusActors.Add(Actor);
+			}
+		}
+
+		return HoleFocusActors;
+	}
+
+	TArray<FShotFocusScores> ScoreFocusActors(const FShotAtlasBakeContext& Context, const FHoleFocusActors& HoleFocusActors)
+	{
+		// Approximates UGolfControllerCommonComponent::GetBestFocusActor without a controller: the hole is preferred when it is in view,
+		// otherwise the focus actors that make progress toward the hole are ordered by the total distance through them
+		const auto& Location = Context.Pawn.GetActorLocation();
+		const auto& HoleLocation = HoleFocusActors.GolfHole->GetActorLocation();
+		const auto DistanceToHole = FVector::Dist2D(Location, HoleLocation);
+
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(GolfAIShotAtlasFocusTrace), false, &Context.Pawn);
+		QueryParams.AddIgnoredActor(HoleFocusActors.GolfHole);
+
+		const bool bHoleInView = !Context.World.LineTraceTestByChannel(Context.Pawn.GetFlickLocation(0.0f), HoleLocation, PG::CollisionChannel::FlickTraceType, QueryParams);
+
+		TArray<FShotFocusScores> FocusScores;
+		FocusScores.Add(FShotFocusScores
+		{
+			.FocusActor = HoleFocusActors.GolfHole,
+			.Score = bHoleInView ? 0.0f : TNumericLimits<float>::Max()
+		});
+
+		for (auto FocusActor : HoleFocusActors.FocusActors)
+		{
+			const auto& FocusLocation = FocusActor->GetActorLocation();
+			const auto FocusDistanceToHole = FVector::Dist2D(FocusLocation, HoleLocation);
+			const auto DistanceToFocus = FVector::Dist2D(Location, FocusLocation);
+
+			if (FocusDistanceToHole >= DistanceToHole || DistanceToFocus < IFocusableActor::Execute_GetMinDistance2D(FocusActor))
+			{
+				continue;
+			}
+
+			FocusScores.Add(FShotFocusScores
+			{
+				.FocusActor = FocusActor,
+				.Score = static_cast<float>(DistanceToFocus + FocusDistanceToHole)
+			});
+		}
+
+		FocusScores.StableSort([](const auto& First, const auto& Second) { return First.Score < Second.Score; });
+
+		return FocusScores;
+	}
+
+	FGolfAIShotAtlasHole BakeHole(const FShotAtlasBakeContext& Context, const FShotAtlasBakeParams& BakeParams, int32 HoleNumber, const FHoleFocusActors& HoleFocusActors)
+	{
+		FGolfAIShotAtlasHole AtlasHole
+		{
+			.HoleNumber = HoleNumber,
+			.CellSize = BakeParams.CellSize
+		};
+
+		FBox HoleBounds{ EForceInit::ForceInit };
+		HoleBounds += HoleFocusActors.GolfHole->GetActorLocation();
+
+		for (auto FocusActor : HoleFocusActors.FocusActors)
+		{
+			HoleBounds += FocusActor->GetActorLocation();
+		}
+
+		HoleBounds = HoleBounds.ExpandBy(FVector{ BakeParams.Margin, BakeParams.Margin, 0.0 });
+
+		const auto MinCoordinates = AtlasHole.GetCellCoordinates(HoleBounds.Min);
+		const auto MaxCoordinates = AtlasHole.GetCellCoordinates(HoleBounds.Max);
+
+		const auto& StaticCollisionBounds = Context.StaticCollisionBounds;
+		const auto TraceStartZ = StaticCollisionBounds.IsValid ? StaticCollisionBounds.Max.Z + 100 : HoleBounds.Max.Z + 100 * 100;
+		const auto TraceEndZ = StaticCollisionBounds.IsValid ? StaticCollisionBounds.Min.Z - 100 : HoleBounds.Min.Z - 100 * 100;
+
+		const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(GolfAIShotAtlasGroundTrace), false, &Context.Pawn);
+
+		auto& Pawn = Context.Pawn;
+		const auto PawnHalfHeight = Pawn.GetComponentsBoundingBox().GetExtent().Z;
+
+		int32 NumSamples{}, NumSkipped{}, NumFailed{};
+
+		for (int32 Y = MinCoordinates.Y; Y <= MaxCoordinates.Y; ++Y)
+		{
+			for (int32 X = MinCoordinates.X; X <= MaxCoordinates.X; ++X)
+			{
+				++NumSamples;
+
+				const FVector2D SampleLocation{ (X + 0.5) * BakeParams.CellSize, (Y + 0.5) * BakeParams.CellSize };
+
+				// Only sample where the ball could come to rest
+				FHitResult GroundHitResult;
+				if (!Context.World.LineTraceSingleByChannel(GroundHitResult, FVector{ SampleLocation, TraceStartZ }, FVector{ SampleLocation, TraceEndZ },
+					PG::CollisionChannel::FlickTraceType, QueryParams) || GroundHitResult.ImpactNormal.Z < PG::Trajectory::LandingMinNormalZ)
+				{
+					++NumSkipped;
+					continue;
+				}
+
+				Pawn.SetActorLocation(GroundHitResult.ImpactPoint + FVector::UpVector * PawnHalfHeight, false, nullptr, ETeleportType::ResetPhysics);
+				Pawn.SnapToGround();
+
+				auto FocusScores = ScoreFocusActors(Context, HoleFocusActors);
+				check(!FocusScores.IsEmpty());
+
+				AActor* FocusActor = FocusScores[0].FocusActor;
+				Pawn.SetFocusActor(FocusActor);
+
+				const auto ShotSetupResult = Context.ShotComponent.SolveShotForAtlas(FAIShotContext
+				{
+					.PlayerPawn = &Pawn,
+					.GolfHole = HoleFocusActors.GolfHole,
+					.FocusActorScores = std::move(FocusScores),
+					.ShotType = Context.ControllerCommonComponent.GetShotTypeForDistance(Pawn.GetDistanceTo(FocusActor))
+				});
+
+				if (!ShotSetupResult || !ShotSetupResult->FocusActor)
+				{
+					++NumFailed;
+					continue;
+				}
+
+				AtlasHole.Cells.Add(FGolfAIShotAtlasCell
+				{
+					.Location = FVector3f{ Pawn.GetActorLocation() },
+					.FocusActorName = ShotSetupResult->FocusActor->GetFName(),
+					.ShotYaw = ShotSetupResult->ShotYaw,
+					.ShotPitch = ShotSetupResult->ShotPitch,
+					.PowerFraction = ShotSetupResult->FlickParams.PowerFraction,
+					.LocalZOffset = ShotSetupResult->FlickParams.LocalZOffset,
+					.ShotType = ShotSetupResult->FlickParams.ShotType
+				});
+			}
+		}
+
+		UE_LOG(LogPGAI, Display, TEXT("GolfAIShotAtlas: HoleNumber=%d - Baked %d cell%s from %d sample%s; Skipped=%d; Failed=%d"),
+			HoleNumber, AtlasHole.Cells.Num(), LoggingUtils::Pluralize(AtlasHole.Cells.Num()), NumSamples, LoggingUtils::Pluralize(NumSamples), NumSkipped, NumFailed);
+
+		return AtlasHole;
+	}
+}
+#endif
@@ -0,0 +1,25 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "GolfAIShotAtlasCommandlet.generated.h"
+
+/*
+* Bakes a UGolfAIShotAtlas for a course map by sampling a grid of pawn positions around each hole and running the full AI shot solver from each one.
+*
+* Usage: -run=GolfAIShotAtlas -Map=/Game/Maps/Course -Atlas=/Game/AI/DA_ShotAtlas_Course -Controller=<AI controller class path> -Pawn=<pawn class path>
+*        [-CellSize=1000] [-Margin=2000] [-Holes=1+2+3]
+*/
+UCLASS()
+class UGolfAIShotAtlasCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UGolfAIShotAtlasCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
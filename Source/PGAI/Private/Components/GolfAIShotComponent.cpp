@@ -7,12 +7,21 @@
 #include "Pawn/PaperGolfPawn.h"
 
 #include "Library/PaperGolfPawnUtilities.h"
+#include "Library/PaperGolfTrajectorySolver.h"
+#include "Library/PaperGolfTrajectoryBatch.h"
+#include "Library/PaperGolfBounceSolver.h"
 
 #include "State/GolfPlayerState.h"
 
+#include "Data/GolfAIShotAtlas.h"
+#include "Data/GolfFocusVisibilityField.h"
+#include "Interfaces/FocusableActor.h"
+#include "Components/GolfControllerCommonComponent.h"
+
 #include "VisualLogger/VisualLogger.h"
 #include "Logging/LoggingUtils.h"
 #include "PGAILogging.h"
+#include "PGAIStats.h"
 #include "Utils/CollisionUtils.h"
 
 #include "Utils/GolfAIShotCalculationUtils.h"
@@ -22,12 +31,16 @@
 #include "Utils/PGMathUtils.h"
 
 #include "Subsystems/GolfEventsSubsystem.h"
+#include "Subsystems/HazardSpatialIndexSubsystem.h"
+#include "Subsystems/GolfAIBenchmarkSubsystem.h"
+#include "Subsystems/MovingObstacleSubsystem.h"
 
 #include "Kismet/GameplayStatics.h"
 #include "Engine/CurveTable.h"
+#include "TimerManager.h"
 #include "Curves/RealCurve.h"
 
-#include "PhysicalMaterials/PhysicalMaterial.h"
+#include "Async/ParallelFor.h"
 
 #include "AIStrategy/AIPerformanceStrategy.h"
 
@@ -36,16 +49,44 @@
 #include "PGTags.h"
 
 #include <array>
-#include <iterator>
 #include <algorithm>
-#include <limits>
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(GolfAIShotComponent)
 
+DECLARE_CYCLE_STAT(TEXT("AI Setup Shot"), STAT_PGAISetupShot, STATGROUP_PGAI);
+DECLARE_CYCLE_STAT(TEXT("AI Evaluate Shot Candidates"), STAT_PGAIEvaluateShotCandidates, STATGROUP_PGAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("AI Shot Candidates"), STAT_PGAIShotCandidates, STATGROUP_PGAI);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("AI Shot Planning Latency (ms)"), STAT_PGAIShotPlanningLatency, STATGROUP_PGAI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("AI Shot Planning Frames"), STAT_PGAIShotPlanningFrames, STATGROUP_PGAI);
+DECLARE_CYCLE_STAT(TEXT("AI Refine Calibrated Pitch"), STAT_PGAIRefineCalibratedPitch, STATGROUP_PGAI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("AI Shot Atlas Hits"), STAT_PGAIShotAtlasHits, STATGROUP_PGAI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("AI Shot Atlas Misses"), STAT_PGAIShotAtlasMisses, STATGROUP_PGAI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("AI Surface Material Cache Hits"), STAT_PGAISurfaceMaterialCacheHits, STATGROUP_PGAI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("AI Surface Material Cache Misses"), STAT_PGAISurfaceMaterialCacheMisses, STATGROUP_PGAI);
+DECLARE_CYCLE_STAT(TEXT("AI Plan Route"), STAT_PGAIPlanRoute, STATGROUP_PGAI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("AI Route Plans"), STAT_PGAIRoutePlans, STATGROUP_PGAI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("AI Route Cached Edges"), STAT_PGAIRouteCachedEdges, STATGROUP_PGAI);
+
 namespace
 {
 	constexpr const std::array ShotPitchAngles = { 45.0f, 60.0f, 75.0f, 30.0f, 0.0f, -15.0f };
 
+	// The last pitch angle is never traced as it is only used as a fallback
+	constexpr int32 NumPitchTraceAngles = static_cast<int32>(ShotPitchAngles.size()) - 1;
+
+	// Offsets from the curve table pitch in order of preference when refining the calibrated pitch.
+	// Eight lanes is two groups for the batch trajectory solver
+	constexpr const std::array CalibrationPitchOffsets = { 0.0f, 5.0f, -5.0f, 10.0f, -10.0f, 15.0f, -15.0f, 20.0f };
+	constexpr float MaxCalibrationPitch = 85.0f;
+	// Drag makes the arcs slower than the drag free estimate of their flight time
+	constexpr double CalibrationFlightTimeMargin = 1.5;
+
+	// Launch angle of the full power stroke used to measure the carry of a route leg
+	constexpr float RouteCarryPitch = 45.0f;
+
+	// Keeps the expected strokes finite when the carry probe is blocked right away
+	constexpr float RouteMinCarryDistance = 100.0f;
+
 	// Gets the power fraction for a given delta distance in meters from the hole
 	const FName DeltaDistanceMetersVsPowerFraction = TEXT("DeltaDistanceM_Power");
 
@@ -59,36 +100,176 @@ namespace
 	const FName AngleDeviationVsPowerMultiplier = TEXT("AngleDelta_Power");
 
 	FRealCurve* FindCurveForKey(UCurveTable* CurveTable, const FName& Key);
-	
-	constexpr float DefaultPitchAngle = 45.0f;
 
-	constexpr double DistSqHitThreshold = FMath::Square(10);
+	// Square of the drag free launch speed at the pitch that carries Carry horizontally while rising Rise. Not positive if the pitch cannot reach
+	double GetDragFreeLaunchSpeedSquared(double Gravity, double Carry, double Rise, float PitchDegrees);
 
-	FVector GetVelocityAtHitPoint(const FPredictProjectilePathResult& PathResult);
+	/*
+	* Earliest wait in WaitStep increments up to MaxWaitTime after which the path misses the moving obstacles where they will be when the pawn reaches them.
+	* Unset if every wait is blocked. OutImmediateHit is set to the hit when launching right away.
+	*/
+	TOptional<float> FindClearMovingObstacleWait(const UMovingObstacleSubsystem& MovingObstacleSubsystem, TConstArrayView<FPredictProjectilePathPointData> Path,
+		float Radius, float MaxWaitTime, float WaitStep, TOptional<FMovingObstacleSweepHit>& OutImmediateHit);
+	
+	constexpr float DefaultPitchAngle = 45.0f;
 }
 
 UGolfAIShotComponent::UGolfAIShotComponent()
 {
 	PrimaryComponentTick.bCanEverTick = false;
+
+	TrajectoryScratch.bRecordPath = false;
 }
 
 FAIShotSetupResult UGolfAIShotComponent::SetupShot(FAIShotContext&& InShotContext)
 {
 	TRACE_CPUPROFILER_EVENT_SCOPE_STR("UGolfAIShotComponent::SetupShot");
+	SCOPE_CYCLE_COUNTER(STAT_PGAISetupShot);
 
 	UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: SetupShot - ShotContext=%s"),
 		*LoggingUtils::GetName(GetOwner()), *GetName(), *InShotContext.ToString());
 
+	CancelShotSetup();
+
+	const auto StartTimeSeconds = FPlatformTime::Seconds();
+
+	BeginShotSetup(std::move(InShotContext));
+	UpdateRoute();
+
+	auto ShotParams = FindAtlasShotParams();
+	if (!ShotParams)
+	{
+		ShotParams = CalculateShotParams();
+	}
+
+	const auto ShotSetupResult = FinishShotSetup(std::move(ShotParams), false);
+
+	UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: SetupShot - Completed in %.2fms"),
+		*LoggingUtils::GetName(GetOwner()), *GetName(), (FPlatformTime::Seconds() - StartTimeSeconds) * 1000);
+
+	return ShotSetupResult;
+}
+
+bool UGolfAIShotComponent::SetupShotAsync(FAIShotContext&& InShotContext, float TimeBudgetSeconds, FOnAIShotSetupComplete&& OnComplete)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("UGolfAIShotComponent::SetupShotAsync");
+	SCOPE_CYCLE_COUNTER(STAT_PGAISetupShot);
+
+	UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: SetupShotAsync - TimeBudgetSeconds=%.2f; ShotContext=%s"),
+		*LoggingUtils::GetName(GetOwner()), *GetName(), TimeBudgetSeconds, *InShotContext.ToString());
+
+	CancelShotSetup();
+
+	auto World = GetWorld();
+	if (!ensure(World))
+	{
+		return false;
+	}
+
+	BeginShotSetup(std::move(InShotContext));
+
+	ShotPlanningState = MakeUnique<FShotPlanningState>();
+	auto& State = *ShotPlanningState;
+
+	State.OnComplete = std::move(OnComplete);
+	State.StartRealTimeSeconds = FPlatformTime::Seconds();
+	State.DeadlineWorldTimeSeconds = World->GetTimeSeconds() + FMath::Max(0.0f, TimeBudgetSeconds);
+
+	// Re-planning evaluates the route legs in frame slices from TickShotSetup before the shot planning starts
+	if (const auto ReplanReason = GetRouteReplanReason(); ReplanReason)
+	{
+		UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: SetupShotAsync - Replanning route over the next frames - %s"),
+			*LoggingUtils::GetName(GetOwner()), *GetName(), ReplanReason);
+
+		State.bRoutePending = true;
+		ScheduleShotSetupTick();
+
+		return true;
+	}
+
+	FollowRoute();
+	StartShotPlanning();
+
+	return true;
+}
+
+void UGolfAIShotComponent::StartShotPlanning()
+{
+	check(ShotPlanningState);
+
+	// Baked shot only needs a single trace so complete immediately
+	if (auto AtlasShotParams = FindAtlasShotParams(); AtlasShotParams)
+	{
+		CompleteShotPlanning(std::move(AtlasShotParams));
+		return;
+	}
+
+	auto& State = *ShotPlanningState;
+	State.bAsyncTraces = true;
+
+	AddFirstShotPlan(State);
+
+	ScheduleShotSetupTick();
+}
+
+void UGolfAIShotComponent::CompleteShotPlanning(TOptional<FShotSetupParams>&& ShotParams)
+{
+	check(ShotPlanningState);
+
+	// Release the planning state before invoking the callback so that a new shot setup can be started from it.
+	// Trace callbacks still outstanding from a deadline are ignored as they reference the previous planning id
+	const auto PlanningState = MoveTemp(ShotPlanningState);
+	++ShotPlanningId;
+	const auto ShotSetupResult = FinishShotSetup(std::move(ShotParams), true);
+
+	PlanningState->OnComplete.ExecuteIfBound(ShotSetupResult);
+}
+
+void UGolfAIShotComponent::CancelShotSetup()
+{
+	if (!ShotPlanningState)
+	{
+		return;
+	}
+
+	UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: CancelShotSetup - PendingTraces=%d; bRoutePending=%s"),
+		*LoggingUtils::GetName(GetOwner()), *GetName(), ShotPlanningState->NumPendingTraces, LoggingUtils::GetBoolString(ShotPlanningState->bRoutePending));
+
+	if (ShotPlanningState->bRoutePending)
+	{
+		RoutePlanner.DiscardStartEdges();
+	}
+
+	if (auto World = GetWorld(); World)
+	{
+		World->GetTimerManager().ClearTimer(ShotPlanningTimerHandle);
+	}
+
+	// Any outstanding trace callbacks will be ignored as they reference the previous planning id
+	ShotPlanningState.Reset();
+	++ShotPlanningId;
+
+	ShotContext = {};
+}
+
+void UGolfAIShotComponent::BeginShotSetup(FAIShotContext&& InShotContext)
+{
 	ShotContext = std::move(InShotContext);
 	CurrentFocusActorFailures = 0;
 	bCurrentFocusActorLandedInHazard = false;
 
+	ShotSetupTimeSeconds = 0;
+	ShotSetupSliceStartTimeSeconds = FPlatformTime::Seconds();
+	NumShotSetupTraces = 0;
+	NumShotSetupTrajectoryPredictions = 0;
+
 	check(ShotContext.PlayerPawn);
 	FocusActor = ShotContext.PlayerPawn->GetFocusActor();
 	InitialFocusYaw = ShotContext.PlayerPawn->GetActorRotation().Yaw;
+}
 
-	auto ShotParams = CalculateShotParams();
-
+FAIShotSetupResult UGolfAIShotComponent::FinishShotSetup(TOptional<FShotSetupParams>&& ShotParams, bool bAsync)
+{
 	if (!ShotParams)
 	{
 		ShotParams = CalculateDefaultShotParams();
@@ -101,11 +282,148 @@ FAIShotSetupResult UGolfAIShotComponent::SetupShot(FAIShotContext&& InShotContex
 		.ShotSetupParams = *ShotParams
 	});
 
+	RecordShotSetupBenchmark(bAsync);
+
 	ShotContext = {};
 
 	return ShotParams->ShotSetupResult;
 }
 
+void UGolfAIShotComponent::RecordShotSetupBenchmark(bool bAsync) const
+{
+	auto World = GetWorld();
+	if (!World || !ShotContext.PlayerPawn)
+	{
+		return;
+	}
+
+	// Only exists when the game was launched to run the bot benchmark
+	if (auto Benchmark = World->GetSubsystem<UGolfAIBenchmarkSubsystem>(); Benchmark)
+	{
+		Benchmark->RecordShotSetup(*ShotContext.PlayerPawn, FGolfAIBenchmarkShotSetupStats
+		{
+			.SetupTimeMs = (ShotSetupTimeSeconds + FPlatformTime::Seconds() - ShotSetupSliceStartTimeSeconds) * 1000,
+			.NumTraces = NumShotSetupTraces,
+			.NumTrajectoryPredictions = NumShotSetupTrajectoryPredictions,
+			.bAsync = bAsync
+		});
+	}
+}
+
+void UGolfAIShotComponent::ScheduleShotSetupTick()
+{
+	auto World = GetWorld();
+	if (!ensure(World))
+	{
+		return;
+	}
+
+	ShotPlanningTimerHandle = World->GetTimerManager().SetTimerForNextTick(this, &ThisClass::TickShotSetup);
+
+	// Yielding until the next frame ends the current slice
+	ShotSetupTimeSeconds += FPlatformTime::Seconds() - ShotSetupSliceStartTimeSeconds;
+}
+
+void UGolfAIShotComponent::TickShotSetup()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("UGolfAIShotComponent::TickShotSetup");
+	SCOPE_CYCLE_COUNTER(STAT_PGAISetupShot);
+
+	if (!ShotPlanningState)
+	{
+		return;
+	}
+
+	ShotSetupSliceStartTimeSeconds = FPlatformTime::Seconds();
+
+	auto World = GetWorld();
+	check(World);
+
+	auto& State = *ShotPlanningState;
+	++State.NumFrames;
+
+	const bool bDeadlineReached = World->GetTimeSeconds() >= State.DeadlineWorldTimeSeconds;
+
+	if (State.bRoutePending)
+	{
+		const auto SliceEndTimeSeconds = FPlatformTime::Seconds() + MaxShotPlanningFrameTimeMs / 1000.0;
+
+		if (!bDeadlineReached && !EvaluateRouteEdges([SliceEndTimeSeconds]() { return FPlatformTime::Seconds() < SliceEndTimeSeconds; }))
+		{
+			ScheduleShotSetupTick();
+			return;
+		}
+
+		State.bRoutePending = false;
+
+		if (bDeadlineReached)
+		{
+			// Shoot without a route rather than spend the rest of the budget on it. The next shot setup plans again
+			UE_VLOG_UELOG(GetOwner(), LogPGAI, Warning, TEXT("%s-%s: TickShotSetup - Deadline reached after %d frame%s while evaluating the route - skipping the route for this shot"),
+				*LoggingUtils::GetName(GetOwner()), *GetName(), State.NumFrames, LoggingUtils::Pluralize(State.NumFrames));
+
+			RoutePlanner.DiscardStartEdges();
+			RoutePlanner.ClearRoute();
+		}
+		else
+		{
+			// Every leg is cached so this only runs the search
+			PlanRoute();
+		}
+
+		FollowRoute();
+		StartShotPlanning();
+
+		return;
+	}
+
+	if (State.NumPendingTraces > 0 && !bDeadlineReached)
+	{
+		ScheduleShotSetupTick();
+		return;
+	}
+
+	TOptional<FShotSetupParams> ShotParams;
+	bool bPlanningComplete;
+
+	if (bDeadlineReached)
+	{
+		// Any traces that have not returned are treated as blocked so the result is conservative
+		UE_VLOG_UELOG(GetOwner(), LogPGAI, Warning, TEXT("%s-%s: TickShotSetup - Deadline reached after %d frame%s with %d pending trace%s - using best shot so far"),
+			*LoggingUtils::GetName(GetOwner()), *GetName(), State.NumFrames, LoggingUtils::Pluralize(State.NumFrames),
+			State.NumPendingTraces, LoggingUtils::Pluralize(State.NumPendingTraces));
+
+		ShotParams = GetBestShotParamsSoFar(State);
+		bPlanningComplete = true;
+	}
+	else
+	{
+		// Resolve at least one focus actor per frame and continue while there is time left in the frame slice
+		const auto SliceEndTimeSeconds = FPlatformTime::Seconds() + MaxShotPlanningFrameTimeMs / 1000.0;
+
+		do
+		{
+			bPlanningComplete = ResolveNextShotPlan(State, ShotParams);
+		} while (!bPlanningComplete && State.NumPendingTraces == 0 && FPlatformTime::Seconds() < SliceEndTimeSeconds);
+	}
+
+	if (!bPlanningComplete)
+	{
+		ScheduleShotSetupTick();
+		return;
+	}
+
+	const auto LatencyMs = static_cast<float>((FPlatformTime::Seconds() - State.StartRealTimeSeconds) * 1000);
+
+	SET_FLOAT_STAT(STAT_PGAIShotPlanningLatency, LatencyMs);
+	SET_DWORD_STAT(STAT_PGAIShotPlanningFrames, State.NumFrames);
+
+	UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: TickShotSetup - Planning completed in %.2fms over %d frame%s; bDeadlineReached=%s"),
+		*LoggingUtils::GetName(GetOwner()), *GetName(), LatencyMs, State.NumFrames, LoggingUtils::Pluralize(State.NumFrames), LoggingUtils::GetBoolString(bDeadlineReached));
+
+	CompleteShotPlanning(std::move(ShotParams));
+}
+
 void UGolfAIShotComponent::StartHole()
 {
 	UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: StartHole"), *LoggingUtils::GetName(GetOwner()), *GetName());
@@ -120,6 +438,7 @@ void UGolfAIShotComponent::Reset()
 {
 	UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: Reset"), *LoggingUtils::GetName(GetOwner()), *GetName());
 
+	CancelShotSetup();
 	ResetHoleData();
 }
 
@@ -131,6 +450,18 @@ void UGolfAIShotComponent::ResetHoleData()
 	CurrentFocusActorFailures = 0;
 	bCurrentFocusActorLandedInHazard = false;
 	DistanceToHole = -1;
+	StaticCollisionBounds.Reset();
+	RoutePlanner.Reset();
+	SET_DWORD_STAT(STAT_PGAIRouteCachedEdges, 0);
+
+	if (SurfaceMaterialCache.Num() > 0)
+	{
+		UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: ResetHoleData - SurfaceMaterialCache: Entries=%d; Hits=%d; Misses=%d"),
+			*LoggingUtils::GetName(GetOwner()), *GetName(), SurfaceMaterialCache.Num(), SurfaceMaterialCache.GetNumHits(), SurfaceMaterialCache.GetNumMisses());
+	}
+
+	SurfaceMaterialCache.Reset();
+	UpdateSurfaceMaterialCacheStats();
 }
 
 void UGolfAIShotComponent::OnHazard(EHazardType HazardType)
@@ -168,142 +499,1099 @@ void UGolfAIShotComponent::BeginPlay()
 	Super::BeginPlay();
 
 	ValidateAndLoadConfig();
+	LoadShotAtlas();
+
+	if (auto Owner = GetOwner(); Owner)
+	{
+		ControllerCommonComponent = Owner->FindComponentByClass<UGolfControllerCommonComponent>();
+	}
 }
 
-TOptional<UGolfAIShotComponent::FShotSetupParams> UGolfAIShotComponent::CalculateShotParams()
+TOptional<FAIShotSetupResult> UGolfAIShotComponent::SolveShotForAtlas(FAIShotContext&& InShotContext)
 {
-	const auto& FocusActorScores = ShotContext.FocusActorScores;
-	const bool bOnlySingleFocusAvailable = FocusActorScores.Num() <= 1;
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("UGolfAIShotComponent::SolveShotForAtlas");
 
-	// If only a single focus actor available, then compute the number of consecutive failures for pitch angle adjustment
-	const int32 FirstResultFailureTolerance = bOnlySingleFocusAvailable ? ShotPitchAngles.size() : ConsecutiveFailureCurrentFocusLimit;
-	const bool bFirstResultViable = IsFocusActorViableBasedOnShotHistory(FocusActor, FirstResultFailureTolerance, &CurrentFocusActorFailures, &bCurrentFocusActorLandedInHazard);
+	CancelShotSetup();
 
-	const auto FirstResult = CalculateShotParamsForCurrentFocusActor();
+	// Each sample is solved independently. The static collision bounds are kept as they are the same for every sample
+	HoleShotResults.Reset();
+	DistanceToHole = -1;
 
-	if (bOnlySingleFocusAvailable)
+	// No performance strategy so that the baked shot has no error applied
+	AIPerformanceStrategy = nullptr;
+
+	if (!CompileConfigCurves())
 	{
-		UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: CalculateShotParams - Insufficient alternative focii to check for hazards - FocusActorCount=%d, using first result=%s"),
-			*LoggingUtils::GetName(GetOwner()), *GetName(), FocusActorScores.Num(), *PG::StringUtils::ToString(FirstResult));
-		return FirstResult;
+		UE_VLOG_UELOG(GetOwner(), LogPGAI, Error, TEXT("%s-%s: SolveShotForAtlas - AIConfigCurveTable is invalid"), *LoggingUtils::GetName(GetOwner()), *GetName());
+		return {};
 	}
 
-	const auto FirstFocusActor = FocusActor;
+	BeginShotSetup(std::move(InShotContext));
 
-	if (FirstResult && bFirstResultViable && !ShotWillEndUpInHazard(FirstResult->ShotSetupResult))
-	{
-		return FirstResult;
-	}
+	const auto ShotParams = CalculateShotParams();
+
+	ShotContext = {};
 
-	for (const auto& FocusActorScore : FocusActorScores)
+	if (!ShotParams)
 	{
-		if (FocusActorScore.FocusActor == FirstFocusActor)
-		{
-			continue;
-		}
+		return {};
+	}
 
-		// Need to filter the focus actors to the ones that haven't resulted in multiple failures
-		int32 FocusActorFailures{};
-		if (!IsFocusActorViableBasedOnShotHistory(FocusActorScore.FocusActor, ConsecutiveFailureCurrentFocusLimit, &FocusActorFailures, &bCurrentFocusActorLandedInHazard))
-		{
-			continue;
-		}
+	return ShotParams->ShotSetupResult;
+}
 
-		FocusActor = FocusActorScore.FocusActor;
-		const auto Result = CalculateShotParamsForCurrentFocusActor();
+void UGolfAIShotComponent::LoadShotAtlas()
+{
+	ShotAtlas = nullptr;
 
-		if (Result && !ShotWillEndUpInHazard(Result->ShotSetupResult))
-		{
-			UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: CalculateShotParams - Using FocusActor=%s; Result=%s"),
-				*LoggingUtils::GetName(GetOwner()), *GetName(), *LoggingUtils::GetName(FocusActor), *PG::StringUtils::ToString(Result));
-			CurrentFocusActorFailures = FocusActorFailures;
-			return Result;
-		}
+	auto World = GetWorld();
+	if (!World || ShotAtlases.IsEmpty())
+	{
+		return;
 	}
 
-	UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: CalculateShotParams - No viable alternative focus actor found, using first result - FocusActor=%s; Result=%s"),
-		*LoggingUtils::GetName(GetOwner()), *GetName(), *LoggingUtils::GetName(FirstFocusActor), *PG::StringUtils::ToString(FirstResult));
+	const TSoftObjectPtr<UWorld> WorldKey{ FSoftObjectPath{ UWorld::RemovePIEPrefix(World->GetPathName()) } };
 
-	FocusActor = FirstFocusActor;
+	if (const auto ShotAtlasPtr = ShotAtlases.Find(WorldKey); ShotAtlasPtr)
+	{
+		ShotAtlas = ShotAtlasPtr->LoadSynchronous();
+	}
 
-	return FirstResult;
+	UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: LoadShotAtlas - World=%s; ShotAtlas=%s"),
+		*LoggingUtils::GetName(GetOwner()), *GetName(), *WorldKey.ToString(), *LoggingUtils::GetName(ShotAtlas));
 }
 
-bool UGolfAIShotComponent::ShotWillEndUpInHazard(const FAIShotSetupResult& ShotSetupResult) const
+TOptional<UGolfAIShotComponent::FShotSetupParams> UGolfAIShotComponent::FindAtlasShotParams()
 {
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("UGolfAIShotComponent::FindAtlasShotParams");
+
+	if (!ShotAtlas || !ShotContext.GolfHole)
+	{
+		return {};
+	}
+
 	const auto PlayerPawn = ShotContext.PlayerPawn;
 	check(PlayerPawn);
 
-	// Must account for additional rotation on top of the current actor rotation
-	const FRotator AdditionalRotation = { ShotSetupResult.ShotPitch, PG::MathUtils::ClampDeltaYaw(PlayerPawn->GetRotationYawToFocusActor(FocusActor) + ShotSetupResult.ShotYaw - InitialFocusYaw), 0 };
+	auto World = GetWorld();
+	check(World);
 
-	FFlickPredictParams FlickPredictParams
+	const auto HoleNumber = IFocusableActor::Execute_GetHoleNumber(ShotContext.GolfHole);
+	const auto& PawnLocation = PlayerPawn->GetActorLocation();
+
+	const auto Cell = ShotAtlas->FindNearestCell(HoleNumber, PawnLocation, ShotAtlasMaxCellDistance);
+
+	const auto Miss = [&](const TCHAR* Reason) -> TOptional<FShotSetupParams>
 	{
-		.AdditionalWorldRotation = AdditionalRotation,
+		INC_DWORD_STAT(STAT_PGAIShotAtlasMisses);
+
+		UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: FindAtlasShotParams - Miss for HoleNumber=%d at %s - %s"),
+			*LoggingUtils::GetName(GetOwner()), *GetName(), HoleNumber, *PawnLocation.ToCompactString(), Reason);
+
+		return {};
 	};
 
-	FPredictProjectilePathResult PathResult;
+	if (!Cell)
+	{
+		return Miss(TEXT("No cell in range"));
+	}
 
-	if (!PlayerPawn->PredictFlick(ShotSetupResult.FlickParams, FlickPredictParams, PathResult))
+	if (ShotContext.ShotType != EShotType::Default && Cell->ShotType != ShotContext.ShotType)
 	{
-		UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: ShotWillEndUpInHazard - FALSE - PredictFlick did not hit anything"), *LoggingUtils::GetName(GetOwner()), *GetName());
-		return false;
+		return Miss(TEXT("Shot type does not match"));
 	}
 
-	const FVector& HitLocation = PathResult.HitResult.ImpactPoint;
+	// Actor names are stable between the baked map and the cooked or PIE map
+	AActor* CellFocusActor{};
+	if (ShotContext.GolfHole->GetFName() == Cell->FocusActorName)
+	{
+		CellFocusActor = ShotContext.GolfHole;
+	}
+	else if (const auto FocusActorScore = ShotContext.FocusActorScores.FindByPredicate(
+		[&](const FShotFocusScores& Candidate) { return Candidate.FocusActor && Candidate.FocusActor->GetFName() == Cell->FocusActorName; }); FocusActorScore)
+	{
+		CellFocusActor = FocusActorScore->FocusActor;
+	}
 
-	// First do a trace to the initial hit result to see if its a hazard in that location and if so what type to see if we need to check for bounce
-	auto PenaltyHazardOptional = TraceToHazard(HitLocation);
-	if (PenaltyHazardOptional && !PenaltyHazardOptional.GetValue()->IsPenaltyOnImpact())
+	if (!CellFocusActor)
 	{
-		// extend the hit location to account for bounce
-		const auto BounceLocation = GetBounceLocation(PathResult);
+		return Miss(TEXT("Focus actor not available"));
+	}
 
-		UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: ShotWillEndUpInHazard - Detected impact hit at %s but %s hazard allows for bounce - Re-testing at final location %s"),
-			*LoggingUtils::GetName(GetOwner()), *GetName(),
-			*HitLocation.ToCompactString(), *LoggingUtils::GetName(PenaltyHazardOptional.GetValue()->GetHazardType()), *BounceLocation.ToCompactString());
+	// Baked shots only know the best next focus so don't let one pull the bot off its route
+	if (const auto Waypoint = RoutePlanner.GetNextWaypoint(); Waypoint && Waypoint == FocusActor && Waypoint != CellFocusActor)
+	{
+		return Miss(TEXT("Focus actor is not the next route waypoint"));
+	}
 
-		UE_VLOG_LOCATION(GetOwner(), LogPGAI, Log, BounceLocation, 10.0f, FColor::Yellow, TEXT("Bounce"));
+	// A baked shot that keeps failing is left to the live solver which adjusts for the shot history
+	int32 NumFailures{};
+	bool bLandedInHazard{};
+	if (!IsFocusActorViableBasedOnShotHistory(CellFocusActor, ConsecutiveFailureCurrentFocusLimit, &NumFailures, &bLandedInHazard))
+	{
+		return Miss(TEXT("Focus actor not viable based on shot history"));
+	}
 
-		PenaltyHazardOptional = TraceToHazard(BounceLocation);
+	FFlickParams FlickParams
+	{
+		.ShotType = Cell->ShotType,
+		.LocalZOffset = Cell->LocalZOffset,
+		.PowerFraction = Cell->PowerFraction
+	};
+
+	// The baked power carries from the cell location so re-solve it for the offset to the pawn at the baked pitch
+	{
+		const auto Gravity = FMath::Abs(World->GetGravityZ());
+		const auto TargetLocation = CellFocusActor->GetActorLocation();
+		const FVector CellLocation{ Cell->Location };
+
+		const auto CellSpeedSquared = GetDragFreeLaunchSpeedSquared(Gravity, (TargetLocation - CellLocation).Size2D(), TargetLocation.Z - CellLocation.Z, Cell->ShotPitch);
+		const auto PawnSpeedSquared = GetDragFreeLaunchSpeedSquared(Gravity, (TargetLocation - PawnLocation).Size2D(), TargetLocation.Z - PawnLocation.Z, Cell->ShotPitch);
+
+		if (CellSpeedSquared <= 0 || PawnSpeedSquared <= 0)
+		{
+			return Miss(TEXT("Focus actor not reachable at the baked pitch"));
+		}
+
+		const auto CellLaunchSpeed = PlayerPawn->GetFlickTrajectoryParams(FlickParams, {}).LaunchVelocity.Size();
+		FlickParams.PowerFraction = GetPowerFractionForLaunchSpeed(FlickParams, CellLaunchSpeed * FMath::Sqrt(PawnSpeedSquared / CellSpeedSquared));
 	}
 
-	const bool bHazard = PenaltyHazardOptional.IsSet();
+	// Validate with the same obstacle trace as the preferred shot candidate from the baked z offset
+	const auto FlickLocation = PlayerPawn->GetFlickLocation(Cell->LocalZOffset);
+	const auto AdditionalRotationYaw = PG::MathUtils::ClampDeltaYaw(PlayerPawn->GetRotationYawToFocusActor(CellFocusActor) - InitialFocusYaw);
+	const auto FlickDirection = PlayerPawn->GetFlickDirection().RotateAngleAxis(AdditionalRotationYaw + Cell->ShotYaw, PlayerPawn->GetActorUpVector());
+	const auto FlickSpeed = PlayerPawn->GetFlickMaxSpeed(Cell->ShotType) * FMath::Sqrt(FlickParams.PowerFraction);
 
-	UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: ShotWillEndUpInHazard - %s"),
-		*LoggingUtils::GetName(GetOwner()), *GetName(), LoggingUtils::GetBoolString(bHazard));
+	const auto TraceEnd = UPaperGolfPawnUtilities::GetShotAngleTraceEnd(this, *PlayerPawn, FlickLocation, FlickDirection, FlickSpeed, Cell->ShotPitch, MinTraceDistance);
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(GolfAIShotAtlasTrace), false, PlayerPawn);
 
-	return bHazard;
-}
+	++NumShotSetupTraces;
 
-float UGolfAIShotComponent::GetPowerMultiplierFromAngleDeviation(float YawDelta, float OriginalPitchAngleDegrees, float NewPitchAngleDegrees) const
-{
-	if (FMath::Abs(YawDelta) > MaxYawPitchAnglePowerMultiplierApplication)
+	if (World->LineTraceTestByChannel(FlickLocation, TraceEnd, PG::CollisionChannel::FlickTraceType, QueryParams))
 	{
-		UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: GetPowerMultiplierFromAngleDeviation - Abs(YawDelta)=%.1f > %.1f; returning 1.0"),
-			*LoggingUtils::GetName(GetOwner()), *GetName(), YawDelta, MaxYawPitchAnglePowerMultiplierApplication);
-		return 1.0f;
+		return Miss(TEXT("Flick trace blocked"));
 	}
 
-	const auto Curve = FindCurveForKey(AIConfigCurveTable, AngleDeviationVsPowerMultiplier);
-	if (!Curve)
+	FAIShotSetupResult ShotSetupResult
 	{
-		return 1.0f;
-	}
+		.FlickParams = FlickParams,
+		.FocusActor = CellFocusActor,
+		.ShotPitch = Cell->ShotPitch,
+		.ShotYaw = Cell->ShotYaw
+	};
 
-	// The deviation from 45 is what will affect the total distance so must compare the relative deviation difference between the original and new angles
-	const auto AngleDeviation = FMath::Abs(NewPitchAngleDegrees - 45) - FMath::Abs(OriginalPitchAngleDegrees - 45);
-	const auto PowerMultiplier = Curve->Eval(AngleDeviation);
+	// Same landing check as the live solver. The prediction aims at the member focus actor so restore it on a miss
+	auto PreviousFocusActor = FocusActor;
+	FocusActor = CellFocusActor;
 
-	UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: GetPowerMultiplierFromAngleDeviation - YawDelta=%1.f; OriginalPitchAngleDegrees=%.1f; NewPitchAngleDegrees=%.1f; AngleDeviation=%.1f; PowerMultiplier=%.2f"),
-		*LoggingUtils::GetName(GetOwner()), *GetName(), YawDelta, OriginalPitchAngleDegrees, NewPitchAngleDegrees, AngleDeviation, PowerMultiplier);
+	if (ShotWillEndUpInHazard(ShotSetupResult))
+	{
+		FocusActor = PreviousFocusActor;
+		return Miss(TEXT("Shot ends up in a hazard"));
+	}
 
-	return PowerMultiplier;
-}
+	const auto InitialPowerFraction = FlickParams.PowerFraction;
 
-FVector UGolfAIShotComponent::GetBounceLocation(const FPredictProjectilePathResult& PathResult) const
-{
-	const FVector VelocityAtHitPoint = GetVelocityAtHitPoint(PathResult);
+	if (AIPerformanceStrategy)
+	{
+		const auto FlickError = AIPerformanceStrategy->CalculateShotError(FlickParams);
+		ShotSetupResult.FlickParams.PowerFraction = FlickError.PowerFraction;
+		ShotSetupResult.FlickParams.Accuracy = FlickError.Accuracy;
+	}
+
+	CurrentFocusActorFailures = NumFailures;
+	bCurrentFocusActorLandedInHazard = bLandedInHazard;
+
+	INC_DWORD_STAT(STAT_PGAIShotAtlasHits);
+
+	UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: FindAtlasShotParams - Hit for HoleNumber=%d at %s; CellLocation=%s; FocusActor=%s; ShotType=%s; BakedPower=%.2f; Power=%.2f; Accuracy=%.2f; ZOffset=%.1f; ShotPitch=%.1f; ShotYaw=%.1f"),
+		*LoggingUtils::GetName(GetOwner()), *GetName(), HoleNumber, *PawnLocation.ToCompactString(), *Cell->Location.ToCompactString(), *LoggingUtils::GetName(CellFocusActor),
+		*LoggingUtils::GetName(ShotSetupResult.FlickParams.ShotType), Cell->PowerFraction, ShotSetupResult.FlickParams.PowerFraction, ShotSetupResult.FlickParams.Accuracy,
+		ShotSetupResult.FlickParams.LocalZOffset, Cell->ShotPitch, Cell->ShotYaw);
+
+	return FShotSetupParams
+	{
+		.FlickLocation = FlickLocation,
+		.InitialPowerFraction = InitialPowerFraction,
+		.ShotSetupResult = ShotSetupResult
+	};
+}
+
+void UGolfAIShotComponent::UpdateRoute()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("UGolfAIShotComponent::UpdateRoute");
+
+	if (const auto ReplanReason = GetRouteReplanReason(); ReplanReason)
+	{
+		UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: UpdateRoute - Replanning - %s"),
+			*LoggingUtils::GetName(GetOwner()), *GetName(), ReplanReason);
+
+		PlanRoute();
+	}
+
+	FollowRoute();
+}
+
+const TCHAR* UGolfAIShotComponent::GetRouteReplanReason()
+{
+	if (!bPlanRoute || !ShotContext.GolfHole)
+	{
+		return nullptr;
+	}
+
+	const TCHAR* ReplanReason{};
+
+	if (!RoutePlanner.HasRoute())
+	{
+		ReplanReason = TEXT("No route");
+	}
+	else if (HasRouteDeviated())
+	{
+		ReplanReason = TEXT("Last shot deviated from route");
+	}
+
+	// Waypoints drop out of the focus candidates once the pawn is on top of or past them
+	while (!ReplanReason && RoutePlanner.HasRoute())
+	{
+		const auto Waypoint = RoutePlanner.GetNextWaypoint();
+		if (!Waypoint)
+		{
+			ReplanReason = TEXT("Waypoint destroyed");
+		}
+		else if (IsRouteFocusCandidate(Waypoint))
+		{
+			break;
+		}
+		else if (!IsRouteWaypointReached(*Waypoint))
+		{
+			ReplanReason = TEXT("Waypoint no longer in view");
+		}
+		else
+		{
+			RoutePlanner.AdvanceWaypoint();
+
+			if (!RoutePlanner.HasRoute())
+			{
+				ReplanReason = TEXT("Route completed");
+			}
+		}
+	}
+
+	return ReplanReason;
+}
+
+void UGolfAIShotComponent::FollowRoute()
+{
+	if (!bPlanRoute || !ShotContext.GolfHole)
+	{
+		return;
+	}
+
+	// The live solver tries FocusActor first so the existing retries still fall back to the other focus actors in view
+	if (const auto Waypoint = RoutePlanner.GetNextWaypoint(); Waypoint && IsRouteFocusCandidate(Waypoint))
+	{
+		FocusActor = Waypoint;
+	}
+
+	UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: FollowRoute - FocusActor=%s; Route=%s"),
+		*LoggingUtils::GetName(GetOwner()), *GetName(), *LoggingUtils::GetName(FocusActor), *RoutePlanner.ToString());
+}
+
+bool UGolfAIShotComponent::PlanRoute()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("UGolfAIShotComponent::PlanRoute");
+	SCOPE_CYCLE_COUNTER(STAT_PGAIPlanRoute);
+
+	const auto PlayerPawn = ShotContext.PlayerPawn;
+	check(PlayerPawn);
+
+	const auto GolfHole = ShotContext.GolfHole;
+	check(GolfHole);
+
+	FRouteStartCandidates StartCandidates;
+	GetRouteStartCandidates(StartCandidates);
+
+	const auto NumCachedEdges = RoutePlanner.GetNumCachedEdges();
+
+	const bool bPlanned = RoutePlanner.Plan(PlayerPawn->GetActorLocation(), StartCandidates, ShotContext.FocusableActors, *GolfHole,
+		[this](const FVector& FromLocation, const AActor* FromActor, const AActor& ToActor)
+		{
+			return CalculateRouteEdgeCost(FromLocation, FromActor, ToActor);
+		});
+
+	INC_DWORD_STAT(STAT_PGAIRoutePlans);
+	INC_DWORD_STAT_BY(STAT_PGAIRouteCachedEdges, RoutePlanner.GetNumCachedEdges() - NumCachedEdges);
+
+	if (!bPlanned)
+	{
+		UE_VLOG_UELOG(GetOwner(), LogPGAI, Warning, TEXT("%s-%s: PlanRoute - No route to %s from %s with %d start candidate%s"),
+			*LoggingUtils::GetName(GetOwner()), *GetName(), *LoggingUtils::GetName(GolfHole), *PlayerPawn->GetActorLocation().ToCompactString(),
+			StartCandidates.Num(), LoggingUtils::Pluralize(StartCandidates.Num()));
+		return false;
+	}
+
+#if ENABLE_VISUAL_LOG
+	if (FVisualLogger::IsRecording())
+	{
+		auto LegStart = PlayerPawn->GetActorLocation();
+		for (const auto& Waypoint : RoutePlanner.GetRoute())
+		{
+			if (const auto WaypointActor = Waypoint.Actor.Get(); WaypointActor)
+			{
+				UE_VLOG_ARROW(GetOwner(), LogPGAI, Log, LegStart, WaypointActor->GetActorLocation(), FColor::Cyan, TEXT("Route: %s"), *Waypoint.Leg.ToString());
+				LegStart = WaypointActor->GetActorLocation();
+			}
+		}
+	}
+#endif
+
+	UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: PlanRoute - Route=%s; CachedEdges=%d"),
+		*LoggingUtils::GetName(GetOwner()), *GetName(), *RoutePlanner.ToString(), RoutePlanner.GetNumCachedEdges());
+
+	return true;
+}
+
+bool UGolfAIShotComponent::EvaluateRouteEdges(TFunctionRef<bool()> CanContinue)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("UGolfAIShotComponent::EvaluateRouteEdges");
+	SCOPE_CYCLE_COUNTER(STAT_PGAIPlanRoute);
+
+	const auto PlayerPawn = ShotContext.PlayerPawn;
+	check(PlayerPawn);
+
+	const auto GolfHole = ShotContext.GolfHole;
+	check(GolfHole);
+
+	FRouteStartCandidates StartCandidates;
+	GetRouteStartCandidates(StartCandidates);
+
+	const auto NumCachedEdges = RoutePlanner.GetNumCachedEdges();
+
+	const bool bComplete = RoutePlanner.EvaluateEdges(PlayerPawn->GetActorLocation(), StartCandidates, ShotContext.FocusableActors, *GolfHole,
+		[this](const FVector& FromLocation, const AActor* FromActor, const AActor& ToActor)
+		{
+			return CalculateRouteEdgeCost(FromLocation, FromActor, ToActor);
+		}, CanContinue);
+
+	INC_DWORD_STAT_BY(STAT_PGAIRouteCachedEdges, RoutePlanner.GetNumCachedEdges() - NumCachedEdges);
+
+	UE_VLOG_UELOG(GetOwner(), LogPGAI, Verbose, TEXT("%s-%s: EvaluateRouteEdges - bComplete=%s; CachedEdges=%d"),
+		*LoggingUtils::GetName(GetOwner()), *GetName(), LoggingUtils::GetBoolString(bComplete), RoutePlanner.GetNumCachedEdges());
+
+	return bComplete;
+}
+
+void UGolfAIShotComponent::GetRouteStartCandidates(FRouteStartCandidates& OutStartCandidates) const
+{
+	for (const auto& FocusActorScore : ShotContext.FocusActorScores)
+	{
+		if (FocusActorScore.FocusActor)
+		{
+			OutStartCandidates.Add(FocusActorScore.FocusActor);
+		}
+	}
+}
+
+bool UGolfAIShotComponent::HasRouteDeviated() const
+{
+	const auto RouteWaypoint = RoutePlanner.GetNextRouteWaypoint();
+	if (!RouteWaypoint || HoleShotResults.IsEmpty())
+	{
+		return false;
+	}
+
+	const auto Waypoint = RouteWaypoint->Actor.Get();
+	const auto& LastShot = HoleShotResults.Last();
+
+	if (!Waypoint || LastShot.ShotSetupParams.ShotSetupResult.FocusActor != Waypoint || LastShot.HitHazard)
+	{
+		return true;
+	}
+
+	// Same success test as the shot history but against the carry of the leg as a long leg takes more than one stroke
+	const auto DistanceToWaypoint = FVector::Dist(LastShot.ShotSetupParams.FlickLocation, Waypoint->GetActorLocation());
+	const auto ExpectedDistance = FMath::Min(DistanceToWaypoint, RouteWaypoint->Leg.Carry);
+
+	return LastShot.GetShotDistanceSquared() < FMath::Square(ExpectedDistance * MinDistanceFractionSuccess);
+}
+
+bool UGolfAIShotComponent::IsRouteWaypointReached(const AActor& Waypoint) const
+{
+	const auto PlayerPawn = ShotContext.PlayerPawn;
+	check(PlayerPawn && ShotContext.GolfHole);
+
+	const auto& PawnLocation = PlayerPawn->GetActorLocation();
+	const auto& WaypointLocation = Waypoint.GetActorLocation();
+
+	if (FVector::DistSquared2D(PawnLocation, WaypointLocation) < FMath::Square(IFocusableActor::Execute_GetMinDistance2D(&Waypoint)))
+	{
+		return true;
+	}
+
+	const auto& HoleLocation = ShotContext.GolfHole->GetActorLocation();
+
+	return FVector::DistSquared2D(PawnLocation, HoleLocation) < FVector::DistSquared2D(WaypointLocation, HoleLocation);
+}
+
+bool UGolfAIShotComponent::IsRouteFocusCandidate(const AActor* Actor) const
+{
+	return Actor && ShotContext.FocusActorScores.ContainsByPredicate([Actor](const FShotFocusScores& Candidate) { return Candidate.FocusActor == Actor; });
+}
+
+TOptional<FGolfAIRouteEdgeCost> UGolfAIShotComponent::CalculateRouteEdgeCost(const FVector& FromLocation, const AActor* FromActor, const AActor& ToActor) const
+{
+	const auto PlayerPawn = ShotContext.PlayerPawn;
+	check(PlayerPawn);
+
+	const auto& ToLocation = ToActor.GetActorLocation();
+	const auto ToTarget = ToLocation - FromLocation;
+	const auto Distance2D = ToTarget.Size2D();
+
+	// Legs from the pawn are limited to the focus candidates in view but those that keep failing are left for the retries
+	if (!FromActor)
+	{
+		bool bLandedInHazard{};
+		if (!IsFocusActorViableBasedOnShotHistory(&ToActor, ConsecutiveFailureCurrentFocusLimit, nullptr, &bLandedInHazard))
+		{
+			return {};
+		}
+	}
+	else
+	{
+		// Same facing and distance rules as focus selection in UGolfControllerCommonComponent::GetBestFocusActor
+		if (Distance2D < IFocusableActor::Execute_GetMinDistance2D(&ToActor))
+		{
+			return {};
+		}
+
+		const auto ToTargetDirection = ToTarget.GetSafeNormal();
+		if ((ToActor.GetActorForwardVector() | ToTargetDirection) < IFocusableActor::Execute_GetMinCosAngle(&ToActor))
+		{
+			return {};
+		}
+
+		if (!HasRouteLOS(FromLocation, FromActor, ToActor))
+		{
+			return {};
+		}
+	}
+
+	// Full power stroke on a fixed arc along the leg to see how far a single shot gets
+	auto TrajectoryParams = PlayerPawn->GetFlickTrajectoryParams(FFlickParams{ .ShotType = EShotType::Full, .PowerFraction = 1.0f }, {});
+
+	float PitchSin, PitchCos;
+	FMath::SinCos(&PitchSin, &PitchCos, FMath::DegreesToRadians(RouteCarryPitch));
+
+	const auto LaunchSpeed = TrajectoryParams.LaunchVelocity.Size();
+	const auto LaunchDirection = ToTarget.GetSafeNormal2D() * PitchCos + FVector::ZAxisVector * PitchSin;
+
+	TrajectoryParams.StartLocation = FromLocation + (TrajectoryParams.StartLocation - PlayerPawn->GetActorLocation());
+	TrajectoryParams.LaunchVelocity = LaunchDirection * LaunchSpeed;
+	TrajectoryParams.AngularVelocity = FVector::ZeroVector;
+	TrajectoryParams.MaxHorizontalDistance = Distance2D;
+
+	FPaperGolfTrajectoryResult PathResult;
+
+	++NumShotSetupTrajectoryPredictions;
+	PlayerPawn->PredictFlick(TrajectoryParams, TrajectoryScratch, PathResult);
+
+	const auto Carry = FMath::Max(FVector::Dist2D(TrajectoryParams.StartLocation, PathResult.LastLocation), RouteMinCarryDistance);
+	const auto ExpectedStrokes = FMath::Max(1.0f, Distance2D / Carry);
+
+	// Where the leg ends and where the first stroke comes down if the leg needs more than one
+	float HazardRisk{};
+	if (IsRouteHazardNear(ToLocation))
+	{
+		HazardRisk += 1.0f;
+	}
+	if (ExpectedStrokes > 1.0f && IsRouteHazardNear(PathResult.LastLocation))
+	{
+		HazardRisk += 1.0f;
+	}
+
+	const FGolfAIRouteEdgeCost EdgeCost
+	{
+		.Distance2D = Distance2D,
+		.Carry = Carry,
+		.ExpectedStrokes = ExpectedStrokes,
+		.HazardRisk = HazardRisk,
+		.Cost = ExpectedStrokes + HazardRisk * RouteHazardRiskStrokes
+	};
+
+	UE_VLOG_UELOG(GetOwner(), LogPGAI, Verbose, TEXT("%s-%s: CalculateRouteEdgeCost - From=%s; To=%s; %s"),
+		*LoggingUtils::GetName(GetOwner()), *GetName(), FromActor ? *LoggingUtils::GetName(FromActor) : TEXT("Pawn"), *LoggingUtils::GetName(ToActor), *EdgeCost.ToString());
+
+	return EdgeCost;
+}
+
+bool UGolfAIShotComponent::HasRouteLOS(const FVector& FromLocation, const AActor* FromActor, const AActor& ToActor) const
+{
+	auto World = GetWorld();
+	check(World);
+
+	if (ControllerCommonComponent)
+	{
+		if (const auto BakedLOS = ControllerCommonComponent->GetBakedLOSBetweenFocusActors(FromActor, &ToActor); BakedLOS)
+		{
+			return *BakedLOS;
+		}
+	}
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(GolfAIRouteLOS), false, ShotContext.PlayerPawn);
+	QueryParams.AddIgnoredActor(&ToActor);
+	QueryParams.AddIgnoredActor(FromActor);
+
+	++NumShotSetupTraces;
+
+	return UGolfControllerCommonComponent::TestLOSToFocus(*World, FromLocation, ToActor.GetActorLocation(), IFocusableActor::Execute_GetFocusTraceEndOffset(&ToActor),
+		ControllerCommonComponent ? ControllerCommonComponent->GetFocusTraceParams() : FGolfFocusTraceParams{}, QueryParams);
+}
+
+bool UGolfAIShotComponent::IsRouteHazardNear(const FVector& Location) const
+{
+	auto World = GetWorld();
+	check(World);
+
+	if (auto HazardIndex = World->GetSubsystem<UHazardSpatialIndexSubsystem>(); HazardIndex)
+	{
+		const auto ProbeBox = FBox::BuildAABB(Location, FVector{ RouteHazardProbeRadius, RouteHazardProbeRadius, HazardTraceDistance });
+		if (HazardIndex->QueryBox(ProbeBox).IsHit())
+		{
+			return true;
+		}
+
+		if (!HazardIndex->NeedsPhysicsQuery(ProbeBox))
+		{
+			return false;
+		}
+	}
+
+	return TraceToHazard(Location).IsHit();
+}
+
+TOptional<UGolfAIShotComponent::FShotSetupParams> UGolfAIShotComponent::CalculateShotParams()
+{
+	FShotPlanningState State;
+
+	AddFirstShotPlan(State);
+
+	TOptional<FShotSetupParams> ShotParams;
+	while (!ResolveNextShotPlan(State, ShotParams))
+	{
+	}
+
+	return ShotParams;
+}
+
+void UGolfAIShotComponent::AddFirstShotPlan(FShotPlanningState& State)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("UGolfAIShotComponent::AddFirstShotPlan");
+
+	State.bOnlySingleFocusAvailable = ShotContext.FocusActorScores.Num() <= 1;
+
+	// If only a single focus actor available, then compute the number of consecutive failures for pitch angle adjustment
+	const int32 FirstResultFailureTolerance = State.bOnlySingleFocusAvailable ? ShotPitchAngles.size() : ConsecutiveFailureCurrentFocusLimit;
+	State.bFirstResultViable = IsFocusActorViableBasedOnShotHistory(FocusActor, FirstResultFailureTolerance, &CurrentFocusActorFailures, &bCurrentFocusActorLandedInHazard);
+	State.bFirstFocusLandedInHazard = bCurrentFocusActorLandedInHazard;
+
+	State.FirstFocusActor = FocusActor;
+	State.bFirstPlanAdded = AddFocusShotPlan(FocusActor, CurrentFocusActorFailures, bCurrentFocusActorLandedInHazard, State.FocusShotPlans, State.TraceCandidates);
+
+	if (State.bFirstPlanAdded)
+	{
+		TraceShotPlanCandidates(State, State.FocusShotPlans[0]);
+	}
+
+	State.NextPlanIndex = State.bFirstPlanAdded ? 1 : 0;
+}
+
+bool UGolfAIShotComponent::AddNextShotPlan(FShotPlanningState& State)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("UGolfAIShotComponent::AddNextShotPlan");
+
+	const auto& FocusActorScores = ShotContext.FocusActorScores;
+
+	while (State.NextFocusActorScoreIndex < FocusActorScores.Num())
+	{
+		const auto PlanFocusActor = FocusActorScores[State.NextFocusActorScoreIndex++].FocusActor;
+		if (PlanFocusActor == State.FirstFocusActor)
+		{
+			continue;
+		}
+
+		// Need to filter the focus actors to the ones that haven't resulted in multiple failures
+		int32 FocusActorFailures{};
+		bool bLandedInHazard{};
+		if (!IsFocusActorViableBasedOnShotHistory(PlanFocusActor, ConsecutiveFailureCurrentFocusLimit, &FocusActorFailures, &bLandedInHazard))
+		{
+			continue;
+		}
+
+		if (AddFocusShotPlan(PlanFocusActor, FocusActorFailures, bLandedInHazard, State.FocusShotPlans, State.TraceCandidates))
+		{
+			TraceShotPlanCandidates(State, State.FocusShotPlans.Last());
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void UGolfAIShotComponent::TraceShotPlanCandidates(FShotPlanningState& State, const FFocusShotPlan& Plan)
+{
+	if (State.bAsyncTraces)
+	{
+		SubmitShotTraceCandidates(State, Plan);
+	}
+	else
+	{
+		EvaluateShotTraceCandidates(MakeArrayView(State.TraceCandidates).Slice(Plan.FirstCandidateIndex, Plan.NumCandidates));
+	}
+}
+
+bool UGolfAIShotComponent::ResolveNextShotPlan(FShotPlanningState& State, TOptional<FShotSetupParams>& OutShotParams)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("UGolfAIShotComponent::ResolveNextShotPlan");
+
+	if (!State.bFirstResultResolved)
+	{
+		ResolveFirstShotResult(State);
+
+		if (State.bOnlySingleFocusAvailable)
+		{
+			UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: CalculateShotParams - Insufficient alternative focii to check for hazards - FocusActorCount=%d, using first result=%s"),
+				*LoggingUtils::GetName(GetOwner()), *GetName(), ShotContext.FocusActorScores.Num(), *PG::StringUtils::ToString(State.FirstResult));
+
+			OutShotParams = State.FirstResult;
+			return true;
+		}
+
+		if (State.FirstResult && State.bFirstResultViable && !ShotWillEndUpInHazard(State.FirstResult->ShotSetupResult))
+		{
+			OutShotParams = State.FirstResult;
+			return true;
+		}
+
+		return false;
+	}
+
+	// Alternative focus actors are only planned once the ones before them have failed. Async traces are resolved on a later tick
+	if (State.NextPlanIndex == State.FocusShotPlans.Num() && AddNextShotPlan(State) && State.bAsyncTraces)
+	{
+		return false;
+	}
+
+	if (State.NextPlanIndex < State.FocusShotPlans.Num())
+	{
+		const auto& Plan = State.FocusShotPlans[State.NextPlanIndex++];
+
+		FocusActor = Plan.FocusActor;
+		bCurrentFocusActorLandedInHazard = Plan.bLandedInHazard;
+
+		const auto Result = CalculateShotParamsForPlan(Plan, State.TraceCandidates);
+
+		if (Result && !ShotWillEndUpInHazard(Result->ShotSetupResult))
+		{
+			UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: CalculateShotParams - Using FocusActor=%s; Result=%s"),
+				*LoggingUtils::GetName(GetOwner()), *GetName(), *LoggingUtils::GetName(FocusActor), *PG::StringUtils::ToString(Result));
+			CurrentFocusActorFailures = Plan.NumFailures;
+
+			OutShotParams = Result;
+			return true;
+		}
+
+		return false;
+	}
+
+	UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: CalculateShotParams - No viable alternative focus actor found, using first result - FocusActor=%s; Result=%s"),
+		*LoggingUtils::GetName(GetOwner()), *GetName(), *LoggingUtils::GetName(State.FirstFocusActor), *PG::StringUtils::ToString(State.FirstResult));
+
+	FocusActor = State.FirstFocusActor;
+	bCurrentFocusActorLandedInHazard = State.bFirstFocusLandedInHazard;
+	OutShotParams = State.FirstResult;
+
+	return true;
+}
+
+void UGolfAIShotComponent::ResolveFirstShotResult(FShotPlanningState& State)
+{
+	State.bFirstResultResolved = true;
+
+	FocusActor = State.FirstFocusActor;
+	State.FirstResult = State.bFirstPlanAdded ? CalculateShotParamsForPlan(State.FocusShotPlans[0], State.TraceCandidates) : TOptional<FShotSetupParams>{};
+}
+
+TOptional<UGolfAIShotComponent::FShotSetupParams> UGolfAIShotComponent::GetBestShotParamsSoFar(FShotPlanningState& State)
+{
+	// Keep resolving with the traces that have returned for one more slice so the result gets the same hazard checks as a completed plan.
+	// Candidates whose traces are still pending have not passed so they count as blocked
+	const auto SliceEndTimeSeconds = FPlatformTime::Seconds() + MaxShotPlanningFrameTimeMs / 1000.0;
+
+	// Any further plans are traced on the game thread as there is no time to wait for async traces
+	State.bAsyncTraces = false;
+
+	TOptional<FShotSetupParams> ShotParams;
+	do
+	{
+		if (ResolveNextShotPlan(State, ShotParams))
+		{
+			return ShotParams;
+		}
+	} while (FPlatformTime::Seconds() < SliceEndTimeSeconds);
+
+	// The first focus actor result is the fallback when no alternative was found to avoid a hazard, same as when all plans are resolved
+	UE_VLOG_UELOG(GetOwner(), LogPGAI, Warning, TEXT("%s-%s: GetBestShotParamsSoFar - No shot clear of hazards found after %d of %d focus plan%s - using first result - FocusActor=%s; Result=%s"),
+		*LoggingUtils::GetName(GetOwner()), *GetName(), State.NextPlanIndex, State.FocusShotPlans.Num(), LoggingUtils::Pluralize(State.FocusShotPlans.Num()),
+		*LoggingUtils::GetName(State.FirstFocusActor), *PG::StringUtils::ToString(State.FirstResult));
+
+	FocusActor = State.FirstFocusActor;
+	bCurrentFocusActorLandedInHazard = State.bFirstFocusLandedInHazard;
+
+	return State.FirstResult;
+}
+
+void UGolfAIShotComponent::SubmitShotTraceCandidates(FShotPlanningState& State, const FFocusShotPlan& Plan)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("UGolfAIShotComponent::SubmitShotTraceCandidates");
+
+	INC_DWORD_STAT_BY(STAT_PGAIShotCandidates, Plan.NumCandidates);
+
+	auto World = GetWorld();
+	check(World);
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(GolfAIShotCandidateTrace), false, ShotContext.PlayerPawn);
+	IgnoreTimedMovingObstacles(QueryParams);
+	if (!State.TraceDelegate.IsBound())
+	{
+		State.TraceDelegate = FTraceDelegate::CreateUObject(this, &ThisClass::OnShotCandidateTraceComplete, ShotPlanningId);
+	}
+
+	for (int32 i = Plan.FirstCandidateIndex; i < Plan.FirstCandidateIndex + Plan.NumCandidates; ++i)
+	{
+		const auto& Candidate = State.TraceCandidates[i];
+
+		// Single trace type as we only care whether there is a blocking hit; the candidate index is passed through as the user data
+		World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Candidate.TraceStart, Candidate.TraceEnd, PG::CollisionChannel::FlickTraceType,
+			QueryParams, FCollisionResponseParams::DefaultResponseParam, &State.TraceDelegate, static_cast<uint32>(i));
+	}
+
+	State.NumPendingTraces += Plan.NumCandidates;
+	NumShotSetupTraces += Plan.NumCandidates;
+
+	UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: SubmitShotTraceCandidates - Submitted %d async trace%s for FocusActor=%s"),
+		*LoggingUtils::GetName(GetOwner()), *GetName(), Plan.NumCandidates, LoggingUtils::Pluralize(Plan.NumCandidates), *LoggingUtils::GetName(Plan.FocusActor));
+}
+
+void UGolfAIShotComponent::OnShotCandidateTraceComplete(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum, uint32 PlanningId)
+{
+	if (!ShotPlanningState || PlanningId != ShotPlanningId)
+	{
+		return;
+	}
+
+	auto& State = *ShotPlanningState;
+	const int32 CandidateIndex = static_cast<int32>(TraceDatum.UserData);
+
+	if (!ensure(State.TraceCandidates.IsValidIndex(CandidateIndex)))
+	{
+		return;
+	}
+
+	State.TraceCandidates[CandidateIndex].bPass = FHitResult::GetFirstBlockingHit(TraceDatum.OutHits) == nullptr;
+	--State.NumPendingTraces;
+}
+
+bool UGolfAIShotComponent::AddFocusShotPlan(AActor* PlanFocusActor, int32 NumFailures, bool bLandedInHazard, FFocusShotPlanArray& Plans, TArray<FShotTraceCandidate>& Candidates)
+{
+	// Initial shot and calibration calculations are relative to the current focus actor
+	FocusActor = PlanFocusActor;
+
+	const auto InitialShotParamsOptional = CalculateInitialShotParams();
+	if (!InitialShotParamsOptional)
+	{
+		return false;
+	}
+
+	const auto& InitialShotParams = *InitialShotParamsOptional;
+
+	auto& Plan = Plans.Add_GetRef(FFocusShotPlan
+	{
+		.FocusActor = PlanFocusActor,
+		.InitialShotParams = InitialShotParams,
+		// Calibrate the power fraction and ideal pitch based on the current distance to hole (ignoring obstacles)
+		.ShotCalibrationResult = CalibrateShot(InitialShotParams.FlickLocation, InitialShotParams.PowerFraction),
+		.NumFailures = NumFailures,
+		.bLandedInHazard = bLandedInHazard,
+		.FirstCandidateIndex = Candidates.Num()
+	});
+
+	AddAvoidanceShotCandidates(Plan, Candidates);
+
+	Plan.NumCandidates = Candidates.Num() - Plan.FirstCandidateIndex;
+
+	return true;
+}
+
+void UGolfAIShotComponent::EvaluateShotTraceCandidates(TArrayView<FShotTraceCandidate> Candidates) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("UGolfAIShotComponent::EvaluateShotTraceCandidates");
+	SCOPE_CYCLE_COUNTER(STAT_PGAIEvaluateShotCandidates);
+
+	INC_DWORD_STAT_BY(STAT_PGAIShotCandidates, Candidates.Num());
+
+	const auto World = GetWorld();
+	check(World);
+
+	const auto StartTimeSeconds = FPlatformTime::Seconds();
+
+	// Scene queries are read only so they can be issued from worker threads; each task only writes the result to its own candidate
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(GolfAIShotCandidateTrace), false, ShotContext.PlayerPawn);
+	IgnoreTimedMovingObstacles(QueryParams);
+
+	ParallelFor(TEXT("GolfAIShotCandidateTraces"), Candidates.Num(), ShotCandidateMinBatchSize, [&](int32 Index)
+	{
+		auto& Candidate = Candidates[Index];
+		Candidate.bPass = !World->LineTraceTestByChannel(Candidate.TraceStart, Candidate.TraceEnd, PG::CollisionChannel::FlickTraceType, QueryParams);
+	}, bParallelShotCandidateEvaluation ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+
+	NumShotSetupTraces += Candidates.Num();
+
+	UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: EvaluateShotTraceCandidates - Evaluated %d candidate%s in %.2fms; bParallel=%s"),
+		*LoggingUtils::GetName(GetOwner()), *GetName(), Candidates.Num(), LoggingUtils::Pluralize(Candidates.Num()),
+		(FPlatformTime::Seconds() - StartTimeSeconds) * 1000, LoggingUtils::GetBoolString(bParallelShotCandidateEvaluation));
+}
+
+float UGolfAIShotComponent::CalculateMovingObstacleWaitTime(const APaperGolfPawn& Pawn, const FFlickParams& FlickParams) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("UGolfAIShotComponent::CalculateMovingObstacleWaitTime");
+
+	const auto MovingObstacleSubsystem = GetTimedMovingObstacleSubsystem();
+	if (!MovingObstacleSubsystem)
+	{
+		return 0.0f;
+	}
+
+	auto TrajectoryParams = Pawn.GetFlickTrajectoryParams(FlickParams, {});
+
+	// The obstacles are swept below where they will be when the pawn gets to them rather than where they are now
+	TrajectoryParams.IgnoreComponents = MovingObstacleSubsystem->GetObstacleComponents();
+
+	FPaperGolfTrajectoryResult PathResult;
+	Pawn.PredictFlick(TrajectoryParams, ObstacleTimingScratch, PathResult);
+
+	TOptional<FMovingObstacleSweepHit> ImmediateHit;
+	const auto WaitTime = FindClearMovingObstacleWait(*MovingObstacleSubsystem, ObstacleTimingScratch.GetPath(PathResult), TrajectoryParams.CollisionRadius,
+		MaxMovingObstacleWaitTime, MovingObstacleWaitStep, ImmediateHit);
+
+	if (ImmediateHit)
+	{
+		UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: CalculateMovingObstacleWaitTime - Blocked now: %s"),
+			*LoggingUtils::GetName(GetOwner()), *GetName(), *ImmediateHit->ToString());
+		UE_VLOG_LOCATION(GetOwner(), LogPGAI, Log, ImmediateHit->ImpactPoint, 20.0f, FColor::Orange, TEXT("Moving Obstacle"));
+	}
+
+	if (WaitTime)
+	{
+		UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: CalculateMovingObstacleWaitTime - WaitTime=%.2fs"),
+			*LoggingUtils::GetName(GetOwner()), *GetName(), *WaitTime);
+		return *WaitTime;
+	}
+
+	UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: CalculateMovingObstacleWaitTime - No clear window within %.1fs - Shooting now"),
+		*LoggingUtils::GetName(GetOwner()), *GetName(), MaxMovingObstacleWaitTime);
+
+	return 0.0f;
+}
+
+bool UGolfAIShotComponent::ShotWillEndUpInHazard(const FAIShotSetupResult& ShotSetupResult) const
+{
+	const auto PlayerPawn = ShotContext.PlayerPawn;
+	check(PlayerPawn);
+
+	// Must account for additional rotation on top of the current actor rotation
+	const FRotator AdditionalRotation = { ShotSetupResult.ShotPitch, PG::MathUtils::ClampDeltaYaw(PlayerPawn->GetRotationYawToFocusActor(FocusActor) + ShotSetupResult.ShotYaw - InitialFocusYaw), 0 };
+
+	FFlickPredictParams FlickPredictParams
+	{
+		.AdditionalWorldRotation = AdditionalRotation,
+	};
+
+	auto TrajectoryParams = PlayerPawn->GetFlickTrajectoryParams(ShotSetupResult.FlickParams, FlickPredictParams);
+
+	// The shot waits for the moving obstacles so they are swept where they will be instead of blocking the prediction where they are now
+	const auto MovingObstacleSubsystem = GetTimedMovingObstacleSubsystem();
+	if (MovingObstacleSubsystem)
+	{
+		TrajectoryParams.IgnoreComponents = MovingObstacleSubsystem->GetObstacleComponents();
+	}
+
+	// Only the landing is needed unless the path is swept against the moving obstacles
+	auto& Scratch = MovingObstacleSubsystem ? ObstacleTimingScratch : TrajectoryScratch;
+	FPaperGolfTrajectoryResult PathResult;
+
+	++NumShotSetupTrajectoryPredictions;
+
+	const bool bPathHit = PlayerPawn->PredictFlick(TrajectoryParams, Scratch, PathResult);
+
+	if (MovingObstacleSubsystem)
+	{
+		TOptional<FMovingObstacleSweepHit> ImmediateHit;
+		if (!FindClearMovingObstacleWait(*MovingObstacleSubsystem, Scratch.GetPath(PathResult), TrajectoryParams.CollisionRadius,
+			MaxMovingObstacleWaitTime, MovingObstacleWaitStep, ImmediateHit) && ImmediateHit)
+		{
+			// No wait clears the path so the shot goes right away and is stopped by the obstacle
+			const bool bHazard = TraceToHazard(ImmediateHit->ImpactPoint).IsHit();
+
+			UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: ShotWillEndUpInHazard - %s - Moving obstacle blocks every wait: %s"),
+				*LoggingUtils::GetName(GetOwner()), *GetName(), LoggingUtils::GetBoolString(bHazard), *ImmediateHit->ToString());
+
+			return bHazard;
+		}
+	}
+
+	if (!bPathHit)
+	{
+		UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: ShotWillEndUpInHazard - FALSE - PredictFlick did not hit anything"), *LoggingUtils::GetName(GetOwner()), *GetName());
+		return false;
+	}
+
+	const FVector& HitLocation = PathResult.HitResult.ImpactPoint;
+
+	// First do a trace to the initial hit result to see if its a hazard in that location and if so what type to see if we need to check for bounce
+	auto HazardResult = TraceToHazard(HitLocation);
+	if (bPredictMultipleBounces)
+	{
+		// Bounces can carry the shot into a hazard even when the landing is clear
+		if (!HazardResult.IsHit() || !HazardResult.bPenaltyOnImpact)
+		{
+			HazardResult = TraceBouncesToHazard(TrajectoryParams, PathResult);
+		}
+	}
+	else if (HazardResult.IsHit() && !HazardResult.bPenaltyOnImpact)
+	{
+		// extend the hit location to account for bounce
+		const auto BounceLocation = GetBounceLocation(PathResult);
+
+		UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: ShotWillEndUpInHazard - Detected impact hit at %s but %s hazard allows for bounce - Re-testing at final location %s"),
+			*LoggingUtils::GetName(GetOwner()), *GetName(),
+			*HitLocation.ToCompactString(), *LoggingUtils::GetName(HazardResult.HazardType), *BounceLocation.ToCompactString());
+
+		UE_VLOG_LOCATION(GetOwner(), LogPGAI, Log, BounceLocation, 10.0f, FColor::Yellow, TEXT("Bounce"));
+
+		HazardResult = TraceToHazard(BounceLocation);
+	}
+
+	const bool bHazard = HazardResult.IsHit();
+
+	UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: ShotWillEndUpInHazard - %s"),
+		*LoggingUtils::GetName(GetOwner()), *GetName(), LoggingUtils::GetBoolString(bHazard));
+
+	return bHazard;
+}
+
+float UGolfAIShotComponent::GetPowerMultiplierFromAngleDeviation(float YawDelta, float OriginalPitchAngleDegrees, float NewPitchAngleDegrees) const
+{
+	if (FMath::Abs(YawDelta) > MaxYawPitchAnglePowerMultiplierApplication)
+	{
+		UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: GetPowerMultiplierFromAngleDeviation - Abs(YawDelta)=%.1f > %.1f; returning 1.0"),
+			*LoggingUtils::GetName(GetOwner()), *GetName(), YawDelta, MaxYawPitchAnglePowerMultiplierApplication);
+		return 1.0f;
+	}
+
+	if (!PowerMultiplierCurve.IsValid())
+	{
+		return 1.0f;
+	}
+
+	// The deviation from 45 is what will affect the total distance so must compare the relative deviation difference between the original and new angles
+	const auto AngleDeviation = FMath::Abs(NewPitchAngleDegrees - 45) - FMath::Abs(OriginalPitchAngleDegrees - 45);
+	const auto PowerMultiplier = PowerMultiplierCurve.Eval(AngleDeviation);
+
+	UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: GetPowerMultiplierFromAngleDeviation - YawDelta=%1.f; OriginalPitchAngleDegrees=%.1f; NewPitchAngleDegrees=%.1f; AngleDeviation=%.1f; PowerMultiplier=%.2f"),
+		*LoggingUtils::GetName(GetOwner()), *GetName(), YawDelta, OriginalPitchAngleDegrees, NewPitchAngleDegrees, AngleDeviation, PowerMultiplier);
+
+	return PowerMultiplier;
+}
+
+const UMovingObstacleSubsystem* UGolfAIShotComponent::GetTimedMovingObstacleSubsystem() const
+{
+	if (!bTimeShotsForMovingObstacles)
+	{
+		return nullptr;
+	}
+
+	auto World = GetWorld();
+	check(World);
+
+	const auto MovingObstacleSubsystem = World->GetSubsystem<UMovingObstacleSubsystem>();
+	return MovingObstacleSubsystem && MovingObstacleSubsystem->GetNumObstacles() > 0 ? MovingObstacleSubsystem : nullptr;
+}
+
+void UGolfAIShotComponent::IgnoreTimedMovingObstacles(FCollisionQueryParams& QueryParams) const
+{
+	// The candidate traces are straight lines rather than the flight so there is no time along them to place the obstacles at.
+	// The hazard check sweeps the predicted path of the chosen shot against them instead
+	if (const auto MovingObstacleSubsystem = GetTimedMovingObstacleSubsystem(); MovingObstacleSubsystem)
+	{
+		for (const auto Component : MovingObstacleSubsystem->GetObstacleComponents())
+		{
+			QueryParams.AddIgnoredComponent(Component);
+		}
+	}
+}
+
+FHazardQueryResult UGolfAIShotComponent::TraceBouncesToHazard(const FPaperGolfTrajectoryParams& TrajectoryParams, const FPaperGolfTrajectoryResult& PathResult) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("UGolfAIShotComponent::TraceBouncesToHazard");
+
+	auto World = GetWorld();
+	if (!ensure(World))
+	{
+		return {};
+	}
+
+	const FPaperGolfBounceParams BounceParams
+	{
+		.MaxBounces = HazardPredictMaxBounces,
+		.RestSpeed = HazardPredictRestSpeed,
+		.DefaultRestitution = DefaultHitRestitution,
+		.DefaultFriction = DefaultHitFriction,
+		.SurfaceMaterialCache = &SurfaceMaterialCache,
+		.MaxBounceSimTime = HazardPredictBounceTime
+	};
+
+	FPaperGolfBounceResult BounceResult;
+	FPaperGolfBounceSolver::Solve(*World, TrajectoryParams, PathResult, BounceParams, BounceResult);
+
+	NumShotSetupTrajectoryPredictions += BounceResult.NumBounces;
+
+	UpdateSurfaceMaterialCacheStats();
+
+	UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: TraceBouncesToHazard - %s"),
+		*LoggingUtils::GetName(GetOwner()), *GetName(), *BounceResult.ToString());
+
+	// The landing contact was already checked by the caller. Any later contact with a penalty on impact hazard ends the shot there
+	for (int32 i = 1; i < BounceResult.Contacts.Num(); ++i)
+	{
+		const auto& Contact = BounceResult.Contacts[i];
+
+		UE_VLOG_LOCATION(GetOwner(), LogPGAI, Log, Contact.Location, 10.0f, FColor::Yellow, TEXT("Bounce %d"), i);
+
+		if (const auto HazardResult = TraceToHazard(Contact.Location); HazardResult.IsHit() && HazardResult.bPenaltyOnImpact)
+		{
+			return HazardResult;
+		}
+	}
+
+	UE_VLOG_LOCATION(GetOwner(), LogPGAI, Log, BounceResult.RestLocation, 10.0f, FColor::Orange, TEXT("Rest"));
+
+	return TraceToHazard(BounceResult.RestLocation);
+}
+
+FVector UGolfAIShotComponent::GetBounceLocation(const FPaperGolfTrajectoryResult& PathResult) const
+{
+	const FVector& VelocityAtHitPoint = PathResult.LastVelocity;
 	const FVector VelocityDirection = VelocityAtHitPoint.GetSafeNormal();
 	const auto Speed = VelocityAtHitPoint.Size();
 	// reduce speed by elasticity -> KE = 1/2mv^2 -> v reduced by factor of sqrt(elasticity)
@@ -324,7 +1612,7 @@ FVector UGolfAIShotComponent::GetBounceLocation(const FPredictProjectilePathResu
 	return BounceLocation;
 }
 
-TOptional<const IPenaltyHazard*> UGolfAIShotComponent::TraceToHazard(const FVector& Location) const
+FHazardQueryResult UGolfAIShotComponent::TraceToHazard(const FVector& Location) const
 {
 	auto World = GetWorld();
 	if (!ensure(World))
@@ -332,32 +1620,56 @@ TOptional<const IPenaltyHazard*> UGolfAIShotComponent::TraceToHazard(const FVect
 		return {};
 	}
 
-	FHitResult HazardHitResult;
 	const auto TraceOffset = FVector::ZAxisVector * HazardTraceDistance * 0.5f;
 
 	const auto HazardTraceStart = Location + TraceOffset;
 	const auto HazardTraceEnd = Location - TraceOffset;
 
-	const bool bTraceResult = World->LineTraceSingleByObjectType(HazardHitResult, HazardTraceStart, HazardTraceEnd, PG::CollisionObjectType::Hazard);
-	if (bTraceResult)
+	FHazardQueryResult HazardResult;
+
+	const FBox HazardTraceBox{ HazardTraceEnd, HazardTraceStart };
+	auto HazardIndex = World->GetSubsystem<UHazardSpatialIndexSubsystem>();
+
+	// The spatial index avoids a physics query; still trace where hazards that did not register with it may be
+	if (HazardIndex)
+	{
+		HazardResult = HazardIndex->QueryBox(HazardTraceBox);
+	}
+
+	if (!HazardResult.IsHit() && (!HazardIndex || HazardIndex->NeedsPhysicsQuery(HazardTraceBox)))
 	{
-		// Cast the actor to IPenaltyHazard
-		const auto HazardActor = HazardHitResult.GetActor();
-		const auto PenaltyHazard = Cast<const IPenaltyHazard>(HazardActor);
-		if (!ensure(HazardActor && PenaltyHazard))
+		++NumShotSetupTraces;
+
+		if (FHitResult HazardHitResult; World->LineTraceSingleByObjectType(HazardHitResult, HazardTraceStart, HazardTraceEnd, PG::CollisionObjectType::Hazard))
 		{
-			UE_VLOG_UELOG(GetOwner(), LogPGAI, Error, TEXT("%s-%s: TraceToHazard - TRUE - HazardActor=%s was not a penalty hazard!"),
-				*LoggingUtils::GetName(GetOwner()), *GetName(), *LoggingUtils::GetName(HazardActor));
-			return {};
+			// Cast the actor to IPenaltyHazard
+			const auto HazardActor = HazardHitResult.GetActor();
+			const auto PenaltyHazard = Cast<const IPenaltyHazard>(HazardActor);
+			if (!ensure(HazardActor && PenaltyHazard))
+			{
+				UE_VLOG_UELOG(GetOwner(), LogPGAI, Error, TEXT("%s-%s: TraceToHazard - TRUE - HazardActor=%s was not a penalty hazard!"),
+					*LoggingUtils::GetName(GetOwner()), *GetName(), *LoggingUtils::GetName(HazardActor));
+				return {};
+			}
+
+			HazardResult = FHazardQueryResult
+			{
+				.HazardActor = HazardActor,
+				.HazardType = PenaltyHazard->GetHazardType(),
+				.bPenaltyOnImpact = PenaltyHazard->IsPenaltyOnImpact()
+			};
 		}
+	}
 
+	if (HazardResult.IsHit())
+	{
 		UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: TraceToHazard - TRUE - Found %s Hazard: %s at %s"),
-			*LoggingUtils::GetName(GetOwner()), *GetName(), *LoggingUtils::GetName(PenaltyHazard->GetHazardType()), *LoggingUtils::GetName(HazardActor), *Location.ToCompactString());
+			*LoggingUtils::GetName(GetOwner()), *GetName(), *LoggingUtils::GetName(HazardResult.HazardType), *LoggingUtils::GetName(HazardResult.HazardActor), *Location.ToCompactString());
 
 		UE_VLOG_ARROW(GetOwner(), LogPGAI, Log, HazardTraceStart, HazardTraceEnd, FColor::Red, TEXT("%s Hazard: %s"),
-			*LoggingUtils::GetName(GetOwner()), *LoggingUtils::GetName(PenaltyHazard->GetHazardType()), *LoggingUtils::GetName(HazardActor));
+			*LoggingUtils::GetName(GetOwner()), *LoggingUtils::GetName(HazardResult.HazardType), *LoggingUtils::GetName(HazardResult.HazardActor));
 
-		return PenaltyHazard;
+		return HazardResult;
 	}
 
 	UE_VLOG_ARROW(GetOwner(), LogPGAI, Verbose, HazardTraceStart, HazardTraceEnd, FColor::Yellow, TEXT("No Hazard"));
@@ -370,71 +1682,37 @@ TOptional<const IPenaltyHazard*> UGolfAIShotComponent::TraceToHazard(const FVect
 
 float UGolfAIShotComponent::GetHitRestitution(const FHitResult& HitResult) const
 {
-	// Ideally we would use PathResult.HitResult.PhysMaterial->Restitution; however, the path prediction hit result is not returned with physical material but we can do a quick trace to get it
-	if (auto PhysicalMaterial = HitResult.PhysMaterial.Get(); PhysicalMaterial)
-	{
-		return PhysicalMaterial->Restitution;
-	}
-
-	// do a trace to get the physical material since the original hit did not have it
-	auto World = GetWorld();
-	if (!ensure(World))
-	{
-		return 0.0f;
-	}
-
-	FCollisionQueryParams Params;
-	Params.AddIgnoredActor(ShotContext.PlayerPawn);
-	Params.bReturnPhysicalMaterial = true;
-
-	FHitResult TraceHitResult;
-
-	if (!World->LineTraceSingleByChannel(TraceHitResult, HitResult.ImpactPoint + HitResult.ImpactNormal * 10, HitResult.ImpactPoint - HitResult.ImpactNormal * 10, PG::CollisionChannel::FlickTraceType))
-	{
-		UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: GetHitRestitution - Unable to determine physical material from re-trace; ImpactPoint=%s; ImpactNormal=%s"),
-			*LoggingUtils::GetName(GetOwner()), *GetName(), *HitResult.ImpactPoint.ToCompactString(), *HitResult.ImpactNormal.ToCompactString());
-		return 0.0f;
-	}
+	// The path prediction hit result is not returned with physical material so resolve it from the hit component through the cache rather than re-tracing
+	const auto Response = SurfaceMaterialCache.Get(HitResult, { DefaultHitRestitution, DefaultHitFriction });
 
-	if (auto PhysicalMaterial = TraceHitResult.PhysMaterial.Get(); PhysicalMaterial)
-	{
-		UE_VLOG_UELOG(GetOwner(), LogPGAI, Verbose,
-			TEXT("%s-%s: GetHitRestitution - %f - PhysicalMaterial=%s; Actor=%s; Component=%s"),
-			*LoggingUtils::GetName(GetOwner()), *GetName(), PhysicalMaterial->Restitution, *PhysicalMaterial->GetName(),
-			*LoggingUtils::GetName(TraceHitResult.GetActor()), *LoggingUtils::GetName(TraceHitResult.GetComponent()));
-
-		return PhysicalMaterial->Restitution;
-	}
+	UE_VLOG_UELOG(GetOwner(), LogPGAI, Verbose,
+		TEXT("%s-%s: GetHitRestitution - %f - Actor=%s; Component=%s; FaceIndex=%d"),
+		*LoggingUtils::GetName(GetOwner()), *GetName(), Response.Restitution,
+		*LoggingUtils::GetName(HitResult.GetActor()), *LoggingUtils::GetName(HitResult.GetComponent()), HitResult.FaceIndex);
 
-	UE_VLOG_UELOG(GetOwner(), LogPGAI, Warning,
-		TEXT("%s-%s: GetHitRestitution - %f - Re-trace hit result did not return physical material using default! OriginalImpactPoint=%s; OriginalImpactNormal=%s; TraceImpactPoint=%s; TraceImpactNormal=%s"),
-		*LoggingUtils::GetName(GetOwner()), *GetName(), DefaultHitRestitution,
-		*HitResult.ImpactPoint.ToCompactString(), *HitResult.ImpactNormal.ToCompactString(),
-		*TraceHitResult.ImpactPoint.ToCompactString(), *TraceHitResult.ImpactNormal.ToCompactString());
+	UpdateSurfaceMaterialCacheStats();
 
-	return DefaultHitRestitution;
+	return Response.Restitution;
 }
 
-TOptional<UGolfAIShotComponent::FShotSetupParams> UGolfAIShotComponent::CalculateShotParamsForCurrentFocusActor()
+void UGolfAIShotComponent::UpdateSurfaceMaterialCacheStats() const
 {
-	const auto InitialShotParamsOptional = CalculateInitialShotParams();
-	if (!InitialShotParamsOptional)
-	{
-		return {};
-	}
+	SET_DWORD_STAT(STAT_PGAISurfaceMaterialCacheHits, SurfaceMaterialCache.GetNumHits());
+	SET_DWORD_STAT(STAT_PGAISurfaceMaterialCacheMisses, SurfaceMaterialCache.GetNumMisses());
+}
 
-	const auto& InitialShotParams = *InitialShotParamsOptional;
+TOptional<UGolfAIShotComponent::FShotSetupParams> UGolfAIShotComponent::CalculateShotParamsForPlan(const FFocusShotPlan& Plan, TConstArrayView<FShotTraceCandidate> Candidates)
+{
+	const auto& InitialShotParams = Plan.InitialShotParams;
+	const auto& ShotCalibrationResult = Plan.ShotCalibrationResult;
 
 	auto FlickParams = InitialShotParams.ToFlickParams();
 
-	// Calibrate the power fraction and ideal pitch based on the current distance to hole (ignoring obstacles)
-	const auto ShotCalibrationResult = CalibrateShot(InitialShotParams.FlickLocation, InitialShotParams.PowerFraction);
 	FlickParams.PowerFraction = ShotCalibrationResult.PowerFraction;
 	FlickParams.LocalZOffset = ShotCalibrationResult.LocalZOffset;
 
 	// calculate the pitch and yaw based on obstacles obstructing the shot
-	const auto& ShotCalculationResult = CalculateAvoidanceShotFactors(
-		InitialShotParams.FlickLocation, ShotCalibrationResult.Pitch, InitialShotParams.FlickMaxSpeed, FlickParams.PowerFraction);
+	const auto& ShotCalculationResult = ResolveAvoidanceShotFactors(Plan, Candidates);
 
 	const auto AngleDeviationPowerMultiplier = GetPowerMultiplierFromAngleDeviation(ShotCalculationResult.Yaw, ShotCalibrationResult.Pitch, ShotCalculationResult.Pitch);
 	// Decrease the power fraction based on avoidance results but make sure it doesn't go below the minimum power reduction factor
@@ -449,7 +1727,7 @@ TOptional<UGolfAIShotComponent::FShotSetupParams> UGolfAIShotComponent::Calculat
 		FlickParams.Accuracy = FlickError.Accuracy;
 	}
 
-	UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: CalculateShotParamsForCurrentFocusActor - ShotType=%s; InitialPower=%.2f; Power=%.2f; Accuracy=%.2f; ZOffset=%.1f; ShotPitch=%.1f; ShotYaw=%.1f"),
+	UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: CalculateShotParamsForPlan - ShotType=%s; InitialPower=%.2f; Power=%.2f; Accuracy=%.2f; ZOffset=%.1f; ShotPitch=%.1f; ShotYaw=%.1f"),
 		*LoggingUtils::GetName(GetOwner()), *GetName(), *LoggingUtils::GetName(FlickParams.ShotType),
 		InitialPowerFraction,
 		FlickParams.PowerFraction, FlickParams.Accuracy, FlickParams.LocalZOffset,
@@ -463,7 +1741,7 @@ TOptional<UGolfAIShotComponent::FShotSetupParams> UGolfAIShotComponent::Calculat
 		.ShotSetupResult = FAIShotSetupResult
 		{
 			.FlickParams = FlickParams,
-			.FocusActor = FocusActor,
+			.FocusActor = Plan.FocusActor,
 			.ShotPitch = ShotCalculationResult.Pitch,
 			.ShotYaw = ShotCalculationResult.Yaw
 		}
@@ -825,7 +2103,7 @@ bool UGolfAIShotComponent::ValidateAndLoadConfig()
 {
 	bool bValid = true;
 
-	if (!ValidateCurveTable(AIConfigCurveTable))
+	if (!CompileConfigCurves())
 	{
 		UE_VLOG_UELOG(GetOwner(), LogPGAI, Error, TEXT("%s-%s: ValidateConfig - FALSE - AIConfigCurveTable is invalid"), *LoggingUtils::GetName(GetOwner()), *GetName());
 		bValid = false;
@@ -870,18 +2148,45 @@ bool UGolfAIShotComponent::ValidateAndLoadAIPerformanceStrategy()
 	});
 }
 
-bool UGolfAIShotComponent::ValidateCurveTable(UCurveTable* CurveTable) const
+bool UGolfAIShotComponent::CompileConfigCurves()
 {
-	if (!ensure(CurveTable))
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("UGolfAIShotComponent::CompileConfigCurves");
+
+	if (!ensure(AIConfigCurveTable))
 	{
 		return false;
 	}
 
-	// Make sure can find the required curve tables
-	return FindCurveForKey(CurveTable, DeltaDistanceMetersVsPowerFraction)  &&
-		   FindCurveForKey(CurveTable, PowerFractionVsPitchAngle) &&
-		   FindCurveForKey(CurveTable, DeltaDistanceMetersVsZOffset) &&
-		   FindCurveForKey(CurveTable, AngleDeviationVsPowerMultiplier);
+	const auto Compile = [this](FPGCompiledCurve& CompiledCurve, const FName& Key)
+	{
+		const auto Curve = FindCurveForKey(AIConfigCurveTable, Key);
+		if (!Curve)
+		{
+			CompiledCurve.Reset();
+			return false;
+		}
+
+		if (CompiledCurve.Compile(*Curve, CompiledCurveTolerance))
+		{
+			UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: CompileConfigCurves - %s - NumSamples=%d; MaxError=%f"),
+				*LoggingUtils::GetName(GetOwner()), *GetName(), *Key.ToString(), CompiledCurve.GetNumSamples(), CompiledCurve.GetMaxError(*Curve));
+		}
+		else
+		{
+			UE_VLOG_UELOG(GetOwner(), LogPGAI, Warning, TEXT("%s-%s: CompileConfigCurves - %s could not be sampled within CompiledCurveTolerance=%f and will be evaluated directly"),
+				*LoggingUtils::GetName(GetOwner()), *GetName(), *Key.ToString(), CompiledCurveTolerance);
+		}
+
+		return true;
+	};
+
+	// Make sure can find the required curve tables. Compile all of them so that every missing curve is reported
+	bool bValid = Compile(PowerFractionCurve, DeltaDistanceMetersVsPowerFraction);
+	bValid &= Compile(PitchAngleCurve, PowerFractionVsPitchAngle);
+	bValid &= Compile(ZOffsetCurve, DeltaDistanceMetersVsZOffset);
+	bValid &= Compile(PowerMultiplierCurve, AngleDeviationVsPowerMultiplier);
+
+	return bValid;
 }
 
 float UGolfAIShotComponent::CalculateDefaultZOffset() const
@@ -896,92 +2201,110 @@ float UGolfAIShotComponent::CalculateDefaultZOffset() const
 		return MaxZOffset;
 	}
 }
-UGolfAIShotComponent::FShotCalculationResult UGolfAIShotComponent::CalculateAvoidanceShotFactors(const FVector& FlickLocation, float PreferredPitchAngle, float FlickMaxSpeed, float PowerFraction) const
+FVector UGolfAIShotComponent::GetPreferredYawDirection(const FVector& FlickLocation) const
 {
-	TRACE_CPUPROFILER_EVENT_SCOPE_STR("UGolfAIShotComponent::CalculateAvoidanceShotFactors");
-
-	const auto PlayerPawn = ShotContext.PlayerPawn;
-	check(PlayerPawn);
-
 	const auto GolfHole = ShotContext.GolfHole;
 	check(GolfHole);
 
-	const auto AdditionalRotationYaw = PG::MathUtils::ClampDeltaYaw(PlayerPawn->GetRotationYawToFocusActor(FocusActor) - InitialFocusYaw);
-	const auto& ActorUpVector = PlayerPawn->GetActorUpVector();
+	// Calculate the average direction to all the focus actors in front of us
+	FVector Direction{ EForceInit::ForceInitToZero };
+	const auto HoleDirection = (GolfHole->GetActorLocation() - FlickLocation).GetSafeNormal();
 
-	const FRotator AdditionalActorRotation = { 0, PG::MathUtils::ClampDeltaYaw(PlayerPawn->GetRotationYawToFocusActor(FocusActor) - InitialFocusYaw), 0 };
-	const auto& OriginalFlickDirection = PlayerPawn->GetFlickDirection();
-	const auto& DefaultFlickDirection = OriginalFlickDirection.RotateAngleAxis(AdditionalRotationYaw, ActorUpVector);
+#if ENABLE_VISUAL_LOG || !NO_LOGGING
+	TArray<AActor*, TInlineAllocator<8>> RelevantFocusActors;
+#endif
 
-	auto GetPreferredYawDirection = [&, PreferredDirectionOptional = TOptional<FVector>{}]() mutable
+	bool bAddedDirection{};
+	for (const auto& FocusActorScore : ShotContext.FocusActorScores)
 	{
-		if (PreferredDirectionOptional.IsSet())
+		const auto ScoreFocusActor = FocusActorScore.FocusActor;
+		if (!ScoreFocusActor || ScoreFocusActor == GolfHole)
 		{
-			return PreferredDirectionOptional.GetValue();
+			continue;
 		}
-		// Calculate the average direction to all the focus actors in front of us
-		FVector Direction{ EForceInit::ForceInitToZero };
-		const auto HoleDirection = (GolfHole->GetActorLocation() - FlickLocation).GetSafeNormal();
-
-#if ENABLE_VISUAL_LOG || !NO_LOGGING
-		TArray<AActor*, TInlineAllocator<8>> RelevantFocusActors;
-#endif
 
-		bool bAddedDirection{};
-		for (const auto& FocusActorScore : ShotContext.FocusActorScores)
+		auto ToFocusActor = ScoreFocusActor->GetActorLocation() - FlickLocation;
+		if ((ToFocusActor | HoleDirection) > 0)
 		{
-			const auto FocusActor = FocusActorScore.FocusActor;
-			if (!FocusActor || FocusActor == GolfHole)
-			{
-				continue;
-			}
-
-			auto ToFocusActor = FocusActor->GetActorLocation() - FlickLocation;
-			if ((ToFocusActor | HoleDirection) > 0)
-			{
 #if ENABLE_VISUAL_LOG || !NO_LOGGING
-				RelevantFocusActors.Add(FocusActor);
+			RelevantFocusActors.Add(ScoreFocusActor);
 #endif
-				Direction += ToFocusActor.GetSafeNormal();
-				bAddedDirection = true;
-			}
+			Direction += ToFocusActor.GetSafeNormal();
+			bAddedDirection = true;
 		}
+	}
 
-		// Add the hole direction if there are no other options
-		if (!bAddedDirection)
-		{
-			Direction += HoleDirection;
-		}
+	// Add the hole direction if there are no other options
+	if (!bAddedDirection)
+	{
+		Direction += HoleDirection;
+	}
 
-		PreferredDirectionOptional = Direction.GetSafeNormal();
+	const auto PreferredDirection = Direction.GetSafeNormal();
 
-		UE_VLOG_ARROW(GetOwner(), LogPGAI, Log, FlickLocation, FlickLocation + Direction * 100.0f, FColor::Emerald, TEXT("PreferredYawDirection"));
-		UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: CalculateShotFactors - PreferredYawDirection=%s; Relevant focus actors=[%s]"),
-			*LoggingUtils::GetName(GetOwner()), *GetName(), *PreferredDirectionOptional->ToCompactString(), *PG::ToStringObjectElements(RelevantFocusActors));
+	UE_VLOG_ARROW(GetOwner(), LogPGAI, Log, FlickLocation, FlickLocation + Direction * 100.0f, FColor::Emerald, TEXT("PreferredYawDirection"));
+	UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: GetPreferredYawDirection - PreferredYawDirection=%s; Relevant focus actors=[%s]"),
+		*LoggingUtils::GetName(GetOwner()), *GetName(), *PreferredDirection.ToCompactString(), *PG::ToStringObjectElements(RelevantFocusActors));
 
-		return *PreferredDirectionOptional;
-	};
+	return PreferredDirection;
+}
 
-	const auto& HoleDirection = (GolfHole->GetActorLocation() - FlickLocation).GetSafeNormal();
+void UGolfAIShotComponent::AddAvoidanceShotCandidates(FFocusShotPlan& Plan, TArray<FShotTraceCandidate>& Candidates) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("UGolfAIShotComponent::AddAvoidanceShotCandidates");
 
-	UE_VLOG_ARROW(GetOwner(), LogPGAI, Log, FlickLocation, FlickLocation + ActorUpVector * 100.0f, FColor::Blue, TEXT("Up"));
+	const auto PlayerPawn = ShotContext.PlayerPawn;
+	check(PlayerPawn);
+
+	const auto& FlickLocation = Plan.InitialShotParams.FlickLocation;
+
+	const auto AdditionalRotationYaw = PG::MathUtils::ClampDeltaYaw(PlayerPawn->GetRotationYawToFocusActor(Plan.FocusActor) - InitialFocusYaw);
+	const auto& ActorUpVector = PlayerPawn->GetActorUpVector();
+
+	Plan.DefaultFlickDirection = PlayerPawn->GetFlickDirection().RotateAngleAxis(AdditionalRotationYaw, ActorUpVector);
 
 	// Via the work energy principle, reducing the power by N will reduce the speed by factor of sqrt(N)
-	const auto FlickSpeed = FlickMaxSpeed * FMath::Sqrt(PowerFraction);
+	Plan.FlickSpeed = Plan.InitialShotParams.FlickMaxSpeed * FMath::Sqrt(Plan.ShotCalibrationResult.PowerFraction);
 
-	if (UPaperGolfPawnUtilities::TraceShotAngle(this, PlayerPawn, FlickLocation, DefaultFlickDirection, FlickSpeed, PreferredPitchAngle, MinTraceDistance))
+	const auto AddCandidate = [&](const FVector& FlickDirection, float Yaw, float PitchAngle)
 	{
-		UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: CalculateShotFactors - Solution Found with preferred pitch - PreferredPitch=%.1f; AdditionalRotationYaw=%f"),
-			*LoggingUtils::GetName(GetOwner()), *GetName(), PreferredPitchAngle, AdditionalRotationYaw);
-		return { PreferredPitchAngle, 0.0f, 1.0f };
-	}
+		Candidates.Add(FShotTraceCandidate
+		{
+			.TraceStart = FlickLocation,
+			.TraceEnd = UPaperGolfPawnUtilities::GetShotAngleTraceEnd(this, *PlayerPawn, FlickLocation, FlickDirection, Plan.FlickSpeed, PitchAngle, MinTraceDistance),
+			.Yaw = Yaw,
+			.Pitch = PitchAngle
+		});
+	};
 
-	FShotCalculationResult LastResult{};
+	// Preferred pitch directly at the focus actor is always tried first
+	AddCandidate(Plan.DefaultFlickDirection, 0.0f, Plan.ShotCalibrationResult.Pitch);
 
 	// If last shot ended in hazard, adjust yaw to try and get around it
-	const int32 DesiredSkips = bCurrentFocusActorLandedInHazard ? CurrentFocusActorFailures : 0;
+	const int32 DesiredSkips = Plan.bLandedInHazard ? Plan.NumFailures : 0;
+
+	Plan.NumYawIncrements = 2 * FMath::FloorToInt32(180.0f / YawRetryDelta);
+	Plan.FirstYawIncrement = FMath::Max(0, FMath::Min(DesiredSkips, Plan.NumYawIncrements - 1));
+
+	// The preferred direction is decided when the first non-zero yaw is reached so if that increment is skipped we keep the default
+	if (Plan.FirstYawIncrement <= 2 && Plan.NumYawIncrements > 2)
+	{
+		// Pick direction that most aligns with hole
+		const auto PositiveRotation = Plan.DefaultFlickDirection.RotateAngleAxis(YawRetryDelta, ActorUpVector);
+		const auto NegativeRotation = Plan.DefaultFlickDirection.RotateAngleAxis(-YawRetryDelta, ActorUpVector);
+
+		const auto& PreferredYawDirection = GetPreferredYawDirection(FlickLocation);
+		const auto PositiveDot = PositiveRotation | PreferredYawDirection;
+		const auto NegativeDot = NegativeRotation | PreferredYawDirection;
+
+		Plan.PreferredYawDirection = PositiveDot >= NegativeDot ? 1 : -1;
+
+		UE_VLOG_UELOG(GetOwner(), LogPGAI, Verbose, TEXT("%s-%s: AddAvoidanceShotCandidates - FocusActor=%s; PreferredDirection=%d; PositiveDot=%.2f; NegativeDot=%.2f; PositionRotation=%s; NegativeRotation=%s"),
+			*LoggingUtils::GetName(GetOwner()), *GetName(), *LoggingUtils::GetName(Plan.FocusActor),
+			Plan.PreferredYawDirection, PositiveDot, NegativeDot, *PositiveRotation.ToCompactString(), *NegativeRotation.ToCompactString());
+	}
 
-	for (int32 PreferredDirection = 1, Increments = 2 * FMath::FloorToInt32(180.0f / YawRetryDelta), i = FMath::Max(0, FMath::Min(DesiredSkips, Increments - 1)); i < Increments; ++i)
+	for (int32 i = Plan.FirstYawIncrement; i < Plan.NumYawIncrements; ++i)
 	{
 		if (i == 1)
 		{
@@ -989,54 +2312,79 @@ UGolfAIShotComponent::FShotCalculationResult UGolfAIShotComponent::CalculateAvoi
 			continue;
 		}
 
-		// calculate preferred direction for the first time
-		TArray<FVector, TInlineAllocator<2>> CalculatedDirections;
-		if (i == 2)
+		const auto Yaw = GetRetryYaw(Plan, i);
+		const auto FlickDirectionRotated = Plan.DefaultFlickDirection.RotateAngleAxis(Yaw, ActorUpVector);
+
+		for (int32 PitchIndex = 0; PitchIndex < NumPitchTraceAngles; ++PitchIndex)
 		{
-			// Pick direction that most aligns with hole
-			const auto PositiveRotation = DefaultFlickDirection.RotateAngleAxis(YawRetryDelta, ActorUpVector);
-			CalculatedDirections.Add(PositiveRotation);
+			AddCandidate(FlickDirectionRotated, Yaw, ShotPitchAngles[PitchIndex]);
+		}
+	}
+}
+
+UGolfAIShotComponent::FShotCalculationResult UGolfAIShotComponent::ResolveAvoidanceShotFactors(const FFocusShotPlan& Plan, TConstArrayView<FShotTraceCandidate> Candidates) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("UGolfAIShotComponent::ResolveAvoidanceShotFactors");
+
+	const auto PlayerPawn = ShotContext.PlayerPawn;
+	check(PlayerPawn);
+
+	const auto PlanCandidates = Candidates.Slice(Plan.FirstCandidateIndex, Plan.NumCandidates);
+	check(!PlanCandidates.IsEmpty());
+
+	const auto& FlickLocation = Plan.InitialShotParams.FlickLocation;
+	const auto& ActorUpVector = PlayerPawn->GetActorUpVector();
+	const auto PreferredPitchAngle = Plan.ShotCalibrationResult.Pitch;
+
+	UE_VLOG_ARROW(GetOwner(), LogPGAI, Log, FlickLocation, FlickLocation + ActorUpVector * 100.0f, FColor::Blue, TEXT("Up"));
 
-			const auto NegativeRotation = DefaultFlickDirection.RotateAngleAxis(-YawRetryDelta, ActorUpVector);
-			CalculatedDirections.Add(NegativeRotation);
+	const auto& PreferredCandidate = PlanCandidates[0];
+	UE_VLOG_ARROW(GetOwner(), LogPGAI, Log, PreferredCandidate.TraceStart, PreferredCandidate.TraceEnd, PreferredCandidate.bPass ? FColor::Green : FColor::Red,
+		TEXT("Trace %.1f"), PreferredCandidate.Pitch);
 
-			const auto& PreferredYawDirection = GetPreferredYawDirection();
-			const auto PositiveDot = PositiveRotation | PreferredYawDirection;
-			const auto NegativeDot = NegativeRotation | PreferredYawDirection;
+	if (PreferredCandidate.bPass)
+	{
+		UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: ResolveAvoidanceShotFactors - Solution Found with preferred pitch - FocusActor=%s; PreferredPitch=%.1f"),
+			*LoggingUtils::GetName(GetOwner()), *GetName(), *LoggingUtils::GetName(Plan.FocusActor), PreferredPitchAngle);
+		return { PreferredPitchAngle, 0.0f, 1.0f };
+	}
 
-			PreferredDirection = PositiveDot >= NegativeDot ? 1 : -1;
+	FShotCalculationResult LastResult{};
 
-			UE_VLOG_UELOG(GetOwner(), LogPGAI, Verbose, TEXT("%s-%s: CalculateShotFactors - PreferredDirection=%d; PositiveDot=%.2f; NegativeDot=%.2f; PositionRotation=%s; NegativeRotation=%s"),
-				*LoggingUtils::GetName(GetOwner()), *GetName(), PreferredDirection, PositiveDot, NegativeDot, *PositiveRotation.ToCompactString(), *NegativeRotation.ToCompactString());
+	for (int32 i = Plan.FirstYawIncrement, CandidateIndex = 1; i < Plan.NumYawIncrements; ++i)
+	{
+		if (i == 1)
+		{
+			continue;
 		}
 
-		// Try positive and then negative version of angle
-		const auto Yaw = YawRetryDelta * (i / 2) * (i % 2 == 0 ? PreferredDirection : -PreferredDirection);
-		const FVector FlickDirectionRotated = CalculatedDirections.IsEmpty() ? DefaultFlickDirection.RotateAngleAxis(Yaw, ActorUpVector) : CalculatedDirections[PreferredDirection > 0 ? 0 : 1];
+		const auto Yaw = GetRetryYaw(Plan, i);
+		const FVector FlickDirectionRotated = Plan.DefaultFlickDirection.RotateAngleAxis(Yaw, ActorUpVector);
+
+		UE_VLOG_UELOG(GetOwner(), LogPGAI, Verbose, TEXT("%s-%s: ResolveAvoidanceShotFactors - i=%d/%d; Yaw=%.1f; FlickDirectionRotated=%s"),
+			*LoggingUtils::GetName(GetOwner()), *GetName(), i, Plan.NumYawIncrements - 1, Yaw, *FlickDirectionRotated.ToCompactString());
 
-		UE_VLOG_UELOG(GetOwner(), LogPGAI, Verbose, TEXT("%s-%s: CalculateShotFactors - i=%d/%d; Yaw=%.1f; FlickDirectionRotated=%s"),
-			*LoggingUtils::GetName(GetOwner()), *GetName(), i, Increments - 1, Yaw, *FlickDirectionRotated.ToCompactString());
-		const auto [bPass, Pitch ] = CalculateShotPitch(FlickLocation, FlickDirectionRotated, FlickSpeed);
-		LastResult = { Pitch, Yaw, static_cast<float>(DefaultFlickDirection | FlickDirectionRotated)};
+		const auto [bPass, Pitch] = ResolveShotPitch(Plan, PlanCandidates.Slice(CandidateIndex, NumPitchTraceAngles));
+		CandidateIndex += NumPitchTraceAngles;
+
+		LastResult = { Pitch, Yaw, static_cast<float>(Plan.DefaultFlickDirection | FlickDirectionRotated) };
 
 		if (bPass)
 		{
-			UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: CalculateShotFactors - Solution Found - Yaw=%.1f; Pitch=%.1f; PowerReduction=%1.f"),
-				*LoggingUtils::GetName(GetOwner()), *GetName(), Yaw, Pitch, LastResult.PowerMultiplier);
+			UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: ResolveAvoidanceShotFactors - Solution Found - FocusActor=%s; Yaw=%.1f; Pitch=%.1f; PowerReduction=%1.f"),
+				*LoggingUtils::GetName(GetOwner()), *GetName(), *LoggingUtils::GetName(Plan.FocusActor), Yaw, Pitch, LastResult.PowerMultiplier);
 			return LastResult;
 		}
 	}
 
-	UE_VLOG_UELOG(GetOwner(), LogPGAI, Display, TEXT("%s-%s: CalculateShotFactors - NO SOLUTION - Default to Yaw=%.1f; Pitch=%.1f; PowerReduction=%.1f"),
-		*LoggingUtils::GetName(GetOwner()), *GetName(), LastResult.Yaw, LastResult.Pitch, LastResult.PowerMultiplier);
+	UE_VLOG_UELOG(GetOwner(), LogPGAI, Display, TEXT("%s-%s: ResolveAvoidanceShotFactors - NO SOLUTION - FocusActor=%s; Default to Yaw=%.1f; Pitch=%.1f; PowerReduction=%.1f"),
+		*LoggingUtils::GetName(GetOwner()), *GetName(), *LoggingUtils::GetName(Plan.FocusActor), LastResult.Yaw, LastResult.Pitch, LastResult.PowerMultiplier);
 
 	return LastResult;
 }
 
-TTuple<bool, float> UGolfAIShotComponent::CalculateShotPitch(const FVector& FlickLocation, const FVector& FlickDirection, float FlickSpeed) const
+TTuple<bool, float> UGolfAIShotComponent::ResolveShotPitch(const FFocusShotPlan& Plan, TConstArrayView<FShotTraceCandidate> PitchCandidates) const
 {
-	TRACE_CPUPROFILER_EVENT_SCOPE_STR("UGolfAIShotComponent::CalculateShotPitch");
-
 	static_assert(ShotPitchAngles.size() > 0, "ShotPitchAngles must have at least one element");
 
 	if constexpr(ShotPitchAngles.size() == 1)
@@ -1045,28 +2393,23 @@ TTuple<bool, float> UGolfAIShotComponent::CalculateShotPitch(const FVector& Flic
 	}
 	else
 	{
-		const auto PlayerPawn = ShotContext.PlayerPawn;
-		check(PlayerPawn);
-
-		auto World = GetWorld();
-		check(World);
+		check(PitchCandidates.Num() == NumPitchTraceAngles);
 
 		int32 NumSkips{};
 		// Don't adjust pitch if last shot landed in hazard as we want to maximize displacement to get over it and instead adjust yaw
-		const int32 DesiredSkips = bCurrentFocusActorLandedInHazard ? 0 : CurrentFocusActorFailures;
+		const int32 DesiredSkips = Plan.bLandedInHazard ? 0 : Plan.NumFailures;
 
-		for (auto It = ShotPitchAngles.begin(), End = std::next(ShotPitchAngles.begin(), ShotPitchAngles.size() - 1); It != End; ++It)
+		for (const auto& Candidate : PitchCandidates)
 		{
-			const auto PitchAngle = *It;
+			UE_VLOG_ARROW(GetOwner(), LogPGAI, Log, Candidate.TraceStart, Candidate.TraceEnd, Candidate.bPass ? FColor::Green : FColor::Red, TEXT("Trace %.1f"), Candidate.Pitch);
 
-			bool bPass = UPaperGolfPawnUtilities::TraceShotAngle(this, PlayerPawn, FlickLocation, FlickDirection, FlickSpeed, PitchAngle, MinTraceDistance);
 			// If the test suggests it will pass but it failed due to this being a retry then skip to next
 			// Ideally this would also change the yaw to avoid the obstacle but the trace test should catch a majority of the issues
-			if (bPass && NumSkips >= DesiredSkips)
+			if (Candidate.bPass && NumSkips >= DesiredSkips)
 			{
-				return { true, PitchAngle };
+				return { true, Candidate.Pitch };
 			}
-			else if(bPass)
+			else if (Candidate.bPass)
 			{
 				++NumSkips;
 			}
@@ -1123,8 +2466,6 @@ UGolfAIShotComponent::FShotCalibrationResult UGolfAIShotComponent::CalibrateShot
 
 	float PitchAngle = DefaultPitchAngle;
 
-	auto Curve = FindCurveForKey(AIConfigCurveTable, DeltaDistanceMetersVsPowerFraction);
-
 	auto DistanceToHoleCalculator = [this, &FlickLocation, Distance = -1.0f]() mutable
 	{
 		// memoize result
@@ -1138,10 +2479,10 @@ UGolfAIShotComponent::FShotCalibrationResult UGolfAIShotComponent::CalibrateShot
 		return Distance;
 	};
 
-	if (Curve)
+	if (PowerFractionCurve.IsValid())
 	{
 		const auto DistanceToHoleMeters = DistanceToHoleCalculator();
-		const auto PowerReductionFactor = Curve->Eval(DistanceToHoleMeters);
+		const auto PowerReductionFactor = PowerFractionCurve.Eval(DistanceToHoleMeters);
 
 		const auto NewPowerFractionCalc = [&]()
 		{
@@ -1155,34 +2496,283 @@ UGolfAIShotComponent::FShotCalibrationResult UGolfAIShotComponent::CalibrateShot
 		PowerFraction = NewPowerFractionCalc();
 	}
 
-	Curve = FindCurveForKey(AIConfigCurveTable, PowerFractionVsPitchAngle);
-	if (Curve)
+	if (PitchAngleCurve.IsValid())
 	{
-		PitchAngle = Curve->Eval(PowerFraction);
+		PitchAngle = PitchAngleCurve.Eval(PowerFraction);
 
 		UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: CalibrateShot - PowerFraction=%.2f -> PitchAngle=%.2f"),
 			*LoggingUtils::GetName(GetOwner()), *GetName(), PowerFraction, PitchAngle);
 	}
 
-	Curve = FindCurveForKey(AIConfigCurveTable, DeltaDistanceMetersVsZOffset);
-
 	float LocalZOffset;
-	if (Curve)
+	if (ZOffsetCurve.IsValid())
 	{
 		const auto DistanceToHoleMeters = DistanceToHoleCalculator();
-		LocalZOffset = Curve->Eval(DistanceToHoleMeters);
+		LocalZOffset = ZOffsetCurve.Eval(DistanceToHoleMeters);
 	}
 	else
 	{
 		LocalZOffset = CalculateDefaultZOffset();
 	}
 
-	return FShotCalibrationResult
+	FShotCalibrationResult Calibration
 	{
 		.PowerFraction = PowerFraction,
 		.Pitch = PitchAngle,
 		.LocalZOffset = LocalZOffset
 	};
+
+	if (bRefineCalibratedPitch)
+	{
+		RefineCalibratedPitch(FlickLocation, Calibration);
+	}
+
+	return Calibration;
+}
+
+bool UGolfAIShotComponent::RefineCalibratedPitch(const FVector& FlickLocation, FShotCalibrationResult& Calibration) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_PGAIRefineCalibratedPitch);
+
+	const auto PlayerPawn = ShotContext.PlayerPawn;
+	auto World = GetWorld();
+
+	if (!PlayerPawn || !World)
+	{
+		return false;
+	}
+
+	const auto TargetLocation = GetFocusActorLocation(FlickLocation);
+	const auto FlickDirection = (TargetLocation - FlickLocation).GetSafeNormal2D();
+
+	if (FlickDirection.IsZero())
+	{
+		return false;
+	}
+
+	const FFlickParams CalibratedFlickParams
+	{
+		.ShotType = ShotContext.ShotType,
+		.LocalZOffset = Calibration.LocalZOffset,
+		.PowerFraction = Calibration.PowerFraction
+	};
+
+	// Gravity and damping do not depend on the aim or the power so only need the trajectory params once
+	const auto TrajectoryParams = PlayerPawn->GetFlickTrajectoryParams(CalibratedFlickParams, {});
+
+	const auto LaunchSpeed = TrajectoryParams.LaunchVelocity.Size();
+	const auto StartLocation = PlayerPawn->GetFlickLocation(Calibration.LocalZOffset) + FlickDirection * TrajectoryParams.CollisionRadius;
+	const auto FlickYaw = FlickDirection.Rotation().Yaw;
+	const auto Gravity = FMath::Abs(TrajectoryParams.GravityZ);
+
+	if (LaunchSpeed <= 0 || Gravity <= 0)
+	{
+		return false;
+	}
+
+	FPaperGolfTrajectoryBatchParams BatchParams
+	{
+		.IgnoreActor = PlayerPawn,
+		.GravityZ = TrajectoryParams.GravityZ,
+		.LinearDamping = TrajectoryParams.LinearDamping,
+		.CollisionRadius = TrajectoryParams.CollisionRadius,
+		.MaxSimTime = TrajectoryParams.MaxSimTime,
+		.SimFrequency = TrajectoryParams.SimFrequency,
+		.LandingZ = static_cast<float>(TargetLocation.Z),
+		.TraceChannel = PG::CollisionChannel::FlickTraceType,
+		.bTraceWithCollision = false
+	};
+
+	// The curve table pitch and power define the carry of the shot so find where it comes down ignoring obstacles. This does no scene queries
+	const FPaperGolfTrajectoryLane ReferenceLane
+	{
+		.StartLocation = StartLocation,
+		.LaunchVelocity = FRotator{ Calibration.Pitch, FlickYaw, 0.0f }.Vector() * LaunchSpeed
+	};
+
+	FPaperGolfTrajectoryLaneResult ReferenceResult;
+	FPaperGolfTrajectoryBatchSolver::Solve(*World, BatchParams, MakeArrayView(&ReferenceLane, 1), MakeArrayView(&ReferenceResult, 1));
+	++NumShotSetupTrajectoryPredictions;
+
+	if (!ReferenceResult.bLanded)
+	{
+		UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: RefineCalibratedPitch - CurvePitch=%.1f never comes down to the target height; keeping it"),
+			*LoggingUtils::GetName(GetOwner()), *GetName(), Calibration.Pitch);
+		return false;
+	}
+
+	const auto Carry = (ReferenceResult.Location - StartLocation).Size2D();
+	const auto Rise = ReferenceResult.Location.Z - StartLocation.Z;
+	const auto MaxLandingError = FMath::Max(Carry * RefinedPitchMaxCarryErrorFraction, TrajectoryParams.CollisionRadius);
+
+	const auto ReferenceVacuumSpeedSquared = GetDragFreeLaunchSpeedSquared(Gravity, Carry, Rise, Calibration.Pitch);
+	if (ReferenceVacuumSpeedSquared <= 0)
+	{
+		return false;
+	}
+
+	struct FPitchCandidate
+	{
+		float Pitch{};
+		float PowerFraction{};
+	};
+
+	const auto NumCandidates = FMath::Clamp(MaxCalibrationPitchCandidates, 1, static_cast<int32>(CalibrationPitchOffsets.size()));
+
+	TArray<FPitchCandidate, TInlineAllocator<CalibrationPitchOffsets.size()>> Candidates;
+	TArray<FPaperGolfTrajectoryLane, TInlineAllocator<CalibrationPitchOffsets.size()>> Lanes;
+
+	const auto CorridorStart = StartLocation - FlickDirection * TrajectoryParams.CollisionRadius;
+	auto CorridorTop = FMath::Max(StartLocation.Z, ReferenceResult.Location.Z);
+	double MaxFlightTime{};
+
+	for (int32 i = 0; i < NumCandidates; ++i)
+	{
+		const auto Pitch = FMath::Clamp(Calibration.Pitch + CalibrationPitchOffsets[i], 0.0f, MaxCalibrationPitch);
+		if (Candidates.ContainsByPredicate([Pitch](const auto& Candidate) { return FMath::IsNearlyEqual(Candidate.Pitch, Pitch); }))
+		{
+			continue;
+		}
+
+		const auto VacuumSpeedSquared = GetDragFreeLaunchSpeedSquared(Gravity, Carry, Rise, Pitch);
+		if (VacuumSpeedSquared <= 0)
+		{
+			continue;
+		}
+
+		// Scale the calibrated speed by the ratio of the drag free speeds so the curve table correction carries over to the new pitch
+		const auto DesiredSpeed = LaunchSpeed * FMath::Sqrt(VacuumSpeedSquared / ReferenceVacuumSpeedSquared);
+		const auto PowerFraction = GetPowerFractionForLaunchSpeed(CalibratedFlickParams, DesiredSpeed);
+
+		auto FlickParams = CalibratedFlickParams;
+		FlickParams.PowerFraction = PowerFraction;
+		const auto Speed = PlayerPawn->GetFlickTrajectoryParams(FlickParams, {}).LaunchVelocity.Size();
+		const auto LaunchVelocity = FRotator{ Pitch, FlickYaw, 0.0f }.Vector() * Speed;
+
+		CorridorTop = FMath::Max(CorridorTop, StartLocation.Z + FMath::Square(FMath::Max(0.0, LaunchVelocity.Z)) / (2 * Gravity));
+		if (const auto HorizontalSpeed = LaunchVelocity.Size2D(); HorizontalSpeed > 0)
+		{
+			MaxFlightTime = FMath::Max(MaxFlightTime, (Carry + MaxLandingError) / HorizontalSpeed);
+		}
+
+		Candidates.Add({ .Pitch = Pitch, .PowerFraction = PowerFraction });
+		Lanes.Add({ .StartLocation = StartLocation, .LaunchVelocity = LaunchVelocity });
+	}
+
+	if (Lanes.IsEmpty())
+	{
+		return false;
+	}
+
+	// Arcs stay in the vertical plane of the flick so only geometry between the flick and the landing can block a candidate that reaches the target.
+	// Anything past the landing tolerance is rejected anyway
+	const auto CorridorEnd = ReferenceResult.Location + FlickDirection * MaxLandingError;
+	const auto CorridorExtent = MaxLandingError + TrajectoryParams.CollisionRadius;
+
+	FBox Corridor(ForceInit);
+	Corridor += CorridorStart;
+	Corridor += CorridorEnd;
+	Corridor.Max.Z = CorridorTop;
+	Corridor = Corridor.ExpandBy(FVector{ CorridorExtent, CorridorExtent, TrajectoryParams.CollisionRadius });
+
+	const auto& StaticBounds = GetStaticCollisionBounds();
+	if (StaticBounds.IsValid)
+	{
+		BatchParams.BroadPhaseBounds = StaticBounds.Overlap(Corridor);
+		// Nothing static between the flick and the landing so the candidates only need to fly
+		BatchParams.bTraceWithCollision = BatchParams.BroadPhaseBounds.IsValid;
+	}
+	else
+	{
+		BatchParams.BroadPhaseBounds = Corridor;
+		BatchParams.bTraceWithCollision = true;
+	}
+
+	// Candidates that have not reached the landing by then are too slow to be accepted
+	if (MaxFlightTime > 0)
+	{
+		BatchParams.MaxSimTime = FMath::Min(BatchParams.MaxSimTime, static_cast<float>(MaxFlightTime * CalibrationFlightTimeMargin));
+	}
+
+	TArray<FPaperGolfTrajectoryLaneResult, TInlineAllocator<CalibrationPitchOffsets.size()>> LaneResults;
+	LaneResults.SetNum(Lanes.Num());
+
+	FPaperGolfTrajectoryBatchSolver::Solve(*World, BatchParams, Lanes, LaneResults);
+	NumShotSetupTrajectoryPredictions += Lanes.Num();
+
+	// Offsets are in order of preference so take the first clear arc that comes down where the calibrated shot would
+	for (int32 i = 0; i < LaneResults.Num(); ++i)
+	{
+		const auto& LaneResult = LaneResults[i];
+		if (!LaneResult.bLanded && !(LaneResult.bHit && PG::Trajectory::IsLandingHit(LaneResult.Velocity, LaneResult.ImpactNormal)))
+		{
+			continue;
+		}
+
+		const auto LandingError = (LaneResult.Location - ReferenceResult.Location).Size2D();
+		if (LandingError > MaxLandingError)
+		{
+			UE_VLOG_UELOG(GetOwner(), LogPGAI, Verbose, TEXT("%s-%s: RefineCalibratedPitch - Rejecting PitchAngle=%.1f; PowerFraction=%.2f - LandingError=%.1fcm > %.1fcm"),
+				*LoggingUtils::GetName(GetOwner()), *GetName(), Candidates[i].Pitch, Candidates[i].PowerFraction, LandingError, MaxLandingError);
+			continue;
+		}
+
+		UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: RefineCalibratedPitch - CurvePitch=%.1f; PowerFraction=%.2f -> PitchAngle=%.1f; PowerFraction=%.2f; Landing=%s; LandingError=%.1fcm; bHit=%s"),
+			*LoggingUtils::GetName(GetOwner()), *GetName(), Calibration.Pitch, Calibration.PowerFraction, Candidates[i].Pitch, Candidates[i].PowerFraction,
+			*LaneResult.Location.ToCompactString(), LandingError, LoggingUtils::GetBoolString(LaneResult.bHit));
+
+		Calibration.Pitch = Candidates[i].Pitch;
+		Calibration.PowerFraction = Candidates[i].PowerFraction;
+
+		return true;
+	}
+
+	UE_VLOG_UELOG(GetOwner(), LogPGAI, Log, TEXT("%s-%s: RefineCalibratedPitch - No clear arc reaches the target from %d pitch candidate%s; keeping CurvePitch=%.1f"),
+		*LoggingUtils::GetName(GetOwner()), *GetName(), Lanes.Num(), LoggingUtils::Pluralize(Lanes.Num()), Calibration.Pitch);
+
+	return false;
+}
+
+float UGolfAIShotComponent::GetPowerFractionForLaunchSpeed(const FFlickParams& FlickParams, double DesiredSpeed) const
+{
+	const auto PlayerPawn = ShotContext.PlayerPawn;
+	check(PlayerPawn);
+
+	const auto GetLaunchSpeed = [&](float PowerFraction)
+	{
+		auto Params = FlickParams;
+		Params.PowerFraction = PowerFraction;
+
+		return PlayerPawn->GetFlickTrajectoryParams(Params, {}).LaunchVelocity.Size();
+	};
+
+	const auto InitialSpeed = GetLaunchSpeed(FlickParams.PowerFraction);
+	if (InitialSpeed <= 0)
+	{
+		return FlickParams.PowerFraction;
+	}
+
+	// Flick impulse is linear in the power fraction but the drag multiplier is not so correct the linear estimate once against the pawn
+	auto PowerFraction = FMath::Clamp(FlickParams.PowerFraction * static_cast<float>(DesiredSpeed / InitialSpeed), MinShotPower, 1.0f);
+
+	if (const auto EstimatedSpeed = GetLaunchSpeed(PowerFraction); EstimatedSpeed > 0)
+	{
+		PowerFraction = FMath::Clamp(PowerFraction * static_cast<float>(DesiredSpeed / EstimatedSpeed), MinShotPower, 1.0f);
+	}
+
+	return PowerFraction;
+}
+
+const FBox& UGolfAIShotComponent::GetStaticCollisionBounds() const
+{
+	// Computed lazily since streaming levels may not be loaded yet when the hole starts
+	if (!StaticCollisionBounds)
+	{
+		auto World = GetWorld();
+		StaticCollisionBounds = World ? PG::CollisionUtils::GetStaticCollisionBounds(*World, PG::CollisionChannel::FlickTraceType) : FBox{ EForceInit::ForceInit };
+	}
+
+	return *StaticCollisionBounds;
 }
 
 FString FAIShotContext::ToString() const
@@ -1205,34 +2795,39 @@ namespace
 #endif
 	}
 
-	FVector GetVelocityAtHitPoint(const FPredictProjectilePathResult& PathResult)
+	double GetDragFreeLaunchSpeedSquared(double Gravity, double Carry, double Rise, float PitchDegrees)
 	{
-		const auto& HitLocation = PathResult.HitResult.ImpactPoint;
+		// See https://en.wikipedia.org/wiki/Projectile_motion
+		double SinPitch, CosPitch;
+		FMath::SinCos(&SinPitch, &CosPitch, FMath::DegreesToRadians(static_cast<double>(PitchDegrees)));
 
-		FVector Velocity{ EForceInit::ForceInitToZero };
-		double MinDist{ std::numeric_limits<double>::max() };
+		const auto Denominator = 2 * CosPitch * (Carry * SinPitch - Rise * CosPitch);
+		return Denominator > UE_KINDA_SMALL_NUMBER ? Gravity * Carry * Carry / Denominator : -1.0;
+	}
 
-		const auto& PathData = PathResult.PathData;
+	TOptional<float> FindClearMovingObstacleWait(const UMovingObstacleSubsystem& MovingObstacleSubsystem, TConstArrayView<FPredictProjectilePathPointData> Path,
+		float Radius, float MaxWaitTime, float WaitStep, TOptional<FMovingObstacleSweepHit>& OutImmediateHit)
+	{
+		const auto ObstacleTime = MovingObstacleSubsystem.GetObstacleTime();
+		const auto NumWaitSteps = FMath::FloorToInt32(MaxWaitTime / FMath::Max(WaitStep, 0.05f));
 
-		for (int i = PathData.Num() - 1; i >= 0; --i)
+		for (int32 i = 0; i <= NumWaitSteps; ++i)
 		{
-			const auto& Point = PathData[i];
+			const auto WaitTime = i * WaitStep;
 
-			const auto Dist = FVector::DistSquared(HitLocation, Point.Location);
-			if (Dist < MinDist)
+			auto Hit = MovingObstacleSubsystem.SweepPath(Path, ObstacleTime + WaitTime, Radius);
+			if (!Hit)
 			{
-				MinDist = Dist;
-				Velocity = Point.Velocity;
-
-				// Close enough - break at this point
-				if (Dist <= DistSqHitThreshold)
-				{
-					break;
-				}
+				return WaitTime;
+			}
+
+			if (i == 0)
+			{
+				OutImmediateHit = MoveTemp(Hit);
 			}
 		}
 
-		return Velocity;
+		return {};
 	}
 }
 
@@ -8,14 +8,25 @@
 #include "PGAITypes.h"
 
 #include "Subsystems/GolfEvents.h"
+#include "Library/PaperGolfSurfaceMaterialCache.h"
+#include "Library/PaperGolfTrajectorySolver.h"
+#include "Utils/PGCompiledCurve.h"
+
+#include "Planning/GolfAIRoutePlanner.h"
+
+#include "WorldCollision.h"
 
 #include "GolfAIShotComponent.generated.h"
 
 class APaperGolfPawn;
 class UCurveTable;
 class UAIPerformanceStrategy;
-class IPenaltyHazard;
-struct FPredictProjectilePathResult;
+class UGolfAIShotAtlas;
+class UGolfControllerCommonComponent;
+class UMovingObstacleSubsystem;
+struct FHazardQueryResult;
+
+DECLARE_DELEGATE_OneParam(FOnAIShotSetupComplete, const FAIShotSetupResult& /* ShotSetupResult */);
 
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class UGolfAIShotComponent : public UActorComponent
@@ -32,6 +43,22 @@ public:
 	*/
 	FAIShotSetupResult SetupShot(FAIShotContext&& ShotContext);
 
+	/**
+	* Asynchronous version of SetupShot. The obstacle traces are submitted as async traces and the shot is resolved over subsequent frames.
+	* When the route needs re-planning its legs are first evaluated in MaxShotPlanningFrameTimeMs slices.
+	* If TimeBudgetSeconds of world time elapses before planning completes then OnComplete is invoked with the best shot found so far.
+	*/
+	bool SetupShotAsync(FAIShotContext&& ShotContext, float TimeBudgetSeconds, FOnAIShotSetupComplete&& OnComplete);
+
+	void CancelShotSetup();
+
+	bool IsShotSetupInProgress() const;
+
+	/**
+	* Runs the live shot solver for the context without any shot history or shot error applied. Used to bake the UGolfAIShotAtlas offline.
+	*/
+	TOptional<FAIShotSetupResult> SolveShotForAtlas(FAIShotContext&& ShotContext);
+
 	void StartHole();
 
 	void Reset();
@@ -39,6 +66,12 @@ public:
 	void OnHazard(EHazardType HazardType);
 	void OnShotFinished(const APaperGolfPawn& Pawn);
 
+	/*
+	* Seconds to hold the flick so that it passes the moving obstacles on its path, assuming the pawn is already aimed.
+	* Zero if the path is clear now or no wait up to MaxMovingObstacleWaitTime clears it.
+	*/
+	float CalculateMovingObstacleWaitTime(const APaperGolfPawn& Pawn, const FFlickParams& FlickParams) const;
+
 protected:
 	virtual void BeginPlay() override;
 
@@ -88,8 +121,146 @@ private:
 		float GetShotDistanceSquared() const;
 	};
 
+	/*
+	* A single obstacle avoidance trace for a candidate (focus actor, yaw, pitch) combination.
+	* Only bPass is written when the candidates are evaluated so the batch can be traced in parallel.
+	*/
+	struct FShotTraceCandidate
+	{
+		FVector TraceStart{};
+		FVector TraceEnd{};
+		float Yaw{};
+		float Pitch{};
+		bool bPass{};
+	};
+
+	/*
+	* Per focus actor inputs needed to generate and later resolve its shot trace candidates.
+	* Candidates are laid out as the preferred pitch trace followed by each yaw retry increment in the order they are tried with
+	* one trace per pitch angle.
+	*/
+	struct FFocusShotPlan
+	{
+		AActor* FocusActor{};
+		FShotPowerCalculationResult InitialShotParams{};
+		FShotCalibrationResult ShotCalibrationResult{};
+		FVector DefaultFlickDirection{};
+		float FlickSpeed{};
+		int32 NumFailures{};
+		bool bLandedInHazard{};
+		int32 PreferredYawDirection{ 1 };
+		int32 FirstYawIncrement{};
+		int32 NumYawIncrements{};
+		int32 FirstCandidateIndex{};
+		int32 NumCandidates{};
+	};
+
+	using FFocusShotPlanArray = TArray<FFocusShotPlan, TInlineAllocator<8>>;
+
+	/*
+	* Shot planning progress so that the focus actor plans can be resolved incrementally across frames.
+	* Alternative focus actor plans are only added once the plans before them have failed.
+	*/
+	struct FShotPlanningState
+	{
+		FFocusShotPlanArray FocusShotPlans{};
+		TArray<FShotTraceCandidate> TraceCandidates{};
+		TOptional<FShotSetupParams> FirstResult{};
+		AActor* FirstFocusActor{};
+		FOnAIShotSetupComplete OnComplete{};
+		FTraceDelegate TraceDelegate{};
+		double StartRealTimeSeconds{};
+		double DeadlineWorldTimeSeconds{};
+		int32 NumPendingTraces{};
+		int32 NextPlanIndex{};
+		int32 NextFocusActorScoreIndex{};
+		int32 NumFrames{};
+		bool bOnlySingleFocusAvailable{};
+		bool bFirstResultViable{};
+		bool bFirstFocusLandedInHazard{};
+		bool bFirstPlanAdded{};
+		bool bFirstResultResolved{};
+
+		// Trace the candidates of each added plan with async traces instead of on the game thread
+		bool bAsyncTraces{};
+
+		// Route legs are still being evaluated so the shot planning has not started
+		bool bRoutePending{};
+	};
+
+	using FRouteStartCandidates = TArray<AActor*, TInlineAllocator<16>>;
+
+	void BeginShotSetup(FAIShotContext&& InShotContext);
+	FAIShotSetupResult FinishShotSetup(TOptional<FShotSetupParams>&& ShotParams, bool bAsync);
+	void RecordShotSetupBenchmark(bool bAsync) const;
+
+	void ScheduleShotSetupTick();
+	void TickShotSetup();
+	void StartShotPlanning();
+	void CompleteShotPlanning(TOptional<FShotSetupParams>&& ShotParams);
+
 	TOptional<FShotSetupParams> CalculateShotParams();
-	TOptional<FShotSetupParams> CalculateShotParamsForCurrentFocusActor();
+
+	/*
+	* Uses the nearest baked shot for the current position if its flick trace is clear. Returns an empty result on a miss so the live solver is used.
+	*/
+	TOptional<FShotSetupParams> FindAtlasShotParams();
+	void LoadShotAtlas();
+
+	/*
+	* Commits to the cheapest route to the hole and sets the focus actor to its next waypoint.
+	* Re-plans only when there is no route or the last shot deviated from it.
+	*/
+	void UpdateRoute();
+
+	/*
+	* Advances past reached waypoints and returns why the route needs re-planning, or null if it can be followed.
+	*/
+	const TCHAR* GetRouteReplanReason();
+	void FollowRoute();
+	bool PlanRoute();
+
+	/*
+	* Evaluates the route legs a plan from the pawn needs while CanContinue returns true so that PlanRoute doesn't evaluate any. Returns true when done.
+	*/
+	bool EvaluateRouteEdges(TFunctionRef<bool()> CanContinue);
+	void GetRouteStartCandidates(FRouteStartCandidates& OutStartCandidates) const;
+	bool HasRouteDeviated() const;
+	bool IsRouteWaypointReached(const AActor& Waypoint) const;
+	bool IsRouteFocusCandidate(const AActor* Actor) const;
+
+	TOptional<FGolfAIRouteEdgeCost> CalculateRouteEdgeCost(const FVector& FromLocation, const AActor* FromActor, const AActor& ToActor) const;
+	bool HasRouteLOS(const FVector& FromLocation, const AActor* FromActor, const AActor& ToActor) const;
+	bool IsRouteHazardNear(const FVector& Location) const;
+
+	void AddFirstShotPlan(FShotPlanningState& State);
+
+	/*
+	* Adds the plan for the next viable alternative focus actor in priority order and traces its candidates. Returns false if there are none left.
+	*/
+	bool AddNextShotPlan(FShotPlanningState& State);
+	void TraceShotPlanCandidates(FShotPlanningState& State, const FFocusShotPlan& Plan);
+
+	/*
+	* Resolves the next focus actor in priority order. Returns true once planning is complete and OutShotParams has the result.
+	* Returns false without resolving a plan while the async traces of the next plan are pending.
+	*/
+	bool ResolveNextShotPlan(FShotPlanningState& State, TOptional<FShotSetupParams>& OutShotParams);
+	void ResolveFirstShotResult(FShotPlanningState& State);
+	TOptional<FShotSetupParams> GetBestShotParamsSoFar(FShotPlanningState& State);
+
+	void SubmitShotTraceCandidates(FShotPlanningState& State, const FFocusShotPlan& Plan);
+	void OnShotCandidateTraceComplete(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum, uint32 PlanningId);
+	TOptional<FShotSetupParams> CalculateShotParamsForPlan(const FFocusShotPlan& Plan, TConstArrayView<FShotTraceCandidate> Candidates);
+
+	/*
+	* Calculates the power and calibration for the focus actor and appends its avoidance traces to Candidates.
+	* Returns false if no shot could be calculated for the focus actor.
+	*/
+	bool AddFocusShotPlan(AActor* PlanFocusActor, int32 NumFailures, bool bLandedInHazard, FFocusShotPlanArray& Plans, TArray<FShotTraceCandidate>& Candidates);
+	void AddAvoidanceShotCandidates(FFocusShotPlan& Plan, TArray<FShotTraceCandidate>& Candidates) const;
+
+	void EvaluateShotTraceCandidates(TArrayView<FShotTraceCandidate> Candidates) const;
 
 	/**
 	* Checks if the current focus actor hasn't resulted in many recent failures
@@ -102,23 +273,43 @@ private:
 
 	TOptional<FShotPowerCalculationResult> CalculateInitialShotParams() const;
 	FShotCalibrationResult CalibrateShot(const FVector& FlickLocation, float PowerFraction) const;
+	/*
+	* Replaces the calibrated pitch and power with the first clear arc in the pitch fan that carries as far as the calibrated shot.
+	* Returns false and leaves the calibration unchanged if none does.
+	*/
+	bool RefineCalibratedPitch(const FVector& FlickLocation, FShotCalibrationResult& Calibration) const;
+	float GetPowerFractionForLaunchSpeed(const FFlickParams& FlickParams, double DesiredSpeed) const;
+	const FBox& GetStaticCollisionBounds() const;
 
 	float CalculateDefaultZOffset() const;
 
-	FShotCalculationResult CalculateAvoidanceShotFactors(const FVector& FlickLocation, float PreferredShotAngle, float FlickMaxSpeed, float PowerFraction) const;
+	FShotCalculationResult ResolveAvoidanceShotFactors(const FFocusShotPlan& Plan, TConstArrayView<FShotTraceCandidate> Candidates) const;
+
+	TTuple<bool, float> ResolveShotPitch(const FFocusShotPlan& Plan, TConstArrayView<FShotTraceCandidate> PitchCandidates) const;
 
-	TTuple<bool, float> CalculateShotPitch(const FVector& FlickLocation, const FVector& FlickDirection, float FlickSpeed) const;
+	FVector GetPreferredYawDirection(const FVector& FlickLocation) const;
+	float GetRetryYaw(const FFocusShotPlan& Plan, int32 YawIncrement) const;
 
 	FVector GetFocusActorLocation(const FVector& FlickLocation) const;
 
 	bool ValidateAndLoadConfig();
-	bool ValidateCurveTable(UCurveTable* CurveTable) const;
+	bool CompileConfigCurves();
 	bool ValidateAndLoadAIPerformanceStrategy();
 
 	bool ShotWillEndUpInHazard(const FAIShotSetupResult& ShotSetupResult) const;
-	TOptional<const IPenaltyHazard*> TraceToHazard(const FVector& Location) const;
-	FVector GetBounceLocation(const FPredictProjectilePathResult& PathResult) const;
+
+	/*
+	* Set when shots are timed for the moving obstacles and there are any. The planning then leaves the obstacles out of its traces
+	* and sweeps the predicted path against where they will be when the pawn reaches them.
+	*/
+	const UMovingObstacleSubsystem* GetTimedMovingObstacleSubsystem() const;
+	void IgnoreTimedMovingObstacles(FCollisionQueryParams& QueryParams) const;
+
+	FHazardQueryResult TraceToHazard(const FVector& Location) const;
+	FHazardQueryResult TraceBouncesToHazard(const FPaperGolfTrajectoryParams& TrajectoryParams, const FPaperGolfTrajectoryResult& PathResult) const;
+	FVector GetBounceLocation(const FPaperGolfTrajectoryResult& PathResult) const;
 	float GetHitRestitution(const FHitResult& HitResult) const;
+	void UpdateSurfaceMaterialCacheStats() const;
 
 	double CalculateDistanceSum(double HorizontalDistance, double VerticalDistance) const;
 
@@ -148,6 +339,21 @@ private:
 	UPROPERTY(EditDefaultsOnly, Category = "Config")
 	float HazardPredictBounceTime{ 3.0f };
 
+	/*
+	* Roll out each bounce after the landing with the surface restitution and friction instead of extrapolating a single bounce.
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = "Config")
+	bool bPredictMultipleBounces{ true };
+
+	UPROPERTY(EditDefaultsOnly, Category = "Config", meta = (EditCondition = "bPredictMultipleBounces", ClampMin = "0", ClampMax = "8"))
+	int32 HazardPredictMaxBounces{ 4 };
+
+	/*
+	* Rebound speed off a surface below which the pawn is considered to stop bouncing and slide to rest.
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = "Config", meta = (EditCondition = "bPredictMultipleBounces"))
+	float HazardPredictRestSpeed{ 100.0f };
+
 	/*
 	* Delta to focus actor orientation to offset the shot yaw.  Try the hole direction first.
 	*/
@@ -176,15 +382,107 @@ private:
 	UPROPERTY(EditDefaultsOnly, Category = "Config")
 	float DefaultHitRestitution{ 0.25f };
 
+	UPROPERTY(EditDefaultsOnly, Category = "Config")
+	float DefaultHitFriction{ 0.7f };
+
 	UPROPERTY(Category = "Config", EditDefaultsOnly)
 	float HazardTraceDistance{ 100.0f };
 
 	UPROPERTY(Category = "Shot Arc Prediction", EditDefaultsOnly)
 	float MinTraceDistance{ 1000.0f };
 
+	/*
+	* Evaluate the obstacle avoidance traces for the shot candidates of each focus actor across worker threads.
+	* Disable to compare the frame time against evaluating them on the game thread.
+	*/
+	UPROPERTY(Category = "Config | Performance", EditDefaultsOnly)
+	bool bParallelShotCandidateEvaluation{ true };
+
+	/*
+	* Minimum number of shot candidate traces given to each worker when evaluating in parallel.
+	*/
+	UPROPERTY(Category = "Config | Performance", EditDefaultsOnly, meta = (ClampMin = "1"))
+	int32 ShotCandidateMinBatchSize{ 8 };
+
+	/*
+	* Baked shots for each course map. See UGolfAIShotAtlasCommandlet.
+	*/
+	UPROPERTY(Category = "Config | Performance", EditDefaultsOnly)
+	TMap<TSoftObjectPtr<UWorld>, TSoftObjectPtr<UGolfAIShotAtlas>> ShotAtlases{};
+
+	/*
+	* Maximum distance from a baked sample position for its shot to be reused. The baked power is re-solved for the offset from the sample.
+	*/
+	UPROPERTY(Category = "Config | Performance", EditDefaultsOnly, meta = (ClampMin = "0"))
+	float ShotAtlasMaxCellDistance{ 500.0f };
+
+	/*
+	* Maximum time in milliseconds to spend resolving focus actors each frame when planning asynchronously.
+	* At least one focus actor is always resolved per frame.
+	*/
+	UPROPERTY(Category = "Config | Performance", EditDefaultsOnly, meta = (ClampMin = "0"))
+	float MaxShotPlanningFrameTimeMs{ 1.0f };
+
+	/*
+	* Plan a route through the focus actors to the hole and keep targeting its next waypoint until a shot deviates from it.
+	* When disabled the nearest focus actor in view is targeted each shot.
+	*/
+	UPROPERTY(Category = "Config | Route", EditDefaultsOnly)
+	bool bPlanRoute{ true };
+
+	/*
+	* Extra strokes a route leg costs for each of its landing spots with a hazard nearby.
+	*/
+	UPROPERTY(Category = "Config | Route", EditDefaultsOnly, meta = (EditCondition = "bPlanRoute", ClampMin = "0"))
+	float RouteHazardRiskStrokes{ 1.5f };
+
+	/*
+	* Horizontal distance around a route landing spot that is checked for hazards.
+	*/
+	UPROPERTY(Category = "Config | Route", EditDefaultsOnly, meta = (EditCondition = "bPlanRoute", ClampMin = "0"))
+	float RouteHazardProbeRadius{ 300.0f };
+
+	/*
+	* Delay the flick until the predicted path misses the moving obstacles where they will be when the pawn reaches them.
+	*/
+	UPROPERTY(Category = "Config | Moving Obstacles", EditDefaultsOnly)
+	bool bTimeShotsForMovingObstacles{ true };
+
+	UPROPERTY(Category = "Config | Moving Obstacles", EditDefaultsOnly, meta = (EditCondition = "bTimeShotsForMovingObstacles", ClampMin = "0"))
+	float MaxMovingObstacleWaitTime{ 4.0f };
+
+	UPROPERTY(Category = "Config | Moving Obstacles", EditDefaultsOnly, meta = (EditCondition = "bTimeShotsForMovingObstacles", ClampMin = "0.05"))
+	float MovingObstacleWaitStep{ 0.25f };
+
 	UPROPERTY(Category = "Config", EditDefaultsOnly)
 	TObjectPtr<UCurveTable> AIConfigCurveTable{};
 
+	/*
+	* Max error of the sampled config curves relative to each curve's value range. Curves that cannot be sampled within it are evaluated directly.
+	*/
+	UPROPERTY(Category = "Config | Performance", EditDefaultsOnly, meta = (ClampMin = "0"))
+	float CompiledCurveTolerance{ 1e-3f };
+
+	/*
+	* Simulate a fan of pitch angles around the curve table pitch and use the closest one whose arc reaches the target without hitting anything.
+	* The power is re-solved for each pitch so the arcs carry as far as the curve table shot.
+	* Off by default as it changes the pitch and power of every AI shot. Obstacle avoidance in ResolveShotPitch still uses the straight pitch traces.
+	*/
+	UPROPERTY(Category = "Config", EditDefaultsOnly)
+	bool bRefineCalibratedPitch{ false };
+
+	/*
+	* Number of pitch angles in the fan including the curve table pitch. Each one is a simulated trajectory.
+	*/
+	UPROPERTY(Category = "Config", EditDefaultsOnly, meta = (EditCondition = "bRefineCalibratedPitch", ClampMin = "1", ClampMax = "8"))
+	int32 MaxCalibrationPitchCandidates{ 4 };
+
+	/*
+	* How far a refined arc may land from where the curve table shot comes down, relative to its carry.
+	*/
+	UPROPERTY(Category = "Config", EditDefaultsOnly, meta = (EditCondition = "bRefineCalibratedPitch", ClampMin = "0"))
+	float RefinedPitchMaxCarryErrorFraction{ 0.1f };
+
 	UPROPERTY(Category = "Config", EditDefaultsOnly)
 	TSubclassOf<UAIPerformanceStrategy> AIPerformanceStrategyClass{};
 
@@ -219,6 +517,13 @@ private:
 	UPROPERTY(Transient)
 	TObjectPtr<UAIPerformanceStrategy> AIPerformanceStrategy{};
 
+	UPROPERTY(Transient)
+	TObjectPtr<UGolfAIShotAtlas> ShotAtlas{};
+
+	// Owning controller's focus line of sight for the route legs. Null when the component is not on a controller
+	UPROPERTY(Transient)
+	TObjectPtr<UGolfControllerCommonComponent> ControllerCommonComponent{};
+
 	UPROPERTY(Transient)
 	FAIShotContext ShotContext{};
 
@@ -227,8 +532,39 @@ private:
 	UPROPERTY(Transient)
 	AActor* FocusActor{};
 
+	TUniquePtr<FShotPlanningState> ShotPlanningState{};
+	FTimerHandle ShotPlanningTimerHandle{};
+	uint32 ShotPlanningId{};
+
+	// Cost of the shot being set up, reported to the bot benchmark when it is running.
+	// The setup time only counts the game thread slices so an async setup isn't charged for the frames in between
+	double ShotSetupTimeSeconds{};
+	double ShotSetupSliceStartTimeSeconds{};
+	mutable int32 NumShotSetupTraces{};
+	mutable int32 NumShotSetupTrajectoryPredictions{};
+
 	TArray<FShotResult> HoleShotResults{};
+
+	// Legs between focus actors stay cached for the hole
+	FGolfAIRoutePlanner RoutePlanner{};
 	mutable float DistanceToHole{};
+	mutable TOptional<FBox> StaticCollisionBounds{};
+
+	// Compiled from AIConfigCurveTable
+	FPGCompiledCurve PowerFractionCurve{};
+	FPGCompiledCurve PitchAngleCurve{};
+	FPGCompiledCurve ZOffsetCurve{};
+	FPGCompiledCurve PowerMultiplierCurve{};
+
+	// Surface restitution and friction of predicted hits for the current hole
+	mutable FPaperGolfSurfaceMaterialCache SurfaceMaterialCache{};
+
+	// Reused by every hazard prediction so shot setup does not allocate once the buffers have grown
+	mutable FPaperGolfTrajectoryScratch TrajectoryScratch{};
+
+	// Records the path of the flick so it can be swept against the moving obstacles, both when timing the shot and when checking it for hazards
+	mutable FPaperGolfTrajectoryScratch ObstacleTimingScratch{};
+
 	int32 CurrentFocusActorFailures{};
 	bool bCurrentFocusActorLandedInHazard{};
 };
@@ -249,4 +585,15 @@ FORCEINLINE float UGolfAIShotComponent::FShotSetupParams::GetPowerDeviation() co
 	return ShotSetupResult.FlickParams.PowerFraction - InitialPowerFraction;
 }
 
+FORCEINLINE bool UGolfAIShotComponent::IsShotSetupInProgress() const
+{
+	return ShotPlanningState.IsValid();
+}
+
+FORCEINLINE float UGolfAIShotComponent::GetRetryYaw(const FFocusShotPlan& Plan, int32 YawIncrement) const
+{
+	// Try positive and then negative version of angle
+	return YawRetryDelta * (YawIncrement / 2) * (YawIncrement % 2 == 0 ? Plan.PreferredYawDirection : -Plan.PreferredYawDirection);
+}
+
 #pragma endregion Inline Definitions
@@ -16,6 +16,7 @@
 #include "Utils/CollisionUtils.h"
 
 #include "Subsystems/GolfEventsSubsystem.h"
+#include "Subsystems/GolfAIBenchmarkSubsystem.h"
 
 #include "PGAILogging.h"
 
@@ -61,6 +62,7 @@ void AGolfAIController::ClearTimers()
 
 	GetWorldTimerManager().ClearTimer(TurnTimerHandle);
 
+	CancelShotSetup();
 	ClearShotAnimationTimers();
 }
 
@@ -218,6 +220,8 @@ void AGolfAIController::Spectate(APaperGolfPawn* InPawn, AGolfPlayerState* InPla
 		PlayerPawn->SetCollisionEnabled(false);
 	}
 
+	CancelShotSetup();
+
 	bTurnActivated = false;
 	GolfControllerCommonComponent->EndTurn();
 }
@@ -300,6 +304,7 @@ void AGolfAIController::OnScored()
 
 	// Cancel any outstanding execute timers
 	GetWorldTimerManager().ClearTimer(TurnTimerHandle);
+	CancelShotSetup();
 
 	bCanFlick = false;
 
@@ -325,6 +330,13 @@ void AGolfAIController::ExecuteTurn()
 		return;
 	}
 
+	if (GolfAIShotComponent->IsShotSetupInProgress())
+	{
+		UE_VLOG_UELOG(this, LogPGAI, Log, TEXT("%s: ExecuteTurn - Shot setup still in progress - deferring until complete"), *GetName());
+		bExecuteTurnOnShotSetupComplete = true;
+		return;
+	}
+
 	if (!ShotSetupParams)
 	{
 		UE_VLOG_UELOG(this, LogPGAI, Warning, TEXT("%s: ExecuteTurn - ShotSetupParams is not defined"), *GetName());
@@ -337,6 +349,19 @@ void AGolfAIController::ExecuteTurn()
 		return;
 	}
 
+	if (!bMovingObstacleWaitApplied)
+	{
+		bMovingObstacleWaitApplied = true;
+
+		if (const auto WaitTime = GolfAIShotComponent->CalculateMovingObstacleWaitTime(*PaperGolfPawn, ShotSetupParams->FlickParams); WaitTime > 0)
+		{
+			UE_VLOG_UELOG(this, LogPGAI, Log, TEXT("%s: ExecuteTurn - Waiting %.2fs for moving obstacles to clear"), *GetName(), WaitTime);
+
+			GetWorldTimerManager().SetTimer(TurnTimerHandle, this, &AGolfAIController::ExecuteTurn, WaitTime, false);
+			return;
+		}
+	}
+
 	AddStroke();
 
 	PaperGolfPawn->Flick(ShotSetupParams->FlickParams);
@@ -358,25 +383,92 @@ bool AGolfAIController::SetupShot()
 		return false;
 	}
 
-	TArray<FShotFocusScores> FocusActorScores;
-	GolfControllerCommonComponent->GetBestFocusActor({}, &FocusActorScores, { .bIncludeMisaligned = true });
+	const auto ShotSetupResult = GolfAIShotComponent->SetupShot(CreateShotContext());
 
-	const auto ShotSetupResult = GolfAIShotComponent->SetupShot(
-		{
-			.PlayerPawn = PlayerPawn,
-			.PlayerState = GetGolfPlayerState(),
-			.GolfHole = GolfControllerCommonComponent->GetCurrentGolfHole(),
-			.FocusActorScores = std::move(FocusActorScores),
-			.ShotType = ShotType
-		}
-	);
+	ApplyShotSetupResult(ShotSetupResult);
+
+	return true;
+}
+
+bool AGolfAIController::SetupShotAsync(float ShotDelayTime)
+{
+	ShotSetupParams.Reset();
+	bExecuteTurnOnShotSetupComplete = false;
+
+	auto World = GetWorld();
+	if (!ensure(World) || !IsValid(PlayerPawn))
+	{
+		return false;
+	}
+
+	// Leave enough of the reaction time to animate the shot setup
+	const auto TimeBudgetSeconds = FMath::Clamp(ShotDelayTime - ShotAnimationMinTime - ShotAnimationFinishDeltaTime, 0.0f, ShotPlanningTimeBudget);
+	const auto ExecuteTimeSeconds = World->GetTimeSeconds() + ShotDelayTime;
+
+	UE_VLOG_UELOG(this, LogPGAI, Log, TEXT("%s: SetupShotAsync - ShotDelayTime=%.2f; TimeBudgetSeconds=%.2f"), *GetName(), ShotDelayTime, TimeBudgetSeconds);
+
+	return GolfAIShotComponent->SetupShotAsync(CreateShotContext(), TimeBudgetSeconds,
+		FOnAIShotSetupComplete::CreateUObject(this, &ThisClass::OnShotSetupComplete, ExecuteTimeSeconds));
+}
+
+void AGolfAIController::OnShotSetupComplete(const FAIShotSetupResult& ShotSetupResult, double ExecuteTimeSeconds)
+{
+	if (!IsValid(PlayerPawn))
+	{
+		return;
+	}
+
+	ApplyShotSetupResult(ShotSetupResult);
+
+	// World time is kept as a double so the remaining time is precise late into a long session
+	const auto RemainingTimeSeconds = static_cast<float>(ExecuteTimeSeconds - GetWorld()->GetTimeSeconds());
+
+	UE_VLOG_UELOG(this, LogPGAI, Log, TEXT("%s: OnShotSetupComplete - RemainingTimeSeconds=%.2f; bExecuteTurnOnShotSetupComplete=%s"),
+		*GetName(), RemainingTimeSeconds, LoggingUtils::GetBoolString(bExecuteTurnOnShotSetupComplete));
+
+	InterpolateShotSetup(RemainingTimeSeconds);
+
+	if (bExecuteTurnOnShotSetupComplete)
+	{
+		bExecuteTurnOnShotSetupComplete = false;
+		ExecuteTurn();
+	}
+}
+
+void AGolfAIController::ApplyShotSetupResult(const FAIShotSetupResult& ShotSetupResult)
+{
+	check(PlayerPawn);
 
 	PlayerPawn->SetFocusActor(ShotSetupResult.FocusActor);
 
 	ShotType = ShotSetupResult.FlickParams.ShotType;
 	ShotSetupParams = ShotSetupResult;
+}
 
-	return true;
+FAIShotContext AGolfAIController::CreateShotContext()
+{
+	TArray<FShotFocusScores> FocusActorScores;
+	GolfControllerCommonComponent->GetBestFocusActor({}, &FocusActorScores, { .bIncludeMisaligned = true });
+
+	return FAIShotContext
+	{
+		.PlayerPawn = PlayerPawn,
+		.PlayerState = GetGolfPlayerState(),
+		.GolfHole = GolfControllerCommonComponent->GetCurrentGolfHole(),
+		.FocusActorScores = std::move(FocusActorScores),
+		.FocusableActors = GolfControllerCommonComponent->GetFocusableActors(),
+		.ShotType = ShotType
+	};
+}
+
+void AGolfAIController::CancelShotSetup()
+{
+	bExecuteTurnOnShotSetupComplete = false;
+
+	if (GolfAIShotComponent)
+	{
+		GolfAIShotComponent->CancelShotSetup();
+	}
 }
 
 void AGolfAIController::InterpolateShotSetup(float ShootDeltaTime)
@@ -538,7 +630,24 @@ void AGolfAIController::SetupNextShot(bool bSetCanFlick)
 		bCanFlick = true;
 		const auto ShotDelayTime = FMath::FRandRange(MinFlickReactionTime, MaxFlickReactionTime);
 
-		if (SetupShot())
+		// The bot benchmark compares the full cost of planning between builds so it plans synchronously without the frame slicing and deadline
+		const bool bBenchmarkRunning = GetWorld()->GetSubsystem<UGolfAIBenchmarkSubsystem>() != nullptr;
+
+		if (bAsyncShotPlanning && !bBenchmarkRunning)
+		{
+			// Shot setup animation is started once planning completes
+			if (SetupShotAsync(ShotDelayTime))
+			{
+				UE_VLOG_UELOG(this, LogPGAI, Log, TEXT("%s: SetupNextShot - Planning shot asynchronously and shooting after %.1fs"), *GetName(), ShotDelayTime);
+
+				GetWorldTimerManager().SetTimer(TurnTimerHandle, this, &AGolfAIController::ExecuteTurn, ShotDelayTime, false);
+			}
+			else
+			{
+				UE_VLOG_UELOG(this, LogPGAI, Error, TEXT("%s: SetupNextShot - Async shot set up failed - no shot will occur"), *GetName());
+			}
+		}
+		else if (SetupShot())
 		{
 			UE_VLOG_UELOG(this, LogPGAI, Log, TEXT("%s: SetupNextShot - Shooting after %.1fs"), *GetName(), ShotDelayTime);
 
@@ -556,6 +665,7 @@ void AGolfAIController::SetupNextShot(bool bSetCanFlick)
 void AGolfAIController::ResetShot()
 {
 	ShotType = EShotType::Default;
+	bMovingObstacleWaitApplied = false;
 
 	GolfControllerCommonComponent->ResetShot();
 }
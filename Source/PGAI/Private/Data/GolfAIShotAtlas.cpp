@@ -0,0 +1,100 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+#include "Data/GolfAIShotAtlas.h"
+
+#include "Logging/LoggingUtils.h"
+#include "PGAILogging.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(GolfAIShotAtlas)
+
+void FGolfAIShotAtlasHole::BuildCellIndices()
+{
+	CellIndices.Reset();
+
+	if (!ensureMsgf(CellSize > 0, TEXT("FGolfAIShotAtlasHole::BuildCellIndices - HoleNumber=%d has invalid CellSize=%f"), HoleNumber, CellSize))
+	{
+		return;
+	}
+
+	CellIndices.Reserve(Cells.Num());
+
+	for (int32 i = 0; i < Cells.Num(); ++i)
+	{
+		CellIndices.Add(GetCellCoordinates(FVector{ Cells[i].Location }), i);
+	}
+}
+
+void UGolfAIShotAtlas::PostLoad()
+{
+	Super::PostLoad();
+
+	for (auto& Hole : Holes)
+	{
+		Hole.BuildCellIndices();
+	}
+
+	UE_LOG(LogPGAI, Log, TEXT("%s: PostLoad - Loaded %d hole%s with %d cell%s"),
+		*GetName(), Holes.Num(), LoggingUtils::Pluralize(Holes.Num()), GetNumCells(), LoggingUtils::Pluralize(GetNumCells()));
+}
+
+const FGolfAIShotAtlasCell* UGolfAIShotAtlas::FindNearestCell(int32 HoleNumber, const FVector& Location, float MaxDistance) const
+{
+	const auto Hole = Holes.FindByPredicate([HoleNumber](const auto& Candidate) { return Candidate.HoleNumber == HoleNumber; });
+	if (!Hole || Hole->CellIndices.IsEmpty())
+	{
+		return nullptr;
+	}
+
+	const auto Coordinates = Hole->GetCellCoordinates(Location);
+	const auto Location3f = FVector3f{ Location };
+
+	const FGolfAIShotAtlasCell* NearestCell{};
+	float NearestDistSq = FMath::Square(MaxDistance);
+
+	// The nearest sample may be in a neighboring cell when close to a cell boundary
+	for (int32 DY = -1; DY <= 1; ++DY)
+	{
+		for (int32 DX = -1; DX <= 1; ++DX)
+		{
+			const auto CellIndex = Hole->CellIndices.Find(Coordinates + FIntPoint{ DX, DY });
+			if (!CellIndex)
+			{
+				continue;
+			}
+
+			const auto& Cell = Hole->Cells[*CellIndex];
+			if (const auto DistSq = FVector3f::DistSquared(Cell.Location, Location3f); DistSq <= NearestDistSq)
+			{
+				NearestCell = &Cell;
+				NearestDistSq = DistSq;
+			}
+		}
+	}
+
+	return NearestCell;
+}
+
+void UGolfAIShotAtlas::SetHole(FGolfAIShotAtlasHole&& Hole)
+{
+	Hole.BuildCellIndices();
+
+	if (auto ExistingHole = Holes.FindByPredicate([&](const auto& Candidate) { return Candidate.HoleNumber == Hole.HoleNumber; }); ExistingHole)
+	{
+		*ExistingHole = MoveTemp(Hole);
+	}
+	else
+	{
+		Holes.Add(MoveTemp(Hole));
+		Holes.Sort([](const auto& First, const auto& Second) { return First.HoleNumber < Second.HoleNumber; });
+	}
+}
+
+int32 UGolfAIShotAtlas::GetNumCells() const
+{
+	int32 NumCells{};
+	for (const auto& Hole : Holes)
+	{
+		NumCells += Hole.Cells.Num();
+	}
+	return NumCells;
+}
@@ -0,0 +1,8 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("PGAI"), STATGROUP_PGAI, STATCAT_Advanced);
@@ -0,0 +1,254 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+#include "Planning/GolfAIRoutePlanner.h"
+
+#include "Logging/LoggingUtils.h"
+
+#include "Algo/Reverse.h"
+
+FString FGolfAIRouteEdgeCost::ToString() const
+{
+	return FString::Printf(TEXT("Distance2D=%.1fm; Carry=%.1fm; ExpectedStrokes=%.2f; HazardRisk=%.1f; Cost=%.2f"),
+		Distance2D / 100, Carry / 100, ExpectedStrokes, HazardRisk, Cost);
+}
+
+bool FGolfAIRoutePlanner::Plan(const FVector& StartLocation, TConstArrayView<AActor*> StartCandidates, TConstArrayView<AActor*> Nodes, AActor& Goal, FEdgeCostFunction EdgeCostFunction)
+{
+	ClearRoute();
+
+	// Index 0 is the start so that node i is PlanNodes[i - 1]
+	GatherPlanNodes(Nodes, Goal);
+
+	const auto GoalIndex = PlanNodes.IndexOfByKey(&Goal) + 1;
+	const auto NumNodes = PlanNodes.Num() + 1;
+
+	NodeCosts.Init(TNumericLimits<float>::Max(), NumNodes);
+	NodeLegs.Reset();
+	NodeLegs.SetNum(NumNodes);
+	PreviousNodes.Init(INDEX_NONE, NumNodes);
+	SettledNodes.Init(false, NumNodes);
+
+	NodeCosts[0] = 0.0f;
+
+	// Holes only have a handful of focus actors so a linear scan for the closest node beats maintaining a heap
+	while (true)
+	{
+		int32 Current = INDEX_NONE;
+		for (int32 i = 0; i < NumNodes; ++i)
+		{
+			if (!SettledNodes[i] && NodeCosts[i] < TNumericLimits<float>::Max() && (Current == INDEX_NONE || NodeCosts[i] < NodeCosts[Current]))
+			{
+				Current = i;
+			}
+		}
+
+		// Don't route through the goal as holing out ends the hole
+		if (Current == INDEX_NONE || Current == GoalIndex)
+		{
+			break;
+		}
+
+		SettledNodes[Current] = true;
+
+		for (int32 Next = 1; Next < NumNodes; ++Next)
+		{
+			if (SettledNodes[Next])
+			{
+				continue;
+			}
+
+			const auto& NextActor = *PlanNodes[Next - 1];
+
+			TOptional<FGolfAIRouteEdgeCost> Leg;
+			if (Current == 0)
+			{
+				if (StartCandidates.Contains(&NextActor))
+				{
+					Leg = GetStartEdgeCost(StartLocation, NextActor, EdgeCostFunction);
+				}
+			}
+			else
+			{
+				Leg = GetCachedEdgeCost(*PlanNodes[Current - 1], NextActor, EdgeCostFunction);
+			}
+
+			if (!Leg)
+			{
+				continue;
+			}
+
+			if (const auto Cost = NodeCosts[Current] + Leg->Cost; Cost < NodeCosts[Next])
+			{
+				NodeCosts[Next] = Cost;
+				NodeLegs[Next] = Leg;
+				PreviousNodes[Next] = Current;
+			}
+		}
+	}
+
+	StartEdgeCosts.Reset();
+
+	if (PreviousNodes[GoalIndex] == INDEX_NONE)
+	{
+		return false;
+	}
+
+	for (int32 Node = GoalIndex; Node != 0; Node = PreviousNodes[Node])
+	{
+		Route.Add(FGolfAIRouteWaypoint
+		{
+			.Actor = PlanNodes[Node - 1],
+			.Leg = *NodeLegs[Node]
+		});
+	}
+
+	Algo::Reverse(Route);
+	RouteCost = NodeCosts[GoalIndex];
+
+	return true;
+}
+
+bool FGolfAIRoutePlanner::EvaluateEdges(const FVector& StartLocation, TConstArrayView<AActor*> StartCandidates, TConstArrayView<AActor*> Nodes, AActor& Goal,
+	FEdgeCostFunction EdgeCostFunction, TFunctionRef<bool()> CanContinue)
+{
+	if (!StartEdgeLocation.Equals(StartLocation))
+	{
+		StartEdgeCosts.Reset();
+		StartEdgeLocation = StartLocation;
+	}
+
+	GatherPlanNodes(Nodes, Goal);
+
+	bool bEvaluatedAny{};
+
+	// Only called between evaluations so that every call makes progress
+	const auto ShouldStop = [&]()
+	{
+		if (!bEvaluatedAny)
+		{
+			bEvaluatedAny = true;
+			return false;
+		}
+		return !CanContinue();
+	};
+
+	for (auto Node : PlanNodes)
+	{
+		if (StartCandidates.Contains(Node) && !StartEdgeCosts.Contains(Node))
+		{
+			if (ShouldStop())
+			{
+				return false;
+			}
+			GetStartEdgeCost(StartLocation, *Node, EdgeCostFunction);
+		}
+	}
+
+	// Same legs as the plan which never routes through the goal
+	for (auto FromNode : PlanNodes)
+	{
+		if (FromNode == &Goal)
+		{
+			continue;
+		}
+
+		for (auto ToNode : PlanNodes)
+		{
+			if (ToNode == FromNode || EdgeCosts.Contains(FEdgeKey{ FromNode, ToNode }))
+			{
+				continue;
+			}
+
+			if (ShouldStop())
+			{
+				return false;
+			}
+			GetCachedEdgeCost(*FromNode, *ToNode, EdgeCostFunction);
+		}
+	}
+
+	return true;
+}
+
+void FGolfAIRoutePlanner::AdvanceWaypoint()
+{
+	if (HasRoute())
+	{
+		++NextWaypointIndex;
+	}
+}
+
+void FGolfAIRoutePlanner::ClearRoute()
+{
+	Route.Reset();
+	NextWaypointIndex = 0;
+	RouteCost = 0.0f;
+}
+
+void FGolfAIRoutePlanner::DiscardStartEdges()
+{
+	StartEdgeCosts.Reset();
+}
+
+void FGolfAIRoutePlanner::Reset()
+{
+	ClearRoute();
+	EdgeCosts.Reset();
+	StartEdgeCosts.Reset();
+}
+
+FString FGolfAIRoutePlanner::ToString() const
+{
+	FString Result = FString::Printf(TEXT("Cost=%.2f; Waypoints="), RouteCost);
+
+	for (const auto& Waypoint : GetRoute())
+	{
+		Result += FString::Printf(TEXT("[%s: %.2f]"), *LoggingUtils::GetName(Waypoint.Actor.Get()), Waypoint.Leg.Cost);
+	}
+
+	return Result;
+}
+
+const TOptional<FGolfAIRouteEdgeCost>& FGolfAIRoutePlanner::GetCachedEdgeCost(const AActor& FromActor, const AActor& ToActor, FEdgeCostFunction EdgeCostFunction)
+{
+	const FEdgeKey Key{ &FromActor, &ToActor };
+
+	if (const auto EdgeCost = EdgeCosts.Find(Key); EdgeCost)
+	{
+		return *EdgeCost;
+	}
+
+	// Legs that can't be played are cached too so they are not re-evaluated on every plan
+	return EdgeCosts.Add(Key, EdgeCostFunction(FromActor.GetActorLocation(), &FromActor, ToActor));
+}
+
+const TOptional<FGolfAIRouteEdgeCost>& FGolfAIRoutePlanner::GetStartEdgeCost(const FVector& StartLocation, const AActor& ToActor, FEdgeCostFunction EdgeCostFunction)
+{
+	// Legs evaluated ahead of the plan from somewhere else are stale
+	if (!StartEdgeLocation.Equals(StartLocation))
+	{
+		StartEdgeCosts.Reset();
+		StartEdgeLocation = StartLocation;
+	}
+
+	if (const auto EdgeCost = StartEdgeCosts.Find(&ToActor); EdgeCost)
+	{
+		return *EdgeCost;
+	}
+
+	return StartEdgeCosts.Add(&ToActor, EdgeCostFunction(StartLocation, nullptr, ToActor));
+}
+
+void FGolfAIRoutePlanner::GatherPlanNodes(TConstArrayView<AActor*> Nodes, AActor& Goal)
+{
+	PlanNodes.Reset();
+	for (auto Node : Nodes)
+	{
+		if (Node)
+		{
+			PlanNodes.AddUnique(Node);
+		}
+	}
+
+	PlanNodes.AddUnique(&Goal);
+}
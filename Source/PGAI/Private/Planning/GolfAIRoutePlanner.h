@@ -0,0 +1,146 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+/*
+* Cost of a single leg of a route, i.e. the shots from one node to the next.
+*/
+struct FGolfAIRouteEdgeCost
+{
+	float Distance2D{};
+
+	// How far a full power stroke carries along the leg before it comes down or hits something
+	float Carry{};
+
+	float ExpectedStrokes{};
+
+	// Number of landing spots along the leg with a hazard nearby
+	float HazardRisk{};
+
+	// Expected strokes including the hazard risk weighted in strokes
+	float Cost{};
+
+	FString ToString() const;
+};
+
+struct FGolfAIRouteWaypoint
+{
+	TWeakObjectPtr<AActor> Actor{};
+
+	// Leg that ends at this waypoint
+	FGolfAIRouteEdgeCost Leg{};
+};
+
+/*
+* Plans the cheapest route from the pawn through the focus actors of a hole to the hole with Dijkstra.
+* The nodes are fixed for the hole so the legs between them are cached until Reset and re-planning after a bad shot
+* only has to evaluate the legs from the new pawn position. EvaluateEdges spreads the leg evaluation of a plan over several calls.
+*/
+class FGolfAIRoutePlanner
+{
+public:
+	using FEdgeCostFunction = TFunctionRef<TOptional<FGolfAIRouteEdgeCost>(const FVector& FromLocation, const AActor* FromActor, const AActor& ToActor)>;
+
+	/*
+	* Replaces the current route. Returns false if the goal can't be reached, in which case there is no route.
+	*
+	* @param StartCandidates Nodes that can be targeted from StartLocation. The legs from the start are not cached.
+	* @param Nodes All nodes of the hole. Goal is added if it is missing.
+	* @param EdgeCostFunction Returns the cost of the leg or unset if it can't be played. FromActor is null for the start.
+	*/
+	bool Plan(const FVector& StartLocation, TConstArrayView<AActor*> StartCandidates, TConstArrayView<AActor*> Nodes, AActor& Goal, FEdgeCostFunction EdgeCostFunction);
+
+	/*
+	* Evaluates legs that a Plan with the same arguments could need and that are not cached yet, at least one per call and then while CanContinue returns true.
+	* The legs from StartLocation are kept until the next Plan. Returns true once every leg is cached so that Plan does not evaluate any.
+	*/
+	bool EvaluateEdges(const FVector& StartLocation, TConstArrayView<AActor*> StartCandidates, TConstArrayView<AActor*> Nodes, AActor& Goal,
+		FEdgeCostFunction EdgeCostFunction, TFunctionRef<bool()> CanContinue);
+
+	void AdvanceWaypoint();
+
+	void ClearRoute();
+
+	/*
+	* Drops the legs from the start evaluated ahead of a plan that will not happen.
+	*/
+	void DiscardStartEdges();
+
+	/*
+	* Clears the route and the cached legs for a new hole.
+	*/
+	void Reset();
+
+	bool HasRoute() const;
+	AActor* GetNextWaypoint() const;
+	const FGolfAIRouteWaypoint* GetNextRouteWaypoint() const;
+	TConstArrayView<FGolfAIRouteWaypoint> GetRoute() const;
+
+	float GetRouteCost() const;
+	int32 GetNumCachedEdges() const;
+
+	FString ToString() const;
+
+private:
+	const TOptional<FGolfAIRouteEdgeCost>& GetCachedEdgeCost(const AActor& FromActor, const AActor& ToActor, FEdgeCostFunction EdgeCostFunction);
+	const TOptional<FGolfAIRouteEdgeCost>& GetStartEdgeCost(const FVector& StartLocation, const AActor& ToActor, FEdgeCostFunction EdgeCostFunction);
+
+	void GatherPlanNodes(TConstArrayView<AActor*> Nodes, AActor& Goal);
+
+private:
+	using FEdgeKey = TPair<TObjectKey<AActor>, TObjectKey<AActor>>;
+
+	TMap<FEdgeKey, TOptional<FGolfAIRouteEdgeCost>> EdgeCosts{};
+
+	// Legs from the start depend on the shot history so they only live until the next plan
+	TMap<TObjectKey<AActor>, TOptional<FGolfAIRouteEdgeCost>> StartEdgeCosts{};
+	FVector StartEdgeLocation{ EForceInit::ForceInitToZero };
+
+	TArray<FGolfAIRouteWaypoint> Route{};
+	int32 NextWaypointIndex{};
+	float RouteCost{};
+
+	// Reused by each plan
+	TArray<AActor*> PlanNodes{};
+	TArray<float> NodeCosts{};
+	TArray<TOptional<FGolfAIRouteEdgeCost>> NodeLegs{};
+	TArray<int32> PreviousNodes{};
+	TBitArray<> SettledNodes{};
+};
+
+#pragma region Inline Definitions
+
+FORCEINLINE bool FGolfAIRoutePlanner::HasRoute() const
+{
+	return NextWaypointIndex < Route.Num();
+}
+
+FORCEINLINE const FGolfAIRouteWaypoint* FGolfAIRoutePlanner::GetNextRouteWaypoint() const
+{
+	return HasRoute() ? &Route[NextWaypointIndex] : nullptr;
+}
+
+FORCEINLINE AActor* FGolfAIRoutePlanner::GetNextWaypoint() const
+{
+	return HasRoute() ? Route[NextWaypointIndex].Actor.Get() : nullptr;
+}
+
+FORCEINLINE TConstArrayView<FGolfAIRouteWaypoint> FGolfAIRoutePlanner::GetRoute() const
+{
+	return MakeArrayView(Route).RightChop(NextWaypointIndex);
+}
+
+FORCEINLINE float FGolfAIRoutePlanner::GetRouteCost() const
+{
+	return RouteCost;
+}
+
+FORCEINLINE int32 FGolfAIRoutePlanner::GetNumCachedEdges() const
+{
+	return EdgeCosts.Num();
+}
+
+#pragma endregion Inline Definitions
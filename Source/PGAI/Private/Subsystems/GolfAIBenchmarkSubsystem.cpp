@@ -0,0 +1,338 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+
+#include "Subsystems/GolfAIBenchmarkSubsystem.h"
+
+#include "Subsystems/GolfEventsSubsystem.h"
+
+#include "Pawn/PaperGolfPawn.h"
+#include "State/GolfPlayerState.h"
+
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/WorldSettings.h"
+#include "Kismet/GameplayStatics.h"
+
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/CommandLine.h"
+
+#include "Serialization/JsonWriter.h"
+#include "Policies/PrettyJsonPrintPolicy.h"
+
+#include "Algo/Accumulate.h"
+
+#include "Logging/LoggingUtils.h"
+#include "VisualLogger/VisualLogger.h"
+#include "PGAILogging.h"
+
+#include <algorithm>
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(GolfAIBenchmarkSubsystem)
+
+namespace
+{
+	constexpr int32 DefaultSeed = 1;
+	constexpr float DefaultTimeDilation = 4.0f;
+
+	FString GetPlayerName(const APaperGolfPawn& PlayerPawn);
+	double GetPercentile(TArray<double>& Values, double Percentile);
+}
+
+bool UGolfAIBenchmarkSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return FParse::Param(FCommandLine::Get(), PG::Benchmark::EnableSwitch) && Super::ShouldCreateSubsystem(Outer);
+}
+
+bool UGolfAIBenchmarkSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UGolfAIBenchmarkSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const auto CommandLine = FCommandLine::Get();
+
+	if (!FParse::Value(CommandLine, PG::Benchmark::OutputDirOption, OutputDir))
+	{
+		OutputDir = FPaths::ProjectSavedDir() / TEXT("Benchmarks");
+	}
+
+	Seed = DefaultSeed;
+	FParse::Value(CommandLine, PG::Benchmark::SeedOption, Seed);
+
+	TimeDilation = DefaultTimeDilation;
+	FParse::Value(CommandLine, PG::Benchmark::TimeDilationOption, TimeDilation);
+
+	// Seed before the game mode initializes so the bot names, strategies and shot deviations are all repeatable
+	FMath::RandInit(Seed);
+	FMath::SRandInit(Seed);
+
+	if (auto GolfEventsSubsystem = Collection.InitializeDependency<UGolfEventsSubsystem>(); ensure(GolfEventsSubsystem))
+	{
+		GolfEventsSubsystem->OnPaperGolfStartHole.AddUniqueDynamic(this, &ThisClass::OnStartHole);
+		GolfEventsSubsystem->OnPaperGolfNextHole.AddUniqueDynamic(this, &ThisClass::OnHoleComplete);
+		GolfEventsSubsystem->OnPaperGolfCourseComplete.AddUniqueDynamic(this, &ThisClass::OnCourseComplete);
+		GolfEventsSubsystem->OnPaperGolfPawnEnteredHazard.AddUniqueDynamic(this, &ThisClass::OnPawnEnteredHazard);
+	}
+
+	UE_LOG(LogPGAI, Display, TEXT("%s: Initialize - OutputDir=%s; Seed=%d; TimeDilation=%.2f"), *GetName(), *OutputDir, Seed, TimeDilation);
+}
+
+void UGolfAIBenchmarkSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (auto WorldSettings = InWorld.GetWorldSettings(); ensure(WorldSettings))
+	{
+		// Clamped to the world settings max global time dilation
+		WorldSettings->SetTimeDilation(TimeDilation);
+
+		UE_VLOG_UELOG(this, LogPGAI, Display, TEXT("%s: OnWorldBeginPlay - TimeDilation=%.2f"), *GetName(), WorldSettings->TimeDilation);
+	}
+}
+
+void UGolfAIBenchmarkSubsystem::RecordShotSetup(const APaperGolfPawn& PlayerPawn, const FGolfAIBenchmarkShotSetupStats& Stats)
+{
+	if (CurrentHoleNumber == INDEX_NONE)
+	{
+		return;
+	}
+
+	int32 ShotNumber{ 1 };
+	for (int32 i = CurrentHoleFirstShotIndex; i < ShotRecords.Num(); ++i)
+	{
+		if (ShotRecords[i].PlayerPawn == &PlayerPawn)
+		{
+			++ShotNumber;
+		}
+	}
+
+	ShotRecords.Add(FShotRecord
+	{
+		.PlayerName = GetPlayerName(PlayerPawn),
+		.PlayerPawn = &PlayerPawn,
+		.HoleNumber = CurrentHoleNumber,
+		.ShotNumber = ShotNumber,
+		.Stats = Stats
+	});
+}
+
+void UGolfAIBenchmarkSubsystem::OnStartHole(int32 HoleNumber)
+{
+	UE_VLOG_UELOG(this, LogPGAI, Log, TEXT("%s: OnStartHole - HoleNumber=%d"), *GetName(), HoleNumber);
+
+	const auto Now = FPlatformTime::Seconds();
+
+	if (CurrentHoleNumber == INDEX_NONE)
+	{
+		MatchStartTimeSeconds = Now;
+	}
+
+	CurrentHoleNumber = HoleNumber;
+	CurrentHoleFirstShotIndex = ShotRecords.Num();
+	HoleStartTimeSeconds = Now;
+}
+
+void UGolfAIBenchmarkSubsystem::OnHoleComplete()
+{
+	if (CurrentHoleNumber == INDEX_NONE || (!HoleRecords.IsEmpty() && HoleRecords.Last().HoleNumber == CurrentHoleNumber))
+	{
+		return;
+	}
+
+	auto& HoleRecord = HoleRecords.Add_GetRef(FHoleRecord
+	{
+		.HoleNumber = CurrentHoleNumber,
+		.NumShots = ShotRecords.Num() - CurrentHoleFirstShotIndex,
+		.WallTimeSeconds = FPlatformTime::Seconds() - HoleStartTimeSeconds
+	});
+
+	for (int32 i = CurrentHoleFirstShotIndex; i < ShotRecords.Num(); ++i)
+	{
+		if (ShotRecords[i].HitHazard)
+		{
+			++HoleRecord.NumHazards;
+		}
+	}
+
+	// Player states have already finished the hole when this is broadcast
+	if (auto GameState = GetWorld()->GetGameState(); ensure(GameState))
+	{
+		for (const auto PlayerState : GameState->PlayerArray)
+		{
+			if (const auto GolfPlayerState = Cast<AGolfPlayerState>(PlayerState); GolfPlayerState && !GolfPlayerState->IsSpectatorOnly())
+			{
+				HoleRecord.StrokesByPlayer.Emplace(GolfPlayerState->GetPlayerName(), GolfPlayerState->GetLastCompletedHoleScore());
+			}
+		}
+	}
+
+	UE_VLOG_UELOG(this, LogPGAI, Display, TEXT("%s: OnHoleComplete - HoleNumber=%d; Shots=%d; Hazards=%d; WallTime=%.2fs"),
+		*GetName(), HoleRecord.HoleNumber, HoleRecord.NumShots, HoleRecord.NumHazards, HoleRecord.WallTimeSeconds);
+}
+
+void UGolfAIBenchmarkSubsystem::OnCourseComplete()
+{
+	if (bCourseComplete || CurrentHoleNumber == INDEX_NONE)
+	{
+		return;
+	}
+
+	bCourseComplete = true;
+
+	OnHoleComplete();
+
+	MatchWallTimeSeconds = FPlatformTime::Seconds() - MatchStartTimeSeconds;
+
+	UE_VLOG_UELOG(this, LogPGAI, Display, TEXT("%s: OnCourseComplete - Holes=%d; Shots=%d; MatchWallTime=%.2fs"),
+		*GetName(), HoleRecords.Num(), ShotRecords.Num(), MatchWallTimeSeconds);
+
+	WriteReports();
+
+	FPlatformMisc::RequestExit(false, TEXT("UGolfAIBenchmarkSubsystem::OnCourseComplete"));
+}
+
+void UGolfAIBenchmarkSubsystem::OnPawnEnteredHazard(APaperGolfPawn* PaperGolfPawn, EHazardType HazardType)
+{
+	for (int32 i = ShotRecords.Num() - 1; i >= CurrentHoleFirstShotIndex; --i)
+	{
+		if (auto& ShotRecord = ShotRecords[i]; ShotRecord.PlayerPawn == PaperGolfPawn)
+		{
+			ShotRecord.HitHazard = HazardType;
+			return;
+		}
+	}
+}
+
+void UGolfAIBenchmarkSubsystem::WriteReports() const
+{
+	const auto MapName = UGameplayStatics::GetCurrentLevelName(this, true);
+	const auto BaseFileName = OutputDir / FString::Printf(TEXT("%s_Seed%d"), *MapName, Seed);
+
+	const auto CsvFileName = BaseFileName + TEXT(".csv");
+	const auto JsonFileName = BaseFileName + TEXT(".json");
+
+	if (FFileHelper::SaveStringToFile(GetCsvReport(), *CsvFileName) && FFileHelper::SaveStringToFile(GetJsonReport(), *JsonFileName))
+	{
+		UE_VLOG_UELOG(this, LogPGAI, Display, TEXT("%s: WriteReports - Wrote %s and %s"), *GetName(), *CsvFileName, *JsonFileName);
+	}
+	else
+	{
+		UE_VLOG_UELOG(this, LogPGAI, Error, TEXT("%s: WriteReports - Failed to write %s or %s"), *GetName(), *CsvFileName, *JsonFileName);
+	}
+}
+
+FString UGolfAIBenchmarkSubsystem::GetCsvReport() const
+{
+	FString Report = TEXT("Hole,Player,Shot,SetupTimeMs,Traces,TrajectoryPredictions,Async,Hazard\n");
+
+	for (const auto& ShotRecord : ShotRecords)
+	{
+		Report += FString::Printf(TEXT("%d,%s,%d,%.3f,%d,%d,%d,%s\n"),
+			ShotRecord.HoleNumber, *ShotRecord.PlayerName, ShotRecord.ShotNumber, ShotRecord.Stats.SetupTimeMs, ShotRecord.Stats.NumTraces,
+			ShotRecord.Stats.NumTrajectoryPredictions, ShotRecord.Stats.bAsync ? 1 : 0,
+			ShotRecord.HitHazard ? *LoggingUtils::GetName(*ShotRecord.HitHazard) : TEXT(""));
+	}
+
+	return Report;
+}
+
+FString UGolfAIBenchmarkSubsystem::GetJsonReport() const
+{
+	TArray<double> SetupTimesMs;
+	SetupTimesMs.Reserve(ShotRecords.Num());
+
+	int32 NumTraces{}, NumTrajectoryPredictions{}, NumHazards{};
+
+	for (const auto& ShotRecord : ShotRecords)
+	{
+		SetupTimesMs.Add(ShotRecord.Stats.SetupTimeMs);
+		NumTraces += ShotRecord.Stats.NumTraces;
+		NumTrajectoryPredictions += ShotRecord.Stats.NumTrajectoryPredictions;
+
+		if (ShotRecord.HitHazard)
+		{
+			++NumHazards;
+		}
+	}
+
+	const auto NumShots = ShotRecords.Num();
+	const auto SafeNumShots = FMath::Max(1, NumShots);
+
+	FString Report;
+	const auto Writer = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&Report);
+
+	Writer->WriteObjectStart();
+
+	Writer->WriteValue(TEXT("map"), UGameplayStatics::GetCurrentLevelName(this, true));
+	Writer->WriteValue(TEXT("seed"), Seed);
+	Writer->WriteValue(TEXT("timeDilation"), TimeDilation);
+	Writer->WriteValue(TEXT("matchWallTimeSeconds"), MatchWallTimeSeconds);
+	Writer->WriteValue(TEXT("shots"), NumShots);
+	Writer->WriteValue(TEXT("hazards"), NumHazards);
+	Writer->WriteValue(TEXT("hazardRate"), static_cast<double>(NumHazards) / SafeNumShots);
+	Writer->WriteValue(TEXT("traces"), NumTraces);
+	Writer->WriteValue(TEXT("tracesPerShot"), static_cast<double>(NumTraces) / SafeNumShots);
+	Writer->WriteValue(TEXT("trajectoryPredictions"), NumTrajectoryPredictions);
+
+	Writer->WriteObjectStart(TEXT("setupTimeMs"));
+	Writer->WriteValue(TEXT("mean"), NumShots ? Algo::Accumulate(SetupTimesMs, 0.0) / NumShots : 0.0);
+	Writer->WriteValue(TEXT("p50"), GetPercentile(SetupTimesMs, 0.5));
+	Writer->WriteValue(TEXT("p95"), GetPercentile(SetupTimesMs, 0.95));
+	Writer->WriteValue(TEXT("max"), GetPercentile(SetupTimesMs, 1.0));
+	Writer->WriteObjectEnd();
+
+	Writer->WriteArrayStart(TEXT("holes"));
+	for (const auto& HoleRecord : HoleRecords)
+	{
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("hole"), HoleRecord.HoleNumber);
+		Writer->WriteValue(TEXT("shots"), HoleRecord.NumShots);
+		Writer->WriteValue(TEXT("hazards"), HoleRecord.NumHazards);
+		Writer->WriteValue(TEXT("hazardRate"), static_cast<double>(HoleRecord.NumHazards) / FMath::Max(1, HoleRecord.NumShots));
+		Writer->WriteValue(TEXT("wallTimeSeconds"), HoleRecord.WallTimeSeconds);
+
+		Writer->WriteObjectStart(TEXT("strokes"));
+		for (const auto& [PlayerName, Strokes] : HoleRecord.StrokesByPlayer)
+		{
+			Writer->WriteValue(PlayerName, Strokes);
+		}
+		Writer->WriteObjectEnd();
+
+		Writer->WriteObjectEnd();
+	}
+	Writer->WriteArrayEnd();
+
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	return Report;
+}
+
+namespace
+{
+	FString GetPlayerName(const APaperGolfPawn& PlayerPawn)
+	{
+		if (const auto PlayerState = PlayerPawn.GetPlayerState(); PlayerState)
+		{
+			return PlayerState->GetPlayerName();
+		}
+
+		return PlayerPawn.GetName();
+	}
+
+	double GetPercentile(TArray<double>& Values, double Percentile)
+	{
+		if (Values.IsEmpty())
+		{
+			return 0.0;
+		}
+
+		const auto Index = FMath::Clamp(FMath::CeilToInt32(Percentile * Values.Num()) - 1, 0, Values.Num() - 1);
+		std::nth_element(Values.GetData(), Values.GetData() + Index, Values.GetData() + Values.Num());
+
+		return Values[Index];
+	}
+}
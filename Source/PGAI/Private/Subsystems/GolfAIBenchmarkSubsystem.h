@@ -0,0 +1,104 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Subsystems/GolfEvents.h"
+
+#include "GolfAIBenchmarkSubsystem.generated.h"
+
+class APaperGolfPawn;
+
+namespace PG::Benchmark
+{
+	// Enables the subsystem
+	inline constexpr auto EnableSwitch = TEXT("PGBotBenchmark");
+
+	// Directory the reports are written to. Defaults to Saved/Benchmarks
+	inline constexpr auto OutputDirOption = TEXT("PGBotBenchmarkOutput=");
+	inline constexpr auto SeedOption = TEXT("PGBotBenchmarkSeed=");
+	inline constexpr auto TimeDilationOption = TEXT("PGBotBenchmarkTimeDilation=");
+}
+
+struct FGolfAIBenchmarkShotSetupStats
+{
+	// Game thread time spent setting up the shot, excluding the frames an async setup waits between its slices
+	double SetupTimeMs{};
+	int32 NumTraces{};
+	int32 NumTrajectoryPredictions{};
+	bool bAsync{};
+};
+
+/**
+ * Records bot self-play over a full course for comparing AI cost and quality between builds.
+ * Only created when the game is launched with -PGBotBenchmark. The random seed and time dilation are fixed from the command line
+ * and once the course is complete a per shot CSV and a JSON summary are written and the game exits.
+ * See Tools/Benchmark for launching the courses headless.
+ */
+UCLASS()
+class UGolfAIBenchmarkSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void RecordShotSetup(const APaperGolfPawn& PlayerPawn, const FGolfAIBenchmarkShotSetupStats& Stats);
+
+protected:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+private:
+	struct FShotRecord
+	{
+		FString PlayerName{};
+		TWeakObjectPtr<const APaperGolfPawn> PlayerPawn{};
+		int32 HoleNumber{};
+		int32 ShotNumber{};
+		FGolfAIBenchmarkShotSetupStats Stats{};
+		TOptional<EHazardType> HitHazard{};
+	};
+
+	struct FHoleRecord
+	{
+		int32 HoleNumber{};
+		TArray<TPair<FString, int32>> StrokesByPlayer{};
+		int32 NumShots{};
+		int32 NumHazards{};
+		double WallTimeSeconds{};
+	};
+
+	UFUNCTION()
+	void OnStartHole(int32 HoleNumber);
+
+	UFUNCTION()
+	void OnHoleComplete();
+
+	UFUNCTION()
+	void OnCourseComplete();
+
+	UFUNCTION()
+	void OnPawnEnteredHazard(APaperGolfPawn* PaperGolfPawn, EHazardType HazardType);
+
+	void WriteReports() const;
+	FString GetCsvReport() const;
+	FString GetJsonReport() const;
+
+private:
+	TArray<FShotRecord> ShotRecords{};
+	TArray<FHoleRecord> HoleRecords{};
+
+	FString OutputDir{};
+	int32 Seed{};
+	float TimeDilation{ 1.0f };
+
+	int32 CurrentHoleNumber{ INDEX_NONE };
+	int32 CurrentHoleFirstShotIndex{};
+	double HoleStartTimeSeconds{};
+	double MatchStartTimeSeconds{};
+	double MatchWallTimeSeconds{};
+	bool bCourseComplete{};
+};
@@ -90,6 +90,12 @@ private:
 	void OnScored();
 
 	bool SetupShot();
+	bool SetupShotAsync(float ShotDelayTime);
+	void OnShotSetupComplete(const FAIShotSetupResult& ShotSetupResult, double ExecuteTimeSeconds);
+	void ApplyShotSetupResult(const FAIShotSetupResult& ShotSetupResult);
+	FAIShotContext CreateShotContext();
+	void CancelShotSetup();
+
 	void InterpolateShotSetup(float ShootDeltaTime);
 
 	void ExecuteTurn();
@@ -139,6 +145,18 @@ private:
 	UPROPERTY(EditDefaultsOnly, Category = "Config")
 	float HazardDelayTime{ 3.0f };
 
+	/*
+	* Plan the shot over multiple frames during the flick reaction time instead of blocking the game thread.
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = "Config | Performance")
+	bool bAsyncShotPlanning{ true };
+
+	/*
+	* Maximum time in seconds for async shot planning. The budget is further limited so that there is time left for the shot animation.
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = "Config | Performance", meta = (EditCondition = "bAsyncShotPlanning", ClampMin = "0"))
+	float ShotPlanningTimeBudget{ 1.0f };
+
 	UPROPERTY(EditDefaultsOnly, Category = "Shot Animation")
 	float ShotAnimationMinTime{ 0.5f };
 
@@ -176,6 +194,10 @@ private:
 	bool bScored{};
 	bool bTurnActivated{};
 	bool bInHazard{};
+	bool bExecuteTurnOnShotSetupComplete{};
+
+	// Only hold the flick once a turn for the moving obstacles
+	bool bMovingObstacleWaitApplied{};
 };
 
 #pragma region Inline Definitions
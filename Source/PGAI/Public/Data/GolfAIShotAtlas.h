@@ -0,0 +1,103 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+
+#include "PaperGolfTypes.h"
+
+#include "GolfAIShotAtlas.generated.h"
+
+/*
+* Best shot found by the AI shot solver from a single sampled position.
+*/
+USTRUCT()
+struct PGAI_API FGolfAIShotAtlasCell
+{
+	GENERATED_BODY()
+
+	// Pawn actor location the shot was solved from
+	UPROPERTY(VisibleAnywhere)
+	FVector3f Location{ EForceInit::ForceInitToZero };
+
+	UPROPERTY(VisibleAnywhere)
+	FName FocusActorName{};
+
+	// Yaw offset from the direction to the focus actor
+	UPROPERTY(VisibleAnywhere)
+	float ShotYaw{};
+
+	UPROPERTY(VisibleAnywhere)
+	float ShotPitch{};
+
+	UPROPERTY(VisibleAnywhere)
+	float PowerFraction{};
+
+	UPROPERTY(VisibleAnywhere)
+	float LocalZOffset{};
+
+	UPROPERTY(VisibleAnywhere)
+	EShotType ShotType{ EShotType::Default };
+};
+
+USTRUCT()
+struct PGAI_API FGolfAIShotAtlasHole
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere)
+	int32 HoleNumber{};
+
+	UPROPERTY(VisibleAnywhere)
+	float CellSize{};
+
+	UPROPERTY(VisibleAnywhere)
+	TArray<FGolfAIShotAtlasCell> Cells{};
+
+	// Cell index by grid coordinate, built on load
+	TMap<FIntPoint, int32> CellIndices{};
+
+	FIntPoint GetCellCoordinates(const FVector& Location) const;
+
+	void BuildCellIndices();
+};
+
+/*
+* Shots baked offline for each hole of a course by UGolfAIShotAtlasCommandlet so that bots can skip the live shot solver
+* when they are close to a sampled position.
+*/
+UCLASS()
+class PGAI_API UGolfAIShotAtlas : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	virtual void PostLoad() override;
+
+	/*
+	* Finds the closest baked cell to Location for the hole within MaxDistance.
+	*/
+	const FGolfAIShotAtlasCell* FindNearestCell(int32 HoleNumber, const FVector& Location, float MaxDistance) const;
+
+	void SetHole(FGolfAIShotAtlasHole&& Hole);
+
+	int32 GetNumCells() const;
+
+private:
+	UPROPERTY(VisibleAnywhere)
+	TArray<FGolfAIShotAtlasHole> Holes{};
+};
+
+#pragma region Inline Definitions
+
+FORCEINLINE FIntPoint FGolfAIShotAtlasHole::GetCellCoordinates(const FVector& Location) const
+{
+	return FIntPoint
+	{
+		FMath::FloorToInt32(Location.X / CellSize),
+		FMath::FloorToInt32(Location.Y / CellSize)
+	};
+}
+
+#pragma endregion Inline Definitions
@@ -28,7 +28,9 @@ struct FAIShotContext
 	UPROPERTY(Transient)
 	TArray<FShotFocusScores> FocusActorScores{};
 
-	// TODO: May want to pass in the full array of focus actors to select another target
+	// All focus actors of the hole, not only the ones in view, so that a route can be planned past them
+	UPROPERTY(Transient)
+	TArray<AActor*> FocusableActors{};
 
 	EShotType ShotType{ EShotType::Default };
 
@@ -17,6 +17,9 @@ namespace
 UBaseCollisionRelevanceComponent::UBaseCollisionRelevanceComponent()
 {
 	PrimaryComponentTick.bCanEverTick = false;
+
+	// Collisions are only notified while active so that the owner can deactivate the component to ignore them
+	bAutoActivate = true;
 }
 
 void UBaseCollisionRelevanceComponent::BeginPlay()
@@ -30,6 +33,11 @@ void UBaseCollisionRelevanceComponent::BeginPlay()
 
 void UBaseCollisionRelevanceComponent::OnActorHit(AActor* SelfActor, AActor* OtherActor, FVector NormalImpulse, const FHitResult& Hit)
 {
+	if (!IsActive())
+	{
+		return;
+	}
+
 	const bool bIsRelevant = IsRelevantCollision(Hit);
 
 	UE_VLOG_UELOG(GetOwner(), LogPGCore, VeryVerbose, TEXT("%s-%s: OnActorHit - bIsRelevant=%s; OtherActor=%s; NormalImpulse=%s; Hit=%s"),
@@ -44,6 +52,11 @@ void UBaseCollisionRelevanceComponent::OnActorHit(AActor* SelfActor, AActor* Oth
 
 void UBaseCollisionRelevanceComponent::OnComponentHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComponent, FVector NormalImpulse, const FHitResult& Hit)
 {
+	if (!IsActive())
+	{
+		return;
+	}
+
 	const bool bIsRelevant = IsRelevantCollision(Hit);
 
 	UE_VLOG_UELOG(GetOwner(), LogPGCore, VeryVerbose, TEXT("%s-%s: OnComponentHit - bIsRelevant=%s; HitComponent=%s; OtherActor=%s; OtherComponent=%s; NormalImpulse=%s; Hit=%s"),
@@ -81,6 +94,16 @@ void UBaseCollisionRelevanceComponent::RegisterComponent(UPrimitiveComponent* Co
 	Component->OnComponentHit.AddUniqueDynamic(this, &ThisClass::OnComponentHit);
 }
 
+bool UBaseCollisionRelevanceComponent::IsRelevanceByObjectTypeOnly() const
+{
+	return ActorSubstrings.IsEmpty() && ComponentSubstrings.IsEmpty();
+}
+
+bool UBaseCollisionRelevanceComponent::IsRelevantObjectType(ECollisionChannel ObjectType) const
+{
+	return ObjectTypes.Contains(ObjectType) ? bMatchTrueCondition : !bMatchTrueCondition;
+}
+
 bool UBaseCollisionRelevanceComponent::IsRelevantCollision(const FHitResult& Hit) const
 {
 	const auto OtherComponent = Hit.GetComponent();
@@ -79,6 +79,12 @@ namespace PG
 		TEXT("Adjust all players' min power reduction from accuracy [0,1]"),
 		ECVF_Default);
 
+	TAutoConsoleVariable<int32> CPredictedFlight(
+		TEXT("pg.net.predictedFlight"),
+		-1,
+		TEXT("Override whether clients simulate flicks locally with server corrections -> -1: variable disabled, 0: replicate movement, 1: predict. Read on the server"),
+		ECVF_Default);
+
 	namespace GameMode
 	{
 		// These only apply before starting the game and are overriden by the game options url string
@@ -0,0 +1,197 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+#include "Utils/PGCompiledCurve.h"
+#include "Utils/PGTestUtils.h"
+
+#include "Curves/RichCurve.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	constexpr float Tolerance = PG::TestUtils::Defaults::CompiledCurveTolerance;
+
+	constexpr int32 NumSweepPoints = 203;
+
+	struct FCurveKey
+	{
+		float Time{};
+		float Value{};
+	};
+
+	struct FCurveParams
+	{
+		ERichCurveInterpMode InterpMode{ ERichCurveInterpMode::RCIM_Cubic };
+		ERichCurveExtrapolation PreInfinityExtrap{ ERichCurveExtrapolation::RCCE_Constant };
+		ERichCurveExtrapolation PostInfinityExtrap{ ERichCurveExtrapolation::RCCE_Constant };
+	};
+
+	FRichCurve MakeCurve(TConstArrayView<FCurveKey> Keys, const FCurveParams& Params)
+	{
+		FRichCurve Curve;
+		for (const auto& Key : Keys)
+		{
+			const auto KeyHandle = Curve.AddKey(Key.Time, Key.Value);
+			Curve.SetKeyInterpMode(KeyHandle, Params.InterpMode);
+		}
+
+		Curve.AutoSetTangents();
+		Curve.PreInfinityExtrap = Params.PreInfinityExtrap;
+		Curve.PostInfinityExtrap = Params.PostInfinityExtrap;
+
+		return Curve;
+	}
+
+	/*
+	* Curves shaped like the AI config curves. Each one is sampled within the tolerance.
+	*/
+	namespace Curves
+	{
+		// Delta distance in meters vs power fraction
+		FRichCurve PowerFraction()
+		{
+			return MakeCurve({ { 0.0f, 0.1f }, { 5.0f, 0.3f }, { 15.0f, 0.6f }, { 30.0f, 0.85f }, { 50.0f, 1.0f } },
+				{ .PreInfinityExtrap = RCCE_Linear, .PostInfinityExtrap = RCCE_Linear });
+		}
+
+		// Power fraction vs pitch angle
+		FRichCurve PitchAngle()
+		{
+			return MakeCurve({ { 0.2f, 65.0f }, { 0.6f, 50.0f }, { 1.0f, 40.0f } }, {});
+		}
+
+		// Delta distance in meters vs z offset
+		FRichCurve ZOffset()
+		{
+			return MakeCurve({ { 0.0f, 0.0f }, { 10.0f, 5.0f }, { 40.0f, 20.0f } },
+				{ .PreInfinityExtrap = RCCE_None, .PostInfinityExtrap = RCCE_None });
+		}
+
+		// Angle deviation vs power multiplier
+		FRichCurve PowerMultiplier()
+		{
+			return MakeCurve({ { 0.0f, 1.0f }, { 20.0f, 1.1f }, { 45.0f, 1.35f } },
+				{ .InterpMode = RCIM_Linear, .PreInfinityExtrap = RCCE_Linear, .PostInfinityExtrap = RCCE_Constant });
+		}
+
+		// The step falls between samples so linear interpolation cannot match it
+		FRichCurve Stepped()
+		{
+			return MakeCurve({ { 0.0f, 0.0f }, { 0.37f, 1.0f }, { 1.0f, 2.0f } }, { .InterpMode = RCIM_Constant });
+		}
+
+		FRichCurve Cycle()
+		{
+			return MakeCurve({ { 0.0f, 0.0f }, { 0.5f, 1.0f }, { 1.0f, 0.0f } },
+				{ .PreInfinityExtrap = RCCE_Cycle, .PostInfinityExtrap = RCCE_Cycle });
+		}
+	}
+
+	/*
+	* Times at the keys, between each pair of keys and swept across the key range extended by the range on both sides to cover the extrapolation.
+	*/
+	TArray<float> GetTestTimes(const FRealCurve& Curve)
+	{
+		TArray<float> Times;
+
+		float PreviousKeyTime{};
+		for (auto It = Curve.GetKeyHandleIterator(); It; ++It)
+		{
+			const auto KeyTime = Curve.GetKeyTime(*It);
+			if (!Times.IsEmpty())
+			{
+				Times.Add(0.5f * (PreviousKeyTime + KeyTime));
+			}
+
+			Times.Add(KeyTime);
+			PreviousKeyTime = KeyTime;
+		}
+
+		float MinTime, MaxTime;
+		Curve.GetTimeRange(MinTime, MaxTime);
+
+		const auto Range = FMath::Max(1.0f, MaxTime - MinTime);
+		for (int32 i = 0; i < NumSweepPoints; ++i)
+		{
+			Times.Add(FMath::Lerp(MinTime - Range, MaxTime + Range, static_cast<float>(i) / (NumSweepPoints - 1)));
+		}
+
+		// Leave a remainder past the SIMD lanes so that the scalar tail of EvalBatch is covered too
+		if (Times.Num() % 4 == 0)
+		{
+			Times.Add(MaxTime + 1.5f * Range);
+		}
+
+		return Times;
+	}
+
+	void TestAgainstSource(FAutomationTestBase& Test, const FString& CurveName, const FPGCompiledCurve& CompiledCurve, const FRealCurve& Curve, float MaxError)
+	{
+		const auto Times = GetTestTimes(Curve);
+
+		TArray<float> BatchValues;
+		BatchValues.SetNumUninitialized(Times.Num());
+		CompiledCurve.EvalBatch(Times, BatchValues);
+
+		float MaxScalarError{}, MaxBatchError{};
+		for (int32 i = 0; i < Times.Num(); ++i)
+		{
+			const auto Expected = Curve.Eval(Times[i]);
+
+			MaxScalarError = FMath::Max(MaxScalarError, FMath::Abs(CompiledCurve.Eval(Times[i]) - Expected));
+			MaxBatchError = FMath::Max(MaxBatchError, FMath::Abs(BatchValues[i] - Expected));
+		}
+
+		Test.TestTrue(FString::Printf(TEXT("%s: Eval MaxError=%f <= %f"), *CurveName, MaxScalarError, MaxError), MaxScalarError <= MaxError);
+		Test.TestTrue(FString::Printf(TEXT("%s: EvalBatch MaxError=%f <= %f"), *CurveName, MaxBatchError, MaxError), MaxBatchError <= MaxError);
+	}
+
+	void TestSampledCurve(FAutomationTestBase& Test, const FString& CurveName, const FRichCurve& Curve)
+	{
+		FPGCompiledCurve CompiledCurve;
+
+		Test.TestTrue(FString::Printf(TEXT("%s: Compile"), *CurveName), CompiledCurve.Compile(Curve, Tolerance));
+		Test.TestTrue(FString::Printf(TEXT("%s: IsSampled"), *CurveName), CompiledCurve.IsSampled());
+
+		float MinValue, MaxValue;
+		Curve.GetValueRange(MinValue, MaxValue);
+
+		TestAgainstSource(Test, CurveName, CompiledCurve, Curve, Tolerance * FMath::Max(1.0f, MaxValue - MinValue));
+	}
+
+	void TestFallbackCurve(FAutomationTestBase& Test, const FString& CurveName, const FRichCurve& Curve)
+	{
+		FPGCompiledCurve CompiledCurve;
+
+		Test.TestFalse(FString::Printf(TEXT("%s: Compile"), *CurveName), CompiledCurve.Compile(Curve, Tolerance));
+		Test.TestTrue(FString::Printf(TEXT("%s: IsValid"), *CurveName), CompiledCurve.IsValid());
+		Test.TestFalse(FString::Printf(TEXT("%s: IsSampled"), *CurveName), CompiledCurve.IsSampled());
+
+		// Evaluates the source curve directly so there is no error
+		TestAgainstSource(Test, CurveName, CompiledCurve, Curve, 0.0f);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPGCompiledCurveSampledTest, "PaperGolf.Core.CompiledCurve.Sampled", PG::TestUtils::AutomationTestFlags)
+
+bool FPGCompiledCurveSampledTest::RunTest(const FString& Parameters)
+{
+	TestSampledCurve(*this, TEXT("PowerFraction"), Curves::PowerFraction());
+	TestSampledCurve(*this, TEXT("PitchAngle"), Curves::PitchAngle());
+	TestSampledCurve(*this, TEXT("ZOffset"), Curves::ZOffset());
+	TestSampledCurve(*this, TEXT("PowerMultiplier"), Curves::PowerMultiplier());
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPGCompiledCurveFallbackTest, "PaperGolf.Core.CompiledCurve.Fallback", PG::TestUtils::AutomationTestFlags)
+
+bool FPGCompiledCurveFallbackTest::RunTest(const FString& Parameters)
+{
+	TestFallbackCurve(*this, TEXT("Stepped"), Curves::Stepped());
+	TestFallbackCurve(*this, TEXT("Cycle"), Curves::Cycle());
+
+	return true;
+}
+
+#endif
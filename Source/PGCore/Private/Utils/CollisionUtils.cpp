@@ -10,11 +10,17 @@
 
 #include "VisualLogger/VisualLogger.h"
 
+#include "EngineUtils.h"
+#include "Components/PrimitiveComponent.h"
+
+#include "Async/ParallelFor.h"
+
 using namespace PG;
 
 namespace
 {
 	FBox DefaultGetAABB(const AActor& Actor);
+	TOptional<FVector> FitGroundPlaneNormal(const CollisionUtils::FGroundProbeResult& Result, const FVector& UpVector);
 }
 
 FBox PG::CollisionUtils::GetAABB(const AActor& Actor)
@@ -110,6 +116,85 @@ void PG::CollisionUtils::ResetActorToGround(const FGroundData& GroundData, AActo
 	Actor.SetActorTransform(FTransform(ResetRotation, ResetLocation), false, nullptr, ETeleportType::ResetPhysics);
 }
 
+TOptional<CollisionUtils::FGroundProbeResult> PG::CollisionUtils::ProbeGround(const UWorld& World, const FGroundProbeParams& Params, const FCollisionQueryParams& QueryParams)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("PG::CollisionUtils::ProbeGround");
+
+	const auto StartOffset = Params.UpVector * Params.StartOffset;
+	const auto EndOffset = Params.UpVector * Params.ProbeDistance;
+
+	// Scene queries are read only so the probes can be traced from worker threads; each task only writes its own hit
+	TArray<FHitResult, TInlineAllocator<8>> HitResults;
+	HitResults.SetNum(Params.Locations.Num());
+
+	ParallelFor(TEXT("PGGroundProbes"), Params.Locations.Num(), FMath::Max(Params.MinBatchSize, 1), [&](int32 Index)
+	{
+		const auto& Location = Params.Locations[Index];
+		World.LineTraceSingleByChannel(HitResults[Index], Location + StartOffset, Location - EndOffset, Params.TraceChannel, QueryParams);
+	});
+
+	FGroundProbeResult Result;
+	Result.HitLocations.Reserve(HitResults.Num());
+
+	FVector NormalSum{ EForceInit::ForceInitToZero };
+
+	for (const auto& HitResult : HitResults)
+	{
+		if (!HitResult.bBlockingHit)
+		{
+			Result.HitLocations.Add({});
+			continue;
+		}
+
+		Result.HitLocations.Add(HitResult.Location);
+		Result.PlaneOrigin += HitResult.Location;
+		NormalSum += HitResult.ImpactNormal;
+		++Result.NumHits;
+	}
+
+	if (Result.NumHits == 0)
+	{
+		return {};
+	}
+
+	Result.PlaneOrigin /= Result.NumHits;
+
+	if (const auto FittedNormal = FitGroundPlaneNormal(Result, Params.UpVector); FittedNormal)
+	{
+		Result.PlaneNormal = *FittedNormal;
+	}
+	else
+	{
+		Result.PlaneNormal = NormalSum.GetSafeNormal(UE_SMALL_NUMBER, Params.UpVector);
+	}
+
+	return Result;
+}
+
+FBox PG::CollisionUtils::GetStaticCollisionBounds(const UWorld& World, ECollisionChannel TraceChannel)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("PG::CollisionUtils::GetStaticCollisionBounds");
+
+	FBox Bounds{ EForceInit::ForceInit };
+
+	for (TActorIterator<AActor> It(const_cast<UWorld*>(&World)); It; ++It)
+	{
+		It->ForEachComponent<UPrimitiveComponent>(false, [&](const UPrimitiveComponent* Component)
+		{
+			if (Component->Mobility == EComponentMobility::Static && Component->IsCollisionEnabled() &&
+				Component->GetCollisionResponseToChannel(TraceChannel) == ECollisionResponse::ECR_Block)
+			{
+				Bounds += Component->Bounds.GetBox();
+			}
+		});
+	}
+
+	UE_LOG(LogPGCore, Log, TEXT("GetStaticCollisionBounds - World=%s; TraceChannel=%d; Bounds=%s"),
+		*World.GetName(), static_cast<int32>(TraceChannel), *Bounds.ToString());
+
+	return Bounds;
+}
+
 namespace
 {
 	FBox DefaultGetAABB(const AActor& Actor)
@@ -122,4 +207,49 @@ namespace
 		// ActorOrigin aligns with the AABB Origin correctly
 		return FBox::BuildAABB(ActorOrigin, BoxExtent);
 	}
+
+	TOptional<FVector> FitGroundPlaneNormal(const CollisionUtils::FGroundProbeResult& Result, const FVector& UpVector)
+	{
+		if (Result.NumHits < 3)
+		{
+			return {};
+		}
+
+		// Fit height along the up vector as a linear function of the two tangent coordinates relative to the centroid, which has no constant term
+		FVector TangentX, TangentY;
+		UpVector.FindBestAxisVectors(TangentX, TangentY);
+
+		double Sxx{}, Sxy{}, Syy{}, Sxh{}, Syh{};
+
+		for (const auto& HitLocation : Result.HitLocations)
+		{
+			if (!HitLocation)
+			{
+				continue;
+			}
+
+			const auto Offset = *HitLocation - Result.PlaneOrigin;
+			const auto X = Offset | TangentX;
+			const auto Y = Offset | TangentY;
+			const auto H = Offset | UpVector;
+
+			Sxx += X * X;
+			Sxy += X * Y;
+			Syy += Y * Y;
+			Sxh += X * H;
+			Syh += Y * H;
+		}
+
+		// Collinear points leave the plane rotation about their line undetermined
+		const auto Determinant = Sxx * Syy - Sxy * Sxy;
+		if (Determinant <= UE_KINDA_SMALL_NUMBER * FMath::Max(1.0, Sxx * Syy))
+		{
+			return {};
+		}
+
+		const auto SlopeX = (Sxh * Syy - Syh * Sxy) / Determinant;
+		const auto SlopeY = (Syh * Sxx - Sxh * Sxy) / Determinant;
+
+		return (UpVector - SlopeX * TangentX - SlopeY * TangentY).GetSafeNormal();
+	}
 }
@@ -0,0 +1,107 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+
+#include "Utils/CommandletUtils.h"
+
+#if WITH_EDITOR
+
+#include "PGCoreLogging.h"
+
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "Engine/LevelStreaming.h"
+#include "Misc/PackageName.h"
+#include "UObject/SavePackage.h"
+
+UWorld* PG::CommandletUtils::LoadWorld(const FString& MapPackageName)
+{
+	auto MapPackage = LoadPackage(nullptr, *MapPackageName, LOAD_None);
+	if (!MapPackage)
+	{
+		return nullptr;
+	}
+
+	auto World = UWorld::FindWorldInPackage(MapPackage);
+	if (!World)
+	{
+		return nullptr;
+	}
+
+	World->AddToRoot();
+	World->WorldType = EWorldType::Editor;
+
+	auto& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Editor);
+	WorldContext.SetCurrentWorld(World);
+
+	if (!World->bIsWorldInitialized)
+	{
+		World->InitWorld(UWorld::InitializationValues()
+			.AllowAudioPlayback(false)
+			.CreatePhysicsScene(true)
+			.CreateNavigation(false)
+			.CreateAISystem(false)
+			.ShouldSimulatePhysics(false)
+			.EnableTraceCollision(true)
+			.SetTransactional(false));
+	}
+
+	// Holes may be split across sublevels so make sure they are all present
+	for (auto StreamingLevel : World->GetStreamingLevels())
+	{
+		if (StreamingLevel)
+		{
+			StreamingLevel->SetShouldBeLoaded(true);
+			StreamingLevel->SetShouldBeVisible(true);
+		}
+	}
+
+	World->UpdateWorldComponents(true, false);
+	World->FlushLevelStreaming(EFlushLevelStreamingType::Full);
+
+	return World;
+}
+
+void PG::CommandletUtils::UnloadWorld(UWorld& World)
+{
+	GEngine->DestroyWorldContext(&World);
+	World.DestroyWorld(false);
+	World.RemoveFromRoot();
+
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+UObject* PG::CommandletUtils::LoadOrCreateAsset(const FString& AssetPackageName, UClass* AssetClass)
+{
+	check(AssetClass);
+
+	const auto AssetName = FPackageName::GetLongPackageAssetName(AssetPackageName);
+
+	// Rebaking a subset of the data keeps the rest
+	if (auto ExistingAsset = StaticLoadObject(AssetClass, nullptr, *FString::Printf(TEXT("%s.%s"), *AssetPackageName, *AssetName), nullptr, LOAD_NoWarn | LOAD_Quiet); ExistingAsset)
+	{
+		return ExistingAsset;
+	}
+
+	auto Package = CreatePackage(*AssetPackageName);
+	return NewObject<UObject>(Package, AssetClass, *AssetName, RF_Public | RF_Standalone);
+}
+
+bool PG::CommandletUtils::SaveAsset(UObject& Asset)
+{
+	auto Package = Asset.GetPackage();
+	check(Package);
+
+	Package->MarkPackageDirty();
+
+	const auto Filename = FPackageName::LongPackageNameToFilename(Package->GetName(), FPackageName::GetAssetPackageExtension());
+
+	FSavePackageArgs SaveArgs;
+	SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+	SaveArgs.Error = GError;
+
+	UE_LOG(LogPGCore, Display, TEXT("SaveAsset: Saving %s"), *Filename);
+
+	return UPackage::SavePackage(Package, &Asset, *Filename, SaveArgs);
+}
+
+#endif
@@ -0,0 +1,188 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+#include "Utils/PGCompiledCurve.h"
+
+#include "Math/VectorRegister.h"
+
+namespace
+{
+	bool IsSupportedExtrapolation(ERichCurveExtrapolation Extrapolation);
+	float GetExtrapolationSlope(const FRealCurve& Curve, ERichCurveExtrapolation Extrapolation, float EndTime, float Direction, float Delta);
+}
+
+bool FPGCompiledCurve::Compile(const FRealCurve& Curve, float Tolerance)
+{
+	Reset();
+
+	SourceCurve = &Curve;
+
+	if (Curve.GetNumKeys() == 0 || !IsSupportedExtrapolation(Curve.PreInfinityExtrap) || !IsSupportedExtrapolation(Curve.PostInfinityExtrap))
+	{
+		return false;
+	}
+
+	Curve.GetTimeRange(MinTime, MaxTime);
+
+	float MinValue, MaxValue;
+	Curve.GetValueRange(MinValue, MaxValue);
+
+	const auto MaxError = Tolerance * FMath::Max(1.0f, MaxValue - MinValue);
+	const auto SlopeDelta = FMath::Max(1.0f, MaxTime - MinTime);
+
+	PreSlope = GetExtrapolationSlope(Curve, Curve.PreInfinityExtrap, MinTime, -1.0f, SlopeDelta);
+	PostSlope = GetExtrapolationSlope(Curve, Curve.PostInfinityExtrap, MaxTime, 1.0f, SlopeDelta);
+
+	for (int32 NumSamples = MinSamples; NumSamples <= MaxSamples; NumSamples *= 2)
+	{
+		Sample(Curve, NumSamples);
+
+		if (GetMaxError(Curve) <= MaxError)
+		{
+			return true;
+		}
+	}
+
+	// Evaluate the source curve instead
+	Samples.Reset();
+
+	return false;
+}
+
+void FPGCompiledCurve::Reset()
+{
+	SourceCurve = nullptr;
+	Samples.Reset();
+	MinTime = MaxTime = InvSampleInterval = PreSlope = PostSlope = 0.0f;
+}
+
+void FPGCompiledCurve::EvalBatch(TConstArrayView<float> InTimes, TArrayView<float> OutValues) const
+{
+	check(InTimes.Num() == OutValues.Num());
+
+	if (!IsSampled())
+	{
+		for (int32 i = 0; i < InTimes.Num(); ++i)
+		{
+			OutValues[i] = Eval(InTimes[i]);
+		}
+		return;
+	}
+
+	constexpr int32 LaneWidth = 4;
+
+	const auto MinTimes = VectorSetFloat1(MinTime);
+	const auto MaxTimes = VectorSetFloat1(MaxTime);
+	const auto InvIntervals = VectorSetFloat1(InvSampleInterval);
+	const auto PreSlopes = VectorSetFloat1(PreSlope);
+	const auto PostSlopes = VectorSetFloat1(PostSlope);
+	const auto Zero = VectorZeroFloat();
+	const int32 MaxIndex = Samples.Num() - 2;
+
+	const int32 NumBatched = InTimes.Num() - InTimes.Num() % LaneWidth;
+
+	for (int32 i = 0; i < NumBatched; i += LaneWidth)
+	{
+		const auto Times = VectorLoad(InTimes.GetData() + i);
+		const auto SampleX = VectorMultiply(VectorSubtract(VectorMin(VectorMax(Times, MinTimes), MaxTimes), MinTimes), InvIntervals);
+
+		alignas(16) float X[LaneWidth];
+		VectorStoreAligned(SampleX, X);
+
+		// Gather is scalar but the rest stays in registers
+		alignas(16) float Lower[LaneWidth], Upper[LaneWidth], Alpha[LaneWidth];
+		for (int32 Lane = 0; Lane < LaneWidth; ++Lane)
+		{
+			const int32 Index = FMath::Min(static_cast<int32>(X[Lane]), MaxIndex);
+			Lower[Lane] = Samples[Index];
+			Upper[Lane] = Samples[Index + 1];
+			Alpha[Lane] = X[Lane] - Index;
+		}
+
+		const auto LowerValues = VectorLoadAligned(Lower);
+		auto Values = VectorMultiplyAdd(VectorSubtract(VectorLoadAligned(Upper), LowerValues), VectorLoadAligned(Alpha), LowerValues);
+
+		// Extrapolation terms are zero inside the key range
+		Values = VectorMultiplyAdd(PreSlopes, VectorMin(VectorSubtract(Times, MinTimes), Zero), Values);
+		Values = VectorMultiplyAdd(PostSlopes, VectorMax(VectorSubtract(Times, MaxTimes), Zero), Values);
+
+		VectorStore(Values, OutValues.GetData() + i);
+	}
+
+	for (int32 i = NumBatched; i < InTimes.Num(); ++i)
+	{
+		OutValues[i] = EvalSampled(InTimes[i]);
+	}
+}
+
+float FPGCompiledCurve::GetMaxError(const FRealCurve& Curve, int32 NumOutsidePoints) const
+{
+	if (!IsValid())
+	{
+		return 0.0f;
+	}
+
+	float MaxError{};
+
+	const auto TestTime = [&](float Time)
+	{
+		MaxError = FMath::Max(MaxError, FMath::Abs(Eval(Time) - Curve.Eval(Time)));
+	};
+
+	for (auto It = Curve.GetKeyHandleIterator(); It; ++It)
+	{
+		TestTime(Curve.GetKeyTime(*It));
+	}
+
+	// Linear interpolation error between samples is largest near the midpoint
+	if (IsSampled() && InvSampleInterval > 0)
+	{
+		const auto SampleInterval = 1.0f / InvSampleInterval;
+		for (int32 i = 0; i < Samples.Num() - 1; ++i)
+		{
+			TestTime(MinTime + (i + 0.5f) * SampleInterval);
+		}
+	}
+
+	const auto OutsideInterval = FMath::Max(1.0f, MaxTime - MinTime) / FMath::Max(1, NumOutsidePoints);
+	for (int32 i = 1; i <= NumOutsidePoints; ++i)
+	{
+		TestTime(MinTime - i * OutsideInterval);
+		TestTime(MaxTime + i * OutsideInterval);
+	}
+
+	return MaxError;
+}
+
+void FPGCompiledCurve::Sample(const FRealCurve& Curve, int32 NumSamples)
+{
+	check(NumSamples >= 2);
+
+	Samples.SetNumUninitialized(NumSamples);
+
+	const auto SampleInterval = (MaxTime - MinTime) / (NumSamples - 1);
+	InvSampleInterval = SampleInterval > 0 ? 1.0f / SampleInterval : 0.0f;
+
+	for (int32 i = 0; i < NumSamples; ++i)
+	{
+		Samples[i] = Curve.Eval(MinTime + i * SampleInterval);
+	}
+}
+
+namespace
+{
+	bool IsSupportedExtrapolation(ERichCurveExtrapolation Extrapolation)
+	{
+		return Extrapolation == RCCE_Constant || Extrapolation == RCCE_Linear || Extrapolation == RCCE_None;
+	}
+
+	float GetExtrapolationSlope(const FRealCurve& Curve, ERichCurveExtrapolation Extrapolation, float EndTime, float Direction, float Delta)
+	{
+		if (Extrapolation != RCCE_Linear)
+		{
+			return 0.0f;
+		}
+
+		// Linear extrapolation is a straight line so any point outside the range gives the slope
+		return (Curve.Eval(EndTime + Direction * Delta) - Curve.Eval(EndTime)) / (Direction * Delta);
+	}
+}
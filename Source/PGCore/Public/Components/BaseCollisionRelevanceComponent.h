@@ -29,6 +29,13 @@ protected:
 	UFUNCTION(BlueprintCallable)
 	void RegisterComponent(UPrimitiveComponent* Component);
 
+	/*
+	* True when no actor or component names are configured so relevance can be decided from the object type alone, e.g. on the physics thread.
+	*/
+	bool IsRelevanceByObjectTypeOnly() const;
+
+	bool IsRelevantObjectType(ECollisionChannel ObjectType) const;
+
 private:
 	UFUNCTION()
 	void OnActorHit(AActor* SelfActor, AActor* OtherActor, FVector NormalImpulse, const FHitResult& Hit);
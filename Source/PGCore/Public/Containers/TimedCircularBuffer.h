@@ -92,6 +92,16 @@ namespace PG
 		T Sum() const requires CircularBufferSumConcept<T>;
 		T Delta() const requires CircularBufferDifferenceConcept<T>;
 
+		/*
+		* Oldest value in the buffer, which is the one replaced by the next Add when full. Buffer must not be empty.
+		*/
+		const T& Oldest() const;
+
+		/*
+		* Most recently added value. Buffer must not be empty.
+		*/
+		const T& Newest() const;
+
 		template<typename TThreshold, typename TFunc = TDefaultThresholdFunc>
 		bool IsZero(const TThreshold& Threshold = {}, const TFunc& Func = {}) const
 			requires CircularBufferSumConcept<T> && CircularBufferMangitudeConcept<T, TFunc, TThreshold>;
@@ -157,6 +167,22 @@ namespace PG
 		return Count % Capacity();
 	}
 
+	template<typename T, typename TDefaultValueFunc, typename TDefaultThresholdFunc> requires CircularBufferConcept<T, TDefaultValueFunc>
+	inline const T& TTimedCircularBuffer<T, TDefaultValueFunc, TDefaultThresholdFunc>::Oldest() const
+	{
+		check(!IsEmpty());
+
+		return Buffer[IsFull() ? NextIndex() : 0];
+	}
+
+	template<typename T, typename TDefaultValueFunc, typename TDefaultThresholdFunc> requires CircularBufferConcept<T, TDefaultValueFunc>
+	inline const T& TTimedCircularBuffer<T, TDefaultValueFunc, TDefaultThresholdFunc>::Newest() const
+	{
+		check(!IsEmpty());
+
+		return Buffer[(Count - 1) % Capacity()];
+	}
+
 	template<typename T, typename TDefaultValueFunc, typename TDefaultThresholdFunc> requires CircularBufferConcept<T, TDefaultValueFunc>
 	template<typename TThreshold, typename TFunc>
 	inline bool TTimedCircularBuffer<T, TDefaultValueFunc, TDefaultThresholdFunc>::IsZero(const TThreshold& Threshold, const TFunc& Func) const
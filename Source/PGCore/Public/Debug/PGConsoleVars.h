@@ -21,6 +21,8 @@ namespace PG
 	extern PGCORE_API TAutoConsoleVariable<float> CGlobalMinPowerMultiplier;
 	extern PGCORE_API TAutoConsoleVariable<float> CGlobalPowerAccuracyExponent;
 
+	extern PGCORE_API TAutoConsoleVariable<int32> CPredictedFlight;
+
 	namespace GameMode
 	{
 		extern PGCORE_API TAutoConsoleVariable<int32> CAllowBots;
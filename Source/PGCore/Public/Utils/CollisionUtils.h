@@ -22,6 +22,48 @@ namespace PG::CollisionUtils
 	PGCORE_API TOptional<FGroundData> GetGroundData(const AActor& Actor, const TOptional<FVector>& PositionOverride = {});
 
 	PGCORE_API void ResetActorToGround(const FGroundData& GroundData, AActor& Actor, float AdditionalZOffset = 0.0f);
+
+	struct FGroundProbeParams
+	{
+		TConstArrayView<FVector> Locations{};
+		FVector UpVector{ FVector::UpVector };
+
+		// Each probe starts this far above its location along UpVector
+		double StartOffset{};
+		double ProbeDistance{ 2000.0 };
+
+		ECollisionChannel TraceChannel{ ECollisionChannel::ECC_Visibility };
+
+		// Probes are traced in parallel in batches of at least this many. Set to at least the number of locations to trace on the calling thread
+		int32 MinBatchSize{ 4 };
+	};
+
+	struct PGCORE_API FGroundProbeResult
+	{
+		// Hit location for each of FGroundProbeParams::Locations in the same order, unset where the probe missed
+		TArray<TOptional<FVector>, TInlineAllocator<8>> HitLocations{};
+
+		// Centroid of the hit locations
+		FVector PlaneOrigin{ EForceInit::ForceInitToZero };
+
+		// Least squares fit through the hit locations, or the average hit normal if there are fewer than three hits or they are collinear
+		FVector PlaneNormal{ FVector::UpVector };
+
+		int32 NumHits{};
+
+		FPlane GetPlane() const { return FPlane(PlaneOrigin, PlaneNormal); }
+	};
+
+	/*
+	* Probes the ground below all the locations with a single shared query setup, tracing them in parallel, and fits a plane to the hits.
+	* Returns an unset optional if none of the probes hit.
+	*/
+	PGCORE_API TOptional<FGroundProbeResult> ProbeGround(const UWorld& World, const FGroundProbeParams& Params, const FCollisionQueryParams& QueryParams);
+
+	/*
+	* Bounds of all the static primitives in the world that block the given channel. Iterates every actor so cache the result.
+	*/
+	PGCORE_API FBox GetStaticCollisionBounds(const UWorld& World, ECollisionChannel TraceChannel);
 }
 
 namespace PG::CollisionChannel
@@ -0,0 +1,41 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <concepts>
+
+#if WITH_EDITOR
+
+/*
+* Helpers shared by the commandlets that bake per course data offline.
+*/
+namespace PG::CommandletUtils
+{
+	/*
+	* Loads the map package into an initialized editor world with collision and all streaming levels loaded but without simulating.
+	*/
+	PGCORE_API UWorld* LoadWorld(const FString& MapPackageName);
+
+	PGCORE_API void UnloadWorld(UWorld& World);
+
+	PGCORE_API UObject* LoadOrCreateAsset(const FString& AssetPackageName, UClass* AssetClass);
+
+	template<std::derived_from<UObject> T>
+	T* LoadOrCreateAsset(const FString& AssetPackageName);
+
+	PGCORE_API bool SaveAsset(UObject& Asset);
+}
+
+#pragma region Template Definitions
+
+template<std::derived_from<UObject> T>
+inline T* PG::CommandletUtils::LoadOrCreateAsset(const FString& AssetPackageName)
+{
+	return CastChecked<T>(LoadOrCreateAsset(AssetPackageName, T::StaticClass()));
+}
+
+#pragma endregion Template Definitions
+
+#endif
@@ -0,0 +1,97 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Curves/RealCurve.h"
+
+/*
+* Uniformly sampled copy of an FRealCurve for evaluating on hot paths without the key search in FRealCurve::Eval.
+* Values between samples are linearly interpolated and the sample count is doubled until every sample interval matches the source curve within the tolerance.
+* Constant and linear extrapolation are supported. If the curve cannot be sampled within the tolerance, e.g. it has stepped keys or cycles,
+* evaluation falls back to the source curve.
+*/
+class PGCORE_API FPGCompiledCurve
+{
+public:
+	static constexpr int32 MinSamples = 64;
+	static constexpr int32 MaxSamples = 4096;
+
+	/*
+	* Samples Curve so that the max error relative to the curve's value range is within Tolerance.
+	* The source curve is referenced for the fallback so it must outlive this object.
+	* Returns false if the curve could not be sampled within the tolerance.
+	*/
+	bool Compile(const FRealCurve& Curve, float Tolerance = 1e-3f);
+
+	void Reset();
+
+	/*
+	* Whether there is a curve to evaluate, either sampled or falling back to the source.
+	*/
+	bool IsValid() const { return SourceCurve != nullptr; }
+
+	bool IsSampled() const { return !Samples.IsEmpty(); }
+
+	int32 GetNumSamples() const { return Samples.Num(); }
+
+	float Eval(float InTime) const;
+
+	/*
+	* Evaluates four inputs at a time with SIMD.
+	*/
+	void EvalBatch(TConstArrayView<float> InTimes, TArrayView<float> OutValues) const;
+
+	/*
+	* Max absolute difference from FRealCurve::Eval at the keys, the midpoint between each pair of samples and NumOutsidePoints beyond each end of the key range.
+	*/
+	float GetMaxError(const FRealCurve& Curve, int32 NumOutsidePoints = 8) const;
+
+private:
+	float EvalSampled(float InTime) const;
+
+	void Sample(const FRealCurve& Curve, int32 NumSamples);
+
+private:
+	const FRealCurve* SourceCurve{};
+
+	TArray<float> Samples{};
+
+	float MinTime{};
+	float MaxTime{};
+	float InvSampleInterval{};
+
+	// Zero for constant extrapolation
+	float PreSlope{};
+	float PostSlope{};
+};
+
+#pragma region Inline Definitions
+
+FORCEINLINE float FPGCompiledCurve::Eval(float InTime) const
+{
+	checkSlow(IsValid());
+
+	return IsSampled() ? EvalSampled(InTime) : SourceCurve->Eval(InTime);
+}
+
+FORCEINLINE float FPGCompiledCurve::EvalSampled(float InTime) const
+{
+	if (InTime <= MinTime)
+	{
+		return Samples[0] + PreSlope * (InTime - MinTime);
+	}
+
+	if (InTime >= MaxTime)
+	{
+		return Samples.Last() + PostSlope * (InTime - MaxTime);
+	}
+
+	const float X = (InTime - MinTime) * InvSampleInterval;
+	const int32 Index = FMath::Min(static_cast<int32>(X), Samples.Num() - 2);
+
+	return FMath::Lerp(Samples[Index], Samples[Index + 1], X - Index);
+}
+
+#pragma endregion Inline Definitions
@@ -0,0 +1,35 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace PG::TestUtils
+{
+	inline constexpr auto AutomationTestFlags = EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter;
+
+	/*
+	* Defaults of the game properties that the tests run against. These need to be kept in sync with the properties named on each.
+	*/
+	namespace Defaults
+	{
+		// UGolfAIShotComponent::CompiledCurveTolerance
+		inline constexpr float CompiledCurveTolerance = 1e-3f;
+
+		// APaperGolfPawn::NumSamples
+		inline constexpr int32 MotionHistorySamples = 25;
+
+		// APaperGolfPawn::MinDistanceThreshold
+		inline constexpr double PerpetualMotionMaxDisplacement = 10.0;
+
+		// APaperGolfPawn::FlickPredictionCacheMaxEntries and FlickPredictionCacheMaxAge
+		inline constexpr int32 FlickPredictionCacheMaxEntries = 64;
+		inline constexpr float FlickPredictionCacheMaxAge = 0.5f;
+	}
+}
+
+#endif
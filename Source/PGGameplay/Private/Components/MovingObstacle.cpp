@@ -4,6 +4,8 @@
 #include "Components/MovingObstacle.h"
 #include "Components/AudioComponent.h"
 
+#include "Subsystems/MovingObstacleSubsystem.h"
+
 #include "VisualLogger/VisualLogger.h"
 #include "Utils/VisualLoggerUtils.h"
 #include "Logging/LoggingUtils.h"
@@ -13,7 +15,8 @@
 
 AMovingObstacle::AMovingObstacle()
 {
-	PrimaryActorTick.bCanEverTick = true;
+	// Moved by UMovingObstacleSubsystem
+	PrimaryActorTick.bCanEverTick = false;
 	bReplicates = true;
 
 	RootComponent=CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
@@ -56,6 +59,11 @@ void AMovingObstacle::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
 	UE_VLOG_UELOG(this, LogPGGameplay, Log, TEXT("%s: EndPlay - %s"), *GetName(), *LoggingUtils::GetName(EndPlayReason));
 
+	if (auto MovingObstacleSubsystem = GetWorld()->GetSubsystem<UMovingObstacleSubsystem>(); MovingObstacleSubsystem)
+	{
+		MovingObstacleSubsystem->UnregisterObstacle(*this);
+	}
+
 	Super::EndPlay(EndPlayReason);
 
 #if ENABLE_VISUAL_LOG
@@ -63,33 +71,28 @@ void AMovingObstacle::EndPlay(const EEndPlayReason::Type EndPlayReason)
 #endif
 }
 
-void AMovingObstacle::EnableTick(bool bEnabled)
-{
-	UE_VLOG_UELOG(this, LogPGGameplay, Log, TEXT("%s: EnableTick - bEnabled=%s"), *GetName(), LoggingUtils::GetBoolString(bEnabled));
-
-	PrimaryActorTick.SetTickFunctionEnable(bEnabled);
-}
-
 void AMovingObstacle::Init()
 {
 	UE_VLOG_UELOG(this, LogPGGameplay, Log, TEXT("%s: Init"), *GetName());
 
-	// Only tick on the server as we will replicate the movement down to clients
-	EnableTick(HasAuthority());
-
 	check(staticMesh);
-	staticMesh->SetIsReplicated(true);
+	check(movementPath);
 
-	// Only enable collision on server and let the collision response replicate to clients
-	if (HasAuthority())
+	const auto& RelativeTransform = staticMesh->GetRelativeTransform();
+	InitialRelativeLocation = RelativeTransform.GetLocation();
+	InitialRelativeRotation = RelativeTransform.GetRotation();
+
+	// Only simulate collision on server and let the collision response replicate to clients.
+	// Queries stay enabled so the shot preview can sweep against the obstacle
+	if (!HasAuthority())
 	{
-		const auto& RelativeTransform = staticMesh->GetRelativeTransform();
-		InitialRelativeLocation = RelativeTransform.GetLocation();
-		InitialRelativeRotation = RelativeTransform.GetRotation();
+		staticMesh->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
 	}
-	else
+
+	// Position is derived from the match time on every machine so the movement does not need to replicate
+	if (auto MovingObstacleSubsystem = GetWorld()->GetSubsystem<UMovingObstacleSubsystem>(); ensure(MovingObstacleSubsystem))
 	{
-		staticMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		MovingObstacleSubsystem->RegisterObstacle(*this, *movementPath, GetMotion());
 	}
 
 	PlayAudioIfValid();
@@ -117,50 +120,17 @@ void AMovingObstacle::PlayAudioIfValid()
 	}
 }
 
-void AMovingObstacle::Tick(float DeltaTime)
-{
-	Super::Tick(DeltaTime);
-
-	SetDistance();
-	EvaluatePosition();
-}
-
-void AMovingObstacle::EvaluatePosition()
+FMovingObstacleMotion AMovingObstacle::GetMotion() const
 {
-	const auto AdjustedDistance = bReverseDirection ? movementPath->GetSplineLength() - distance : distance;
-	const auto& SplineTransform = movementPath->GetTransformAtDistanceAlongSpline(AdjustedDistance, ESplineCoordinateSpace::World);
-	// Preserve local transform of static mesh
-	const auto& LocalTransform = staticMesh->GetRelativeTransform();
-
-	// Combine the local transform with the spline transform
-	FTransform UpdatedTransform = staticMesh->GetComponentTransform();
-	UpdatedTransform.SetLocation(SplineTransform.GetLocation() + InitialRelativeLocation);
-	UpdatedTransform.SetRotation(InitialRelativeRotation * SplineTransform.GetRotation());
-
-	// Set the final world transform of the static mesh
-	staticMesh->SetWorldTransform(UpdatedTransform);
-}
-
-void AMovingObstacle::SetDistance()
-{
-	if (distance >= movementPath->GetSplineLength())
-	{
-		if (!movementPath->IsClosedLoop())
-		{
-			valueToAdd = -1;
-		}
-		else
-		{
-			distance = 0;
-		}
-	}
-
-	if (distance <= 0)
+	// The mesh keeps its placement relative to the path
+	return FMovingObstacleMotion
 	{
-		valueToAdd = 1;
-	}
-
-	distance+=valueToAdd*speed;
+		.StartDistance = distance,
+		.SpeedPerSecond = speed * SpeedReferenceFrameRate,
+		.MeshOffset = InitialRelativeLocation,
+		.MeshRotation = InitialRelativeRotation,
+		.bReverseDirection = bReverseDirection
+	};
 }
 
 #pragma region Visual Logger
@@ -171,7 +141,14 @@ void AMovingObstacle::GrabDebugSnapshot(FVisualLogEntry* Snapshot) const
 	FVisualLogStatusCategory Category;
 	Category.Category = FString::Printf(TEXT("MovingObstacle (%s)"), *GetName());
 
-	Category.Add("Distance", FString::Printf(TEXT("%.1f"), distance));
+	if (auto MovingObstacleSubsystem = GetWorld()->GetSubsystem<UMovingObstacleSubsystem>(); MovingObstacleSubsystem)
+	{
+		if (const auto PathDistance = MovingObstacleSubsystem->GetPathDistanceAtTime(*this, MovingObstacleSubsystem->GetObstacleTime()); PathDistance)
+		{
+			Category.Add("Distance", FString::Printf(TEXT("%.1f"), *PathDistance));
+		}
+	}
+
 	Category.Add("Speed", FString::Printf(TEXT("%.1f"), speed));
 	Category.Add("ReverseDirection", LoggingUtils::GetBoolString(bReverseDirection));
 
@@ -8,6 +8,7 @@
 #include "State/PaperGolfGameStateBase.h"
 
 #include "Subsystems/GolfEventsSubsystem.h"
+#include "Subsystems/FocusableActorRegistrySubsystem.h"
 
 #include "Components/OverlapConditionComponent.h"
 
@@ -59,11 +60,21 @@ AGolfHole* AGolfHole::GetCurrentHole(const UObject* WorldContextObject)
 		return nullptr;
 	}
 
-	const auto GolfHoles = GetAllWorldHoles(WorldContextObject, false);
-
 	check(GameState);
 
 	const auto CurrentHoleNumber = GameState->GetCurrentHoleNumber();
+
+	// Holes register on BeginPlay so only fall back to searching the world if the hole hasn't begun play yet
+	if (auto FocusableActorRegistry = World->GetSubsystem<UFocusableActorRegistrySubsystem>(); FocusableActorRegistry)
+	{
+		if (auto RegisteredGolfHole = Cast<AGolfHole>(FocusableActorRegistry->GetHole(CurrentHoleNumber)); RegisteredGolfHole)
+		{
+			return RegisteredGolfHole;
+		}
+	}
+
+	const auto GolfHoles = GetAllWorldHoles(WorldContextObject, false);
+
 	AGolfHole* MatchedGolfHole{};
 
 	for (auto GolfHole : GolfHoles)
@@ -154,6 +165,11 @@ void AGolfHole::BeginPlay()
 
 	UE_VLOG_UELOG(this, LogPGGameplay, Log, TEXT("%s: BeginPlay"), *GetName());
 
+	if (auto FocusableActorRegistry = GetWorld()->GetSubsystem<UFocusableActorRegistrySubsystem>(); ensure(FocusableActorRegistry))
+	{
+		FocusableActorRegistry->RegisterFocusableActor(*this);
+	}
+
 	// listen for hole changes to propagate the collider registration updates, but only on the server
 	if (!HasAuthority())
 	{
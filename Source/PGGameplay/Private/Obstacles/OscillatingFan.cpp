@@ -3,6 +3,8 @@
 
 #include "Obstacles/OscillatingFan.h"
 
+#include "Subsystems/MovingObstacleSubsystem.h"
+
 #include "VisualLogger/VisualLogger.h"
 #include "Logging/LoggingUtils.h"
 #include "Utils/VisualLoggerUtils.h"
@@ -24,6 +26,15 @@ void AOscillatingFan::BeginPlay()
 	// TODO: We should subscribe to game events to disable the force if an end overlap event doesn't happen before the end of the player's turn
 	// or maybe even the end of the hole
 
+	// The oscillation is driven from blueprint so the shot planning can only account for where the fan head is right now
+	if (auto FanHeadMesh = GetFanHeadMesh(); FanHeadMesh)
+	{
+		if (auto MovingObstacleSubsystem = GetWorld()->GetSubsystem<UMovingObstacleSubsystem>(); ensure(MovingObstacleSubsystem))
+		{
+			MovingObstacleSubsystem->RegisterHeldObstacle(*this, *FanHeadMesh);
+		}
+	}
+
 	// regularly draw updates if visual logging is enabled so we can see the obstacle in the visual logger
 #if ENABLE_VISUAL_LOG
 	GetWorldTimerManager().SetTimer(VisualLoggerTimer, FTimerDelegate::CreateWeakLambda(this, [this]()
@@ -35,6 +46,11 @@ void AOscillatingFan::BeginPlay()
 
 void AOscillatingFan::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
+	if (auto MovingObstacleSubsystem = GetWorld()->GetSubsystem<UMovingObstacleSubsystem>(); MovingObstacleSubsystem)
+	{
+		MovingObstacleSubsystem->UnregisterObstacle(*this);
+	}
+
 	Super::EndPlay(EndPlayReason);
 
 #if ENABLE_VISUAL_LOG
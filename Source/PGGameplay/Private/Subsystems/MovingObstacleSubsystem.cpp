@@ -0,0 +1,481 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+
+#include "Subsystems/MovingObstacleSubsystem.h"
+
+#include "Components/MovingObstacle.h"
+#include "Components/SplineComponent.h"
+#include "Components/PrimitiveComponent.h"
+
+#include "Kismet/GameplayStaticsTypes.h"
+
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+
+#include "Logging/LoggingUtils.h"
+#include "VisualLogger/VisualLogger.h"
+#include "PGGameplayLogging.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(MovingObstacleSubsystem)
+
+namespace
+{
+	// Fine enough that the lerp between samples is indistinguishable from evaluating the spline on curved paths
+	constexpr float PathSampleSpacing = 25.0f;
+	constexpr int32 MaxPathSamples = 4096;
+
+	// Inline capacity of the obstacles that can be near a single predicted path
+	constexpr int32 PathCandidateCount = 16;
+}
+
+FString FMovingObstacleSweepHit::ToString() const
+{
+	return FString::Printf(TEXT("Obstacle=%s; Component=%s; Time=%.2fs; PathIndex=%d; Location=%s; ImpactNormal=%s"),
+		*LoggingUtils::GetName(Obstacle.Get()), *LoggingUtils::GetName(Component.Get()), Time, PathIndex, *Location.ToCompactString(), *ImpactNormal.ToCompactString());
+}
+
+void UMovingObstacleSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddUObject(this, &ThisClass::OnWorldPreActorTick);
+}
+
+void UMovingObstacleSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPreActorTick.Remove(PreActorTickHandle);
+	PreActorTickHandle.Reset();
+
+	Entries.Empty();
+	SampleX.Empty();
+	SampleY.Empty();
+	SampleZ.Empty();
+	SampleRotations.Empty();
+	ObstacleComponents.Empty();
+
+	Super::Deinitialize();
+}
+
+void UMovingObstacleSubsystem::RegisterObstacle(AMovingObstacle& Obstacle, const USplineComponent& Path, const FMovingObstacleMotion& Motion)
+{
+	check(IsInGameThread());
+
+	if (const auto Existing = FindEntry(Obstacle); Existing)
+	{
+		RemoveEntry(UE_PTRDIFF_TO_INT32(Existing - Entries.GetData()));
+	}
+
+	auto Mesh = Obstacle.staticMesh.Get();
+	if (!ensureMsgf(Mesh, TEXT("%s: RegisterObstacle - Obstacle=%s has no mesh"), *GetName(), *Obstacle.GetName()))
+	{
+		return;
+	}
+
+	const auto PathLength = Path.GetSplineLength();
+	const auto NumSamples = FMath::Clamp(FMath::CeilToInt32(PathLength / PathSampleSpacing) + 1, 2, MaxPathSamples);
+	const auto SampleSpacing = PathLength / (NumSamples - 1);
+	const auto FirstSample = SampleX.Num();
+
+	SampleX.Reserve(FirstSample + NumSamples);
+	SampleY.Reserve(FirstSample + NumSamples);
+	SampleZ.Reserve(FirstSample + NumSamples);
+	SampleRotations.Reserve(FirstSample + NumSamples);
+
+	FBox PathBounds{ EForceInit::ForceInit };
+
+	for (int32 i = 0; i < NumSamples; ++i)
+	{
+		const auto SampleDistance = FMath::Min(i * SampleSpacing, PathLength);
+		const auto Location = Path.GetLocationAtDistanceAlongSpline(SampleDistance, ESplineCoordinateSpace::World);
+
+		PathBounds += Location;
+
+		SampleX.Add(Location.X);
+		SampleY.Add(Location.Y);
+		SampleZ.Add(Location.Z);
+		SampleRotations.Add(Path.GetQuaternionAtDistanceAlongSpline(SampleDistance, ESplineCoordinateSpace::World));
+	}
+
+	Entries.Add(FObstacleEntry
+	{
+		.Obstacle = &Obstacle,
+		.Component = Mesh,
+		.Motion = Motion,
+		// The mesh may be in any orientation at any point of the path
+		.MotionBounds = PathBounds.ShiftBy(Motion.MeshOffset).ExpandBy(Mesh->Bounds.SphereRadius),
+		.PathLength = PathLength,
+		.SampleSpacing = SampleSpacing,
+		.FirstSample = FirstSample,
+		.NumSamples = NumSamples,
+		.bClosedLoop = Path.IsClosedLoop()
+	});
+
+	UpdateObstacleComponents();
+
+	UE_VLOG_UELOG(this, LogPGGameplay, Log, TEXT("%s: RegisterObstacle - Obstacle=%s; PathLength=%.1fm; NumSamples=%d; SpeedPerSecond=%.1f; StartDistance=%.1f; bClosedLoop=%s; bReverseDirection=%s"),
+		*GetName(), *Obstacle.GetName(), PathLength / 100, NumSamples, Motion.SpeedPerSecond, Motion.StartDistance,
+		LoggingUtils::GetBoolString(Path.IsClosedLoop()), LoggingUtils::GetBoolString(Motion.bReverseDirection));
+
+	// Place it right away so it is not at the start of the path until the next frame
+	const auto& Entry = Entries.Last();
+	const auto Transform = CalculateMeshTransform(Entry, CalculatePathDistance(Entry, GetObstacleTime()));
+	Mesh->SetWorldLocationAndRotation(Transform.GetLocation(), Transform.GetRotation());
+}
+
+void UMovingObstacleSubsystem::RegisterHeldObstacle(AActor& Obstacle, UPrimitiveComponent& Component)
+{
+	check(IsInGameThread());
+
+	if (const auto Existing = FindEntry(Obstacle); Existing)
+	{
+		RemoveEntry(UE_PTRDIFF_TO_INT32(Existing - Entries.GetData()));
+	}
+
+	Entries.Add(FObstacleEntry
+	{
+		.Obstacle = &Obstacle,
+		.Component = &Component,
+		// Covers the component turning about any point inside it
+		.MotionBounds = Component.Bounds.GetBox().ExpandBy(Component.Bounds.SphereRadius),
+		.FirstSample = SampleX.Num()
+	});
+
+	UpdateObstacleComponents();
+
+	UE_VLOG_UELOG(this, LogPGGameplay, Log, TEXT("%s: RegisterHeldObstacle - Obstacle=%s; Component=%s"),
+		*GetName(), *Obstacle.GetName(), *Component.GetName());
+}
+
+void UMovingObstacleSubsystem::UnregisterObstacle(const AActor& Obstacle)
+{
+	check(IsInGameThread());
+
+	if (const auto Entry = FindEntry(Obstacle); Entry)
+	{
+		UE_VLOG_UELOG(this, LogPGGameplay, Log, TEXT("%s: UnregisterObstacle - Obstacle=%s"), *GetName(), *Obstacle.GetName());
+
+		RemoveEntry(UE_PTRDIFF_TO_INT32(Entry - Entries.GetData()));
+	}
+}
+
+double UMovingObstacleSubsystem::GetObstacleTime() const
+{
+	auto World = GetWorld();
+	check(World);
+
+	// Clients offset their world time by the replicated server time so obstacles line up across the session
+	if (const auto GameState = World->GetGameState(); GameState)
+	{
+		return GameState->GetServerWorldTimeSeconds();
+	}
+
+	return World->GetTimeSeconds();
+}
+
+TOptional<FTransform> UMovingObstacleSubsystem::GetObstacleTransformAtTime(const AActor& Obstacle, double Time) const
+{
+	const auto Entry = FindEntry(Obstacle);
+	if (!Entry)
+	{
+		return {};
+	}
+
+	auto Component = Entry->Component.Get();
+	if (!Component)
+	{
+		return {};
+	}
+
+	return CalculateComponentTransformAtTime(*Entry, *Component, Time);
+}
+
+TOptional<float> UMovingObstacleSubsystem::GetPathDistanceAtTime(const AActor& Obstacle, double Time) const
+{
+	const auto Entry = FindEntry(Obstacle);
+	if (!Entry || !Entry->HasPath())
+	{
+		return {};
+	}
+
+	return CalculatePathDistance(*Entry, Time);
+}
+
+TOptional<FMovingObstacleSweepHit> UMovingObstacleSubsystem::SweepSegment(const FVector& Start, const FVector& End, double StartTime, double EndTime, float Radius) const
+{
+	TOptional<FMovingObstacleSweepHit> Result;
+
+	for (const auto& Entry : Entries)
+	{
+		if (auto Hit = SweepEntry(Entry, Start, End, StartTime, EndTime, Radius); Hit && (!Result || Hit->Time < Result->Time))
+		{
+			Result = MoveTemp(Hit);
+		}
+	}
+
+	return Result;
+}
+
+TOptional<FMovingObstacleSweepHit> UMovingObstacleSubsystem::SweepPath(TConstArrayView<FPredictProjectilePathPointData> Path, double LaunchTime, float Radius) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("UMovingObstacleSubsystem::SweepPath");
+
+	if (Path.Num() < 2 || Entries.IsEmpty())
+	{
+		return {};
+	}
+
+	FBox PathBounds{ EForceInit::ForceInit };
+	for (const auto& PathPoint : Path)
+	{
+		PathBounds += PathPoint.Location;
+	}
+	PathBounds = PathBounds.ExpandBy(Radius);
+
+	// Most obstacles are nowhere near the shot so only sweep the segments against the ones that are
+	TArray<const FObstacleEntry*, TInlineAllocator<PathCandidateCount>> Candidates;
+	for (const auto& Entry : Entries)
+	{
+		if (Entry.MotionBounds.Intersect(PathBounds))
+		{
+			Candidates.Add(&Entry);
+		}
+	}
+
+	if (Candidates.IsEmpty())
+	{
+		return {};
+	}
+
+	for (int32 i = 0; i < Path.Num() - 1; ++i)
+	{
+		const auto& SegmentStart = Path[i];
+		const auto& SegmentEnd = Path[i + 1];
+
+		TOptional<FMovingObstacleSweepHit> Result;
+
+		for (auto Entry : Candidates)
+		{
+			if (auto Hit = SweepEntry(*Entry, SegmentStart.Location, SegmentEnd.Location, LaunchTime + SegmentStart.Time, LaunchTime + SegmentEnd.Time, Radius);
+				Hit && (!Result || Hit->Time < Result->Time))
+			{
+				Result = MoveTemp(Hit);
+			}
+		}
+
+		if (Result)
+		{
+			Result->PathIndex = i;
+			return Result;
+		}
+	}
+
+	return {};
+}
+
+void UMovingObstacleSubsystem::OnWorldPreActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+	if (InWorld != GetWorld() || Entries.IsEmpty())
+	{
+		return;
+	}
+
+	// Time does not advance while paused so there is nothing to move
+	const auto Time = GetObstacleTime();
+	if (Time == LastUpdateTime)
+	{
+		return;
+	}
+
+	UpdateObstacles(Time);
+}
+
+void UMovingObstacleSubsystem::UpdateObstacles(double Time)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("UMovingObstacleSubsystem::UpdateObstacles");
+
+	LastUpdateTime = Time;
+
+	for (int32 i = Entries.Num() - 1; i >= 0; --i)
+	{
+		const auto& Entry = Entries[i];
+
+		auto Mesh = Entry.Component.Get();
+		if (!Entry.Obstacle.IsValid() || !Mesh)
+		{
+			RemoveEntry(i);
+			continue;
+		}
+
+		// Held obstacles move themselves
+		if (!Entry.HasPath())
+		{
+			continue;
+		}
+
+		const auto Transform = CalculateMeshTransform(Entry, CalculatePathDistance(Entry, Time));
+		Mesh->SetWorldLocationAndRotation(Transform.GetLocation(), Transform.GetRotation());
+	}
+}
+
+const UMovingObstacleSubsystem::FObstacleEntry* UMovingObstacleSubsystem::FindEntry(const AActor& Obstacle) const
+{
+	return Entries.FindByPredicate([&Obstacle](const FObstacleEntry& Entry) { return Entry.Obstacle.Get() == &Obstacle; });
+}
+
+void UMovingObstacleSubsystem::RemoveEntry(int32 EntryIndex)
+{
+	check(Entries.IsValidIndex(EntryIndex));
+
+	const auto FirstSample = Entries[EntryIndex].FirstSample;
+	const auto NumSamples = Entries[EntryIndex].NumSamples;
+
+	SampleX.RemoveAt(FirstSample, NumSamples, EAllowShrinking::No);
+	SampleY.RemoveAt(FirstSample, NumSamples, EAllowShrinking::No);
+	SampleZ.RemoveAt(FirstSample, NumSamples, EAllowShrinking::No);
+	SampleRotations.RemoveAt(FirstSample, NumSamples, EAllowShrinking::No);
+
+	Entries.RemoveAt(EntryIndex, 1, EAllowShrinking::No);
+
+	for (auto& Entry : Entries)
+	{
+		if (Entry.FirstSample > FirstSample)
+		{
+			Entry.FirstSample -= NumSamples;
+		}
+	}
+
+	UpdateObstacleComponents();
+}
+
+void UMovingObstacleSubsystem::UpdateObstacleComponents()
+{
+	ObstacleComponents.Reset();
+
+	for (const auto& Entry : Entries)
+	{
+		if (auto Component = Entry.Component.Get(); Component)
+		{
+			ObstacleComponents.Add(Component);
+		}
+	}
+}
+
+float UMovingObstacleSubsystem::CalculatePathDistance(const FObstacleEntry& Entry, double Time)
+{
+	const double PathLength = Entry.PathLength;
+	if (PathLength <= 0)
+	{
+		return 0.0f;
+	}
+
+	const auto Travelled = Entry.Motion.StartDistance + Entry.Motion.SpeedPerSecond * Time;
+
+	double Distance;
+	if (Entry.bClosedLoop)
+	{
+		Distance = FMath::Fmod(Travelled, PathLength);
+		if (Distance < 0)
+		{
+			Distance += PathLength;
+		}
+	}
+	else
+	{
+		// Open paths go back and forth so a period covers the path twice
+		const auto Period = 2 * PathLength;
+
+		auto PeriodDistance = FMath::Fmod(Travelled, Period);
+		if (PeriodDistance < 0)
+		{
+			PeriodDistance += Period;
+		}
+
+		Distance = PeriodDistance <= PathLength ? PeriodDistance : Period - PeriodDistance;
+	}
+
+	return static_cast<float>(Entry.Motion.bReverseDirection ? PathLength - Distance : Distance);
+}
+
+FTransform UMovingObstacleSubsystem::CalculateMeshTransform(const FObstacleEntry& Entry, float PathDistance) const
+{
+	const auto SamplePosition = FMath::Clamp(PathDistance / FMath::Max(Entry.SampleSpacing, UE_KINDA_SMALL_NUMBER), 0.0f, static_cast<float>(Entry.NumSamples - 1));
+	const auto LocalIndex = FMath::Min(FMath::FloorToInt32(SamplePosition), Entry.NumSamples - 2);
+	const auto Alpha = SamplePosition - LocalIndex;
+
+	const auto Index = Entry.FirstSample + LocalIndex;
+
+	const FVector PathLocation
+	{
+		FMath::Lerp(SampleX[Index], SampleX[Index + 1], Alpha),
+		FMath::Lerp(SampleY[Index], SampleY[Index + 1], Alpha),
+		FMath::Lerp(SampleZ[Index], SampleZ[Index + 1], Alpha)
+	};
+
+	const auto PathRotation = FQuat::FastLerp(SampleRotations[Index], SampleRotations[Index + 1], Alpha).GetNormalized();
+
+	return FTransform
+	{
+		Entry.Motion.MeshRotation * PathRotation,
+		PathLocation + Entry.Motion.MeshOffset
+	};
+}
+
+FTransform UMovingObstacleSubsystem::CalculateComponentTransformAtTime(const FObstacleEntry& Entry, const UPrimitiveComponent& Component, double Time) const
+{
+	if (!Entry.HasPath())
+	{
+		return Component.GetComponentTransform();
+	}
+
+	auto Transform = CalculateMeshTransform(Entry, CalculatePathDistance(Entry, Time));
+	Transform.SetScale3D(Component.GetComponentScale());
+
+	return Transform;
+}
+
+TOptional<FMovingObstacleSweepHit> UMovingObstacleSubsystem::SweepEntry(const FObstacleEntry& Entry, const FVector& Start, const FVector& End, double StartTime, double EndTime, float Radius) const
+{
+	auto Component = Entry.Component.Get();
+	if (!Component)
+	{
+		return {};
+	}
+
+	FBox SegmentBounds{ EForceInit::ForceInit };
+	SegmentBounds += Start;
+	SegmentBounds += End;
+
+	if (!Entry.MotionBounds.Intersect(SegmentBounds.ExpandBy(Radius)))
+	{
+		return {};
+	}
+
+	// Sweep in the frame of the obstacle so its motion over the segment is folded into the segment.
+	// The component is then queried where it is now instead of moving it to each future pose
+	const auto& CurrentTransform = Component->GetComponentTransform();
+	const auto StartTransform = CalculateComponentTransformAtTime(Entry, *Component, StartTime);
+	const auto EndTransform = CalculateComponentTransformAtTime(Entry, *Component, EndTime);
+
+	const auto SweepStart = CurrentTransform.TransformPosition(StartTransform.InverseTransformPosition(Start));
+	const auto SweepEnd = CurrentTransform.TransformPosition(EndTransform.InverseTransformPosition(End));
+
+	FHitResult HitResult;
+	if (!Component->SweepComponent(HitResult, SweepStart, SweepEnd, FQuat::Identity, FCollisionShape::MakeSphere(Radius)))
+	{
+		return {};
+	}
+
+	const auto HitTime = FMath::Lerp(StartTime, EndTime, static_cast<double>(HitResult.Time));
+	const auto HitTransform = CalculateComponentTransformAtTime(Entry, *Component, HitTime);
+
+	return FMovingObstacleSweepHit
+	{
+		.Obstacle = Entry.Obstacle,
+		.Component = Entry.Component,
+		.ObstacleTransform = HitTransform,
+		.Location = FMath::Lerp(Start, End, static_cast<double>(HitResult.Time)),
+		.ImpactPoint = HitTransform.TransformPosition(CurrentTransform.InverseTransformPosition(HitResult.ImpactPoint)),
+		.ImpactNormal = HitTransform.TransformVectorNoScale(CurrentTransform.InverseTransformVectorNoScale(HitResult.ImpactNormal)),
+		.Time = HitTime
+	};
+}
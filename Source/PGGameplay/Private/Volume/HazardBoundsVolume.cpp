@@ -6,6 +6,7 @@
 #include "Pawn/PaperGolfPawn.h"
 #include "PGTags.h"
 #include "Subsystems/GolfEventsSubsystem.h"
+#include "Subsystems/HazardSpatialIndexSubsystem.h"
 
 #include "Utils/PGAudioUtilities.h"
 #include "Utils/CollisionUtils.h"
@@ -31,6 +32,30 @@ AHazardBoundsVolume::AHazardBoundsVolume()
 	NetDormancy = ENetDormancy::DORM_DormantAll;
 }
 
+void AHazardBoundsVolume::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Register on clients too so their shot previews can query hazards. Collision is disabled there so pass the brush explicitly
+	if (auto HazardIndex = GetWorld()->GetSubsystem<UHazardSpatialIndexSubsystem>(); ensure(HazardIndex))
+	{
+		HazardIndex->RegisterHazard(*this, HazardType, IsPenaltyOnImpact(), { GetBrushComponent() });
+	}
+}
+
+void AHazardBoundsVolume::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (auto World = GetWorld(); World)
+	{
+		if (auto HazardIndex = World->GetSubsystem<UHazardSpatialIndexSubsystem>(); HazardIndex)
+		{
+			HazardIndex->UnregisterHazard(*this);
+		}
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void AHazardBoundsVolume::OnConditionTriggered(APaperGolfPawn& PaperGolfPawn, UGolfEventsSubsystem& GolfEvents)
 {
 	GolfEvents.OnPaperGolfPawnEnteredHazard.Broadcast(&PaperGolfPawn, HazardType);
@@ -13,6 +13,7 @@
 #include "MovingObstacle.generated.h"
 
 class UAudioComponent;
+struct FMovingObstacleMotion;
 
 UCLASS()
 class PGGAMEPLAY_API AMovingObstacle : public AActor, public IVisualLoggerDebugSnapshotInterface
@@ -31,13 +32,19 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	TObjectPtr<USplineComponent> movementPath{};
 
+	/*
+	* Distance along the path at the start of the match.
+	*/
 	UPROPERTY(EditAnywhere)
 	float distance = 0;
 
+	/*
+	* Distance along the path per 1/60th of a second. The obstacle used to move this far every frame so existing paths keep their speed at 60 fps.
+	*/
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	float speed = 1;
 
-	virtual void Tick(float DeltaTime) override;
+	FMovingObstacleMotion GetMotion() const;
 
 #if ENABLE_VISUAL_LOG
 	virtual void GrabDebugSnapshot(FVisualLogEntry* Snapshot) const override;
@@ -49,10 +56,6 @@ protected:
 
 private:
 
-	void EvaluatePosition();
-	void SetDistance();
-
-	void EnableTick(bool bEnabled);
 	void Init();
 
 	void PlayAudioIfValid();
@@ -66,7 +69,7 @@ private:
 	FVector InitialRelativeLocation{ EForceInit::ForceInitToZero };
 	FQuat InitialRelativeRotation{ EForceInit::ForceInit };
 
-	float valueToAdd = 1;
+	static constexpr float SpeedReferenceFrameRate = 60.0f;
 
 	UPROPERTY(EditAnywhere)
 	bool bReverseDirection{};
@@ -0,0 +1,189 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineTypes.h"
+
+#include "MovingObstacleSubsystem.generated.h"
+
+class AMovingObstacle;
+class USplineComponent;
+class UPrimitiveComponent;
+struct FPredictProjectilePathPointData;
+
+/*
+* Everything needed to place a moving obstacle at any time, captured when it registers.
+*/
+struct PGGAMEPLAY_API FMovingObstacleMotion
+{
+	// Distance along the path at time zero
+	float StartDistance{};
+
+	float SpeedPerSecond{};
+
+	// Offset of the obstacle mesh from the path in world space
+	FVector MeshOffset{ EForceInit::ForceInitToZero };
+	FQuat MeshRotation{ EForceInit::ForceInit };
+
+	bool bReverseDirection{};
+};
+
+struct PGGAMEPLAY_API FMovingObstacleSweepHit
+{
+	TWeakObjectPtr<AActor> Obstacle{};
+	TWeakObjectPtr<UPrimitiveComponent> Component{};
+
+	// Pose of the obstacle at the time it is hit
+	FTransform ObstacleTransform{};
+
+	// Center of the swept sphere at the hit
+	FVector Location{ EForceInit::ForceInitToZero };
+	FVector ImpactPoint{ EForceInit::ForceInitToZero };
+	FVector ImpactNormal{ EForceInit::ForceInitToZero };
+
+	double Time{};
+
+	// Path point that the hit segment starts at when sweeping a path
+	int32 PathIndex{ INDEX_NONE };
+
+	FString ToString() const;
+};
+
+/**
+ * Moves all moving obstacles of the world once per frame before the actors tick.
+ * The position on the path is a function of the synchronized match time only, so clients place the obstacles locally
+ * exactly where the server has them without replicating the movement, and any future position can be queried.
+ * Each path is sampled at even arc length intervals on registration and the samples of all obstacles are stored
+ * back to back as separate component arrays so a frame update is a lerp between two samples per obstacle.
+ * Obstacles whose motion is not known in code, such as the Blueprint driven fan heads, can be registered to be held at their current pose.
+ */
+UCLASS()
+class PGGAMEPLAY_API UMovingObstacleSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/*
+	* Samples the path in its current world placement. Registering again replaces the previous samples.
+	*/
+	void RegisterObstacle(AMovingObstacle& Obstacle, const USplineComponent& Path, const FMovingObstacleMotion& Motion);
+
+	/*
+	* Registers a component that moves on its own so it is included in the sweeps. It is predicted to stay where it is.
+	*/
+	void RegisterHeldObstacle(AActor& Obstacle, UPrimitiveComponent& Component);
+
+	void UnregisterObstacle(const AActor& Obstacle);
+
+	/*
+	* Server world time that the obstacle positions are derived from. Synchronized to the server on clients.
+	*/
+	double GetObstacleTime() const;
+
+	/*
+	* World transform of the obstacle mesh at the given obstacle time. Unset if the obstacle is not registered.
+	*/
+	TOptional<FTransform> GetObstacleTransformAtTime(const AActor& Obstacle, double Time) const;
+
+	/*
+	* Distance along the path at the given obstacle time. Unset if the obstacle is not registered or does not follow a path.
+	*/
+	TOptional<float> GetPathDistanceAtTime(const AActor& Obstacle, double Time) const;
+
+	/*
+	* Sweeps a sphere from Start at StartTime to End at EndTime against every obstacle where it will be at that time.
+	* Returns the earliest hit.
+	*/
+	TOptional<FMovingObstacleSweepHit> SweepSegment(const FVector& Start, const FVector& End, double StartTime, double EndTime, float Radius) const;
+
+	/*
+	* Sweeps each segment of a predicted path in turn. The path point times are relative to LaunchTime.
+	*/
+	TOptional<FMovingObstacleSweepHit> SweepPath(TConstArrayView<FPredictProjectilePathPointData> Path, double LaunchTime, float Radius) const;
+
+	int32 GetNumObstacles() const;
+
+	/*
+	* Colliding component of each registered obstacle, e.g. to leave them out of a trajectory prediction that is swept against them separately.
+	* Only valid until the next obstacle registers or unregisters.
+	*/
+	TConstArrayView<const UPrimitiveComponent*> GetObstacleComponents() const;
+
+protected:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+private:
+	struct FObstacleEntry
+	{
+		TWeakObjectPtr<AActor> Obstacle{};
+		TWeakObjectPtr<UPrimitiveComponent> Component{};
+		FMovingObstacleMotion Motion{};
+
+		// Everything the component can touch over its whole motion
+		FBox MotionBounds{ EForceInit::ForceInit };
+
+		float PathLength{};
+		float SampleSpacing{};
+
+		int32 FirstSample{};
+
+		// Zero for held obstacles
+		int32 NumSamples{};
+
+		bool bClosedLoop{};
+
+		bool HasPath() const { return NumSamples > 0; }
+	};
+
+	void OnWorldPreActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+
+	void UpdateObstacles(double Time);
+
+	const FObstacleEntry* FindEntry(const AActor& Obstacle) const;
+	void RemoveEntry(int32 EntryIndex);
+
+	void UpdateObstacleComponents();
+
+	static float CalculatePathDistance(const FObstacleEntry& Entry, double Time);
+	FTransform CalculateMeshTransform(const FObstacleEntry& Entry, float PathDistance) const;
+
+	/*
+	* Mesh transform at the time including the component scale so it can be compared with the current component transform.
+	*/
+	FTransform CalculateComponentTransformAtTime(const FObstacleEntry& Entry, const UPrimitiveComponent& Component, double Time) const;
+
+	TOptional<FMovingObstacleSweepHit> SweepEntry(const FObstacleEntry& Entry, const FVector& Start, const FVector& End, double StartTime, double EndTime, float Radius) const;
+
+private:
+	TArray<FObstacleEntry> Entries{};
+
+	// Arc length samples of all paths in world space. FObstacleEntry::FirstSample indexes into each array
+	TArray<double> SampleX{};
+	TArray<double> SampleY{};
+	TArray<double> SampleZ{};
+	TArray<FQuat> SampleRotations{};
+
+	// Component of each entry. Obstacles unregister when they end play so none of these outlive their entry
+	TArray<const UPrimitiveComponent*> ObstacleComponents{};
+
+	double LastUpdateTime{ -1.0 };
+
+	FDelegateHandle PreActorTickHandle{};
+};
+
+#pragma region Inline Definitions
+
+FORCEINLINE int32 UMovingObstacleSubsystem::GetNumObstacles() const
+{
+	return Entries.Num();
+}
+
+FORCEINLINE TConstArrayView<const UPrimitiveComponent*> UMovingObstacleSubsystem::GetObstacleComponents() const
+{
+	return ObstacleComponents;
+}
+
+#pragma endregion Inline Definitions
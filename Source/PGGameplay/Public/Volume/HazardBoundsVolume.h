@@ -28,6 +28,9 @@ public:
 	virtual bool IsPenaltyOnImpact() const override { return Type == EPaperGolfVolumeOverlapType::Any; }
 
 protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	virtual void OnConditionTriggered(APaperGolfPawn& PaperGolfPawn, UGolfEventsSubsystem& GolfEvents) override;
 	virtual bool CheckEndCondition_Implementation(const APaperGolfPawn* PaperGolfPawn) const override;
 
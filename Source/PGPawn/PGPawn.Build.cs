@@ -37,6 +37,7 @@ public class PGPawn : ModuleRules
 		var enginePrivateDependencyModuleNames = new string[] 
 		{
 			"PhysicsCore",
+			"Chaos",
 		};
 
 		PrivateDependencyModuleNames.AddRange(enginePrivateDependencyModuleNames);
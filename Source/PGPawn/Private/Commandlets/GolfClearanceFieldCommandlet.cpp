@@ -0,0 +1,453 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+
+#include "Commandlets/GolfClearanceFieldCommandlet.h"
+
+#include "Data/GolfClearanceField.h"
+#include "Pawn/PaperGolfPawn.h"
+#include "Components/GolfShotClearanceComponent.h"
+#include "Interfaces/FocusableActor.h"
+
+#include "Logging/LoggingUtils.h"
+#include "PGPawnLogging.h"
+#include "Utils/CollisionUtils.h"
+#include "Utils/CommandletUtils.h"
+
+#include "Engine/World.h"
+#include "Kismet/GameplayStatics.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(GolfClearanceFieldCommandlet)
+
+#if WITH_EDITOR
+namespace
+{
+	struct FClearanceFieldBakeParams
+	{
+		FString MapPackageName{};
+		FString FieldPackageName{};
+		TSubclassOf<APaperGolfPawn> PawnClass{};
+		float CellSize{ 25.0f };
+		float Margin{ 2000.0f };
+		float MaxDistance{ 1000.0f };
+		TArray<int32> HoleNumbers{};
+	};
+
+	struct FClearanceFieldBakeContext
+	{
+		UWorld& World;
+		const APaperGolfPawn& Pawn;
+		float ProbeHalfHeight;
+		FBox StaticCollisionBounds;
+	};
+
+	TOptional<FClearanceFieldBakeParams> ParseBakeParams(const FString& Params);
+
+	TSortedMap<int32, FBox> GatherHoleBounds(UWorld& World);
+
+	FGolfClearanceFieldHole BakeHole(const FClearanceFieldBakeContext& Context, const FClearanceFieldBakeParams& BakeParams, int32 HoleNumber, const FBox& HoleBounds);
+
+	/*
+	* Distance from each cell center to the nearest occupied cell boundary, negative inside occupied cells.
+	*/
+	TArray<int16> ComputeSignedDistances(const TBitArray<>& Occupied, const FIntPoint& Size, float CellSize, float MaxDistance);
+
+	/*
+	* Squared euclidean distance in cells from each cell to the nearest cell where Sites is set.
+	*/
+	TArray<float> ComputeSquaredDistances(const TBitArray<>& Sites, bool bSiteValue, const FIntPoint& Size);
+
+	void DistanceTransform1D(TConstArrayView<float> F, TArrayView<float> OutD, TArray<int32>& V, TArray<float>& Z);
+}
+#endif
+
+UGolfClearanceFieldCommandlet::UGolfClearanceFieldCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+
+	HelpDescription = TEXT("Bakes the shot clearance distance field for a course map");
+	HelpUsage = TEXT("-run=GolfClearanceField -Map=<map package> -Field=<field package> -Pawn=<pawn class> [-CellSize=25] [-Margin=2000] [-MaxDistance=1000] [-Holes=1+2+3]");
+}
+
+int32 UGolfClearanceFieldCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	const auto BakeParams = ParseBakeParams(Params);
+	if (!BakeParams)
+	{
+		UE_LOG(LogPGPawn, Error, TEXT("GolfClearanceField: Invalid arguments. Usage: %s"), *HelpUsage);
+		return 1;
+	}
+
+	auto World = PG::CommandletUtils::LoadWorld(BakeParams->MapPackageName);
+	if (!World)
+	{
+		UE_LOG(LogPGPawn, Error, TEXT("GolfClearanceField: Could not load Map=%s"), *BakeParams->MapPackageName);
+		return 1;
+	}
+
+	auto Field = PG::CommandletUtils::LoadOrCreateAsset<UGolfClearanceField>(BakeParams->FieldPackageName);
+	check(Field);
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParams.ObjectFlags |= RF_Transient;
+
+	// The pawn is only needed for its clearance band and is ignored by the bake queries
+	auto Pawn = World->SpawnActor<APaperGolfPawn>(BakeParams->PawnClass, FTransform::Identity, SpawnParams);
+	auto ClearanceComponent = Pawn ? Pawn->FindComponentByClass<UGolfShotClearanceComponent>() : nullptr;
+
+	if (!ClearanceComponent)
+	{
+		UE_LOG(LogPGPawn, Error, TEXT("GolfClearanceField: Could not spawn Pawn=%s with a clearance component"), *LoggingUtils::GetName(BakeParams->PawnClass));
+
+		if (Pawn)
+		{
+			Pawn->Destroy();
+		}
+		PG::CommandletUtils::UnloadWorld(*World);
+		return 1;
+	}
+
+	const FClearanceFieldBakeContext Context
+	{
+		.World = *World,
+		.Pawn = *Pawn,
+		.ProbeHalfHeight = ClearanceComponent->GetProbeHalfHeight(),
+		.StaticCollisionBounds = PG::CollisionUtils::GetStaticCollisionBounds(*World, PG::CollisionChannel::FlickTraceType)
+	};
+
+	if (!FMath::IsNearlyEqual(Field->GetProbeHalfHeight(), Context.ProbeHalfHeight) || !FMath::IsNearlyEqual(Field->GetMaxDistance(), BakeParams->MaxDistance))
+	{
+		UE_LOG(LogPGPawn, Display, TEXT("GolfClearanceField: Field settings changed from ProbeHalfHeight=%f; MaxDistance=%f - all holes should be rebaked"),
+			Field->GetProbeHalfHeight(), Field->GetMaxDistance());
+	}
+
+	Field->SetProbeHalfHeight(Context.ProbeHalfHeight);
+	Field->SetMaxDistance(BakeParams->MaxDistance);
+
+	const auto StartTimeSeconds = FPlatformTime::Seconds();
+
+	for (const auto& [HoleNumber, HoleBounds] : GatherHoleBounds(*World))
+	{
+		if (!BakeParams->HoleNumbers.IsEmpty() && !BakeParams->HoleNumbers.Contains(HoleNumber))
+		{
+			continue;
+		}
+
+		Field->SetHole(BakeHole(Context, *BakeParams, HoleNumber, HoleBounds));
+	}
+
+	UE_LOG(LogPGPawn, Display, TEXT("GolfClearanceField: Baked %d cell%s in %.1fs"),
+		Field->GetNumCells(), LoggingUtils::Pluralize(Field->GetNumCells()), FPlatformTime::Seconds() - StartTimeSeconds);
+
+	Pawn->Destroy();
+	PG::CommandletUtils::UnloadWorld(*World);
+
+	if (!PG::CommandletUtils::SaveAsset(*Field))
+	{
+		UE_LOG(LogPGPawn, Error, TEXT("GolfClearanceField: Could not save Field=%s"), *BakeParams->FieldPackageName);
+		return 1;
+	}
+
+	return 0;
+#else
+	UE_LOG(LogPGPawn, Error, TEXT("GolfClearanceField: Only supported in editor builds"));
+	return 1;
+#endif
+}
+
+#if WITH_EDITOR
+namespace
+{
+	TOptional<FClearanceFieldBakeParams> ParseBakeParams(const FString& Params)
+	{
+		FClearanceFieldBakeParams BakeParams;
+
+		FString PawnClassPath;
+
+		if (!FParse::Value(*Params, TEXT("Map="), BakeParams.MapPackageName) ||
+			!FParse::Value(*Params, TEXT("Field="), BakeParams.FieldPackageName) ||
+			!FParse::Value(*Params, TEXT("Pawn="), PawnClassPath))
+		{
+			return {};
+		}
+
+		FParse::Value(*Params, TEXT("CellSize="), BakeParams.CellSize);
+		FParse::Value(*Params, TEXT("Margin="), BakeParams.Margin);
+		FParse::Value(*Params, TEXT("MaxDistance="), BakeParams.MaxDistance);
+
+		if (FString HolesString; FParse::Value(*Params, TEXT("Holes="), HolesString))
+		{
+			TArray<FString> HoleStrings;
+			HolesString.ParseIntoArray(HoleStrings, TEXT("+"));
+
+			for (const auto& HoleString : HoleStrings)
+			{
+				BakeParams.HoleNumbers.Add(FCString::Atoi(*HoleString));
+			}
+		}
+
+		BakeParams.PawnClass = LoadClass<APaperGolfPawn>(nullptr, *PawnClassPath);
+
+		// Distances are stored as whole centimeters in an int16
+		if (!BakeParams.PawnClass || BakeParams.CellSize <= 0 || BakeParams.MaxDistance <= 0 || BakeParams.MaxDistance > MAX_int16)
+		{
+			return {};
+		}
+
+		return BakeParams;
+	}
+
+	TSortedMap<int32, FBox> GatherHoleBounds(UWorld& World)
+	{
+		TSortedMap<int32, FBox> HoleBounds;
+
+		TArray<AActor*> InterfaceActors;
+		UGameplayStatics::GetAllActorsWithInterface(&World, UFocusableActor::StaticClass(), InterfaceActors);
+
+		for (auto Actor : InterfaceActors)
+		{
+			const auto HoleNumber = IFocusableActor::Execute_GetHoleNumber(Actor);
+
+			auto Bounds = HoleBounds.Find(HoleNumber);
+			if (!Bounds)
+			{
+				Bounds = &HoleBounds.Add(HoleNumber, FBox{ EForceInit::ForceInit });
+			}
+
+			*Bounds += Actor->GetActorLocation();
+		}
+
+		return HoleBounds;
+	}
+
+	FGolfClearanceFieldHole BakeHole(const FClearanceFieldBakeContext& Context, const FClearanceFieldBakeParams& BakeParams, int32 HoleNumber, const FBox& HoleBounds)
+	{
+		const auto CellSize = BakeParams.CellSize;
+		const auto Bounds = HoleBounds.ExpandBy(FVector{ BakeParams.Margin, BakeParams.Margin, 0.0 });
+
+		FGolfClearanceFieldHole FieldHole
+		{
+			.HoleNumber = HoleNumber,
+			.Origin = FVector2D{ Bounds.Min },
+			.CellSize = CellSize,
+			.Size = FIntPoint
+			{
+				FMath::Max(2, FMath::CeilToInt32((Bounds.Max.X - Bounds.Min.X) / CellSize) + 1),
+				FMath::Max(2, FMath::CeilToInt32((Bounds.Max.Y - Bounds.Min.Y) / CellSize) + 1)
+			}
+		};
+
+		const auto NumCells = FieldHole.GetNumCells();
+
+		const auto& StaticCollisionBounds = Context.StaticCollisionBounds;
+		const auto TraceStartZ = StaticCollisionBounds.IsValid ? StaticCollisionBounds.Max.Z + 100 : Bounds.Max.Z + 100 * 100;
+		const auto TraceEndZ = StaticCollisionBounds.IsValid ? StaticCollisionBounds.Min.Z - 100 : Bounds.Min.Z - 100 * 100;
+
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(GolfClearanceFieldBake), false, &Context.Pawn);
+
+		TArray<TOptional<float>> GroundZs;
+		GroundZs.Reserve(NumCells);
+
+		float MinGroundZ = TNumericLimits<float>::Max();
+		float MaxGroundZ = TNumericLimits<float>::Lowest();
+
+		for (int32 Y = 0; Y < FieldHole.Size.Y; ++Y)
+		{
+			for (int32 X = 0; X < FieldHole.Size.X; ++X)
+			{
+				const auto CellCenter = FieldHole.GetCellCenter(X, Y);
+
+				FHitResult GroundHitResult;
+				if (!Context.World.LineTraceSingleByChannel(GroundHitResult, FVector{ CellCenter, TraceStartZ }, FVector{ CellCenter, TraceEndZ },
+					PG::CollisionChannel::FlickTraceType, QueryParams))
+				{
+					GroundZs.Add({});
+					continue;
+				}
+
+				const auto GroundZ = static_cast<float>(GroundHitResult.ImpactPoint.Z);
+				GroundZs.Add(GroundZ);
+
+				MinGroundZ = FMath::Min(MinGroundZ, GroundZ);
+				MaxGroundZ = FMath::Max(MaxGroundZ, GroundZ);
+			}
+		}
+
+		FieldHole.BaseZ = MinGroundZ <= MaxGroundZ ? MinGroundZ : 0.0f;
+
+		if (MaxGroundZ - FieldHole.BaseZ >= MAX_int16)
+		{
+			UE_LOG(LogPGPawn, Warning, TEXT("GolfClearanceField: HoleNumber=%d - Ground height range %fm is too large and will be clamped"),
+				HoleNumber, (MaxGroundZ - FieldHole.BaseZ) / 100);
+		}
+
+		// Same band as UGolfShotClearanceComponent::IsClearanceNeeded checks above the pawn, whose location is on the ground after snapping
+		const auto HalfHeight = Context.ProbeHalfHeight;
+		const auto ObstacleShape = FCollisionShape::MakeBox(FVector{ CellSize * 0.5, CellSize * 0.5, HalfHeight });
+
+		// Moving obstacles are still checked live at runtime
+		auto ObstacleQueryParams = QueryParams;
+		ObstacleQueryParams.MobilityType = EQueryMobilityType::Static;
+
+		TBitArray<> ObstacleCells(false, NumCells);
+		TBitArray<> HazardCells(false, NumCells);
+		FieldHole.GroundHeights.Reserve(NumCells);
+
+		for (int32 Y = 0; Y < FieldHole.Size.Y; ++Y)
+		{
+			for (int32 X = 0; X < FieldHole.Size.X; ++X)
+			{
+				const auto Index = FieldHole.GetCellIndex(X, Y);
+				const auto& GroundZ = GroundZs[Index];
+
+				if (!GroundZ)
+				{
+					FieldHole.GroundHeights.Add(FGolfClearanceFieldHole::NoGround);
+					continue;
+				}
+
+				FieldHole.GroundHeights.Add(static_cast<int16>(FMath::Clamp(FMath::RoundToInt32(*GroundZ - FieldHole.BaseZ), 0, MAX_int16)));
+
+				const auto CellCenter = FieldHole.GetCellCenter(X, Y);
+
+				ObstacleCells[Index] = Context.World.OverlapAnyTestByChannel(FVector{ CellCenter, *GroundZ + 2 * HalfHeight }, FQuat::Identity,
+					PG::CollisionChannel::StaticObstacleTrace, ObstacleShape, ObstacleQueryParams);
+
+				HazardCells[Index] = Context.World.OverlapAnyTestByObjectType(FVector{ CellCenter, *GroundZ }, FQuat::Identity,
+					PG::CollisionObjectType::Hazard, ObstacleShape, QueryParams);
+			}
+		}
+
+		FieldHole.ObstacleDistances = ComputeSignedDistances(ObstacleCells, FieldHole.Size, CellSize, BakeParams.MaxDistance);
+		FieldHole.HazardDistances = ComputeSignedDistances(HazardCells, FieldHole.Size, CellSize, BakeParams.MaxDistance);
+
+		const auto NumObstacleCells = ObstacleCells.CountSetBits();
+		const auto NumHazardCells = HazardCells.CountSetBits();
+
+		UE_LOG(LogPGPawn, Display, TEXT("GolfClearanceField: HoleNumber=%d - Baked %dx%d cells; Obstacles=%d; Hazards=%d; BaseZ=%f"),
+			HoleNumber, FieldHole.Size.X, FieldHole.Size.Y, NumObstacleCells, NumHazardCells, FieldHole.BaseZ);
+
+		return FieldHole;
+	}
+
+	TArray<int16> ComputeSignedDistances(const TBitArray<>& Occupied, const FIntPoint& Size, float CellSize, float MaxDistance)
+	{
+		const auto OutsideSquaredDistances = ComputeSquaredDistances(Occupied, true, Size);
+		const auto InsideSquaredDistances = ComputeSquaredDistances(Occupied, false, Size);
+
+		const auto NumCells = Size.X * Size.Y;
+
+		TArray<int16> Distances;
+		Distances.Reserve(NumCells);
+
+		for (int32 i = 0; i < NumCells; ++i)
+		{
+			// The surface is taken as half a cell from the center of the nearest cell on the other side
+			const auto Distance = Occupied[i] ?
+				-(FMath::Sqrt(InsideSquaredDistances[i]) - 0.5f) * CellSize :
+				(FMath::Sqrt(OutsideSquaredDistances[i]) - 0.5f) * CellSize;
+
+			Distances.Add(static_cast<int16>(FMath::Clamp(FMath::RoundToInt32(Distance), -FMath::RoundToInt32(MaxDistance), FMath::RoundToInt32(MaxDistance))));
+		}
+
+		return Distances;
+	}
+
+	TArray<float> ComputeSquaredDistances(const TBitArray<>& Sites, bool bSiteValue, const FIntPoint& Size)
+	{
+		// Separable exact transform from Felzenszwalb and Huttenlocher, "Distance Transforms of Sampled Functions": columns then rows
+		constexpr auto Infinity = 1e20f;
+
+		const auto MaxDimension = FMath::Max(Size.X, Size.Y);
+
+		TArray<float> SquaredDistances;
+		SquaredDistances.SetNumUninitialized(Size.X * Size.Y);
+
+		for (int32 i = 0; i < SquaredDistances.Num(); ++i)
+		{
+			SquaredDistances[i] = Sites[i] == bSiteValue ? 0.0f : Infinity;
+		}
+
+		TArray<float> F, D, Z;
+		TArray<int32> V;
+		F.SetNumUninitialized(MaxDimension);
+		D.SetNumUninitialized(MaxDimension);
+		V.SetNumUninitialized(MaxDimension);
+		Z.SetNumUninitialized(MaxDimension + 1);
+
+		for (int32 X = 0; X < Size.X; ++X)
+		{
+			for (int32 Y = 0; Y < Size.Y; ++Y)
+			{
+				F[Y] = SquaredDistances[Y * Size.X + X];
+			}
+
+			DistanceTransform1D(MakeArrayView(F.GetData(), Size.Y), MakeArrayView(D.GetData(), Size.Y), V, Z);
+
+			for (int32 Y = 0; Y < Size.Y; ++Y)
+			{
+				SquaredDistances[Y * Size.X + X] = D[Y];
+			}
+		}
+
+		for (int32 Y = 0; Y < Size.Y; ++Y)
+		{
+			const auto Row = MakeArrayView(SquaredDistances.GetData() + Y * Size.X, Size.X);
+
+			FMemory::Memcpy(F.GetData(), Row.GetData(), Size.X * sizeof(float));
+			DistanceTransform1D(MakeArrayView(F.GetData(), Size.X), Row, V, Z);
+		}
+
+		return SquaredDistances;
+	}
+
+	void DistanceTransform1D(TConstArrayView<float> F, TArrayView<float> OutD, TArray<int32>& V, TArray<float>& Z)
+	{
+		// Unsampled values are large but finite so the intersections below stay finite and are always above the lower bound
+		constexpr auto Bound = TNumericLimits<float>::Max();
+
+		const auto N = F.Num();
+
+		const auto Intersection = [&](int32 Q, int32 P)
+		{
+			return ((F[Q] + Q * Q) - (F[P] + P * P)) / (2.0f * (Q - P));
+		};
+
+		// Lower envelope of the parabolas rooted at each sample
+		int32 K = 0;
+		V[0] = 0;
+		Z[0] = -Bound;
+		Z[1] = Bound;
+
+		for (int32 Q = 1; Q < N; ++Q)
+		{
+			auto S = Intersection(Q, V[K]);
+			while (S <= Z[K])
+			{
+				--K;
+				S = Intersection(Q, V[K]);
+			}
+
+			++K;
+			V[K] = Q;
+			Z[K] = S;
+			Z[K + 1] = Bound;
+		}
+
+		K = 0;
+		for (int32 Q = 0; Q < N; ++Q)
+		{
+			while (Z[K + 1] < Q)
+			{
+				++K;
+			}
+
+			OutD[Q] = FMath::Square(static_cast<float>(Q - V[K])) + F[V[K]];
+		}
+	}
+}
+#endif
@@ -0,0 +1,26 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "GolfClearanceFieldCommandlet.generated.h"
+
+/*
+* Bakes a UGolfClearanceField for a course map. A grid around each hole is traced for ground and the static obstacles and hazards
+* around the pawn's clearance band at each cell are converted to signed distances.
+*
+* Usage: -run=GolfClearanceField -Map=/Game/Maps/Course -Field=/Game/Data/DA_ClearanceField_Course -Pawn=<pawn class path>
+*        [-CellSize=25] [-Margin=2000] [-MaxDistance=1000] [-Holes=1+2+3]
+*/
+UCLASS()
+class UGolfClearanceFieldCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UGolfClearanceFieldCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,436 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+
+#include "Commandlets/GolfFocusVisibilityFieldCommandlet.h"
+
+#include "Data/GolfFocusVisibilityField.h"
+#include "Pawn/PaperGolfPawn.h"
+#include "Components/GolfControllerCommonComponent.h"
+#include "Interfaces/FocusableActor.h"
+#include "Library/PaperGolfTrajectorySolver.h"
+
+#include "Logging/LoggingUtils.h"
+#include "PGPawnLogging.h"
+#include "Utils/CollisionUtils.h"
+#include "Utils/CommandletUtils.h"
+#include "Utils/ObjectUtils.h"
+
+#include "Engine/World.h"
+#include "GameFramework/Controller.h"
+#include "Kismet/GameplayStatics.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(GolfFocusVisibilityFieldCommandlet)
+
+#if WITH_EDITOR
+namespace
+{
+	struct FFocusVisibilityBakeParams
+	{
+		FString MapPackageName{};
+		FString FieldPackageName{};
+		TSubclassOf<AController> ControllerClass{};
+		TSubclassOf<APaperGolfPawn> PawnClass{};
+		float CellSize{ 100.0f };
+		float Margin{ 2000.0f };
+		float DynamicMargin{ 500.0f };
+		TArray<int32> HoleNumbers{};
+	};
+
+	struct FFocusVisibilityBakeContext
+	{
+		UWorld& World;
+		APaperGolfPawn& Pawn;
+		FGolfFocusTraceParams TraceParams;
+		FBox StaticCollisionBounds;
+	};
+
+	struct FBakeFocusActor
+	{
+		AActor* Actor{};
+		FVector Location{ EForceInit::ForceInitToZero };
+		float FocusEndOffset{};
+	};
+
+	TOptional<FFocusVisibilityBakeParams> ParseBakeParams(const FString& Params);
+
+	/*
+	* Focus actors of each hole with the golf hole first.
+	*/
+	TSortedMap<int32, TArray<FBakeFocusActor>> GatherHoleFocusActors(UWorld& World);
+
+	FGolfFocusVisibilityHole BakeHole(const FFocusVisibilityBakeContext& Context, const FFocusVisibilityBakeParams& BakeParams, int32 HoleNumber, TConstArrayView<FBakeFocusActor> FocusActors);
+
+	/*
+	* Whether either of the focus traces from Position passes within DynamicMargin of movable geometry.
+	*/
+	bool IsNearDynamicGeometry(const FFocusVisibilityBakeContext& Context, const FVector& Position, const FBakeFocusActor& FocusActor, float DynamicMargin, const FCollisionQueryParams& QueryParams);
+}
+#endif
+
+UGolfFocusVisibilityFieldCommandlet::UGolfFocusVisibilityFieldCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+
+	HelpDescription = TEXT("Bakes the focus line of sight field for a course map");
+	HelpUsage = TEXT("-run=GolfFocusVisibilityField -Map=<map package> -Field=<field package> -Controller=<controller class> -Pawn=<pawn class> [-CellSize=100] [-Margin=2000] [-DynamicMargin=500] [-Holes=1+2+3]");
+}
+
+int32 UGolfFocusVisibilityFieldCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	const auto BakeParams = ParseBakeParams(Params);
+	if (!BakeParams)
+	{
+		UE_LOG(LogPGPawn, Error, TEXT("GolfFocusVisibilityField: Invalid arguments. Usage: %s"), *HelpUsage);
+		return 1;
+	}
+
+	// Players and bots share the component so either controller has the trace offsets
+	const auto ControllerCDO = BakeParams->ControllerClass->GetDefaultObject<AController>();
+	const auto ControllerCommonComponentTemplate = PG::ObjectUtils::FindDefaultComponentByClass<UGolfControllerCommonComponent>(ControllerCDO);
+
+	if (!ControllerCommonComponentTemplate)
+	{
+		UE_LOG(LogPGPawn, Error, TEXT("GolfFocusVisibilityField: Controller=%s is missing its controller common component"), *LoggingUtils::GetName(BakeParams->ControllerClass));
+		return 1;
+	}
+
+	auto World = PG::CommandletUtils::LoadWorld(BakeParams->MapPackageName);
+	if (!World)
+	{
+		UE_LOG(LogPGPawn, Error, TEXT("GolfFocusVisibilityField: Could not load Map=%s"), *BakeParams->MapPackageName);
+		return 1;
+	}
+
+	auto Field = PG::CommandletUtils::LoadOrCreateAsset<UGolfFocusVisibilityField>(BakeParams->FieldPackageName);
+	check(Field);
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParams.ObjectFlags |= RF_Transient;
+
+	auto Pawn = World->SpawnActor<APaperGolfPawn>(BakeParams->PawnClass, FTransform::Identity, SpawnParams);
+	if (!Pawn)
+	{
+		UE_LOG(LogPGPawn, Error, TEXT("GolfFocusVisibilityField: Could not spawn Pawn=%s"), *LoggingUtils::GetName(BakeParams->PawnClass));
+		PG::CommandletUtils::UnloadWorld(*World);
+		return 1;
+	}
+
+	// Snapping to the ground needs the pawn to be initialized even though the world is never played
+	Pawn->DispatchBeginPlay();
+
+	const FFocusVisibilityBakeContext Context
+	{
+		.World = *World,
+		.Pawn = *Pawn,
+		.TraceParams = ControllerCommonComponentTemplate->GetFocusTraceParams(),
+		.StaticCollisionBounds = PG::CollisionUtils::GetStaticCollisionBounds(*World, PG::CollisionChannel::FlickTraceType)
+	};
+
+	if (!Field->GetTraceParams().Equals(Context.TraceParams))
+	{
+		UE_LOG(LogPGPawn, Display, TEXT("GolfFocusVisibilityField: Trace offsets changed from StartOffset=%f; EndOffset=%f; MaxEndOffset=%f - all holes should be rebaked"),
+			Field->GetTraceParams().StartOffset, Field->GetTraceParams().EndOffset, Field->GetTraceParams().MaxEndOffset);
+	}
+
+	Field->SetTraceParams(Context.TraceParams);
+
+	const auto StartTimeSeconds = FPlatformTime::Seconds();
+
+	for (const auto& [HoleNumber, FocusActors] : GatherHoleFocusActors(*World))
+	{
+		if (!BakeParams->HoleNumbers.IsEmpty() && !BakeParams->HoleNumbers.Contains(HoleNumber))
+		{
+			continue;
+		}
+
+		Field->SetHole(BakeHole(Context, *BakeParams, HoleNumber, FocusActors));
+	}
+
+	UE_LOG(LogPGPawn, Display, TEXT("GolfFocusVisibilityField: Baked %d cell%s in %.1fs"),
+		Field->GetNumCells(), LoggingUtils::Pluralize(Field->GetNumCells()), FPlatformTime::Seconds() - StartTimeSeconds);
+
+	Pawn->Destroy();
+	PG::CommandletUtils::UnloadWorld(*World);
+
+	if (!PG::CommandletUtils::SaveAsset(*Field))
+	{
+		UE_LOG(LogPGPawn, Error, TEXT("GolfFocusVisibilityField: Could not save Field=%s"), *BakeParams->FieldPackageName);
+		return 1;
+	}
+
+	return 0;
+#else
+	UE_LOG(LogPGPawn, Error, TEXT("GolfFocusVisibilityField: Only supported in editor builds"));
+	return 1;
+#endif
+}
+
+#if WITH_EDITOR
+namespace
+{
+	TOptional<FFocusVisibilityBakeParams> ParseBakeParams(const FString& Params)
+	{
+		FFocusVisibilityBakeParams BakeParams;
+
+		FString ControllerClassPath, PawnClassPath;
+
+		if (!FParse::Value(*Params, TEXT("Map="), BakeParams.MapPackageName) ||
+			!FParse::Value(*Params, TEXT("Field="), BakeParams.FieldPackageName) ||
+			!FParse::Value(*Params, TEXT("Controller="), ControllerClassPath) ||
+			!FParse::Value(*Params, TEXT("Pawn="), PawnClassPath))
+		{
+			return {};
+		}
+
+		FParse::Value(*Params, TEXT("CellSize="), BakeParams.CellSize);
+		FParse::Value(*Params, TEXT("Margin="), BakeParams.Margin);
+		FParse::Value(*Params, TEXT("DynamicMargin="), BakeParams.DynamicMargin);
+
+		if (FString HolesString; FParse::Value(*Params, TEXT("Holes="), HolesString))
+		{
+			TArray<FString> HoleStrings;
+			HolesString.ParseIntoArray(HoleStrings, TEXT("+"));
+
+			for (const auto& HoleString : HoleStrings)
+			{
+				BakeParams.HoleNumbers.Add(FCString::Atoi(*HoleString));
+			}
+		}
+
+		BakeParams.ControllerClass = LoadClass<AController>(nullptr, *ControllerClassPath);
+		BakeParams.PawnClass = LoadClass<APaperGolfPawn>(nullptr, *PawnClassPath);
+
+		if (!BakeParams.ControllerClass || !BakeParams.PawnClass || BakeParams.CellSize <= 0 || BakeParams.DynamicMargin < 0)
+		{
+			return {};
+		}
+
+		return BakeParams;
+	}
+
+	TSortedMap<int32, TArray<FBakeFocusActor>> GatherHoleFocusActors(UWorld& World)
+	{
+		TSortedMap<int32, TArray<FBakeFocusActor>> HoleFocusActors;
+
+		TArray<AActor*> InterfaceActors;
+		UGameplayStatics::GetAllActorsWithInterface(&World, UFocusableActor::StaticClass(), InterfaceActors);
+
+		for (auto Actor : InterfaceActors)
+		{
+			auto& FocusActors = HoleFocusActors.FindOrAdd(IFocusableActor::Execute_GetHoleNumber(Actor));
+
+			const FBakeFocusActor FocusActor
+			{
+				.Actor = Actor,
+				.Location = Actor->GetActorLocation(),
+				.FocusEndOffset = IFocusableActor::Execute_GetFocusTraceEndOffset(Actor)
+			};
+
+			// Keeping the hole first means it is never the one dropped when a hole has too many focus actors
+			if (IFocusableActor::Execute_IsHole(Actor))
+			{
+				FocusActors.Insert(FocusActor, 0);
+			}
+			else
+			{
+				FocusActors.Add(FocusActor);
+			}
+		}
+
+		for (auto& [HoleNumber, FocusActors] : HoleFocusActors)
+		{
+			if (FocusActors.Num() > FGolfFocusVisibilityHole::MaxFocusActors)
+			{
+				UE_LOG(LogPGPawn, Warning, TEXT("GolfFocusVisibilityField: HoleNumber=%d - Only the first %d of %d focus actors are baked; the rest are traced live"),
+					HoleNumber, FGolfFocusVisibilityHole::MaxFocusActors, FocusActors.Num());
+
+				FocusActors.SetNum(FGolfFocusVisibilityHole::MaxFocusActors);
+			}
+		}
+
+		return HoleFocusActors;
+	}
+
+	FGolfFocusVisibilityHole BakeHole(const FFocusVisibilityBakeContext& Context, const FFocusVisibilityBakeParams& BakeParams, int32 HoleNumber, TConstArrayView<FBakeFocusActor> FocusActors)
+	{
+		const auto CellSize = BakeParams.CellSize;
+
+		FBox HoleBounds{ EForceInit::ForceInit };
+		for (const auto& FocusActor : FocusActors)
+		{
+			HoleBounds += FocusActor.Location;
+		}
+
+		const auto Bounds = HoleBounds.ExpandBy(FVector{ BakeParams.Margin, BakeParams.Margin, 0.0 });
+
+		FGolfFocusVisibilityHole FieldHole
+		{
+			.HoleNumber = HoleNumber,
+			.Origin = FVector2D{ Bounds.Min },
+			.CellSize = CellSize,
+			.Size = FIntPoint
+			{
+				FMath::CeilToInt32((Bounds.Max.X - Bounds.Min.X) / CellSize) + 1,
+				FMath::CeilToInt32((Bounds.Max.Y - Bounds.Min.Y) / CellSize) + 1
+			}
+		};
+
+		const auto NumCells = FieldHole.GetNumCells();
+		const auto NumFocusActors = FocusActors.Num();
+
+		for (const auto& FocusActor : FocusActors)
+		{
+			FieldHole.FocusActorNames.Add(FocusActor.Actor->GetFName());
+			FieldHole.FocusActorLocations.Add(FocusActor.Location);
+		}
+
+		// Moving obstacles are flagged separately so only static geometry decides the baked line of sight
+		FCollisionQueryParams StaticQueryParams(SCENE_QUERY_STAT(GolfFocusVisibilityBake), false, &Context.Pawn);
+		StaticQueryParams.MobilityType = EQueryMobilityType::Static;
+
+		auto DynamicQueryParams = StaticQueryParams;
+		DynamicQueryParams.MobilityType = EQueryMobilityType::Dynamic;
+
+		const auto MakeFocusQueryParams = [](const FCollisionQueryParams& QueryParams, const FBakeFocusActor& FocusActor)
+		{
+			auto FocusQueryParams = QueryParams;
+			FocusQueryParams.AddIgnoredActor(FocusActor.Actor);
+			return FocusQueryParams;
+		};
+
+		// The graph is from the focus actor locations themselves as that is roughly where the pawn ends up after a shot to it
+		FieldHole.FocusVisibility.SetNumZeroed(NumFocusActors);
+
+		for (int32 From = 0; From < NumFocusActors; ++From)
+		{
+			for (int32 To = 0; To < NumFocusActors; ++To)
+			{
+				auto FocusQueryParams = MakeFocusQueryParams(StaticQueryParams, FocusActors[To]);
+				FocusQueryParams.AddIgnoredActor(FocusActors[From].Actor);
+
+				if (From == To || UGolfControllerCommonComponent::TestLOSToFocus(Context.World, FocusActors[From].Location, FocusActors[To].Location,
+					FocusActors[To].FocusEndOffset, Context.TraceParams, FocusQueryParams))
+				{
+					FieldHole.FocusVisibility[From] |= uint64{ 1 } << To;
+				}
+			}
+		}
+
+		const auto& StaticCollisionBounds = Context.StaticCollisionBounds;
+		const auto TraceStartZ = StaticCollisionBounds.IsValid ? StaticCollisionBounds.Max.Z + 100 : Bounds.Max.Z + 100 * 100;
+		const auto TraceEndZ = StaticCollisionBounds.IsValid ? StaticCollisionBounds.Min.Z - 100 : Bounds.Min.Z - 100 * 100;
+
+		auto& Pawn = Context.Pawn;
+		const auto PawnHalfHeight = Pawn.GetComponentsBoundingBox().GetExtent().Z;
+
+		TArray<TOptional<float>> PawnZs;
+		PawnZs.Reserve(NumCells);
+
+		float MinPawnZ = TNumericLimits<float>::Max();
+		float MaxPawnZ = TNumericLimits<float>::Lowest();
+
+		FieldHole.CellVisibility.SetNumZeroed(NumCells);
+		FieldHole.CellDynamic.SetNumZeroed(NumCells);
+
+		int32 NumDynamic{};
+
+		for (int32 Y = 0; Y < FieldHole.Size.Y; ++Y)
+		{
+			for (int32 X = 0; X < FieldHole.Size.X; ++X)
+			{
+				const auto Index = FieldHole.GetCellIndex(X, Y);
+				const auto CellCenter = FieldHole.GetCellCenter(X, Y);
+
+				// Only sample where the pawn could come to rest
+				FHitResult GroundHitResult;
+				if (!Context.World.LineTraceSingleByChannel(GroundHitResult, FVector{ CellCenter, TraceStartZ }, FVector{ CellCenter, TraceEndZ },
+					PG::CollisionChannel::FlickTraceType, StaticQueryParams) || GroundHitResult.ImpactNormal.Z < PG::Trajectory::LandingMinNormalZ)
+				{
+					PawnZs.Add({});
+					continue;
+				}
+
+				Pawn.SetActorLocation(GroundHitResult.ImpactPoint + FVector::UpVector * PawnHalfHeight, false, nullptr, ETeleportType::ResetPhysics);
+				Pawn.SnapToGround();
+
+				const auto& Position = Pawn.GetActorLocation();
+				const auto PawnZ = static_cast<float>(Position.Z);
+
+				PawnZs.Add(PawnZ);
+				MinPawnZ = FMath::Min(MinPawnZ, PawnZ);
+				MaxPawnZ = FMath::Max(MaxPawnZ, PawnZ);
+
+				for (int32 FocusIndex = 0; FocusIndex < NumFocusActors; ++FocusIndex)
+				{
+					const auto& FocusActor = FocusActors[FocusIndex];
+					const auto FocusBit = uint64{ 1 } << FocusIndex;
+
+					if (UGolfControllerCommonComponent::TestLOSToFocus(Context.World, Position, FocusActor.Location, FocusActor.FocusEndOffset,
+						Context.TraceParams, MakeFocusQueryParams(StaticQueryParams, FocusActor)))
+					{
+						FieldHole.CellVisibility[Index] |= FocusBit;
+					}
+
+					if (IsNearDynamicGeometry(Context, Position, FocusActor, BakeParams.DynamicMargin, MakeFocusQueryParams(DynamicQueryParams, FocusActor)))
+					{
+						FieldHole.CellDynamic[Index] |= FocusBit;
+						++NumDynamic;
+					}
+				}
+			}
+		}
+
+		FieldHole.BaseZ = MinPawnZ <= MaxPawnZ ? MinPawnZ : 0.0f;
+
+		if (MaxPawnZ - FieldHole.BaseZ >= MAX_int16)
+		{
+			UE_LOG(LogPGPawn, Warning, TEXT("GolfFocusVisibilityField: HoleNumber=%d - Pawn height range %fm is too large and will be clamped"),
+				HoleNumber, (MaxPawnZ - FieldHole.BaseZ) / 100);
+		}
+
+		FieldHole.PawnHeights.Reserve(NumCells);
+
+		int32 NumGroundCells{};
+
+		for (const auto& PawnZ : PawnZs)
+		{
+			if (PawnZ)
+			{
+				FieldHole.PawnHeights.Add(static_cast<int16>(FMath::Clamp(FMath::RoundToInt32(*PawnZ - FieldHole.BaseZ), 0, MAX_int16)));
+				++NumGroundCells;
+			}
+			else
+			{
+				FieldHole.PawnHeights.Add(FGolfFocusVisibilityHole::NoGround);
+			}
+		}
+
+		UE_LOG(LogPGPawn, Display, TEXT("GolfFocusVisibilityField: HoleNumber=%d - Baked %dx%d cells to %d focus actor%s; Ground=%d; Dynamic=%d; BaseZ=%f"),
+			HoleNumber, FieldHole.Size.X, FieldHole.Size.Y, NumFocusActors, LoggingUtils::Pluralize(NumFocusActors), NumGroundCells, NumDynamic, FieldHole.BaseZ);
+
+		return FieldHole;
+	}
+
+	bool IsNearDynamicGeometry(const FFocusVisibilityBakeContext& Context, const FVector& Position, const FBakeFocusActor& FocusActor, float DynamicMargin, const FCollisionQueryParams& QueryParams)
+	{
+		// Moving obstacles are baked wherever they happen to be in the editor so the margin has to cover their range of motion
+		const auto Shape = FCollisionShape::MakeSphere(DynamicMargin);
+
+		const auto SweepTest = [&](const FVector& Start, const FVector& End)
+		{
+			return Context.World.SweepTestByChannel(Start, End, FQuat::Identity, PG::CollisionChannel::FlickTraceType, Shape, QueryParams);
+		};
+
+		const auto& TraceParams = Context.TraceParams;
+		const auto SelectedEndOffset = TraceParams.GetSelectedEndOffset(Position.Z - FocusActor.Location.Z, FocusActor.FocusEndOffset);
+
+		return SweepTest(Position, FocusActor.Location) ||
+			SweepTest(Position + FVector::ZAxisVector * TraceParams.StartOffset, FocusActor.Location + FVector::ZAxisVector * SelectedEndOffset);
+	}
+}
+#endif
@@ -0,0 +1,27 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "GolfFocusVisibilityFieldCommandlet.generated.h"
+
+/*
+* Bakes a UGolfFocusVisibilityField for a course map. The pawn is snapped to the ground at each cell of a grid around each hole and the
+* focus line of sight traces of the controller are run against static geometry. Traces that pass within DynamicMargin of movable geometry
+* are flagged to be checked live instead.
+*
+* Usage: -run=GolfFocusVisibilityField -Map=/Game/Maps/Course -Field=/Game/Data/DA_FocusVisibility_Course -Controller=<controller class path> -Pawn=<pawn class path>
+*        [-CellSize=100] [-Margin=2000] [-DynamicMargin=500] [-Holes=1+2+3]
+*/
+UCLASS()
+class UGolfFocusVisibilityFieldCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UGolfFocusVisibilityFieldCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -8,9 +8,247 @@
 #include "PGPawnLogging.h"
 
 #include "Components/StaticMeshComponent.h"
+#include "Curves/CurveFloat.h"
+#include "Engine/World.h"
+#include "Physics/PhysicsFiltering.h"
+
+#include "Chaos/SimCallbackObject.h"
+#include "Chaos/SimCallbackInput.h"
+#include "Chaos/ContactModification.h"
+#include "Chaos/ParticleHandle.h"
+#include "PBDRigidsSolver.h"
+#include "Physics/Experimental/PhysScene_Chaos.h"
+#include "PhysicsProxy/SingleParticlePhysicsProxy.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(CollisionDampeningComponent)
 
+namespace
+{
+	// Contacts are generated ahead of time within the cull distance so only count pairs that are actually touching
+	constexpr float ContactSeparationTolerance = 0.5f;
+
+	Chaos::FPBDRigidParticleHandle* GetRigidParticle_Internal(Chaos::FSingleParticlePhysicsProxy* Proxy);
+	bool IsTouching_Internal(const Chaos::FContactPairModifier& PairModifier);
+	bool IsRelevantParticle_Internal(const Chaos::FGeometryParticleHandle& Particle, uint32 RelevantObjectTypeMask);
+}
+
+struct FCollisionDampeningSimParams
+{
+	// Copies of the curve data as the curve assets cannot be read from the physics thread
+	FRichCurve AngularDampeningCurve{};
+	FRichCurve LinearDampeningCurve{};
+	FRichCurve AngularDampeningRatioCurve{};
+
+	float InitialAngularDampening{};
+	float InitialLinearDampening{};
+	float FlickTimeDelay{};
+	float CollisionTimeRecordDelay{};
+
+	// Bit per ECollisionChannel of the other body
+	uint32 RelevantObjectTypeMask{};
+
+	bool bEnableLinearDampening{};
+	bool bEnableRatioAngularDampening{};
+};
+
+struct FCollisionDampeningSimInput : public Chaos::FSimCallbackInput
+{
+	struct FCommand
+	{
+		Chaos::FSingleParticlePhysicsProxy* Proxy{};
+		FCollisionDampeningSimParams Params{};
+		bool bActivate{};
+	};
+
+	TArray<FCommand> Commands;
+
+	void Reset()
+	{
+		Commands.Reset();
+	}
+};
+
+struct FCollisionDampeningSimOutput : public Chaos::FSimCallbackOutput
+{
+	struct FHit
+	{
+		int32 HitCount{};
+		float AngularDampening{};
+		float LinearDampening{};
+		float AngularVsLinearRatio{};
+	};
+
+	TArray<FHit, TInlineAllocator<4>> Hits;
+
+	void Reset()
+	{
+		Hits.Reset();
+	}
+};
+
+class FCollisionDampeningSimCallback : public Chaos::TSimCallbackObject<
+	FCollisionDampeningSimInput,
+	FCollisionDampeningSimOutput,
+	Chaos::ESimCallbackOptions::Presimulate | Chaos::ESimCallbackOptions::ContactModification>
+{
+public:
+	void AddCommand_External(FCollisionDampeningSimInput::FCommand&& Command)
+	{
+		GetProducerInputData_External()->Commands.Add(MoveTemp(Command));
+	}
+
+private:
+	virtual void OnPreSimulate_Internal() override;
+	virtual void OnContactModification_Internal(Chaos::FCollisionContactModifier& Modifier) override;
+
+	void ApplyCommands_Internal(const FCollisionDampeningSimInput& Input);
+	void ApplyDampening_Internal(Chaos::FPBDRigidParticleHandle& Particle) const;
+
+private:
+	struct FActiveState
+	{
+		Chaos::FSingleParticlePhysicsProxy* Proxy{};
+		FCollisionDampeningSimParams Params{};
+
+		Chaos::FReal ActivationSimTime{};
+		Chaos::FReal LastHitSimTime{};
+
+		// Only compared and never dereferenced
+		const void* LastHitParticle{};
+
+		int32 HitCount{};
+		float AngularDampening{};
+		float LinearDampening{};
+	};
+
+	// Only accessed on the physics thread
+	TOptional<FActiveState> State{};
+};
+
+void FCollisionDampeningSimCallback::OnPreSimulate_Internal()
+{
+	if (const auto Input = GetConsumerInput_Internal(); Input)
+	{
+		ApplyCommands_Internal(*Input);
+	}
+
+	if (!State)
+	{
+		return;
+	}
+
+	// A push of the body's dynamic properties from the game thread would overwrite the drag set here so keep reapplying it
+	if (const auto Particle = GetRigidParticle_Internal(State->Proxy); Particle)
+	{
+		ApplyDampening_Internal(*Particle);
+	}
+}
+
+void FCollisionDampeningSimCallback::OnContactModification_Internal(Chaos::FCollisionContactModifier& Modifier)
+{
+	if (!State)
+	{
+		return;
+	}
+
+	const auto Particle = GetRigidParticle_Internal(State->Proxy);
+	if (!Particle)
+	{
+		return;
+	}
+
+	const auto& Params = State->Params;
+	const auto SimTime = GetSimTime_Internal();
+
+	if (SimTime - State->ActivationSimTime <= Params.FlickTimeDelay)
+	{
+		return;
+	}
+
+	FCollisionDampeningSimOutput* Output{};
+
+	for (auto& PairModifier : Modifier.GetContacts(Particle))
+	{
+		const auto Particles = PairModifier.GetParticlePair();
+		const auto OtherParticle = Particles[0] == Particle ? Particles[1] : Particles[0];
+
+		if (!OtherParticle || !IsTouching_Internal(PairModifier) || !IsRelevantParticle_Internal(*OtherParticle, Params.RelevantObjectTypeMask))
+		{
+			continue;
+		}
+
+		if (OtherParticle == State->LastHitParticle && SimTime - State->LastHitSimTime <= Params.CollisionTimeRecordDelay)
+		{
+			continue;
+		}
+
+		++State->HitCount;
+		State->LastHitSimTime = SimTime;
+		State->LastHitParticle = OtherParticle;
+
+		// Velocities at the step of the contact rather than after the bounce has been resolved
+		const auto LinearSpeed = static_cast<float>(Particle->V().Size());
+		const auto AngularSpeed = FMath::RadiansToDegrees(static_cast<float>(Particle->W().Size()));
+		const auto AngularVsLinearRatio = AngularSpeed / FMath::Max(LinearSpeed, 0.001f);
+
+		State->AngularDampening = Params.InitialAngularDampening * (Params.bEnableRatioAngularDampening ?
+			Params.AngularDampeningRatioCurve.Eval(AngularVsLinearRatio) : Params.AngularDampeningCurve.Eval(State->HitCount));
+		State->LinearDampening = Params.bEnableLinearDampening ?
+			Params.InitialLinearDampening * Params.LinearDampeningCurve.Eval(State->HitCount) : Params.InitialLinearDampening;
+
+		ApplyDampening_Internal(*Particle);
+
+		if (!Output)
+		{
+			Output = &GetProducerOutputData_Internal();
+		}
+
+		Output->Hits.Add(
+		{
+			.HitCount = State->HitCount,
+			.AngularDampening = State->AngularDampening,
+			.LinearDampening = State->LinearDampening,
+			.AngularVsLinearRatio = AngularVsLinearRatio
+		});
+	}
+}
+
+void FCollisionDampeningSimCallback::ApplyCommands_Internal(const FCollisionDampeningSimInput& Input)
+{
+	for (const auto& Command : Input.Commands)
+	{
+		if (!Command.bActivate)
+		{
+			State.Reset();
+			continue;
+		}
+
+		State.Emplace(FActiveState
+		{
+			.Proxy = Command.Proxy,
+			.Params = Command.Params,
+			.ActivationSimTime = GetSimTime_Internal(),
+			.AngularDampening = Command.Params.InitialAngularDampening,
+			.LinearDampening = Command.Params.InitialLinearDampening
+		});
+	}
+}
+
+void FCollisionDampeningSimCallback::ApplyDampening_Internal(Chaos::FPBDRigidParticleHandle& Particle) const
+{
+	check(State);
+
+	// Body instance damping maps directly onto the Chaos ether drag
+	if (Particle.AngularEtherDrag() != State->AngularDampening)
+	{
+		Particle.SetAngularEtherDrag(State->AngularDampening);
+	}
+	if (Particle.LinearEtherDrag() != State->LinearDampening)
+	{
+		Particle.SetLinearEtherDrag(State->LinearDampening);
+	}
+}
+
 UCollisionDampeningComponent::UCollisionDampeningComponent()
 {
 	PrimaryComponentTick.bCanEverTick = false;
@@ -28,6 +266,11 @@ void UCollisionDampeningComponent::OnFlick()
 
 	ResetState();
 	FlickTime = GetWorld()->GetTimeSeconds();
+
+	if (SimCallback)
+	{
+		ActivatePhysicsThreadDampening();
+	}
 }
 
 void UCollisionDampeningComponent::OnShotFinished()
@@ -37,6 +280,22 @@ void UCollisionDampeningComponent::OnShotFinished()
 	DisableCollisionDampening();
 }
 
+void UCollisionDampeningComponent::SetParked(bool bParked)
+{
+	UE_VLOG_UELOG(GetOwner(), LogPGPawn, Log, TEXT("%s-%s: SetParked - bParked=%s"), *LoggingUtils::GetName(GetOwner()), *GetName(), LoggingUtils::GetBoolString(bParked));
+
+	if (bParked)
+	{
+		bRestoreSimCallback = SimCallback != nullptr;
+		UnregisterSimCallback();
+	}
+	else if (bRestoreSimCallback)
+	{
+		bRestoreSimCallback = false;
+		EnsureSimCallback();
+	}
+}
+
 void UCollisionDampeningComponent::BeginPlay()
 {
 	Super::BeginPlay();
@@ -48,6 +307,13 @@ void UCollisionDampeningComponent::BeginPlay()
 	}
 }
 
+void UCollisionDampeningComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UnregisterSimCallback();
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void UCollisionDampeningComponent::RegisterCollisions()
 {
 	if (!ShouldEnableCollisionDampening())
@@ -70,16 +336,21 @@ void UCollisionDampeningComponent::RegisterCollisions()
 
 	OwnerStaticMeshComponent = MyOwner->GetComponentByClass<UStaticMeshComponent>();
 
-	if (OwnerStaticMeshComponent)
-	{
-		RegisterComponent(OwnerStaticMeshComponent);
-	}
-	else
+	if (!OwnerStaticMeshComponent)
 	{
 		UE_VLOG_UELOG(GetOwner(), LogPGPawn, Warning,
 			TEXT("%s-%s: RegisterCollisions - Could not find UStaticMeshComponent to register for hit callback"),
 			*GetName(), *LoggingUtils::GetName(GetOwner()));
 	}
+	else if (ShouldUsePhysicsThreadDampening() && EnsureSimCallback())
+	{
+		UE_VLOG_UELOG(GetOwner(), LogPGPawn, Log, TEXT("%s-%s: RegisterCollisions - Using physics thread contact dampening"),
+			*LoggingUtils::GetName(GetOwner()), *GetName());
+	}
+	else
+	{
+		RegisterComponent(OwnerStaticMeshComponent);
+	}
 }
 
 void UCollisionDampeningComponent::OnNotifyRelevantCollision(UPrimitiveComponent* HitComponent, const FHitResult& Hit, const FVector& NormalImpulse)
@@ -224,6 +495,11 @@ float UCollisionDampeningComponent::GetAngularRatioDampeningValue() const
 void UCollisionDampeningComponent::DisableCollisionDampening()
 {
 	FlickTime = -1.0f;
+
+	if (SimCallback)
+	{
+		SimCallback->AddCommand_External({});
+	}
 }
 
 bool UCollisionDampeningComponent::IsCollisionDampeningActive() const
@@ -236,3 +512,194 @@ bool UCollisionDampeningComponent::ShouldEnableCollisionDampening() const
 	// only register on server
 	return bEnableCollisionDampening && GetOwner() && GetOwner()->HasAuthority();
 }
+
+bool UCollisionDampeningComponent::ShouldUsePhysicsThreadDampening() const
+{
+	return bUsePhysicsThreadDampening && IsRelevanceByObjectTypeOnly();
+}
+
+bool UCollisionDampeningComponent::EnsureSimCallback()
+{
+	if (SimCallback)
+	{
+		return true;
+	}
+
+	auto World = GetWorld();
+	if (!ensure(World))
+	{
+		return false;
+	}
+
+	auto PhysicsScene = World->GetPhysicsScene();
+	if (!PhysicsScene)
+	{
+		return false;
+	}
+
+	auto Solver = PhysicsScene->GetSolver();
+	if (!ensure(Solver))
+	{
+		return false;
+	}
+
+	SimCallback = Solver->CreateAndRegisterSimCallbackObject_External<FCollisionDampeningSimCallback>();
+	if (!SimCallback)
+	{
+		return false;
+	}
+
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &ThisClass::OnWorldPostActorTick);
+
+	return true;
+}
+
+void UCollisionDampeningComponent::UnregisterSimCallback()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	PostActorTickHandle.Reset();
+
+	if (!SimCallback)
+	{
+		return;
+	}
+
+	if (auto World = GetWorld(); World && World->GetPhysicsScene())
+	{
+		if (auto Solver = World->GetPhysicsScene()->GetSolver(); Solver)
+		{
+			Solver->UnregisterAndFreeSimCallbackObject_External(SimCallback);
+		}
+	}
+
+	SimCallback = nullptr;
+}
+
+void UCollisionDampeningComponent::ActivatePhysicsThreadDampening()
+{
+	check(SimCallback);
+	check(OwnerStaticMeshComponent);
+
+	const auto BodyInstance = OwnerStaticMeshComponent->GetBodyInstance();
+	const auto Proxy = BodyInstance ? BodyInstance->GetPhysicsActorHandle() : nullptr;
+
+	if (!Proxy)
+	{
+		UE_VLOG_UELOG(GetOwner(), LogPGPawn, Warning, TEXT("%s-%s: ActivatePhysicsThreadDampening - No physics proxy for %s so dampening is disabled for this shot"),
+			*LoggingUtils::GetName(GetOwner()), *GetName(), *OwnerStaticMeshComponent->GetName());
+		return;
+	}
+
+	FCollisionDampeningSimParams Params
+	{
+		.InitialAngularDampening = InitialAngularDampening,
+		.InitialLinearDampening = InitialLinearDampening,
+		.FlickTimeDelay = FlickTimeDelay,
+		.CollisionTimeRecordDelay = CollisionTimeRecordDelay,
+		.RelevantObjectTypeMask = GetRelevantObjectTypeMask(),
+		.bEnableLinearDampening = bEnableLinearDampening,
+		.bEnableRatioAngularDampening = bEnableRatioAngularDampening
+	};
+
+	if (AngularDampeningCurve)
+	{
+		Params.AngularDampeningCurve = AngularDampeningCurve->FloatCurve;
+	}
+	if (LinearDampeningCurve)
+	{
+		Params.LinearDampeningCurve = LinearDampeningCurve->FloatCurve;
+	}
+	if (AngularDampeningRatioCurve)
+	{
+		Params.AngularDampeningRatioCurve = AngularDampeningRatioCurve->FloatCurve;
+	}
+
+	SimCallback->AddCommand_External(
+	{
+		.Proxy = Proxy,
+		.Params = MoveTemp(Params),
+		.bActivate = true
+	});
+}
+
+uint32 UCollisionDampeningComponent::GetRelevantObjectTypeMask() const
+{
+	uint32 Mask{};
+
+	for (int32 Channel = 0; Channel < 32; ++Channel)
+	{
+		if (IsRelevantObjectType(static_cast<ECollisionChannel>(Channel)))
+		{
+			Mask |= 1u << Channel;
+		}
+	}
+
+	return Mask;
+}
+
+void UCollisionDampeningComponent::OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+	if (InWorld != GetWorld() || !SimCallback)
+	{
+		return;
+	}
+
+	while (const auto Output = SimCallback->PopOutputData_External())
+	{
+		for (const auto& Hit : Output->Hits)
+		{
+			UE_VLOG_UELOG(GetOwner(), LogPGPawn, Log, TEXT("%s-%s: OnWorldPostActorTick - Physics thread hit: HitCount=%d; AngularDampening=%f; LinearDampening=%f; AvsL=%f"),
+				*LoggingUtils::GetName(GetOwner()), *GetName(), Hit.HitCount, Hit.AngularDampening, Hit.LinearDampening, Hit.AngularVsLinearRatio);
+
+			HitCount = Hit.HitCount;
+
+			// Mirror without pushing back to the physics thread so that game thread reads and later pushes of the body properties agree
+			if (auto BodyInstance = OwnerStaticMeshComponent ? OwnerStaticMeshComponent->GetBodyInstance() : nullptr; BodyInstance)
+			{
+				BodyInstance->AngularDamping = Hit.AngularDampening;
+				BodyInstance->LinearDamping = Hit.LinearDampening;
+			}
+		}
+	}
+}
+
+namespace
+{
+	Chaos::FPBDRigidParticleHandle* GetRigidParticle_Internal(Chaos::FSingleParticlePhysicsProxy* Proxy)
+	{
+		if (!Proxy)
+		{
+			return nullptr;
+		}
+
+		const auto Handle = Proxy->GetHandle_LowLevel();
+		return Handle ? Handle->CastToRigidParticle() : nullptr;
+	}
+
+	bool IsTouching_Internal(const Chaos::FContactPairModifier& PairModifier)
+	{
+		for (int32 ContactIndex = 0, NumContacts = PairModifier.GetNumContacts(); ContactIndex < NumContacts; ++ContactIndex)
+		{
+			if (PairModifier.GetSeparation(ContactIndex) <= ContactSeparationTolerance)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool IsRelevantParticle_Internal(const Chaos::FGeometryParticleHandle& Particle, uint32 RelevantObjectTypeMask)
+	{
+		const auto& Shapes = Particle.ShapesArray();
+		if (Shapes.IsEmpty())
+		{
+			return false;
+		}
+
+		// All the shapes of a component share the object type of the component
+		const auto ObjectType = static_cast<uint32>(GetCollisionChannel(Shapes[0]->GetSimData().Word3));
+
+		return ObjectType < 32 && (RelevantObjectTypeMask & (1u << ObjectType)) != 0;
+	}
+}
@@ -8,9 +8,12 @@
 
 class UCurveFloat;
 class UStaticMeshComponent;
+class FCollisionDampeningSimCallback;
 
 /**
- * 
+ * Increases the pawn's damping as it keeps bouncing after a flick so that shots settle instead of skittering around.
+ * By default the hits are counted and the damping applied by a physics thread contact modification callback at the step of the contact,
+ * which keeps bounces consistent regardless of frame rate. Falls back to game thread hit events when relevance depends on actor or component names.
  */
 UCLASS()
 class UCollisionDampeningComponent : public UBaseCollisionRelevanceComponent
@@ -23,8 +26,14 @@ public:
 	void OnFlick();
 	void OnShotFinished();
 
+	/*
+	* Parked pawns can't be hit so the contact callback is removed from the solver until the pawn is unparked.
+	*/
+	void SetParked(bool bParked);
+
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	virtual void RegisterCollisions() override;
 	virtual void OnNotifyRelevantCollision(UPrimitiveComponent* HitComponent, const FHitResult& Hit, const FVector& NormalImpulse) override;
@@ -43,6 +52,14 @@ private:
 	bool IsCollisionDampeningActive() const;
 	bool ShouldEnableCollisionDampening() const;
 
+	bool ShouldUsePhysicsThreadDampening() const;
+	bool EnsureSimCallback();
+	void UnregisterSimCallback();
+	void ActivatePhysicsThreadDampening();
+	uint32 GetRelevantObjectTypeMask() const;
+
+	void OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+
 private:
 
 	UPROPERTY(Category = "Config", EditDefaultsOnly)
@@ -54,6 +71,13 @@ private:
 	UPROPERTY(Category = "Config", EditDefaultsOnly)
 	bool bEnableRatioAngularDampening{};
 
+	/*
+	* Apply dampening from a physics thread contact callback instead of game thread hit events.
+	* Ignored if the relevance filter uses actor or component names as those cannot be checked on the physics thread.
+	*/
+	UPROPERTY(Category = "Config", EditDefaultsOnly)
+	bool bUsePhysicsThreadDampening{ true };
+
 	UPROPERTY(Category = "Config", EditDefaultsOnly)
 	float FlickTimeDelay{ 0.2f };
 
@@ -82,4 +106,11 @@ private:
 	// Don't need to store as weak object or UPROPERTY as just using it for comparison and not dereferencing
 	// Make it a void* to make that apparent and prevent misuse
 	const void* LastHitComponent{};
+
+	// Only created on the server when using physics thread dampening
+	FCollisionDampeningSimCallback* SimCallback{};
+	FDelegateHandle PostActorTickHandle{};
+
+	// Whether the sim callback was registered when the pawn was parked
+	bool bRestoreSimCallback{};
 };
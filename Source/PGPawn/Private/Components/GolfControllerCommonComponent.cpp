@@ -6,8 +6,10 @@
 #include "Interfaces/GolfController.h"
 #include "Interfaces/FocusableActor.h"
 #include "Pawn/PaperGolfPawn.h"
+#include "Data/GolfFocusVisibilityField.h"
 
 #include "PGPawnLogging.h"
+#include "PGPawnStats.h"
 #include "Logging/LoggingUtils.h"
 #include "VisualLogger/VisualLogger.h"
 
@@ -23,11 +25,20 @@
 #include "State/PaperGolfGameStateBase.h"
 
 #include "Subsystems/GolfEventsSubsystem.h"
-
-#include "Kismet/GameplayStatics.h"
+#include "Subsystems/PawnRestDetectionSubsystem.h"
+#include "Subsystems/FocusableActorRegistrySubsystem.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(GolfControllerCommonComponent)
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Focus LOS Baked"), STAT_PGFocusLOSBaked, STATGROUP_PGPawn);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Focus LOS Traced"), STAT_PGFocusLOSTraced, STATGROUP_PGPawn);
+
+namespace
+{
+	// Focus actors are placed in the level so anything more than float noise means the bake is stale for that actor
+	constexpr float FocusVisibilityMaxFocusMoveDistance = 10.0f;
+}
+
 UGolfControllerCommonComponent::UGolfControllerCommonComponent()
 {
 	PrimaryComponentTick.bCanEverTick = false;
@@ -49,6 +60,8 @@ void UGolfControllerCommonComponent::BeginPlay()
 		return;
 	}
 
+	LoadFocusVisibilityField();
+
 	if (auto World = GetWorld(); ensure(World))
 	{
 		auto GameState = World->GetGameState<APaperGolfGameStateBase>();
@@ -99,8 +112,8 @@ void UGolfControllerCommonComponent::DestroyPawn()
 		PaperGolfPawn->Destroy();
 	}
 
-	// Unregister any active timers
-	UnregisterShotFinishedTimer();
+	// Stop listening for the shot to finish
+	UnregisterShotFinishedListener();
 }
 
 AActor* UGolfControllerCommonComponent::GetShotFocusActor(EShotFocusType ShotFocusType) const
@@ -153,18 +166,7 @@ EShotType UGolfControllerCommonComponent::DetermineShotType(EShotFocusType ShotF
 
 	const auto ShotDistance = PaperGolfPawn->GetDistanceTo(FocusActor);
 
-	const EShotType NewShotType = [&]()
-	{
-		if (ShotDistance > MediumShotThreshold)
-		{
-			return EShotType::Full;
-		}
-		if (ShotDistance > CloseShotThreshold)
-		{
-			return EShotType::Medium;
-		}
-		return EShotType::Close;
-	}();
+	const EShotType NewShotType = GetShotTypeForDistance(ShotDistance);
 
 	UE_VLOG_UELOG(GetOwner(), LogPGPawn, Log, TEXT("%s-%s: %s - DetermineShotType(%s): %s - Distance=%fm to FocusActor=%s"),
 		*GetName(), *LoggingUtils::GetName(GetOwner()),
@@ -173,6 +175,19 @@ EShotType UGolfControllerCommonComponent::DetermineShotType(EShotFocusType ShotF
 	return NewShotType;
 }
 
+EShotType UGolfControllerCommonComponent::GetShotTypeForDistance(float ShotDistance) const
+{
+	if (ShotDistance > MediumShotThreshold)
+	{
+		return EShotType::Full;
+	}
+	if (ShotDistance > CloseShotThreshold)
+	{
+		return EShotType::Medium;
+	}
+	return EShotType::Close;
+}
+
 void UGolfControllerCommonComponent::AddToShotHistory(APaperGolfPawn* PaperGolfPawn)
 {
 	if (!PaperGolfPawn)
@@ -385,15 +400,9 @@ AActor* UGolfControllerCommonComponent::GetBestFocusActor(const TOptional<FVecto
 	return BestFocus;
 }
 
-void UGolfControllerCommonComponent::RegisterShotFinishedTimer()
+void UGolfControllerCommonComponent::RegisterShotFinishedListener()
 {
-	if (NextShotTimerHandle.IsValid())
-	{
-		return;
-	}
-
-	auto World = GetWorld();
-	if (!ensure(World))
+	if (bShotFinishedListenerRegistered)
 	{
 		return;
 	}
@@ -404,42 +413,71 @@ void UGolfControllerCommonComponent::RegisterShotFinishedTimer()
 		return;
 	}
 
-	OnFlickHandle = PaperGolfPawn->OnFlick.AddWeakLambda(this, [this, World, Pawn = MakeWeakObjectPtr(PaperGolfPawn)]()
-	{
-		LastFlickTime = World->GetTimeSeconds();
-		UE_VLOG_UELOG(GetOwner(), LogPGPawn, Log, TEXT("%s-%s: OnFlick - Time=%fs"), *GetName(), *LoggingUtils::GetName(Pawn), LastFlickTime);
-	});
+	// Rest tracking starts when the pawn is flicked so there is nothing to check until then
+	OnFlickHandle = PaperGolfPawn->OnFlick.AddUObject(this, &ThisClass::OnPawnFlicked);
 	WeakPaperGolfPawn = PaperGolfPawn;
 
-	FirstRestCheckPassTime = -1.0f;
-
-	World->GetTimerManager().SetTimer(NextShotTimerHandle, this, &ThisClass::CheckForNextShot, RestCheckTickRate, true);
+	bShotFinishedListenerRegistered = true;
 }
 
-void UGolfControllerCommonComponent::UnregisterShotFinishedTimer()
+void UGolfControllerCommonComponent::UnregisterShotFinishedListener()
 {
-	if (!NextShotTimerHandle.IsValid())
+	if (!bShotFinishedListenerRegistered)
 	{
 		return;
 	}
 
-	if (auto PaperGolfPawn = WeakPaperGolfPawn.Get(); PaperGolfPawn && OnFlickHandle.IsValid())
+	bShotFinishedListenerRegistered = false;
+
+	if (auto PaperGolfPawn = WeakPaperGolfPawn.Get(); PaperGolfPawn)
 	{
-		PaperGolfPawn->OnFlick.Remove(OnFlickHandle);
+		if (OnFlickHandle.IsValid())
+		{
+			PaperGolfPawn->OnFlick.Remove(OnFlickHandle);
+		}
+
+		if (auto World = GetWorld(); World)
+		{
+			if (auto RestDetectionSubsystem = World->GetSubsystem<UPawnRestDetectionSubsystem>(); RestDetectionSubsystem)
+			{
+				RestDetectionSubsystem->UntrackPawn(*PaperGolfPawn);
+			}
+		}
 	}
 
-	FirstRestCheckPassTime = -1.0f;
 	OnFlickHandle.Reset();
 	WeakPaperGolfPawn.Reset();
+}
 
+void UGolfControllerCommonComponent::OnPawnFlicked()
+{
 	auto World = GetWorld();
-	if (!World)
+	if (!ensure(World))
+	{
+		return;
+	}
+
+	auto PaperGolfPawn = WeakPaperGolfPawn.Get();
+	if (!PaperGolfPawn)
 	{
-		NextShotTimerHandle.Invalidate();
 		return;
 	}
 
-	World->GetTimerManager().ClearTimer(NextShotTimerHandle);
+	LastFlickTime = World->GetTimeSeconds();
+	UE_VLOG_UELOG(GetOwner(), LogPGPawn, Log, TEXT("%s-%s: OnPawnFlicked - Time=%fs"), *GetName(), *PaperGolfPawn->GetName(), LastFlickTime);
+
+	auto RestDetectionSubsystem = World->GetSubsystem<UPawnRestDetectionSubsystem>();
+	if (!ensure(RestDetectionSubsystem))
+	{
+		return;
+	}
+
+	RestDetectionSubsystem->TrackPawn(*PaperGolfPawn,
+		{
+			.MinTrackingTime = MinFlickElapsedTimeForShotFinished,
+			.RestTime = RestCheckTriggerDelay
+		},
+		FSimpleDelegate::CreateUObject(this, &ThisClass::CheckForNextShot));
 }
 
 bool UGolfControllerCommonComponent::HandleFallThroughFloor()
@@ -572,7 +610,7 @@ void UGolfControllerCommonComponent::SetPositionTo(const FVector& Position, cons
 void UGolfControllerCommonComponent::CheckForNextShot()
 {
 	// Make sure we didn't get unregistered in this frame
-	if (!NextShotTimerHandle.IsValid())
+	if (!bShotFinishedListenerRegistered)
 	{
 		return;
 	}
@@ -588,23 +626,18 @@ void UGolfControllerCommonComponent::CheckForNextShot()
 		return;
 	}
 
-	// Check that enough time has elapsed
-	if (World->GetTimeSeconds() - LastFlickTime < MinFlickElapsedTimeForShotFinished)
-	{
-		UE_VLOG_UELOG(GetOwner(), LogPGPawn, VeryVerbose,
-			TEXT("%s-%s: CheckForNextShot - Skip - Flick in progress: time remaining=%fs"),
-			*GetName(), *LoggingUtils::GetName(GetOwner()), MinFlickElapsedTimeForShotFinished - (World->GetTimeSeconds() - LastFlickTime));
-		return;
-	}
-
 	if (GolfController->HasScored())
 	{
-		UnregisterShotFinishedTimer();
+		UnregisterShotFinishedListener();
 		return;
 	}
 
+	// The rest detection subsystem will notify again from its watchdog if the controller isn't ready yet
 	if (!GolfController->IsReadyForNextShot())
 	{
+		UE_VLOG_UELOG(GetOwner(), LogPGPawn, Verbose,
+			TEXT("%s-%s: CheckForNextShot - Skip - Controller not ready for next shot"),
+			*GetName(), *LoggingUtils::GetName(GetOwner()));
 		return;
 	}
 
@@ -614,23 +647,7 @@ void UGolfControllerCommonComponent::CheckForNextShot()
 		return;
 	}
 
-	const auto CurrentTimeSeconds = World->GetTimeSeconds();
-
-	if (FirstRestCheckPassTime < 0)
-	{
-		FirstRestCheckPassTime = CurrentTimeSeconds;
-	}
-
-	if (const auto DeltaTime = CurrentTimeSeconds - FirstRestCheckPassTime; DeltaTime < RestCheckTriggerDelay)
-	{
-		UE_VLOG_UELOG(GetOwner(), LogPGPawn, VeryVerbose,
-			TEXT("%s-%s: CheckForNextShot - Skip - Waiting for rest check delay: time remaining=%fs"),
-			*GetName(), *LoggingUtils::GetName(GetOwner()), RestCheckTriggerDelay - DeltaTime);
-
-		return;
-	}
-
-	UnregisterShotFinishedTimer();
+	UnregisterShotFinishedListener();
 
 	OnControllerShotFinished.ExecuteIfBound();
 
@@ -668,66 +685,30 @@ void UGolfControllerCommonComponent::InitFocusableActors()
 
 	FocusableActors.Reset();
 	GolfHole = nullptr;
+	FocusVisibilityIndices.Reset();
 
-	TArray<AActor*> InterfaceActors;
-	UGameplayStatics::GetAllActorsWithInterface(GetWorld(), UFocusableActor::StaticClass(), InterfaceActors);
-
-	UE_VLOG_UELOG(GetOwner(), LogPGPawn, Log, TEXT("%s-%s: InitFocusableActors - HoleNumber=%d - Found %d candidate instances of UFocusableActor in world: %s"),
-		*GetName(), *LoggingUtils::GetName(GetOwner()), HoleNumber, InterfaceActors.Num(), *PG::ToStringObjectElements(InterfaceActors));
-
-
-	for (auto Actor : InterfaceActors)
+	auto FocusableActorRegistry = World->GetSubsystem<UFocusableActorRegistrySubsystem>();
+	if (!ensure(FocusableActorRegistry))
 	{
-		// See https://www.stevestreeting.com/2020/11/02/ue4-c-interfaces-hints-n-tips/ for why we need to avoid using Cast
-		// since there are blueprint implemenations of this C++ interface
-		// This already asserted with GetAllActorsWithInterface
-		checkf(Actor->Implements<UFocusableActor>(),
-			TEXT("%s-%s: GetAllActorsWithInterface added but Implements<UFocusableActor> returns false for %s!"), 
-				*GetName(), *LoggingUtils::GetName(GetOwner()), *Actor->GetName());
+		return;
+	}
 
-		// Filter to hole number
-		if (IFocusableActor::Execute_GetHoleNumber(Actor) != HoleNumber)
-		{
-			UE_VLOG_UELOG(GetOwner(), LogPGPawn, Verbose,
-				TEXT("%s-%s: InitFocusableActors - Skipping %s with hole %d as it is not for hole %d"),
-				*GetName(), *LoggingUtils::GetName(GetOwner()), *Actor->GetName(), IFocusableActor::Execute_GetHoleNumber(Actor), HoleNumber);
-			continue;
-		}
+	GolfHole = FocusableActorRegistry->GetHole(HoleNumber);
 
-		// See if this is the hole or not
-		if (IFocusableActor::Execute_IsHole(Actor))
-		{
-			if (!GolfHole)
-			{
-				GolfHole = Actor;
-				UE_VLOG_UELOG(GetOwner(), LogPGPawn, Verbose,
-					TEXT("%s-%s: InitFocusableActors - Matched GolfHole=%s for HoleNumber=%d"),
-					*GetName(), *LoggingUtils::GetName(GetOwner()), *Actor->GetName(), HoleNumber);
-				UE_VLOG_LOCATION(GetOwner(), LogPGPawn, Verbose, Actor->GetActorLocation(), 10.f, FColor::Turquoise, TEXT("Hole: %d"), HoleNumber);
-			}
-			else
-			{
-				UE_VLOG_UELOG(GetOwner(), LogPGPawn, Error, TEXT("%s-%s: InitFocusableActors - Found multiple golf holes for hole number %d: %s and %s"),
-					*GetName(), *LoggingUtils::GetName(GetOwner()), HoleNumber, *GolfHole->GetName(), *Actor->GetName());
-			}
-
-			// Add the hole as a regular focusable actor
-			if (!IFocusableActor::Execute_IsPreferredFocus(Actor))
-			{
-				FocusableActors.Add(Actor);
-			}
-		}
-		else
-		{
-			UE_VLOG_UELOG(GetOwner(), LogPGPawn, Verbose,
-				TEXT("%s-%s: InitFocusableActors - Matched FocusActor=%s for HoleNumber=%d"),
-				*GetName(), *LoggingUtils::GetName(GetOwner()), *Actor->GetName(), HoleNumber);
+	const auto HoleFocusableActors = FocusableActorRegistry->GetFocusableActors(HoleNumber);
+	FocusableActors.Append(HoleFocusableActors.GetData(), HoleFocusableActors.Num());
 
-			UE_VLOG_LOCATION(GetOwner(), LogPGPawn, Verbose, Actor->GetActorLocation(), 10.f, FColor::Turquoise, TEXT("Focus: %d"), HoleNumber);
+	InitFocusVisibility(HoleNumber);
 
-			FocusableActors.Add(Actor);
+#if ENABLE_VISUAL_LOG
+	if (FVisualLogger::IsRecording())
+	{
+		for (const auto& Entry : FocusableActorRegistry->GetEntries(HoleNumber))
+		{
+			UE_VLOG_LOCATION(GetOwner(), LogPGPawn, Verbose, Entry.Location, 10.f, FColor::Turquoise, TEXT("%s: %d"), Entry.bHole ? TEXT("Hole") : TEXT("Focus"), HoleNumber);
 		}
-	} // for InterfaceActors
+	}
+#endif
 
 	if (!FocusableActors.IsEmpty())
 	{
@@ -761,40 +742,26 @@ bool UGolfControllerCommonComponent::HasLOSToFocus(const FVector& Position, cons
 		return false;
 	}
 
-	FCollisionQueryParams QueryParams;
-	QueryParams.AddIgnoredActor(FocusActor);
-	
-	// Try direct LOS first before doing offsets
-	const auto LOSTest = [&](const auto& Start, const auto& End)
+	if (const auto BakedLOS = GetBakedLOSToFocus(Position, FocusActor); BakedLOS)
 	{
-		return !World->LineTraceTestByChannel(
-			Start,
-			End,
-			PG::CollisionChannel::FlickTraceType,
-			QueryParams
-		);
-	};
-	
-	const auto& FocusActorLocation = FocusActor->GetActorLocation();
-	const auto TraceStartOffsetVector = FVector::ZAxisVector * FocusTraceStartOffset;
+		INC_DWORD_STAT(STAT_PGFocusLOSBaked);
 
-	// Want to go between FocusTraceEndOffset offset by ElevationDiff but be constrained by FocusTraceMaxEndOffset as don't want to go through ceiling
-	const auto FocusTraceOffsetOverride = IFocusableActor::Execute_GetFocusTraceEndOffset(FocusActor);
-	const auto FocusTraceOffsetToUse = FocusTraceOffsetOverride >= 1 ? FocusTraceOffsetOverride : FocusTraceEndOffset;
+		UE_VLOG_UELOG(GetOwner(), LogPGPawn, Verbose, TEXT("%s-%s: HasLOSToFocus(%s,%s) = %s : Baked"),
+			*GetName(), *LoggingUtils::GetName(GetOwner()), *Position.ToCompactString(), *LoggingUtils::GetName(FocusActor), LoggingUtils::GetBoolString(*BakedLOS));
 
-	const auto ElevationDiff = Position.Z - FocusActorLocation.Z;
-	const auto FocusTraceSelectedEndOffset = FMath::Clamp(FocusTraceOffsetToUse + ElevationDiff, FocusTraceStartOffset, FocusTraceMaxEndOffset);
-	const auto TraceEndOffsetVector = FVector::ZAxisVector * FocusTraceSelectedEndOffset;
-	
-	bool bLOS = LOSTest(Position, FocusActorLocation);
+		return *BakedLOS;
+	}
 
-	if (!bLOS)
-	{
-		const auto TraceStartLocation = Position + TraceStartOffsetVector;
-		const auto TraceEndLocation = FocusActorLocation + TraceEndOffsetVector;
+	INC_DWORD_STAT(STAT_PGFocusLOSTraced);
 
-		bLOS = LOSTest(TraceStartLocation, TraceEndLocation);
-	}
+	FCollisionQueryParams QueryParams;
+	QueryParams.AddIgnoredActor(FocusActor);
+
+	const auto& FocusActorLocation = FocusActor->GetActorLocation();
+	const auto TraceParams = GetFocusTraceParams();
+	const auto FocusEndOffset = IFocusableActor::Execute_GetFocusTraceEndOffset(FocusActor);
+
+	const bool bLOS = TestLOSToFocus(*World, Position, FocusActorLocation, FocusEndOffset, TraceParams, QueryParams);
 
 	UE_VLOG_ARROW(GetOwner(), LogPGPawn, Verbose, Position + 200.f * FVector::ZAxisVector, FocusActorLocation + 200.f * FVector::ZAxisVector,
 		bLOS ? FColor::Green : FColor::Red, TEXT("LOS: %s"), *FocusActor->GetName());
@@ -808,6 +775,8 @@ bool UGolfControllerCommonComponent::HasLOSToFocus(const FVector& Position, cons
 
 	if (bVisualLogger || UE_LOG_ACTIVE(LogPGPawn,Verbose))
 	{
+		const auto FocusTraceSelectedEndOffset = TraceParams.GetSelectedEndOffset(Position.Z - FocusActorLocation.Z, FocusEndOffset);
+
 		if (bLOS)
 		{
 			UE_VLOG_UELOG(GetOwner(), LogPGPawn, Verbose, TEXT("%s-%s: HasLOSToFocus(%s,%s) = TRUE : FocusTraceSelectedEndOffset=%f"),
@@ -818,8 +787,8 @@ bool UGolfControllerCommonComponent::HasLOSToFocus(const FVector& Position, cons
 			FHitResult HitResult;
 			World->LineTraceSingleByChannel(
 				HitResult,
-				Position + TraceStartOffsetVector,
-				FocusActorLocation + TraceEndOffsetVector,
+				Position + FVector::ZAxisVector * TraceParams.StartOffset,
+				FocusActorLocation + FVector::ZAxisVector * FocusTraceSelectedEndOffset,
 				PG::CollisionChannel::FlickTraceType,
 				QueryParams
 			);
@@ -836,6 +805,151 @@ bool UGolfControllerCommonComponent::HasLOSToFocus(const FVector& Position, cons
 	return bLOS;
 }
 
+bool UGolfControllerCommonComponent::TestLOSToFocus(const UWorld& World, const FVector& Position, const FVector& FocusActorLocation, float FocusEndOffset,
+	const FGolfFocusTraceParams& TraceParams, const FCollisionQueryParams& QueryParams)
+{
+	const auto LOSTest = [&](const auto& Start, const auto& End)
+	{
+		return !World.LineTraceTestByChannel(
+			Start,
+			End,
+			PG::CollisionChannel::FlickTraceType,
+			QueryParams
+		);
+	};
+
+	// Try direct LOS first before doing offsets
+	if (LOSTest(Position, FocusActorLocation))
+	{
+		return true;
+	}
+
+	// Want to go between FocusTraceEndOffset offset by ElevationDiff but be constrained by FocusTraceMaxEndOffset as don't want to go through ceiling
+	const auto FocusTraceSelectedEndOffset = TraceParams.GetSelectedEndOffset(Position.Z - FocusActorLocation.Z, FocusEndOffset);
+
+	return LOSTest(Position + FVector::ZAxisVector * TraceParams.StartOffset, FocusActorLocation + FVector::ZAxisVector * FocusTraceSelectedEndOffset);
+}
+
+FGolfFocusTraceParams UGolfControllerCommonComponent::GetFocusTraceParams() const
+{
+	return FGolfFocusTraceParams
+	{
+		.StartOffset = FocusTraceStartOffset,
+		.EndOffset = FocusTraceEndOffset,
+		.MaxEndOffset = FocusTraceMaxEndOffset
+	};
+}
+
+void UGolfControllerCommonComponent::LoadFocusVisibilityField()
+{
+	FocusVisibilityField = nullptr;
+
+	auto World = GetWorld();
+	if (!World || FocusVisibilityFields.IsEmpty())
+	{
+		return;
+	}
+
+	const TSoftObjectPtr<UWorld> WorldKey{ FSoftObjectPath{ UWorld::RemovePIEPrefix(World->GetPathName()) } };
+
+	if (const auto FocusVisibilityFieldPtr = FocusVisibilityFields.Find(WorldKey); FocusVisibilityFieldPtr)
+	{
+		FocusVisibilityField = FocusVisibilityFieldPtr->LoadSynchronous();
+	}
+
+	// A field baked with other offsets would disagree with the live traces used for the cells it can't answer
+	if (FocusVisibilityField && !FocusVisibilityField->GetTraceParams().Equals(GetFocusTraceParams(), 1.0f))
+	{
+		UE_VLOG_UELOG(GetOwner(), LogPGPawn, Warning, TEXT("%s-%s: LoadFocusVisibilityField - Ignoring %s as its trace offsets do not match FocusTraceStartOffset=%f; FocusTraceEndOffset=%f; FocusTraceMaxEndOffset=%f - rebake the field"),
+			*GetName(), *LoggingUtils::GetName(GetOwner()), *FocusVisibilityField->GetName(), FocusTraceStartOffset, FocusTraceEndOffset, FocusTraceMaxEndOffset);
+
+		FocusVisibilityField = nullptr;
+	}
+
+	UE_VLOG_UELOG(GetOwner(), LogPGPawn, Log, TEXT("%s-%s: LoadFocusVisibilityField - World=%s; FocusVisibilityField=%s"),
+		*GetName(), *LoggingUtils::GetName(GetOwner()), *WorldKey.ToString(), *LoggingUtils::GetName(FocusVisibilityField));
+}
+
+void UGolfControllerCommonComponent::InitFocusVisibility(int32 HoleNumber)
+{
+	FocusVisibilityHole = FocusVisibilityField ? FocusVisibilityField->FindHole(HoleNumber) : nullptr;
+	FocusVisibilityIndices.Reset();
+
+	if (!FocusVisibilityHole)
+	{
+		return;
+	}
+
+	const auto AddFocusVisibilityIndex = [&](AActor* FocusActor)
+	{
+		if (!FocusActor)
+		{
+			return;
+		}
+
+		const auto FocusIndex = FocusVisibilityHole->FindFocusIndex(FocusActor->GetFName(), FocusActor->GetActorLocation(), FocusVisibilityMaxFocusMoveDistance);
+		if (FocusIndex != INDEX_NONE)
+		{
+			FocusVisibilityIndices.Add(FocusActor, FocusIndex);
+		}
+		else
+		{
+			UE_VLOG_UELOG(GetOwner(), LogPGPawn, Warning, TEXT("%s-%s: InitFocusVisibility - HoleNumber=%d; FocusActor=%s was not baked or has moved since - rebake the field"),
+				*GetName(), *LoggingUtils::GetName(GetOwner()), HoleNumber, *FocusActor->GetName());
+		}
+	};
+
+	AddFocusVisibilityIndex(GolfHole);
+
+	for (auto FocusActor : FocusableActors)
+	{
+		AddFocusVisibilityIndex(FocusActor);
+	}
+
+	UE_VLOG_UELOG(GetOwner(), LogPGPawn, Log, TEXT("%s-%s: InitFocusVisibility - HoleNumber=%d; Matched %d/%d baked focus actors"),
+		*GetName(), *LoggingUtils::GetName(GetOwner()), HoleNumber, FocusVisibilityIndices.Num(), FocusVisibilityHole->GetNumFocusActors());
+}
+
+TOptional<bool> UGolfControllerCommonComponent::GetBakedLOSToFocus(const FVector& Position, const AActor* FocusActor) const
+{
+	if (!FocusVisibilityHole)
+	{
+		return {};
+	}
+
+	const auto FocusIndex = FocusVisibilityIndices.Find(FocusActor);
+	if (!FocusIndex)
+	{
+		return {};
+	}
+
+	const auto CellIndex = FocusVisibilityHole->FindCellIndex(Position, FocusVisibilityMaxHeightDifference);
+	if (CellIndex == INDEX_NONE)
+	{
+		return {};
+	}
+
+	return FocusVisibilityHole->HasLOSToFocus(CellIndex, *FocusIndex);
+}
+
+TOptional<bool> UGolfControllerCommonComponent::GetBakedLOSBetweenFocusActors(const AActor* FromFocusActor, const AActor* ToFocusActor) const
+{
+	if (!FocusVisibilityHole)
+	{
+		return {};
+	}
+
+	const auto FromFocusIndex = FocusVisibilityIndices.Find(FromFocusActor);
+	const auto ToFocusIndex = FocusVisibilityIndices.Find(ToFocusActor);
+
+	if (!FromFocusIndex || !ToFocusIndex)
+	{
+		return {};
+	}
+
+	return FocusVisibilityHole->HasLOSBetweenFocusActors(*FromFocusIndex, *ToFocusIndex);
+}
+
 void UGolfControllerCommonComponent::OnHoleChanged(int32 HoleNumber)
 {
 	UE_VLOG_UELOG(GetOwner(), LogPGPawn, Log, TEXT("%s-%s: OnHoleChanged - HoleNumber=%d"),
@@ -906,7 +1020,7 @@ void UGolfControllerCommonComponent::BeginTurn()
 		}
 	}
 
-	RegisterShotFinishedTimer();
+	RegisterShotFinishedListener();
 }
 
 void UGolfControllerCommonComponent::EndTurn()
@@ -914,7 +1028,7 @@ void UGolfControllerCommonComponent::EndTurn()
 	UE_VLOG_UELOG(GetOwner(), LogPGPawn, Log, TEXT("%s-%s: EndTurn"),
 		*GetName(), *LoggingUtils::GetName(GetOwner()));
 
-	UnregisterShotFinishedTimer();
+	UnregisterShotFinishedListener();
 }
 
 void UGolfControllerCommonComponent::Reset()
@@ -940,5 +1054,5 @@ void UGolfControllerCommonComponent::OnScored()
 		GolfPlayerState->SetHasScored(true);
 	}
 
-	UnregisterShotFinishedTimer();
+	UnregisterShotFinishedListener();
 }
@@ -13,6 +13,9 @@
 
 #include "Components/StaticMeshComponent.h"
 
+#include "Subsystems/HazardSpatialIndexSubsystem.h"
+#include "Data/GolfClearanceField.h"
+
 #include "PGPawnLogging.h"
 
 #include "PGConstants.h"
@@ -103,6 +106,69 @@ void UGolfShotClearanceComponent::BeginPlay()
 	bFirstShot = true;
 
 	HitNormalAlignmentAngleCos = FMath::Cos(FMath::DegreesToRadians(HitNormalAlignmentAngle));
+
+	LoadClearanceField();
+}
+
+void UGolfShotClearanceComponent::LoadClearanceField()
+{
+	ClearanceField = nullptr;
+
+	auto World = GetWorld();
+	if (!World || ClearanceFields.IsEmpty())
+	{
+		return;
+	}
+
+	const TSoftObjectPtr<UWorld> WorldKey{ FSoftObjectPath{ UWorld::RemovePIEPrefix(World->GetPathName()) } };
+
+	if (const auto ClearanceFieldPtr = ClearanceFields.Find(WorldKey); ClearanceFieldPtr)
+	{
+		ClearanceField = ClearanceFieldPtr->LoadSynchronous();
+	}
+
+	// The baked band must match what would be checked live or the field would disagree with the physics queries
+	if (ClearanceField && !FMath::IsNearlyEqual(ClearanceField->GetProbeHalfHeight(), GetProbeHalfHeight(), 1.0f))
+	{
+		UE_VLOG_UELOG(GetOwner(), LogPGPawn, Warning, TEXT("%s-%s: LoadClearanceField - Ignoring %s as it was baked with ProbeHalfHeight=%f but the pawn has %f - rebake the field"),
+			*LoggingUtils::GetName(GetOwner()), *GetName(), *ClearanceField->GetName(), ClearanceField->GetProbeHalfHeight(), GetProbeHalfHeight());
+
+		ClearanceField = nullptr;
+	}
+
+	UE_VLOG_UELOG(GetOwner(), LogPGPawn, Log, TEXT("%s-%s: LoadClearanceField - World=%s; ClearanceField=%s"),
+		*LoggingUtils::GetName(GetOwner()), *GetName(), *WorldKey.ToString(), *LoggingUtils::GetName(ClearanceField));
+}
+
+TOptional<FGolfClearanceFieldSample> UGolfShotClearanceComponent::SampleClearanceField(const FVector& Location) const
+{
+	if (!ClearanceField)
+	{
+		return {};
+	}
+
+	const auto Hole = ClearanceField->FindHole(Location);
+	if (!Hole)
+	{
+		return {};
+	}
+
+	auto FieldSample = Hole->Sample(Location);
+
+	const auto MyOwner = GetOwner();
+	check(MyOwner);
+
+	const auto PawnGroundZ = Location.Z - PG::CollisionUtils::GetActorHalfHeight(*MyOwner);
+
+	if (!FieldSample.GroundZ || FMath::Abs(*FieldSample.GroundZ - PawnGroundZ) > ClearanceFieldMaxHeightDifference)
+	{
+		UE_VLOG_UELOG(MyOwner, LogPGPawn, Verbose, TEXT("%s-%s: SampleClearanceField - Location=%s is not on the baked ground surface GroundZ=%s - using physics queries"),
+			*LoggingUtils::GetName(MyOwner), *GetName(), *Location.ToCompactString(),
+			FieldSample.GroundZ ? *FString::Printf(TEXT("%.1f"), *FieldSample.GroundZ) : TEXT("None"));
+		return {};
+	}
+
+	return FieldSample;
 }
 
 bool UGolfShotClearanceComponent::ShouldAdjustPosition() const
@@ -219,9 +285,81 @@ bool UGolfShotClearanceComponent::IsClearanceNeeded(FHitResultData& OutHitResult
 	const auto MyOwner = GetOwner();
 	check(MyOwner);
 
+	const auto FieldSample = SampleClearanceField(MyOwner->GetActorLocation());
+	if (!FieldSample)
+	{
+		return IsClearanceNeededLive(false, OutHitResultData);
+	}
+
+	if (FieldSample->ObstacleDistance >= AdjustmentDistance)
+	{
+		UE_VLOG_UELOG(MyOwner, LogPGPawn, Verbose, TEXT("%s-%s: IsClearanceNeeded - Clearance field has no static obstacles within %fm - only checking moving obstacles"),
+			*LoggingUtils::GetName(MyOwner), *GetName(), FieldSample->ObstacleDistance / 100);
+
+		return IsClearanceNeededLive(true, OutHitResultData);
+	}
+
+	if (ConfirmClearanceFieldObstacle(*FieldSample, OutHitResultData))
+	{
+		return true;
+	}
+
+	UE_VLOG_UELOG(MyOwner, LogPGPawn, Warning, TEXT("%s-%s: IsClearanceNeeded - Could not confirm clearance field obstacle at distance %fm - the field may be out of date"),
+		*LoggingUtils::GetName(MyOwner), *GetName(), FieldSample->ObstacleDistance / 100);
+
+	return IsClearanceNeededLive(false, OutHitResultData);
+}
+
+bool UGolfShotClearanceComponent::ConfirmClearanceFieldObstacle(const FGolfClearanceFieldSample& FieldSample, FHitResultData& OutHitResultData) const
+{
+	const auto MyOwner = GetOwner();
+	check(MyOwner);
+
 	auto World = GetWorld();
 	check(World);
 
+	// The gradient points away from the nearest obstacle and is flat deep inside one
+	const FVector ToObstacleDirection{ -FieldSample.ObstacleGradient, 0.0 };
+	if (ToObstacleDirection.IsNearlyZero())
+	{
+		return false;
+	}
+
+	const auto TracePosition = MyOwner->GetActorLocation() + MyOwner->GetActorUpVector() * GetProbeHalfHeight() * 2.0f;
+	const auto TraceEnd = TracePosition + ToObstacleDirection * AdjustmentDistance * 2;
+
+	FCollisionQueryParams QueryParams;
+	QueryParams.AddIgnoredActor(MyOwner);
+	QueryParams.bIgnoreTouches = true;
+
+	FHitResult HitResult;
+	if (!World->LineTraceSingleByChannel(HitResult, TracePosition, TraceEnd, PG::CollisionChannel::StaticObstacleTrace, QueryParams))
+	{
+		UE_VLOG_ARROW(MyOwner, LogPGPawn, Log, TracePosition, TraceEnd, FColor::Orange, TEXT("Clr: Field No Hit"));
+		return false;
+	}
+
+	OutHitResultData.Location = HitResult.Location;
+	OutHitResultData.Normal = HitResult.Normal;
+
+	UE_VLOG_UELOG(MyOwner, LogPGPawn, Log, TEXT("%s-%s: AdjustPositionForClearance - TRUE - Field Distance=%fm; HitLocation=%s; HitNormal=%s"),
+		*LoggingUtils::GetName(MyOwner), *GetName(), FieldSample.ObstacleDistance / 100, *OutHitResultData.Location.ToCompactString(), *OutHitResultData.Normal.ToCompactString());
+
+	UE_VLOG_ARROW(MyOwner, LogPGPawn, Log, HitResult.Location, HitResult.Location + HitResult.Normal * 100.0f, FColor::Yellow, TEXT("Clr: Field Hit Normal"));
+
+	return true;
+}
+
+bool UGolfShotClearanceComponent::IsClearanceNeededLive(bool bOnlyMovingObstacles, FHitResultData& OutHitResultData) const
+{
+	const auto MyOwner = GetOwner();
+	check(MyOwner);
+
+	auto World = GetWorld();
+	check(World);
+
+	const auto MobilityType = bOnlyMovingObstacles ? EQueryMobilityType::Dynamic : EQueryMobilityType::Any;
+
 	const auto& CurrentPosition = MyOwner->GetActorLocation();
 	const auto& ForwardDirection = MyOwner->GetActorForwardVector();
 	const auto& UpVector = MyOwner->GetActorUpVector();
@@ -236,8 +374,11 @@ bool UGolfShotClearanceComponent::IsClearanceNeeded(FHitResultData& OutHitResult
 	const auto TracePosition = CurrentPosition + TraceOffset;
 	const auto TraceShape = FCollisionShape::MakeBox(FVector{ AdjustmentDistance, AdjustmentDistance, TraceHeight });
 
+	FCollisionQueryParams OverlapQueryParams;
+	OverlapQueryParams.MobilityType = MobilityType;
+
 	// Cannot get the hit normal from the sweep trace with a box shape so need to do a line trace after to the hit location direction
-	bool bResult = World->OverlapAnyTestByChannel(TracePosition, RotationQuat, PG::CollisionChannel::StaticObstacleTrace, TraceShape);
+	bool bResult = World->OverlapAnyTestByChannel(TracePosition, RotationQuat, PG::CollisionChannel::StaticObstacleTrace, TraceShape, OverlapQueryParams);
 
 #if ENABLE_VISUAL_LOG
 	if (bResult && FVisualLogger::IsRecording())
@@ -260,6 +401,7 @@ bool UGolfShotClearanceComponent::IsClearanceNeeded(FHitResultData& OutHitResult
 		QueryParams.bIgnoreBlocks = false;
 		QueryParams.bIgnoreTouches = true;
 		QueryParams.bFindInitialOverlaps = false;
+		QueryParams.MobilityType = MobilityType;
 
 		const auto& RightVector = MyOwner->GetActorRightVector();
 
@@ -472,8 +614,25 @@ bool UGolfShotClearanceComponent::CheckNewLocationPlayable(const FClearanceLocat
 	auto World = GetWorld();
 	check(World);
 
+	const auto FieldSample = SampleClearanceField(ClearanceLocationResult.NewPosition);
+
 	// Make sure that our elevation change isn't too great (example - moving off a counter)
-	const auto GroundData = PG::CollisionUtils::GetGroundData(*MyOwner, ClearanceLocationResult.NewPosition);
+	TOptional<PG::CollisionUtils::FGroundData> GroundData;
+
+	// The field only has the top ground surface so if that is above where the ground trace would start then there is an overhang and need to trace
+	if (FieldSample && FieldSample->GroundZ && *FieldSample->GroundZ <= ClearanceLocationResult.NewPosition.Z + PG::CollisionUtils::GetActorHalfHeight(*MyOwner))
+	{
+		GroundData = PG::CollisionUtils::FGroundData
+		{
+			.Location = FVector{ ClearanceLocationResult.NewPosition.X, ClearanceLocationResult.NewPosition.Y, *FieldSample->GroundZ },
+			.Normal = FVector::UpVector
+		};
+	}
+	else
+	{
+		GroundData = PG::CollisionUtils::GetGroundData(*MyOwner, ClearanceLocationResult.NewPosition);
+	}
+
 	if (!GroundData)
 	{
 		UE_VLOG_UELOG(MyOwner, LogPGPawn, Log, TEXT("%s-%s: AdjustPositionForClearance - FALSE - Pushback direction: %s to location %s resulted in not being able to determine ground"),
@@ -510,7 +669,26 @@ bool UGolfShotClearanceComponent::CheckNewLocationPlayable(const FClearanceLocat
 
 	// Check if overlap a hazard - use the ground position and offset the height so that the overlap check sweeps to the ground
 	const auto HazardTraceCenter = ClearanceLocationResult.NewPosition - FVector::ZAxisVector * ToNewPositionGroundHalfHeight;
-	bool bTestPasses = !World->OverlapAnyTestByObjectType(HazardTraceCenter, FQuat::Identity, PG::CollisionObjectType::Hazard, HazardBoundsTraceShape, QueryParams);
+	bool bTestPasses;
+
+	// The field is conclusive when clear of or inside a hazard by more than the overlap extent
+	if (FieldSample && FMath::Abs(FieldSample->HazardDistance) >= ClearanceTraceParams.TraceHalfHeight)
+	{
+		bTestPasses = FieldSample->HazardDistance > 0;
+	}
+	else
+	{
+		// Only overlap the physics scene where there may be hazards that did not register with the spatial index
+		const auto HazardTraceBox = FBox::BuildAABB(HazardTraceCenter, HazardBoundsTraceShape.GetExtent());
+		auto HazardIndex = World->GetSubsystem<UHazardSpatialIndexSubsystem>();
+
+		bTestPasses = !HazardIndex || !HazardIndex->QueryBox(HazardTraceBox).IsHit();
+
+		if (bTestPasses && (!HazardIndex || HazardIndex->NeedsPhysicsQuery(HazardTraceBox)))
+		{
+			bTestPasses = !World->OverlapAnyTestByObjectType(HazardTraceCenter, FQuat::Identity, PG::CollisionObjectType::Hazard, HazardBoundsTraceShape, QueryParams);
+		}
+	}
 
 	if (!bTestPasses)
 	{
@@ -6,6 +6,8 @@
 #include "Components/ActorComponent.h"
 #include "GolfShotClearanceComponent.generated.h"
 
+class UGolfClearanceField;
+struct FGolfClearanceFieldSample;
 
 UCLASS()
 class UGolfShotClearanceComponent : public UActorComponent
@@ -21,6 +23,11 @@ public:
 
 	bool IsEnabled() const { return bEnabled; }
 
+	/*
+	* Half height of the band above the pawn that is checked for obstacles.
+	*/
+	float GetProbeHalfHeight() const { return GetActorHeight() * 0.5f; }
+
 protected:
 	virtual void BeginPlay() override;
 
@@ -57,6 +64,11 @@ private:
 	FBox GetOwnerAABB() const;
 
 	bool IsClearanceNeeded(FHitResultData& OutHitResultData) const;
+	bool IsClearanceNeededLive(bool bOnlyMovingObstacles, FHitResultData& OutHitResultData) const;
+	bool ConfirmClearanceFieldObstacle(const FGolfClearanceFieldSample& FieldSample, FHitResultData& OutHitResultData) const;
+
+	void LoadClearanceField();
+	TOptional<FGolfClearanceFieldSample> SampleClearanceField(const FVector& Location) const;
 	bool CalculateClearanceLocation(const FHitResultData& OutHitResultData, FVector& OutNewLocation) const;
 	bool CalculateClearanceLocation(const FVector& HitLocation, const FVector& PushbackDirection, FVector& OutNewLocation) const;
 
@@ -83,6 +95,23 @@ private:
 	UPROPERTY(Category = "Config", EditDefaultsOnly)
 	float HitNormalAlignmentAngle{ 45.0f };
 
+	/*
+	* Baked static obstacle and hazard distances for each course map. See UGolfClearanceFieldCommandlet.
+	* Without a field for the map, or outside the baked holes, all checks use physics queries.
+	*/
+	UPROPERTY(Category = "Config | Performance", EditDefaultsOnly)
+	TMap<TSoftObjectPtr<UWorld>, TSoftObjectPtr<UGolfClearanceField>> ClearanceFields{};
+
+	/*
+	* The field only has the top ground surface of each cell so it is only used if that is within this height of the ground under the pawn.
+	* A pawn under a table would otherwise read the tabletop and miss the legs around it.
+	*/
+	UPROPERTY(Category = "Config | Performance", EditDefaultsOnly, meta = (ClampMin = "0.0"))
+	float ClearanceFieldMaxHeightDifference{ 50.0f };
+
+	UPROPERTY(Transient)
+	TObjectPtr<UGolfClearanceField> ClearanceField{};
+
 	float HitNormalAlignmentAngleCos{};
 
 	mutable float ActorHeight{ -1.0f };
@@ -94,6 +94,15 @@ void UPaperGolfPawnAudioComponent::GetLifetimeReplicatedProps(TArray<FLifetimePr
 	DOREPLIFETIME(ThisClass, bPlayFlightRequested);
 }
 
+void UPaperGolfPawnAudioComponent::Deactivate()
+{
+	UE_VLOG_UELOG(GetOwner(), LogPGPawn, Log, TEXT("%s-%s: Deactivate"), *LoggingUtils::GetName(GetOwner()), *GetName());
+
+	StopFlight();
+
+	Super::Deactivate();
+}
+
 void UPaperGolfPawnAudioComponent::BeginPlay()
 {
 	UE_VLOG_UELOG(GetOwner(), LogPGPawn, Log, TEXT("%s-%s: BeginPlay"), *LoggingUtils::GetName(GetOwner()), *GetName());
@@ -0,0 +1,353 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+
+#include "Components/PredictedFlightComponent.h"
+
+#include "Pawn/PaperGolfPawn.h"
+
+#include "VisualLogger/VisualLogger.h"
+#include "Logging/LoggingUtils.h"
+#include "PGPawnLogging.h"
+
+#include "Debug/PGConsoleVars.h"
+
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+
+#include "Net/UnrealNetwork.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(PredictedFlightComponent)
+
+namespace
+{
+	FVector GetDampedRotationVector(const FVector& AngularVelocity, float Damping, float SimFrequency, float SimTime);
+}
+
+UPredictedFlightComponent::UPredictedFlightComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+
+	SetIsReplicatedByDefault(true);
+}
+
+void UPredictedFlightComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// The owner is running its own physics simulation of the flick
+	DOREPLIFETIME_CONDITION(UPredictedFlightComponent, Keyframe, COND_SimulatedOnly);
+}
+
+void UPredictedFlightComponent::Initialize(UPrimitiveComponent& InPhysicsComponent)
+{
+	PhysicsComponent = &InPhysicsComponent;
+}
+
+bool UPredictedFlightComponent::IsEnabled() const
+{
+#if PG_DEBUG_ENABLED
+	if (const auto Override = PG::CPredictedFlight.GetValueOnGameThread(); Override >= 0)
+	{
+		return Override > 0;
+	}
+#endif
+
+	return bEnabled;
+}
+
+FFlickPredictParams UPredictedFlightComponent::GetPredictParams() const
+{
+	return FFlickPredictParams
+	{
+		.MaxSimTime = MaxSimTime,
+		.SimFrequency = SimFrequency,
+		.CollisionRadius = CollisionRadius
+	};
+}
+
+FNetworkFlightLaunch UPredictedFlightComponent::BeginServerFlight(const FPaperGolfTrajectoryParams& TrajectoryParams)
+{
+	auto Owner = GetOwner();
+	check(Owner && Owner->HasAuthority());
+
+	if (bServerPredicting)
+	{
+		EndServerFlight(TEXT("NewFlight"));
+	}
+
+	++FlightId;
+
+	FNetworkFlightLaunch Launch
+	{
+		.Location = Owner->GetActorLocation(),
+		.FlightId = FlightId
+	};
+
+	if (!IsEnabled() || !PhysicsComponent || !Solve(TrajectoryParams))
+	{
+		return Launch;
+	}
+
+	Launch.bPredicted = true;
+	bServerPredicting = true;
+	FlightStartTimeSeconds = GetWorld()->GetTimeSeconds();
+
+	// Clients simulate the mesh themselves until the first impact
+	PhysicsComponent->SetIsReplicated(false);
+
+	Keyframe = FPredictedFlightKeyframe
+	{
+		.Location = PhysicsComponent->GetComponentLocation(),
+		.SimTime = 0.0f,
+		.FlightId = FlightId,
+		.bPredicting = true
+	};
+
+	GetWorld()->GetTimerManager().SetTimer(KeyframeTimerHandle, this, &ThisClass::SendKeyframe, KeyframeInterval, true);
+
+	UE_VLOG_UELOG(GetOwner(), LogPGPawn, Log, TEXT("%s-%s: BeginServerFlight - FlightId=%d; PredictedImpactTime=%.2fs; NumPoints=%d"),
+		*LoggingUtils::GetName(GetOwner()), *GetName(), FlightId, Result.SimTime, Result.NumPoints);
+
+	return Launch;
+}
+
+void UPredictedFlightComponent::EndServerFlight(const TCHAR* Reason)
+{
+	if (!bServerPredicting)
+	{
+		return;
+	}
+
+	bServerPredicting = false;
+
+	if (auto World = GetWorld(); World)
+	{
+		World->GetTimerManager().ClearTimer(KeyframeTimerHandle);
+	}
+
+	if (PhysicsComponent)
+	{
+		PhysicsComponent->SetIsReplicated(true);
+	}
+
+	Keyframe.bPredicting = false;
+
+	UE_VLOG_UELOG(GetOwner(), LogPGPawn, Log, TEXT("%s-%s: EndServerFlight - FlightId=%d; Reason=%s; SimTime=%.2fs"),
+		*LoggingUtils::GetName(GetOwner()), *GetName(), FlightId, Reason, Keyframe.SimTime);
+}
+
+void UPredictedFlightComponent::BeginClientFlight(const FNetworkFlightLaunch& Launch, const FPaperGolfTrajectoryParams& TrajectoryParams)
+{
+	if (bClientPlayback)
+	{
+		EndClientFlight(TEXT("NewFlight"));
+	}
+
+	if (!PhysicsComponent || !Solve(TrajectoryParams))
+	{
+		UE_VLOG_UELOG(GetOwner(), LogPGPawn, Warning, TEXT("%s-%s: BeginClientFlight - FlightId=%d - Unable to simulate flight"),
+			*LoggingUtils::GetName(GetOwner()), *GetName(), Launch.FlightId);
+		return;
+	}
+
+	FlightId = Launch.FlightId;
+	PlaybackTime = 0.0f;
+	CorrectionOffset = TargetCorrectionOffset = FVector::ZeroVector;
+	NumKeyframes = 0;
+	TotalKeyframeError = MaxKeyframeError = 0.0;
+
+	// Playback drives the mesh directly so local physics would only fight it
+	bRestoreSimulatePhysics = PhysicsComponent->IsSimulatingPhysics();
+	if (bRestoreSimulatePhysics)
+	{
+		PhysicsComponent->SetSimulatePhysics(false);
+	}
+
+	bClientPlayback = true;
+	SetComponentTickEnabled(true);
+
+	UE_VLOG_UELOG(GetOwner(), LogPGPawn, Log, TEXT("%s-%s: BeginClientFlight - FlightId=%d; PredictedImpactTime=%.2fs; NumPoints=%d"),
+		*LoggingUtils::GetName(GetOwner()), *GetName(), FlightId, Result.SimTime, Result.NumPoints);
+}
+
+void UPredictedFlightComponent::EndClientFlight(const TCHAR* Reason)
+{
+	if (!bClientPlayback)
+	{
+		return;
+	}
+
+	bClientPlayback = false;
+	SetComponentTickEnabled(false);
+
+	if (bRestoreSimulatePhysics && PhysicsComponent)
+	{
+		PhysicsComponent->SetSimulatePhysics(true);
+	}
+	bRestoreSimulatePhysics = false;
+
+	// Summary is parsed by Tools/Multiplayer/PredictedFlightTest to measure divergence
+	UE_LOG(LogPGPawn, Display, TEXT("%s-%s: EndClientFlight - FlightId=%d; Reason=%s; PlaybackTime=%.2fs; Keyframes=%d; MeanError=%.2f; MaxError=%.2f"),
+		*LoggingUtils::GetName(GetOwner()), *GetName(), FlightId, Reason, PlaybackTime, NumKeyframes,
+		NumKeyframes ? TotalKeyframeError / NumKeyframes : 0.0, MaxKeyframeError);
+
+	UE_VLOG(GetOwner(), LogPGPawn, Log, TEXT("%s-%s: EndClientFlight - FlightId=%d; Reason=%s"),
+		*LoggingUtils::GetName(GetOwner()), *GetName(), FlightId, Reason);
+}
+
+void UPredictedFlightComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (!bClientPlayback || !PhysicsComponent)
+	{
+		SetComponentTickEnabled(false);
+		return;
+	}
+
+	// Hold at the predicted impact until the server resumes replicating the mesh
+	PlaybackTime = FMath::Min(PlaybackTime + DeltaTime, Result.SimTime);
+	CorrectionOffset = FMath::VInterpTo(CorrectionOffset, TargetCorrectionOffset, DeltaTime, CorrectionBlendSpeed);
+
+	PhysicsComponent->SetWorldLocationAndRotation(
+		GetPredictedLocation(PlaybackTime) + CorrectionOffset, GetPredictedRotation(PlaybackTime), false, nullptr, ETeleportType::TeleportPhysics);
+}
+
+void UPredictedFlightComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	Super::EndPlay(EndPlayReason);
+
+	if (auto World = GetWorld(); World)
+	{
+		World->GetTimerManager().ClearTimer(KeyframeTimerHandle);
+	}
+
+	bServerPredicting = false;
+	bClientPlayback = false;
+}
+
+bool UPredictedFlightComponent::Solve(const FPaperGolfTrajectoryParams& TrajectoryParams)
+{
+	check(PhysicsComponent);
+
+	auto World = GetWorld();
+	if (!ensure(World))
+	{
+		return false;
+	}
+
+	// Deliberately not using the pawn prediction cache so that both sides always run the same fresh simulation
+	const auto OutPath = Scratch.Prepare(TrajectoryParams);
+	FPaperGolfTrajectorySolver::Solve(*World, TrajectoryParams, Scratch.QueryParams, OutPath, Result);
+
+	if (Result.NumPoints < 2)
+	{
+		return false;
+	}
+
+	PathOffset = PhysicsComponent->GetComponentLocation() - TrajectoryParams.StartLocation;
+	LaunchRotation = PhysicsComponent->GetComponentQuat();
+	LaunchAngularVelocity = TrajectoryParams.AngularVelocity;
+	AngularDamping = TrajectoryParams.AngularDamping;
+
+	return true;
+}
+
+FVector UPredictedFlightComponent::GetPredictedLocation(float SimTime) const
+{
+	const auto Path = Scratch.GetPath(Result);
+	check(Path.Num() >= 2);
+
+	// Points are at fixed steps apart from the final impact point
+	const auto Index = FMath::Clamp(FMath::FloorToInt32(SimTime * SimFrequency), 0, Path.Num() - 2);
+	const auto& Start = Path[Index];
+	const auto& End = Path[Index + 1];
+
+	const auto Alpha = End.Time > Start.Time ? FMath::Clamp((SimTime - Start.Time) / (End.Time - Start.Time), 0.0f, 1.0f) : 1.0f;
+
+	return FMath::Lerp(Start.Location, End.Location, Alpha) + PathOffset;
+}
+
+FQuat UPredictedFlightComponent::GetPredictedRotation(float SimTime) const
+{
+	return FQuat::MakeFromRotationVector(GetDampedRotationVector(LaunchAngularVelocity, AngularDamping, SimFrequency, SimTime)) * LaunchRotation;
+}
+
+void UPredictedFlightComponent::SendKeyframe()
+{
+	if (!bServerPredicting || !PhysicsComponent)
+	{
+		return;
+	}
+
+	const auto SimTime = static_cast<float>(GetWorld()->GetTimeSeconds() - FlightStartTimeSeconds);
+	const auto& Location = PhysicsComponent->GetComponentLocation();
+
+	Keyframe = FPredictedFlightKeyframe
+	{
+		.Location = Location,
+		.SimTime = SimTime,
+		.FlightId = FlightId,
+		.bPredicting = true
+	};
+
+	if (SimTime >= Result.SimTime)
+	{
+		EndServerFlight(TEXT("Impact"));
+	}
+	else if (const auto Error = FVector::Dist(Location, GetPredictedLocation(SimTime)); Error > MaxPredictionError)
+	{
+		UE_VLOG_UELOG(GetOwner(), LogPGPawn, Log, TEXT("%s-%s: SendKeyframe - FlightId=%d; Error=%.1f exceeds MaxPredictionError=%.1f at SimTime=%.2fs"),
+			*LoggingUtils::GetName(GetOwner()), *GetName(), FlightId, Error, MaxPredictionError, SimTime);
+
+		EndServerFlight(TEXT("Diverged"));
+	}
+}
+
+void UPredictedFlightComponent::OnRep_Keyframe()
+{
+	if (!bClientPlayback || Keyframe.FlightId != FlightId)
+	{
+		return;
+	}
+
+	if (!Keyframe.bPredicting)
+	{
+		EndClientFlight(TEXT("ServerEnded"));
+		return;
+	}
+
+	// Keyframes and the launch arrive with the same latency so the key time lines up with the playback time
+	const auto SimTime = FMath::Min(Keyframe.SimTime, Result.SimTime);
+	const auto Error = Keyframe.Location - GetPredictedLocation(SimTime);
+	const auto ErrorSize = Error.Size();
+
+	TargetCorrectionOffset = Error;
+
+	++NumKeyframes;
+	TotalKeyframeError += ErrorSize;
+	MaxKeyframeError = FMath::Max(MaxKeyframeError, ErrorSize);
+
+	UE_VLOG_UELOG(GetOwner(), LogPGPawn, Verbose, TEXT("%s-%s: OnRep_Keyframe - FlightId=%d; SimTime=%.2fs; PlaybackTime=%.2fs; Error=%.2f"),
+		*LoggingUtils::GetName(GetOwner()), *GetName(), FlightId, Keyframe.SimTime, PlaybackTime, ErrorSize);
+}
+
+namespace
+{
+	FVector GetDampedRotationVector(const FVector& AngularVelocity, float Damping, float SimFrequency, float SimTime)
+	{
+		// Sum of the angular velocity damped each step like FPaperGolfTrajectorySolver, which is a geometric series
+		const auto DeltaTime = 1.0f / SimFrequency;
+		const auto DampingFactor = FMath::Max(0.0f, 1.0f - Damping * DeltaTime);
+		const auto NumSteps = SimTime * SimFrequency;
+
+		if (FMath::IsNearlyEqual(DampingFactor, 1.0f))
+		{
+			return AngularVelocity * SimTime;
+		}
+
+		return AngularVelocity * (DeltaTime * DampingFactor * (1.0f - FMath::Pow(DampingFactor, NumSteps)) / (1.0f - DampingFactor));
+	}
+}
@@ -0,0 +1,153 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+
+#include "PaperGolfTypes.h"
+#include "Library/PaperGolfTrajectorySolver.h"
+#include "Engine/NetSerialization.h"
+
+#include "PredictedFlightComponent.generated.h"
+
+class UPrimitiveComponent;
+struct FNetworkFlightLaunch;
+
+/*
+* Sparse server state used to correct the flight that the clients are simulating.
+*/
+USTRUCT()
+struct FPredictedFlightKeyframe
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector_NetQuantize10 Location{};
+
+	// Seconds since the flick on the server
+	UPROPERTY()
+	float SimTime{};
+
+	UPROPERTY()
+	uint8 FlightId{};
+
+	// False once the server has stopped predicting and resumed replicating the mesh
+	UPROPERTY()
+	bool bPredicting{};
+};
+
+/*
+* Replaces per-frame movement replication of a flick with a fixed step simulation that the server and every client run from the same launch state.
+* The server stops replicating the pawn mesh until the predicted first impact and sends sparse keyframes that simulated proxies blend toward.
+* Bounces are left to regular replication as they are too sensitive to the exact contact to predict.
+*/
+UCLASS()
+class UPredictedFlightComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UPredictedFlightComponent();
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	void Initialize(UPrimitiveComponent& InPhysicsComponent);
+
+	bool IsEnabled() const;
+
+	/*
+	* Predict params for the shared simulation. The server and clients must use the same values for the simulations to match.
+	*/
+	FFlickPredictParams GetPredictParams() const;
+
+	/*
+	* Called on the server just before the flick impulse is applied. Returns the launch state for the clients.
+	*/
+	FNetworkFlightLaunch BeginServerFlight(const FPaperGolfTrajectoryParams& TrajectoryParams);
+	void EndServerFlight(const TCHAR* Reason);
+
+	/*
+	* Called on simulated proxies with the pawn already moved to the launch location.
+	*/
+	void BeginClientFlight(const FNetworkFlightLaunch& Launch, const FPaperGolfTrajectoryParams& TrajectoryParams);
+	void EndClientFlight(const TCHAR* Reason);
+
+	bool IsPlayingBack() const { return bClientPlayback; }
+
+protected:
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	bool Solve(const FPaperGolfTrajectoryParams& TrajectoryParams);
+
+	FVector GetPredictedLocation(float SimTime) const;
+	FQuat GetPredictedRotation(float SimTime) const;
+
+	void SendKeyframe();
+
+	UFUNCTION()
+	void OnRep_Keyframe();
+
+private:
+	UPROPERTY(Transient)
+	TObjectPtr<UPrimitiveComponent> PhysicsComponent{};
+
+	UPROPERTY(Transient, ReplicatedUsing = OnRep_Keyframe)
+	FPredictedFlightKeyframe Keyframe{};
+
+	UPROPERTY(Category = "Config", EditDefaultsOnly)
+	bool bEnabled{};
+
+	UPROPERTY(Category = "Config", EditDefaultsOnly, meta = (ClampMin = "1.0"))
+	float SimFrequency{ 60.0f };
+
+	UPROPERTY(Category = "Config", EditDefaultsOnly, meta = (ClampMin = "0.1"))
+	float MaxSimTime{ 10.0f };
+
+	UPROPERTY(Category = "Config", EditDefaultsOnly, meta = (ClampMin = "0.1"))
+	float CollisionRadius{ 3.0f };
+
+	UPROPERTY(Category = "Config", EditDefaultsOnly, meta = (ClampMin = "0.01"))
+	float KeyframeInterval{ 0.25f };
+
+	/*
+	* Rate the correction from the latest keyframe is blended in on the clients.
+	*/
+	UPROPERTY(Category = "Config", EditDefaultsOnly, meta = (ClampMin = "0.0"))
+	float CorrectionBlendSpeed{ 5.0f };
+
+	/*
+	* The server falls back to replicating the mesh if the flight is further than this from the prediction, e.g. from hitting a moving obstacle.
+	*/
+	UPROPERTY(Category = "Config", EditDefaultsOnly, meta = (ClampMin = "0.0"))
+	float MaxPredictionError{ 50.0f };
+
+	FPaperGolfTrajectoryScratch Scratch{};
+	FPaperGolfTrajectoryResult Result{};
+
+	// Path points are for the flick location so this maps them to the physics component
+	FVector PathOffset{ EForceInit::ForceInitToZero };
+	FQuat LaunchRotation{ EForceInit::ForceInitToZero };
+	FVector LaunchAngularVelocity{ EForceInit::ForceInitToZero };
+	float AngularDamping{};
+
+	double FlightStartTimeSeconds{};
+	float PlaybackTime{};
+	uint8 FlightId{};
+
+	FVector CorrectionOffset{ EForceInit::ForceInitToZero };
+	FVector TargetCorrectionOffset{ EForceInit::ForceInitToZero };
+
+	// Divergence of the client simulation measured at each keyframe
+	int32 NumKeyframes{};
+	double TotalKeyframeError{};
+	double MaxKeyframeError{};
+
+	FTimerHandle KeyframeTimerHandle{};
+
+	bool bServerPredicting{};
+	bool bClientPlayback{};
+	bool bRestoreSimulatePhysics{};
+};
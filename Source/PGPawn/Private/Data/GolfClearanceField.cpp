@@ -0,0 +1,122 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+#include "Data/GolfClearanceField.h"
+
+#include "Logging/LoggingUtils.h"
+#include "PGPawnLogging.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(GolfClearanceField)
+
+namespace
+{
+	float Bilerp(const TArray<int16>& Values, int32 Index00, int32 Index10, int32 Index01, int32 Index11, double FX, double FY);
+}
+
+bool FGolfClearanceFieldHole::IsValid() const
+{
+	const auto NumCells = GetNumCells();
+
+	return CellSize > 0 && Size.X >= 2 && Size.Y >= 2 &&
+		ObstacleDistances.Num() == NumCells && HazardDistances.Num() == NumCells && GroundHeights.Num() == NumCells;
+}
+
+bool FGolfClearanceFieldHole::Contains(const FVector& Location) const
+{
+	const auto LocalX = (Location.X - Origin.X) / CellSize;
+	const auto LocalY = (Location.Y - Origin.Y) / CellSize;
+
+	return LocalX >= 0 && LocalX <= Size.X - 1 && LocalY >= 0 && LocalY <= Size.Y - 1;
+}
+
+FGolfClearanceFieldSample FGolfClearanceFieldHole::Sample(const FVector& Location) const
+{
+	checkSlow(IsValid());
+
+	const auto LocalX = (Location.X - Origin.X) / CellSize;
+	const auto LocalY = (Location.Y - Origin.Y) / CellSize;
+
+	const auto X0 = FMath::Clamp(FMath::FloorToInt32(LocalX), 0, Size.X - 2);
+	const auto Y0 = FMath::Clamp(FMath::FloorToInt32(LocalY), 0, Size.Y - 2);
+
+	const auto FX = FMath::Clamp(LocalX - X0, 0.0, 1.0);
+	const auto FY = FMath::Clamp(LocalY - Y0, 0.0, 1.0);
+
+	const auto Index00 = GetCellIndex(X0, Y0);
+	const auto Index10 = Index00 + 1;
+	const auto Index01 = Index00 + Size.X;
+	const auto Index11 = Index01 + 1;
+
+	// Derivative of the bilinear interpolation
+	const double D00 = ObstacleDistances[Index00], D10 = ObstacleDistances[Index10], D01 = ObstacleDistances[Index01], D11 = ObstacleDistances[Index11];
+	const FVector2D Gradient
+	{
+		(D10 - D00) * (1 - FY) + (D11 - D01) * FY,
+		(D01 - D00) * (1 - FX) + (D11 - D10) * FX
+	};
+
+	FGolfClearanceFieldSample Sample
+	{
+		.ObstacleDistance = Bilerp(ObstacleDistances, Index00, Index10, Index01, Index11, FX, FY),
+		.ObstacleGradient = Gradient.GetSafeNormal(),
+		.HazardDistance = Bilerp(HazardDistances, Index00, Index10, Index01, Index11, FX, FY)
+	};
+
+	// Interpolating ground across a ledge would give a height that doesn't exist so use the nearest cell
+	const auto NearestIndex = GetCellIndex(FMath::RoundToInt32(FMath::Clamp(LocalX, 0.0, Size.X - 1.0)), FMath::RoundToInt32(FMath::Clamp(LocalY, 0.0, Size.Y - 1.0)));
+	if (const auto GroundHeight = GroundHeights[NearestIndex]; GroundHeight != NoGround)
+	{
+		Sample.GroundZ = BaseZ + GroundHeight;
+	}
+
+	return Sample;
+}
+
+void UGolfClearanceField::PostLoad()
+{
+	Super::PostLoad();
+
+	for (const auto& Hole : Holes)
+	{
+		ensureMsgf(Hole.IsValid(), TEXT("%s: PostLoad - HoleNumber=%d is invalid; Size=%s; CellSize=%f"),
+			*GetName(), Hole.HoleNumber, *Hole.Size.ToString(), Hole.CellSize);
+	}
+
+	UE_LOG(LogPGPawn, Log, TEXT("%s: PostLoad - Loaded %d hole%s with %d cell%s; ProbeHalfHeight=%f; MaxDistance=%f"),
+		*GetName(), Holes.Num(), LoggingUtils::Pluralize(Holes.Num()), GetNumCells(), LoggingUtils::Pluralize(GetNumCells()), ProbeHalfHeight, MaxDistance);
+}
+
+const FGolfClearanceFieldHole* UGolfClearanceField::FindHole(const FVector& Location) const
+{
+	return Holes.FindByPredicate([&](const auto& Hole) { return Hole.IsValid() && Hole.Contains(Location); });
+}
+
+void UGolfClearanceField::SetHole(FGolfClearanceFieldHole&& Hole)
+{
+	if (auto ExistingHole = Holes.FindByPredicate([&](const auto& Candidate) { return Candidate.HoleNumber == Hole.HoleNumber; }); ExistingHole)
+	{
+		*ExistingHole = MoveTemp(Hole);
+	}
+	else
+	{
+		Holes.Add(MoveTemp(Hole));
+		Holes.Sort([](const auto& First, const auto& Second) { return First.HoleNumber < Second.HoleNumber; });
+	}
+}
+
+int32 UGolfClearanceField::GetNumCells() const
+{
+	int32 NumCells{};
+	for (const auto& Hole : Holes)
+	{
+		NumCells += Hole.GetNumCells();
+	}
+	return NumCells;
+}
+
+namespace
+{
+	float Bilerp(const TArray<int16>& Values, int32 Index00, int32 Index10, int32 Index01, int32 Index11, double FX, double FY)
+	{
+		return FMath::BiLerp<double>(Values[Index00], Values[Index10], Values[Index01], Values[Index11], FX, FY);
+	}
+}
@@ -0,0 +1,131 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+#include "Data/GolfFocusVisibilityField.h"
+
+#include "Logging/LoggingUtils.h"
+#include "PGPawnLogging.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(GolfFocusVisibilityField)
+
+float FGolfFocusTraceParams::GetSelectedEndOffset(float ElevationDiff, float FocusEndOffset) const
+{
+	const auto EndOffsetToUse = FocusEndOffset >= 1 ? FocusEndOffset : EndOffset;
+
+	return FMath::Clamp(EndOffsetToUse + ElevationDiff, StartOffset, MaxEndOffset);
+}
+
+bool FGolfFocusTraceParams::Equals(const FGolfFocusTraceParams& Other, float Tolerance) const
+{
+	return FMath::IsNearlyEqual(StartOffset, Other.StartOffset, Tolerance) &&
+		FMath::IsNearlyEqual(EndOffset, Other.EndOffset, Tolerance) &&
+		FMath::IsNearlyEqual(MaxEndOffset, Other.MaxEndOffset, Tolerance);
+}
+
+bool FGolfFocusVisibilityHole::IsValid() const
+{
+	const auto NumCells = GetNumCells();
+	const auto NumFocusActors = GetNumFocusActors();
+
+	return CellSize > 0 && Size.X >= 1 && Size.Y >= 1 && NumFocusActors <= MaxFocusActors &&
+		FocusActorLocations.Num() == NumFocusActors && FocusVisibility.Num() == NumFocusActors &&
+		PawnHeights.Num() == NumCells && CellVisibility.Num() == NumCells && CellDynamic.Num() == NumCells;
+}
+
+int32 FGolfFocusVisibilityHole::FindFocusIndex(FName FocusActorName, const FVector& FocusActorLocation, float MaxMoveDistance) const
+{
+	const auto Index = FocusActorNames.IndexOfByKey(FocusActorName);
+	if (Index == INDEX_NONE || FVector::DistSquared(FocusActorLocations[Index], FocusActorLocation) > FMath::Square(MaxMoveDistance))
+	{
+		return INDEX_NONE;
+	}
+
+	return Index;
+}
+
+int32 FGolfFocusVisibilityHole::FindCellIndex(const FVector& Location, float MaxHeightDifference) const
+{
+	checkSlow(IsValid());
+
+	const auto X = FMath::RoundToInt32((Location.X - Origin.X) / CellSize);
+	const auto Y = FMath::RoundToInt32((Location.Y - Origin.Y) / CellSize);
+
+	if (X < 0 || X >= Size.X || Y < 0 || Y >= Size.Y)
+	{
+		return INDEX_NONE;
+	}
+
+	const auto Index = GetCellIndex(X, Y);
+
+	// Line of sight from a ledge says nothing about line of sight from under it
+	const auto PawnHeight = PawnHeights[Index];
+	if (PawnHeight == NoGround || FMath::Abs(BaseZ + PawnHeight - Location.Z) > MaxHeightDifference)
+	{
+		return INDEX_NONE;
+	}
+
+	return Index;
+}
+
+TOptional<bool> FGolfFocusVisibilityHole::HasLOSToFocus(int32 CellIndex, int32 FocusIndex) const
+{
+	check(CellVisibility.IsValidIndex(CellIndex) && FocusActorNames.IsValidIndex(FocusIndex));
+
+	const auto FocusBit = uint64{ 1 } << FocusIndex;
+
+	if (CellDynamic[CellIndex] & FocusBit)
+	{
+		return {};
+	}
+
+	return (CellVisibility[CellIndex] & FocusBit) != 0;
+}
+
+bool FGolfFocusVisibilityHole::HasLOSBetweenFocusActors(int32 FromFocusIndex, int32 ToFocusIndex) const
+{
+	check(FocusVisibility.IsValidIndex(FromFocusIndex) && FocusVisibility.IsValidIndex(ToFocusIndex));
+
+	return (FocusVisibility[FromFocusIndex] & (uint64{ 1 } << ToFocusIndex)) != 0;
+}
+
+void UGolfFocusVisibilityField::PostLoad()
+{
+	Super::PostLoad();
+
+	for (const auto& Hole : Holes)
+	{
+		ensureMsgf(Hole.IsValid(), TEXT("%s: PostLoad - HoleNumber=%d is invalid; Size=%s; CellSize=%f; NumFocusActors=%d"),
+			*GetName(), Hole.HoleNumber, *Hole.Size.ToString(), Hole.CellSize, Hole.GetNumFocusActors());
+	}
+
+	UE_LOG(LogPGPawn, Log, TEXT("%s: PostLoad - Loaded %d hole%s with %d cell%s; StartOffset=%f; EndOffset=%f; MaxEndOffset=%f"),
+		*GetName(), Holes.Num(), LoggingUtils::Pluralize(Holes.Num()), GetNumCells(), LoggingUtils::Pluralize(GetNumCells()),
+		TraceParams.StartOffset, TraceParams.EndOffset, TraceParams.MaxEndOffset);
+}
+
+const FGolfFocusVisibilityHole* UGolfFocusVisibilityField::FindHole(int32 HoleNumber) const
+{
+	return Holes.FindByPredicate([HoleNumber](const auto& Hole) { return Hole.HoleNumber == HoleNumber && Hole.IsValid(); });
+}
+
+void UGolfFocusVisibilityField::SetHole(FGolfFocusVisibilityHole&& Hole)
+{
+	if (auto ExistingHole = Holes.FindByPredicate([&](const auto& Candidate) { return Candidate.HoleNumber == Hole.HoleNumber; }); ExistingHole)
+	{
+		*ExistingHole = MoveTemp(Hole);
+	}
+	else
+	{
+		Holes.Add(MoveTemp(Hole));
+		Holes.Sort([](const auto& First, const auto& Second) { return First.HoleNumber < Second.HoleNumber; });
+	}
+}
+
+int32 UGolfFocusVisibilityField::GetNumCells() const
+{
+	int32 NumCells{};
+	for (const auto& Hole : Holes)
+	{
+		NumCells += Hole.GetNumCells();
+	}
+	return NumCells;
+}
@@ -0,0 +1,162 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+
+#include "Library/PaperGolfBounceSolver.h"
+
+#include "Library/PaperGolfSurfaceMaterialCache.h"
+
+#include "Engine/World.h"
+#include "CollisionQueryParams.h"
+#include "CollisionShape.h"
+
+#include "PhysicalMaterials/PhysicalMaterial.h"
+
+namespace
+{
+	// Keeps the next arc from starting inside the surface it bounced off
+	constexpr float SurfaceOffset = 0.1f;
+
+	void GetSurfaceResponse(const FHitResult& HitResult, const FPaperGolfBounceParams& BounceParams, float& OutRestitution, float& OutFriction);
+	FVector GetReboundVelocity(const FVector& Velocity, const FVector& Normal, float Restitution, float Friction);
+	FVector Slide(const UWorld& World, const FPaperGolfTrajectoryParams& Params, const FPaperGolfBounceParams& BounceParams,
+		const FVector& Location, const FVector& Normal, const FVector& TangentVelocity, float Friction);
+}
+
+bool FPaperGolfBounceSolver::Solve(const UWorld& World, const FPaperGolfTrajectoryParams& Params, const FPaperGolfTrajectoryResult& Landing, const FPaperGolfBounceParams& BounceParams,
+	FPaperGolfBounceResult& OutResult)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("FPaperGolfBounceSolver::Solve");
+
+	OutResult = {};
+	OutResult.RestLocation = Landing.LastLocation;
+
+	if (!Landing.bHit)
+	{
+		return false;
+	}
+
+	const auto MaxBounces = FMath::Clamp(BounceParams.MaxBounces, 0, PG::Trajectory::MaxBounces);
+
+	auto ArcParams = Params;
+	ArcParams.MaxSimTime = BounceParams.MaxBounceSimTime;
+	ArcParams.MaxHorizontalDistance = 0;
+
+	FHitResult HitResult = Landing.HitResult;
+	FVector Velocity = Landing.LastVelocity;
+	FVector AngularVelocity = Landing.LastAngularVelocity;
+
+	for (;;)
+	{
+		const FVector& Normal = HitResult.ImpactNormal;
+
+		OutResult.Contacts.Add(FPaperGolfBounceContact
+		{
+			.Location = HitResult.ImpactPoint,
+			.ImpactNormal = Normal,
+			.Velocity = Velocity
+		});
+
+		float Restitution, Friction;
+		GetSurfaceResponse(HitResult, BounceParams, Restitution, Friction);
+
+		const auto ReboundVelocity = GetReboundVelocity(Velocity, Normal, Restitution, Friction);
+		const auto ReboundNormalSpeed = ReboundVelocity | Normal;
+
+		if (ReboundNormalSpeed < BounceParams.RestSpeed || OutResult.NumBounces >= MaxBounces)
+		{
+			OutResult.RestLocation = Slide(World, Params, BounceParams, HitResult.Location, Normal, ReboundVelocity - Normal * ReboundNormalSpeed, Friction);
+			OutResult.bAtRest = ReboundNormalSpeed < BounceParams.RestSpeed;
+			break;
+		}
+
+		++OutResult.NumBounces;
+
+		ArcParams.StartLocation = HitResult.Location + Normal * SurfaceOffset;
+		ArcParams.LaunchVelocity = ReboundVelocity;
+		ArcParams.AngularVelocity = AngularVelocity;
+
+		FPaperGolfTrajectoryResult ArcResult;
+		if (!FPaperGolfTrajectorySolver::Solve(World, ArcParams, {}, ArcResult))
+		{
+			// Did not come back down in time, e.g. bounced off the edge of the course
+			OutResult.RestLocation = ArcResult.LastLocation;
+			break;
+		}
+
+		HitResult = ArcResult.HitResult;
+		Velocity = ArcResult.LastVelocity;
+		AngularVelocity = ArcResult.LastAngularVelocity;
+	}
+
+	return OutResult.bAtRest;
+}
+
+FString FPaperGolfBounceResult::ToString() const
+{
+	return FString::Printf(TEXT("bAtRest=%s; RestLocation=%s; NumBounces=%d; NumContacts=%d"),
+		bAtRest ? TEXT("TRUE") : TEXT("FALSE"), *RestLocation.ToCompactString(), NumBounces, Contacts.Num());
+}
+
+namespace
+{
+	void GetSurfaceResponse(const FHitResult& HitResult, const FPaperGolfBounceParams& BounceParams, float& OutRestitution, float& OutFriction)
+	{
+		if (BounceParams.SurfaceMaterialCache)
+		{
+			const auto Response = BounceParams.SurfaceMaterialCache->Get(HitResult, { BounceParams.DefaultRestitution, BounceParams.DefaultFriction });
+			OutRestitution = Response.Restitution;
+			OutFriction = Response.Friction;
+		}
+		else if (const auto PhysicalMaterial = HitResult.PhysMaterial.Get(); PhysicalMaterial)
+		{
+			OutRestitution = PhysicalMaterial->Restitution;
+			OutFriction = PhysicalMaterial->Friction;
+		}
+		else
+		{
+			OutRestitution = BounceParams.DefaultRestitution;
+			OutFriction = BounceParams.DefaultFriction;
+		}
+	}
+
+	FVector GetReboundVelocity(const FVector& Velocity, const FVector& Normal, float Restitution, float Friction)
+	{
+		const auto NormalSpeed = Velocity | Normal;
+		const FVector TangentVelocity = Velocity - Normal * NormalSpeed;
+
+		// Coulomb friction limited by the normal impulse of the contact
+		const auto NormalImpulse = (1 + Restitution) * FMath::Abs(NormalSpeed);
+		const auto TangentSpeed = TangentVelocity.Size();
+		const auto TangentScale = TangentSpeed > UE_KINDA_SMALL_NUMBER ? FMath::Max(0.0f, 1 - Friction * NormalImpulse / TangentSpeed) : 0.0f;
+
+		return TangentVelocity * TangentScale - Normal * (NormalSpeed * Restitution);
+	}
+
+	FVector Slide(const UWorld& World, const FPaperGolfTrajectoryParams& Params, const FPaperGolfBounceParams& BounceParams,
+		const FVector& Location, const FVector& Normal, const FVector& TangentVelocity, float Friction)
+	{
+		// v^2 = 2ad with the deceleration from friction against the normal component of gravity
+		const auto Deceleration = Friction * FMath::Abs(Params.GravityZ) * FMath::Max(0.0, Normal.Z);
+		const auto SlideDistance = Deceleration > UE_KINDA_SMALL_NUMBER
+			? FMath::Min(TangentVelocity.SizeSquared() / (2 * Deceleration), BounceParams.MaxSlideDistance)
+			: BounceParams.MaxSlideDistance;
+
+		const auto SlideEnd = Location + TangentVelocity.GetSafeNormal() * SlideDistance;
+
+		if (!Params.bTraceWithCollision || SlideDistance <= UE_KINDA_SMALL_NUMBER)
+		{
+			return SlideEnd;
+		}
+
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(PaperGolfBounceSlide), false, Params.IgnoreActor);
+		const FVector SweepStart = Location + Normal * SurfaceOffset;
+
+		if (FHitResult HitResult; World.SweepSingleByChannel(HitResult, SweepStart, SlideEnd + Normal * SurfaceOffset, FQuat::Identity, Params.TraceChannel,
+			FCollisionShape::MakeSphere(Params.CollisionRadius), QueryParams))
+		{
+			return HitResult.Location;
+		}
+
+		return SlideEnd;
+	}
+}
@@ -13,6 +13,7 @@
 #include "PGPawnLogging.h"
 
 #include "Pawn/PaperGolfPawn.h"
+#include "Library/PaperGolfTrajectorySolver.h"
 
 #include "Utils/CollisionUtils.h"
 #include "Utils/PGMathUtils.h"
@@ -224,32 +225,39 @@ bool UPaperGolfPawnUtilities::TraceShotAngle(const UObject* WorldContextObject,
 	auto World = WorldContextObject->GetWorld();
 	check(World);
 
-	const auto TraceAngle = FlickAngleDegrees > 0 ? FlickAngleDegrees : 0;
-	const auto MaxHeight = TraceAngle > 0 ? PG::MathUtils::GetMaxProjectileHeight(WorldContextObject, FlickAngleDegrees, FlickSpeed) : 0;
-
 	FCollisionQueryParams QueryParams;
 	QueryParams.AddIgnoredActor(PlayerPawn);
 
-	// Pitch up or down based on the FlickAngleDegrees
-	const auto PitchedFlickDirection = FlickDirection.RotateAngleAxis(TraceAngle, -PlayerPawn->GetActorRightVector());
-
-	// Need the horizontal distance to be MinTraceLength and the Z to be MaxHeigth
-	// Pythagorean theorem: a^2 + b^2 = c^2
-	const auto TraceLength = FMath::Sqrt(FMath::Square(MinTraceDistance) + FMath::Square(MaxHeight));
-	const FVector TraceEnd = TraceStart + PitchedFlickDirection * TraceLength;
+	const FVector TraceEnd = GetShotAngleTraceEnd(WorldContextObject, *PlayerPawn, TraceStart, FlickDirection, FlickSpeed, FlickAngleDegrees, MinTraceDistance);
 
 	// Try line trace directly to trace length as an approximation
 	bool bPass = !World->LineTraceTestByChannel(TraceStart, TraceEnd, PG::CollisionChannel::FlickTraceType, QueryParams);
 
 	UE_VLOG_ARROW(GetVisualLoggerOwner(WorldContextObject), LogPGPawn, Log, TraceStart, TraceEnd, bPass ? FColor::Green : FColor::Red, TEXT("Trace %.1f"), FlickAngleDegrees);
-	UE_VLOG_UELOG(GetVisualLoggerOwner(WorldContextObject), LogPGPawn, Verbose, TEXT("%s-%s: TraceShotAngle - TraceStart=%s; FlickDirection=%s; PitchedFlickDirection=%s; FlickAngle=%.1f; FlickSpeed=%.1f; MaxHeight=%.1f; bPass=%s"),
+	UE_VLOG_UELOG(GetVisualLoggerOwner(WorldContextObject), LogPGPawn, Verbose, TEXT("%s-%s: TraceShotAngle - TraceStart=%s; TraceEnd=%s; FlickDirection=%s; FlickAngle=%.1f; FlickSpeed=%.1f; bPass=%s"),
 		*LoggingUtils::GetName(GetVisualLoggerOwner(WorldContextObject)), *WorldContextObject->GetName(),
-		*TraceStart.ToCompactString(), *FlickDirection.ToCompactString(), *PitchedFlickDirection.ToCompactString(), FlickAngleDegrees, FlickSpeed, MaxHeight, LoggingUtils::GetBoolString(bPass));
+		*TraceStart.ToCompactString(), *TraceEnd.ToCompactString(), *FlickDirection.ToCompactString(), FlickAngleDegrees, FlickSpeed, LoggingUtils::GetBoolString(bPass));
 
 	return bPass;
 }
 
-bool UPaperGolfPawnUtilities::TraceCurrentShotWithParameters(const UObject* WorldContextObject, const APaperGolfPawn* PlayerPawn, const FFlickParams& FlickParams, float FlickAngleDegrees, float MinTraceDistance)
+FVector UPaperGolfPawnUtilities::GetShotAngleTraceEnd(const UObject* WorldContextObject, const APaperGolfPawn& PlayerPawn, const FVector& TraceStart, const FVector& FlickDirection, float FlickSpeed, float FlickAngleDegrees, float MinTraceDistance)
+{
+	const auto TraceAngle = FlickAngleDegrees > 0 ? FlickAngleDegrees : 0;
+	const auto MaxHeight = TraceAngle > 0 ? PG::MathUtils::GetMaxProjectileHeight(WorldContextObject, FlickAngleDegrees, FlickSpeed) : 0;
+
+	// Pitch up or down based on the FlickAngleDegrees
+	const auto PitchedFlickDirection = FlickDirection.RotateAngleAxis(TraceAngle, -PlayerPawn.GetActorRightVector());
+
+	// Need the horizontal distance to be MinTraceLength and the Z to be MaxHeigth
+	// Pythagorean theorem: a^2 + b^2 = c^2
+	const auto TraceLength = FMath::Sqrt(FMath::Square(MinTraceDistance) + FMath::Square(MaxHeight));
+
+	return TraceStart + PitchedFlickDirection * TraceLength;
+}
+
+bool UPaperGolfPawnUtilities::TraceCurrentShotWithParameters(const UObject* WorldContextObject, const APaperGolfPawn* PlayerPawn, const FFlickParams& FlickParams,
+	float FlickAngleDegrees, float MinTraceDistance, bool bSimulateTrajectory)
 {
 	if (!ensure(WorldContextObject))
 	{
@@ -263,18 +271,53 @@ bool UPaperGolfPawnUtilities::TraceCurrentShotWithParameters(const UObject* Worl
 
 	const auto TraceStart = PlayerPawn->GetFlickLocation(FlickParams.LocalZOffset);
 	const auto& FlickDirection = PlayerPawn->GetFlickDirection();
-	const auto FlickSpeed = [&]()
+
+	// There is no rising part of the arc to simulate for a flat shot so just trace straight ahead for obstacles
+	if (!bSimulateTrajectory || FlickAngleDegrees <= 0)
 	{
-		if (FMath::IsNearlyEqual(FlickParams.PowerFraction, 1.0f, KINDA_SMALL_NUMBER) && 
-			FMath::IsNearlyZero(FlickParams.Accuracy, KINDA_SMALL_NUMBER))
+		const auto FlickSpeed = [&]()
 		{
-			return PlayerPawn->GetFlickMaxSpeed(FlickParams.ShotType);
-		}
-		return PlayerPawn->GetFlickSpeed(FlickParams.ShotType, FlickParams.Accuracy, FlickParams.PowerFraction);
-	}();
+			if (FMath::IsNearlyEqual(FlickParams.PowerFraction, 1.0f, KINDA_SMALL_NUMBER) && 
+				FMath::IsNearlyZero(FlickParams.Accuracy, KINDA_SMALL_NUMBER))
+			{
+				return PlayerPawn->GetFlickMaxSpeed(FlickParams.ShotType);
+			}
+			return PlayerPawn->GetFlickSpeed(FlickParams.ShotType, FlickParams.Accuracy, FlickParams.PowerFraction);
+		}();
+
+		return UPaperGolfPawnUtilities::TraceShotAngle(
+			WorldContextObject, PlayerPawn, TraceStart, FlickDirection, FlickSpeed, FlickAngleDegrees);
+	}
+
+	const auto World = WorldContextObject->GetWorld();
+	if (!ensure(World))
+	{
+		return false;
+	}
+
+	const FFlickPredictParams FlickPredictParams{};
+	auto TrajectoryParams = PlayerPawn->GetFlickTrajectoryParams(FlickParams, FlickPredictParams);
+
+	// Pitch up about the pawn's right axis
+	const auto PitchAxis = -PlayerPawn->GetActorRightVector();
+	TrajectoryParams.LaunchVelocity = TrajectoryParams.LaunchVelocity.RotateAngleAxis(FlickAngleDegrees, PitchAxis);
+	TrajectoryParams.AngularVelocity = TrajectoryParams.AngularVelocity.RotateAngleAxis(FlickAngleDegrees, PitchAxis);
+	TrajectoryParams.StartLocation = TraceStart + TrajectoryParams.LaunchVelocity.GetSafeNormal() * TrajectoryParams.CollisionRadius;
+	TrajectoryParams.MaxHorizontalDistance = MinTraceDistance;
+
+	// Only the hit is needed so no path buffer
+	FPaperGolfTrajectoryResult TrajectoryResult;
+	const bool bHit = PlayerPawn->PredictFlick(TrajectoryParams, {}, TrajectoryResult);
 
-	return UPaperGolfPawnUtilities::TraceShotAngle(
-		WorldContextObject, PlayerPawn, TraceStart, FlickDirection, FlickSpeed, FlickAngleDegrees);
+	const bool bLanded = bHit && PG::Trajectory::IsLandingHit(TrajectoryResult.LastVelocity, TrajectoryResult.HitResult.ImpactNormal);
+	const bool bPass = !bHit || bLanded;
+
+	UE_VLOG_ARROW(GetVisualLoggerOwner(WorldContextObject), LogPGPawn, Log, TrajectoryParams.StartLocation, TrajectoryResult.LastLocation, bPass ? FColor::Green : FColor::Red, TEXT("Trajectory %.1f"), FlickAngleDegrees);
+	UE_VLOG_UELOG(GetVisualLoggerOwner(WorldContextObject), LogPGPawn, Verbose, TEXT("%s-%s: TraceCurrentShotWithParameters - FlickParams=%s; FlickAngle=%.1f; bLanded=%s; bPass=%s; Result=%s"),
+		*LoggingUtils::GetName(GetVisualLoggerOwner(WorldContextObject)), *WorldContextObject->GetName(),
+		*FlickParams.ToString(), FlickAngleDegrees, LoggingUtils::GetBoolString(bLanded), LoggingUtils::GetBoolString(bPass), *TrajectoryResult.ToString());
+
+	return bPass;
 }
 
 bool UPaperGolfPawnUtilities::ShotWillReachDestination(const UObject* WorldContextObject, const APaperGolfPawn* PlayerPawn, const FFlickParams& FlickParams, const AActor* FocusActorOverride)
@@ -0,0 +1,73 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+
+#include "Library/PaperGolfSurfaceMaterialCache.h"
+
+#include "Engine/HitResult.h"
+#include "Components/PrimitiveComponent.h"
+#include "Materials/MaterialInterface.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+
+namespace
+{
+	const UPhysicalMaterial* GetPhysicalMaterial(const UPrimitiveComponent& Component, int32 FaceIndex);
+}
+
+FPaperGolfSurfaceResponse FPaperGolfSurfaceMaterialCache::Get(const FHitResult& HitResult, const FPaperGolfSurfaceResponse& Default)
+{
+	if (const auto PhysicalMaterial = HitResult.PhysMaterial.Get(); PhysicalMaterial)
+	{
+		return { PhysicalMaterial->Restitution, PhysicalMaterial->Friction };
+	}
+
+	const auto Component = HitResult.GetComponent();
+	if (!Component)
+	{
+		return Default;
+	}
+
+	const FKey Key{ Component, HitResult.FaceIndex };
+
+	if (const auto Entry = Entries.Find(Key); Entry)
+	{
+		++NumHits;
+		return *Entry;
+	}
+
+	++NumMisses;
+
+	const auto PhysicalMaterial = GetPhysicalMaterial(*Component, HitResult.FaceIndex);
+	const auto Response = PhysicalMaterial ? FPaperGolfSurfaceResponse{ PhysicalMaterial->Restitution, PhysicalMaterial->Friction } : Default;
+
+	Entries.Add(Key, Response);
+
+	return Response;
+}
+
+void FPaperGolfSurfaceMaterialCache::Reset()
+{
+	Entries.Reset();
+	NumHits = NumMisses = 0;
+}
+
+namespace
+{
+	const UPhysicalMaterial* GetPhysicalMaterial(const UPrimitiveComponent& Component, int32 FaceIndex)
+	{
+		// Complex collision hits can have a per-section material
+		if (FaceIndex != INDEX_NONE)
+		{
+			int32 SectionIndex;
+			if (const auto Material = Component.GetMaterialFromCollisionFaceIndex(FaceIndex, SectionIndex); Material)
+			{
+				if (const auto PhysicalMaterial = Material->GetPhysicalMaterial(); PhysicalMaterial)
+				{
+					return PhysicalMaterial;
+				}
+			}
+		}
+
+		// Same resolution as the physics scene uses for simple collision: the override, then the material, then the engine default
+		return Component.BodyInstance.GetSimplePhysicalMaterial();
+	}
+}
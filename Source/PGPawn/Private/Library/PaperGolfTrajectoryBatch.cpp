@@ -0,0 +1,356 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+
+#include "Library/PaperGolfTrajectoryBatch.h"
+
+#include "Engine/World.h"
+#include "CollisionQueryParams.h"
+#include "CollisionShape.h"
+
+#include "Math/VectorRegister.h"
+
+#include "PGConstants.h"
+
+#if PG_DEBUG_ENABLED
+	#include "EngineUtils.h"
+	#include "Pawn/PaperGolfPawn.h"
+	#include "Library/PaperGolfTrajectorySolver.h"
+	#include "Utils/CollisionUtils.h"
+	#include "PGPawnLogging.h"
+#endif
+
+namespace
+{
+	using FLaneFloats = float[FPaperGolfTrajectoryBatchSolver::LaneWidth];
+
+	struct alignas(16) FLaneGroup
+	{
+		FLaneFloats X, Y, Z;
+		FLaneFloats VX, VY, VZ;
+		FLaneFloats NextX, NextY, NextZ;
+	};
+
+	void SolveLaneGroup(const UWorld& World, const FPaperGolfTrajectoryBatchParams& Params, const FCollisionQueryParams& QueryParams,
+		TConstArrayView<FPaperGolfTrajectoryLane> Lanes, TArrayView<FPaperGolfTrajectoryLaneResult> OutResults);
+
+#if PG_DEBUG_ENABLED
+	void BenchmarkTrajectoryKernelConsoleCommand(const TArray<FString>& Args, UWorld* World);
+
+	FAutoConsoleCommandWithWorldAndArgs CBenchmarkTrajectoryKernel(
+		TEXT("pg.traj.benchmark"),
+		TEXT("Compares the batched trajectory kernel against the scalar trajectory solver for the first paper golf pawn. Args: [NumLanes=64] [Iterations=10]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(BenchmarkTrajectoryKernelConsoleCommand), ECVF_Cheat
+	);
+#endif
+}
+
+void FPaperGolfTrajectoryBatchSolver::Solve(const UWorld& World, const FPaperGolfTrajectoryBatchParams& Params,
+	TConstArrayView<FPaperGolfTrajectoryLane> Lanes, TArrayView<FPaperGolfTrajectoryLaneResult> OutResults)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("FPaperGolfTrajectoryBatchSolver::Solve");
+
+	if (!ensureMsgf(Lanes.Num() == OutResults.Num(), TEXT("FPaperGolfTrajectoryBatchSolver::Solve - Lanes=%d does not match OutResults=%d"), Lanes.Num(), OutResults.Num()))
+	{
+		return;
+	}
+
+	if (!ensureMsgf(Params.SimFrequency > 0, TEXT("FPaperGolfTrajectoryBatchSolver::Solve - SimFrequency=%f must be positive"), Params.SimFrequency))
+	{
+		return;
+	}
+
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(PaperGolfTrajectoryBatch), false, Params.IgnoreActor);
+
+	for (int32 i = 0; i < Lanes.Num(); i += LaneWidth)
+	{
+		const int32 Count = FMath::Min(LaneWidth, Lanes.Num() - i);
+		SolveLaneGroup(World, Params, QueryParams, Lanes.Slice(i, Count), OutResults.Slice(i, Count));
+	}
+}
+
+namespace
+{
+	void SolveLaneGroup(const UWorld& World, const FPaperGolfTrajectoryBatchParams& Params, const FCollisionQueryParams& QueryParams,
+		TConstArrayView<FPaperGolfTrajectoryLane> Lanes, TArrayView<FPaperGolfTrajectoryLaneResult> OutResults)
+	{
+		constexpr int32 LaneWidth = FPaperGolfTrajectoryBatchSolver::LaneWidth;
+
+		const int32 NumLanes = Lanes.Num();
+		check(NumLanes > 0 && NumLanes <= LaneWidth);
+
+		// Simulate relative to the first lane so that single precision is enough with large world coordinates
+		const FVector Origin = Lanes[0].StartLocation;
+
+		FLaneGroup Group{};
+
+		for (int32 i = 0; i < LaneWidth; ++i)
+		{
+			// Pad unused lanes with a copy of the first one and mask them off
+			const auto& Lane = Lanes[i < NumLanes ? i : 0];
+			const FVector3f RelativeStart{ Lane.StartLocation - Origin };
+			const FVector3f LaunchVelocity{ Lane.LaunchVelocity };
+
+			Group.X[i] = RelativeStart.X;
+			Group.Y[i] = RelativeStart.Y;
+			Group.Z[i] = RelativeStart.Z;
+			Group.VX[i] = LaunchVelocity.X;
+			Group.VY[i] = LaunchVelocity.Y;
+			Group.VZ[i] = LaunchVelocity.Z;
+
+			if (i < NumLanes)
+			{
+				OutResults[i] = FPaperGolfTrajectoryLaneResult
+				{
+					.Location = Lane.StartLocation,
+					.Velocity = Lane.LaunchVelocity
+				};
+			}
+		}
+
+		const float DeltaTime = 1.0f / Params.SimFrequency;
+		const int32 MaxSteps = FMath::CeilToInt32(Params.MaxSimTime * Params.SimFrequency);
+
+		const bool bBroadPhase = Params.bTraceWithCollision && Params.BroadPhaseBounds.IsValid;
+		const FVector3f BoundsMin{ Params.BroadPhaseBounds.Min - Origin };
+		const FVector3f BoundsMax{ Params.BroadPhaseBounds.Max - Origin };
+		const float RelativeLandingZ = Params.LandingZ > TNumericLimits<float>::Lowest() ? static_cast<float>(Params.LandingZ - Origin.Z) : TNumericLimits<float>::Lowest();
+
+		const VectorRegister4Float Dt = VectorSetFloat1(DeltaTime);
+		const VectorRegister4Float GravityDt = VectorSetFloat1(Params.GravityZ * DeltaTime);
+		const VectorRegister4Float DampingScale = VectorSetFloat1(FMath::Max(0.0f, 1.0f - Params.LinearDamping * DeltaTime));
+		const VectorRegister4Float Radius = VectorSetFloat1(Params.CollisionRadius);
+		const VectorRegister4Float BoxMinX = VectorSetFloat1(BoundsMin.X), BoxMinY = VectorSetFloat1(BoundsMin.Y), BoxMinZ = VectorSetFloat1(BoundsMin.Z);
+		const VectorRegister4Float BoxMaxX = VectorSetFloat1(BoundsMax.X), BoxMaxY = VectorSetFloat1(BoundsMax.Y), BoxMaxZ = VectorSetFloat1(BoundsMax.Z);
+		const VectorRegister4Float LandingZ = VectorSetFloat1(RelativeLandingZ);
+		const VectorRegister4Float Zero = VectorZeroFloat();
+
+		VectorRegister4Float X = VectorLoadAligned(Group.X), Y = VectorLoadAligned(Group.Y), Z = VectorLoadAligned(Group.Z);
+		VectorRegister4Float VX = VectorLoadAligned(Group.VX), VY = VectorLoadAligned(Group.VY), VZ = VectorLoadAligned(Group.VZ);
+
+		const auto CollisionShape = FCollisionShape::MakeSphere(Params.CollisionRadius);
+
+		uint32 ActiveMask = (1u << NumLanes) - 1;
+
+		for (int32 Step = 0; Step < MaxSteps && ActiveMask; ++Step)
+		{
+			// Semi-implicit Euler matching FPaperGolfTrajectorySolver
+			VZ = VectorAdd(VZ, GravityDt);
+			VX = VectorMultiply(VX, DampingScale);
+			VY = VectorMultiply(VY, DampingScale);
+			VZ = VectorMultiply(VZ, DampingScale);
+
+			const VectorRegister4Float NextX = VectorMultiplyAdd(VX, Dt, X);
+			const VectorRegister4Float NextY = VectorMultiplyAdd(VY, Dt, Y);
+			const VectorRegister4Float NextZ = VectorMultiplyAdd(VZ, Dt, Z);
+
+			// Broad-phase: does the swept sphere's box for this step overlap the static bounds
+			uint32 QueryMask{};
+			if (bBroadPhase)
+			{
+				const VectorRegister4Float OverlapX = VectorBitwiseAnd(
+					VectorCompareGE(VectorAdd(VectorMax(X, NextX), Radius), BoxMinX),
+					VectorCompareLE(VectorSubtract(VectorMin(X, NextX), Radius), BoxMaxX));
+				const VectorRegister4Float OverlapY = VectorBitwiseAnd(
+					VectorCompareGE(VectorAdd(VectorMax(Y, NextY), Radius), BoxMinY),
+					VectorCompareLE(VectorSubtract(VectorMin(Y, NextY), Radius), BoxMaxY));
+				const VectorRegister4Float OverlapZ = VectorBitwiseAnd(
+					VectorCompareGE(VectorAdd(VectorMax(Z, NextZ), Radius), BoxMinZ),
+					VectorCompareLE(VectorSubtract(VectorMin(Z, NextZ), Radius), BoxMaxZ));
+
+				QueryMask = VectorMaskBits(VectorBitwiseAnd(VectorBitwiseAnd(OverlapX, OverlapY), OverlapZ)) & ActiveMask;
+			}
+			else if (Params.bTraceWithCollision)
+			{
+				QueryMask = ActiveMask;
+			}
+
+			const uint32 LandedMask = VectorMaskBits(VectorBitwiseAnd(VectorCompareLT(VZ, Zero), VectorCompareLT(NextZ, LandingZ))) & ActiveMask;
+
+			if (QueryMask | LandedMask)
+			{
+				VectorStoreAligned(X, Group.X);
+				VectorStoreAligned(Y, Group.Y);
+				VectorStoreAligned(Z, Group.Z);
+				VectorStoreAligned(VX, Group.VX);
+				VectorStoreAligned(VY, Group.VY);
+				VectorStoreAligned(VZ, Group.VZ);
+				VectorStoreAligned(NextX, Group.NextX);
+				VectorStoreAligned(NextY, Group.NextY);
+				VectorStoreAligned(NextZ, Group.NextZ);
+
+				for (uint32 Mask = QueryMask | LandedMask; Mask; Mask &= Mask - 1)
+				{
+					const int32 i = FMath::CountTrailingZeros(Mask);
+					const uint32 LaneBit = 1u << i;
+
+					auto& Result = OutResults[i];
+
+					const FVector Start = Origin + FVector{ Group.X[i], Group.Y[i], Group.Z[i] };
+					const FVector End = Origin + FVector{ Group.NextX[i], Group.NextY[i], Group.NextZ[i] };
+					const FVector Velocity{ Group.VX[i], Group.VY[i], Group.VZ[i] };
+
+					if (QueryMask & LaneBit)
+					{
+						++Result.NumSceneQueries;
+
+						FHitResult HitResult;
+						if (World.SweepSingleByChannel(HitResult, Start, End, FQuat::Identity, Params.TraceChannel, CollisionShape, QueryParams))
+						{
+							Result.Location = HitResult.Location;
+							Result.Velocity = Velocity;
+							Result.ImpactNormal = HitResult.ImpactNormal;
+							Result.SimTime = (Step + HitResult.Time) * DeltaTime;
+							Result.bHit = true;
+
+							ActiveMask &= ~LaneBit;
+							continue;
+						}
+					}
+
+					if (LandedMask & LaneBit)
+					{
+						// Interpolate to where the step crossed the landing height
+						const auto StepDeltaZ = Group.NextZ[i] - Group.Z[i];
+						const auto Alpha = FMath::IsNearlyZero(StepDeltaZ) ? 1.0f : FMath::Clamp((RelativeLandingZ - Group.Z[i]) / StepDeltaZ, 0.0f, 1.0f);
+
+						Result.Location = FMath::Lerp(Start, End, Alpha);
+						Result.Velocity = Velocity;
+						Result.ImpactNormal = FVector::UpVector;
+						Result.SimTime = (Step + Alpha) * DeltaTime;
+						Result.bLanded = true;
+
+						ActiveMask &= ~LaneBit;
+					}
+				}
+			}
+
+			X = NextX;
+			Y = NextY;
+			Z = NextZ;
+		}
+
+		// Lanes still active ran out of simulation time
+		if (ActiveMask)
+		{
+			VectorStoreAligned(X, Group.X);
+			VectorStoreAligned(Y, Group.Y);
+			VectorStoreAligned(Z, Group.Z);
+			VectorStoreAligned(VX, Group.VX);
+			VectorStoreAligned(VY, Group.VY);
+			VectorStoreAligned(VZ, Group.VZ);
+
+			for (uint32 Mask = ActiveMask; Mask; Mask &= Mask - 1)
+			{
+				const int32 i = FMath::CountTrailingZeros(Mask);
+
+				auto& Result = OutResults[i];
+				Result.Location = Origin + FVector{ Group.X[i], Group.Y[i], Group.Z[i] };
+				Result.Velocity = FVector{ Group.VX[i], Group.VY[i], Group.VZ[i] };
+				Result.SimTime = MaxSteps * DeltaTime;
+			}
+		}
+	}
+
+#if PG_DEBUG_ENABLED
+	void BenchmarkTrajectoryKernelConsoleCommand(const TArray<FString>& Args, UWorld* World)
+	{
+		if (!World)
+		{
+			return;
+		}
+
+		const int32 NumLanes = FMath::Max(1, Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 64);
+		const int32 Iterations = FMath::Max(1, Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 10);
+
+		TActorIterator<APaperGolfPawn> It(World);
+		if (!It)
+		{
+			UE_LOG(LogPGPawn, Warning, TEXT("pg.traj.benchmark - No paper golf pawn in world"));
+			return;
+		}
+
+		const APaperGolfPawn& Pawn = **It;
+		const auto BaseParams = Pawn.GetFlickTrajectoryParams(FFlickParams{ .ShotType = EShotType::Full }, FFlickPredictParams{});
+
+		// Fan of pitch and yaw offsets around the current flick direction
+		TArray<FPaperGolfTrajectoryLane> Lanes;
+		Lanes.Reserve(NumLanes);
+
+		for (int32 i = 0; i < NumLanes; ++i)
+		{
+			const auto Alpha = NumLanes > 1 ? static_cast<float>(i) / (NumLanes - 1) : 0.0f;
+			const FRotator Offset{ FMath::Lerp(0.0f, 60.0f, Alpha), FMath::Lerp(-30.0f, 30.0f, FMath::Frac(Alpha * 4)), 0.0f };
+
+			Lanes.Add(FPaperGolfTrajectoryLane
+			{
+				.StartLocation = BaseParams.StartLocation,
+				.LaunchVelocity = Offset.RotateVector(BaseParams.LaunchVelocity)
+			});
+		}
+
+		FPaperGolfTrajectoryBatchParams BatchParams
+		{
+			.IgnoreActor = &Pawn,
+			.GravityZ = BaseParams.GravityZ,
+			.LinearDamping = BaseParams.LinearDamping,
+			.CollisionRadius = BaseParams.CollisionRadius,
+			.MaxSimTime = BaseParams.MaxSimTime,
+			.SimFrequency = BaseParams.SimFrequency,
+			.LandingZ = BaseParams.KillZ,
+			.TraceChannel = BaseParams.TraceChannel
+		};
+
+		TArray<FPaperGolfTrajectoryLaneResult> BatchResults;
+		BatchResults.SetNum(NumLanes);
+
+		const auto Run = [&](auto&& Func)
+		{
+			const auto StartTimeSeconds = FPlatformTime::Seconds();
+			for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+			{
+				Func();
+			}
+			return (FPlatformTime::Seconds() - StartTimeSeconds) * 1000 / Iterations;
+		};
+
+		// Scalar solver sweeps every step
+		int32 ScalarQueries{};
+		const auto ScalarMs = Run([&]()
+		{
+			ScalarQueries = 0;
+			for (const auto& Lane : Lanes)
+			{
+				auto ScalarParams = BaseParams;
+				ScalarParams.StartLocation = Lane.StartLocation;
+				ScalarParams.LaunchVelocity = Lane.LaunchVelocity;
+				ScalarParams.AngularVelocity = FVector::ZeroVector;
+
+				FPaperGolfTrajectoryResult Result;
+				FPaperGolfTrajectorySolver::Solve(*World, ScalarParams, {}, Result);
+				ScalarQueries += Result.NumSteps;
+			}
+		});
+
+		const auto BatchNoBroadPhaseMs = Run([&]()
+		{
+			FPaperGolfTrajectoryBatchSolver::Solve(*World, BatchParams, Lanes, BatchResults);
+		});
+
+		BatchParams.BroadPhaseBounds = PG::CollisionUtils::GetStaticCollisionBounds(*World, BaseParams.TraceChannel);
+
+		int32 BroadPhaseQueries{};
+		const auto BatchMs = Run([&]()
+		{
+			FPaperGolfTrajectoryBatchSolver::Solve(*World, BatchParams, Lanes, BatchResults);
+		});
+
+		for (const auto& Result : BatchResults)
+		{
+			BroadPhaseQueries += Result.NumSceneQueries;
+		}
+
+		UE_LOG(LogPGPawn, Display, TEXT("pg.traj.benchmark - Lanes=%d; Iterations=%d; Scalar=%.3fms (%d scene queries); Batch=%.3fms; Batch+BroadPhase=%.3fms (%d scene queries); BroadPhaseBounds=%s"),
+			NumLanes, Iterations, ScalarMs, ScalarQueries, BatchNoBroadPhaseMs, BatchMs, BroadPhaseQueries, *BatchParams.BroadPhaseBounds.ToString());
+	}
+#endif
+}
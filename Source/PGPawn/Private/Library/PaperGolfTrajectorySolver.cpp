@@ -0,0 +1,165 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+
+#include "Library/PaperGolfTrajectorySolver.h"
+
+#include "Engine/World.h"
+#include "CollisionQueryParams.h"
+#include "CollisionShape.h"
+
+namespace
+{
+	void WritePathPoint(TArrayView<FPredictProjectilePathPointData> OutPath, int32& NumPoints, const FVector& Location, const FVector& Velocity, float Time);
+	FVector ApplyDamping(const FVector& Value, float Damping, float DeltaTime);
+}
+
+FPaperGolfTrajectoryScratch::FPaperGolfTrajectoryScratch() :
+	QueryParams(SCENE_QUERY_STAT(PaperGolfTrajectory), false)
+{
+}
+
+TArrayView<FPredictProjectilePathPointData> FPaperGolfTrajectoryScratch::Prepare(const FPaperGolfTrajectoryParams& Params)
+{
+	QueryParams.ClearIgnoredActors();
+	QueryParams.ClearIgnoredComponents();
+	if (Params.IgnoreActor)
+	{
+		QueryParams.AddIgnoredActor(Params.IgnoreActor);
+	}
+	for (auto Component : Params.IgnoreComponents)
+	{
+		QueryParams.AddIgnoredComponent(Component);
+	}
+	QueryParams.bReturnPhysicalMaterial = Params.bReturnPhysicalMaterial;
+
+	const auto NumPoints = bRecordPath ? Params.GetMaxNumPoints() : 0;
+	Path.SetNumUninitialized(NumPoints, EAllowShrinking::No);
+
+	return Path;
+}
+
+bool FPaperGolfTrajectorySolver::Solve(const UWorld& World, const FPaperGolfTrajectoryParams& Params, TArrayView<FPredictProjectilePathPointData> OutPath, FPaperGolfTrajectoryResult& OutResult)
+{
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(PaperGolfTrajectory), false, Params.IgnoreActor);
+	QueryParams.bReturnPhysicalMaterial = Params.bReturnPhysicalMaterial;
+	for (auto Component : Params.IgnoreComponents)
+	{
+		QueryParams.AddIgnoredComponent(Component);
+	}
+
+	return Solve(World, Params, QueryParams, OutPath, OutResult);
+}
+
+bool FPaperGolfTrajectorySolver::Solve(const UWorld& World, const FPaperGolfTrajectoryParams& Params, const FCollisionQueryParams& QueryParams,
+	TArrayView<FPredictProjectilePathPointData> OutPath, FPaperGolfTrajectoryResult& OutResult)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("FPaperGolfTrajectorySolver::Solve");
+
+	OutResult = {};
+
+	if (!ensureMsgf(Params.SimFrequency > 0, TEXT("FPaperGolfTrajectorySolver::Solve - SimFrequency=%f must be positive"), Params.SimFrequency))
+	{
+		return false;
+	}
+
+	const float DeltaTime = 1.0f / Params.SimFrequency;
+	const FVector Gravity{ 0.0, 0.0, Params.GravityZ };
+	const auto MaxHorizontalDistanceSq = Params.MaxHorizontalDistance > 0 ? FMath::Square(Params.MaxHorizontalDistance) : -1.0;
+	const bool bApplySpinLift = !FMath::IsNearlyZero(Params.SpinLiftCoefficient);
+
+	const auto CollisionShape = FCollisionShape::MakeSphere(Params.CollisionRadius);
+
+	FVector Location = Params.StartLocation;
+	FVector Velocity = Params.LaunchVelocity;
+	FVector AngularVelocity = Params.AngularVelocity;
+	float SimTime{};
+
+	WritePathPoint(OutPath, OutResult.NumPoints, Location, Velocity, SimTime);
+
+	while (SimTime < Params.MaxSimTime)
+	{
+		const auto StepTime = FMath::Min(DeltaTime, Params.MaxSimTime - SimTime);
+
+		// Semi-implicit Euler which is what the physics solver uses so the discretization error is similar
+		FVector Acceleration = Gravity;
+		if (bApplySpinLift)
+		{
+			Acceleration += Params.SpinLiftCoefficient * (AngularVelocity ^ Velocity);
+		}
+
+		Velocity = ApplyDamping(Velocity + Acceleration * StepTime, Params.LinearDamping, StepTime);
+		AngularVelocity = ApplyDamping(AngularVelocity, Params.AngularDamping, StepTime);
+
+		const FVector NextLocation = Location + Velocity * StepTime;
+
+		++OutResult.NumSteps;
+
+		if (Params.bTraceWithCollision)
+		{
+			FHitResult HitResult;
+			if (World.SweepSingleByChannel(HitResult, Location, NextLocation, FQuat::Identity, Params.TraceChannel, CollisionShape, QueryParams))
+			{
+				SimTime += StepTime * HitResult.Time;
+				Location = HitResult.Location;
+
+				OutResult.HitResult = HitResult;
+				OutResult.bHit = true;
+
+				WritePathPoint(OutPath, OutResult.NumPoints, Location, Velocity, SimTime);
+				break;
+			}
+		}
+
+		SimTime += StepTime;
+		Location = NextLocation;
+
+		WritePathPoint(OutPath, OutResult.NumPoints, Location, Velocity, SimTime);
+
+		if (Location.Z < Params.KillZ)
+		{
+			break;
+		}
+
+		if (MaxHorizontalDistanceSq > 0 && FVector::DistSquared2D(Location, Params.StartLocation) >= MaxHorizontalDistanceSq)
+		{
+			break;
+		}
+	}
+
+	OutResult.LastLocation = Location;
+	OutResult.LastVelocity = Velocity;
+	OutResult.LastAngularVelocity = AngularVelocity;
+	OutResult.SimTime = SimTime;
+
+	return OutResult.bHit;
+}
+
+FString FPaperGolfTrajectoryResult::ToString() const
+{
+	return FString::Printf(TEXT("bHit=%s; HitActor=%s; LastLocation=%s; LastVelocity=%s; LastAngularVelocity=%s; SimTime=%.2fs; NumSteps=%d; NumPoints=%d"),
+		bHit ? TEXT("TRUE") : TEXT("FALSE"), bHit ? *GetNameSafe(HitResult.GetActor()) : TEXT("N/A"),
+		*LastLocation.ToCompactString(), *LastVelocity.ToCompactString(), *LastAngularVelocity.ToCompactString(), SimTime, NumSteps, NumPoints);
+}
+
+namespace
+{
+	void WritePathPoint(TArrayView<FPredictProjectilePathPointData> OutPath, int32& NumPoints, const FVector& Location, const FVector& Velocity, float Time)
+	{
+		if (OutPath.IsEmpty())
+		{
+			return;
+		}
+
+		// Once full keep overwriting the last slot so that the path ends at the latest point
+		const int32 Index = FMath::Min(NumPoints, OutPath.Num() - 1);
+		OutPath[Index].Set(Location, Velocity, Time);
+
+		NumPoints = Index + 1;
+	}
+
+	FVector ApplyDamping(const FVector& Value, float Damping, float DeltaTime)
+	{
+		// Matches the Chaos ether drag integration
+		return Value * FMath::Max(0.0f, 1.0f - Damping * DeltaTime);
+	}
+}
@@ -0,0 +1,231 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+#include "Pawn/FlickPredictionCache.h"
+
+namespace
+{
+	// Fine enough that quantized inputs give visually identical trajectories
+	constexpr double LocationQuantum = 0.01;
+	constexpr double VelocityQuantum = 0.01;
+	constexpr double AngularVelocityQuantum = 1e-4;
+
+	// Transform changes smaller than this are float noise from recomposing the same transform rather than the pawn moving
+	constexpr float TransformTolerance = 1e-3f;
+
+	FIntVector Quantize(const FVector& Value, double Quantum);
+}
+
+FString FFlickPredictionCacheStats::ToString() const
+{
+	return FString::Printf(TEXT("Hits=%d; Misses=%d; HitRate=%.1f%%; NumEntries=%d"), Hits, Misses, GetHitRate() * 100, NumEntries);
+}
+
+FFlickPredictionCache::FKey::FKey(const FPaperGolfTrajectoryParams& Params) :
+	StartLocation(Quantize(Params.StartLocation, LocationQuantum)),
+	LaunchVelocity(Quantize(Params.LaunchVelocity, VelocityQuantum)),
+	AngularVelocity(Quantize(Params.AngularVelocity, AngularVelocityQuantum)),
+	GravityZ(Params.GravityZ),
+	LinearDamping(Params.LinearDamping),
+	AngularDamping(Params.AngularDamping),
+	SpinLiftCoefficient(Params.SpinLiftCoefficient),
+	CollisionRadius(Params.CollisionRadius),
+	MaxSimTime(Params.MaxSimTime),
+	SimFrequency(Params.SimFrequency),
+	MaxHorizontalDistance(Params.MaxHorizontalDistance),
+	KillZ(Params.KillZ),
+	IgnoreActor(Params.IgnoreActor),
+	TraceChannel(Params.TraceChannel),
+	bTraceWithCollision(Params.bTraceWithCollision),
+	bReturnPhysicalMaterial(Params.bReturnPhysicalMaterial)
+{
+}
+
+uint32 FFlickPredictionCache::FKey::GetHash() const
+{
+	// Vectors vary the most between predictions so only hash those and leave the rest to the equality check
+	auto Hash = GetTypeHash(StartLocation);
+	Hash = HashCombineFast(Hash, GetTypeHash(LaunchVelocity));
+	Hash = HashCombineFast(Hash, GetTypeHash(AngularVelocity));
+	Hash = HashCombineFast(Hash, GetTypeHash(MaxHorizontalDistance));
+
+	return Hash;
+}
+
+void FFlickPredictionCache::Configure(int32 InMaxEntries, float InMaxEntryAge)
+{
+	MaxEntries = FMath::Max(1, InMaxEntries);
+	MaxEntryAge = InMaxEntryAge;
+
+	Invalidate();
+
+	Entries.Reserve(MaxEntries);
+	FreeEntryIndices.Reserve(MaxEntries);
+	EntryIndices.Reserve(MaxEntries);
+}
+
+bool FFlickPredictionCache::ResetIfMoved(const FTransform& InPawnTransform)
+{
+	if (PawnTransform && PawnTransform->Equals(InPawnTransform, TransformTolerance))
+	{
+		return false;
+	}
+
+	const bool bHadEntries = !EntryIndices.IsEmpty();
+
+	Invalidate();
+	PawnTransform = InPawnTransform;
+
+	return bHadEntries;
+}
+
+bool FFlickPredictionCache::Find(const FPaperGolfTrajectoryParams& Params, double TimeSeconds, TArrayView<FPredictProjectilePathPointData> OutPath, FPaperGolfTrajectoryResult& OutResult)
+{
+	const FKey Key(Params);
+
+	const auto EntryIndex = EntryIndices.Find(Key);
+	if (!EntryIndex)
+	{
+		++Misses;
+		return false;
+	}
+
+	const auto& Entry = Entries[*EntryIndex];
+
+	if (TimeSeconds - Entry.TimeSeconds > MaxEntryAge)
+	{
+		ReleaseEntry(Key, *EntryIndex);
+		++Misses;
+		return false;
+	}
+
+	if (!OutPath.IsEmpty() && Entry.PathCapacity != OutPath.Num())
+	{
+		++Misses;
+		return false;
+	}
+
+	++Hits;
+
+	OutResult = Entry.Result;
+
+	if (OutPath.IsEmpty())
+	{
+		OutResult.NumPoints = 0;
+	}
+	else
+	{
+		FMemory::Memcpy(OutPath.GetData(), Entry.Path.GetData(), Entry.Path.Num() * sizeof(FPredictProjectilePathPointData));
+	}
+
+	return true;
+}
+
+void FFlickPredictionCache::Add(const FPaperGolfTrajectoryParams& Params, double TimeSeconds, TConstArrayView<FPredictProjectilePathPointData> Path, const FPaperGolfTrajectoryResult& Result)
+{
+	FKey Key(Params);
+
+	int32 EntryIndex;
+	if (const auto ExistingEntryIndex = EntryIndices.Find(Key); ExistingEntryIndex)
+	{
+		EntryIndex = *ExistingEntryIndex;
+	}
+	else
+	{
+		EntryIndex = AllocateEntry();
+		EntryIndices.Add(MoveTemp(Key), EntryIndex);
+	}
+
+	auto& Entry = Entries[EntryIndex];
+
+	const auto NumPoints = FMath::Min(Result.NumPoints, Path.Num());
+
+	// Reset keeps the buffer of whichever prediction previously used the entry
+	Entry.Path.Reset();
+	Entry.Path.Append(Path.GetData(), NumPoints);
+
+	Entry.Result = Result;
+	Entry.PathCapacity = Path.Num();
+	Entry.TimeSeconds = TimeSeconds;
+}
+
+void FFlickPredictionCache::Invalidate()
+{
+	for (const auto& [Key, EntryIndex] : EntryIndices)
+	{
+		FreeEntryIndices.Add(EntryIndex);
+	}
+
+	EntryIndices.Reset();
+	PawnTransform.Reset();
+}
+
+FFlickPredictionCacheStats FFlickPredictionCache::GetStats() const
+{
+	return FFlickPredictionCacheStats
+	{
+		.Hits = Hits,
+		.Misses = Misses,
+		.NumEntries = EntryIndices.Num()
+	};
+}
+
+int32 FFlickPredictionCache::AllocateEntry()
+{
+	if (!FreeEntryIndices.IsEmpty())
+	{
+		return FreeEntryIndices.Pop(EAllowShrinking::No);
+	}
+
+	if (Entries.Num() < MaxEntries)
+	{
+		return Entries.AddDefaulted();
+	}
+
+	return EvictOldest();
+}
+
+void FFlickPredictionCache::ReleaseEntry(const FKey& Key, int32 EntryIndex)
+{
+	EntryIndices.Remove(Key);
+	FreeEntryIndices.Add(EntryIndex);
+}
+
+int32 FFlickPredictionCache::EvictOldest()
+{
+	check(!EntryIndices.IsEmpty());
+
+	const FKey* OldestKey{};
+	int32 OldestEntryIndex{ INDEX_NONE };
+	double OldestTimeSeconds{ TNumericLimits<double>::Max() };
+
+	for (const auto& [Key, EntryIndex] : EntryIndices)
+	{
+		if (const auto TimeSeconds = Entries[EntryIndex].TimeSeconds; TimeSeconds < OldestTimeSeconds)
+		{
+			OldestKey = &Key;
+			OldestEntryIndex = EntryIndex;
+			OldestTimeSeconds = TimeSeconds;
+		}
+	}
+
+	check(OldestKey);
+
+	// Copy as removing invalidates the reference
+	const FKey KeyToRemove = *OldestKey;
+	EntryIndices.Remove(KeyToRemove);
+
+	return OldestEntryIndex;
+}
+
+namespace
+{
+	FIntVector Quantize(const FVector& Value, double Quantum)
+	{
+		return FIntVector
+		{
+			FMath::RoundToInt32(Value.X / Quantum),
+			FMath::RoundToInt32(Value.Y / Quantum),
+			FMath::RoundToInt32(Value.Z / Quantum)
+		};
+	}
+}
@@ -12,6 +12,7 @@
 
 #include "Camera/CameraComponent.h"
 #include "GameFramework/SpringArmComponent.h"
+#include "GameFramework/WorldSettings.h"
 #include "Components/StaticMeshComponent.h"
 #include "Components/SceneComponent.h"
 
@@ -22,6 +23,7 @@
 #include "Build/BuildUtilities.h"
 
 #include "Library/PaperGolfPawnUtilities.h"
+#include "Library/PaperGolfTrajectorySolver.h"
 
 #include "Subsystems/GolfEventsSubsystem.h"
 
@@ -29,6 +31,7 @@
 #include "Components/PawnCameraLookComponent.h"
 #include "Components/CollisionDampeningComponent.h"
 #include "Components/GolfShotClearanceComponent.h"
+#include "Components/PredictedFlightComponent.h"
 
 #include "VisualLogger/VisualLogger.h"
 #include "Logging/LoggingUtils.h"
@@ -43,6 +46,7 @@
 #include "Debug/PGConsoleVars.h"
 
 #include "PGPawnLogging.h"
+#include "PGPawnStats.h"
 
 // Used for drawing the pawn
 #if ENABLE_VISUAL_LOG
@@ -54,6 +58,9 @@
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(PaperGolfPawn)
 
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Active Pawn Bodies"), STAT_PGActivePawnBodies, STATGROUP_PGPawn);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Parked Pawn Bodies"), STAT_PGParkedPawnBodies, STATGROUP_PGPawn);
+
 namespace
 {
 	constexpr float ValidateFloatEpsilon = 0.001f;
@@ -65,6 +72,63 @@ namespace
 	const FName FlickSocketName = TEXT("Flick");
 	const FName ComponentContactPointTagName = TEXT("ContactPoint");
 	const FName ComponentFlickPointTagName = TEXT("FlickPoint");
+
+	// Flick network quantization. Accuracy uses an odd number of steps so that a perfect shot is exactly zero
+	constexpr uint32 FlickPowerMaxValue = (1 << 12) - 1;
+	constexpr int32 FlickAccuracyHalfRange = (1 << 11) - 1;
+	constexpr float FlickZOffsetQuantum = 0.01f;
+
+	static_assert(static_cast<uint32>(EShotType::MAX) < 8, "EShotType no longer fits in 3 bits");
+
+	uint32 QuantizeFlickPower(float PowerFraction);
+	float DequantizeFlickPower(uint32 Value);
+	uint32 QuantizeFlickAccuracy(float Accuracy);
+	float DequantizeFlickAccuracy(uint32 Value);
+	int16 QuantizeFlickZOffset(float LocalZOffset);
+	float DequantizeFlickZOffset(int16 Value);
+	FRotator QuantizeFlickRotation(const FRotator& Rotation);
+}
+
+void FNetworkFlickParams::Quantize()
+{
+	FlickParams.PowerFraction = DequantizeFlickPower(QuantizeFlickPower(FlickParams.PowerFraction));
+	FlickParams.Accuracy = DequantizeFlickAccuracy(QuantizeFlickAccuracy(FlickParams.Accuracy));
+	FlickParams.LocalZOffset = DequantizeFlickZOffset(QuantizeFlickZOffset(FlickParams.LocalZOffset));
+	Rotation = QuantizeFlickRotation(Rotation);
+}
+
+bool FNetworkFlickParams::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	uint32 ShotType{}, PowerFraction{}, Accuracy{};
+	int16 LocalZOffset{};
+
+	if (Ar.IsSaving())
+	{
+		ShotType = static_cast<uint32>(FlickParams.ShotType);
+		PowerFraction = QuantizeFlickPower(FlickParams.PowerFraction);
+		Accuracy = QuantizeFlickAccuracy(FlickParams.Accuracy);
+		LocalZOffset = QuantizeFlickZOffset(FlickParams.LocalZOffset);
+	}
+
+	// MAX is still sendable so that ServerFlick_Validate rejects it
+	Ar.SerializeInt(ShotType, static_cast<uint32>(EShotType::MAX) + 1);
+	Ar.SerializeInt(PowerFraction, FlickPowerMaxValue + 1);
+	Ar.SerializeInt(Accuracy, 2 * FlickAccuracyHalfRange + 1);
+	Ar << LocalZOffset;
+
+	Rotation.SerializeCompressedShort(Ar);
+
+	if (Ar.IsLoading())
+	{
+		FlickParams.ShotType = static_cast<EShotType>(ShotType);
+		FlickParams.PowerFraction = DequantizeFlickPower(PowerFraction);
+		FlickParams.Accuracy = DequantizeFlickAccuracy(Accuracy);
+		FlickParams.LocalZOffset = DequantizeFlickZOffset(LocalZOffset);
+	}
+
+	bOutSuccess = !Ar.IsError();
+
+	return true;
 }
 
 APaperGolfPawn::APaperGolfPawn()
@@ -73,10 +137,14 @@ APaperGolfPawn::APaperGolfPawn()
 	bAlwaysRelevant = true;
 	bReplicates = true;
 
+	// Millimeter precision is plenty for the pawn and saves bits on every movement update in flight
+	GetReplicatedMovement_Mutable().LocationQuantizationLevel = EVectorQuantization::RoundOneDecimal;
+
 	PawnAudioComponent = CreateDefaultSubobject<UPaperGolfPawnAudioComponent>(TEXT("Audio"));
 	CameraLookComponent = CreateDefaultSubobject<UPawnCameraLookComponent>(TEXT("CameraLook"));
 	CollisionDampeningComponent = CreateDefaultSubobject<UCollisionDampeningComponent>(TEXT("CollisionDampening"));
 	GolfShotClearanceComponent = CreateDefaultSubobject<UGolfShotClearanceComponent>(TEXT("GolfShotClearance"));
+	PredictedFlightComponent = CreateDefaultSubobject<UPredictedFlightComponent>(TEXT("PredictedFlight"));
 }
 
 void APaperGolfPawn::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
@@ -122,17 +190,7 @@ FVector APaperGolfPawn::GetCenterOfMassPosition() const
 
 bool APaperGolfPawn::IsStuckInPerpetualMotion() const
 {
-	if (States.Num() < NumSamples)
-	{
-		return false;
-	}
-
-	const int32 OldestIndex = (StateIndex + 1) % NumSamples;
-
-	// Check the delta against threshold
-	const auto Delta = States[StateIndex].Position - States[OldestIndex].Position;
-
-	return Delta.Size() < MinDistanceThreshold;
+	return MotionHistory.IsInPerpetualMotion(MotionClassifierParams, MinDistanceThreshold);
 }
 
 // We need to check the _PaperGolfMesh since a physics actor pops out of the hierarchy
@@ -233,6 +291,7 @@ void APaperGolfPawn::SetFocusActor(AActor* Focus, const TOptional<FVector>& Posi
 	UE_VLOG_UELOG(this, LogPGPawn, Log, TEXT("%s: SetFocusActor - Focus=%s; PositionOverride=%s"), *GetName(), *LoggingUtils::GetName(Focus), *PG::StringUtils::ToString(PositionOverride));
 
 	FocusActor = Focus;
+	FlushNetDormancy();
 
 	// Target position happens before it adjusts for clearance
 	if (FocusActor)
@@ -287,16 +346,38 @@ void APaperGolfPawn::SnapToGround(bool bAdjustForClearance, bool bOnlyGroundTest
 	const auto& BoundsExtent = Bounds.GetExtent();
 	const auto ZAdjustThreshold = FMath::Max3(BoundsExtent.X, BoundsExtent.Y, BoundsExtent.Z);
 
-	TArray<FVector, TInlineAllocator<8>> GroundTestLocations;
+	GroundPositionArray GroundTestLocations;
 	PopulateGroundPositions(GroundTestLocations, bOnlyGroundTestFlickLocation);
 
+	FCollisionQueryParams QueryParams;
+	QueryParams.AddIgnoredActor(this);
+
+	// All the contact points are probed together and the fitted plane gives the ground normal without tracing again
+	const auto GroundProbeResult = PG::CollisionUtils::ProbeGround(*World,
+		{
+			.Locations = GroundTestLocations,
+			.UpVector = ActorUpVector,
+			.StartOffset = BoundsExtent | ActorUpVector.GetAbs(),
+			.ProbeDistance = 2000.0,
+			.TraceChannel = PG::CollisionChannel::FlickTraceType
+		},
+		QueryParams);
+
 	TOptional<FVector> GroundLocationOptional;
-	for (const auto& GroundTestStart : GroundTestLocations)
+	if (GroundProbeResult)
 	{
-		if (const auto GroundTestLocationOptional = GetGroundLocation(
-			{ .Location = GroundTestStart, .ActorUpVector = ActorUpVector, .Bounds = Bounds }
-		); GroundTestLocationOptional)
+		for (int32 i = 0; i < GroundTestLocations.Num(); ++i)
 		{
+			const auto& GroundTestLocationOptional = GroundProbeResult->HitLocations[i];
+
+			UE_VLOG_SEGMENT_THICK(this, LogPGPawn, Log, GroundTestLocations[i], GroundTestLocationOptional ? *GroundTestLocationOptional : GroundTestLocations[i] - 2000 * ActorUpVector,
+				GroundTestLocationOptional ? FColor::Yellow : FColor::Red, 10.0, TEXT("GroundTrace"));
+
+			if (!GroundTestLocationOptional)
+			{
+				continue;
+			}
+
 			// If we find a higher position that is above the adjust threshold (half size of the paper football since first point is the center)
 			if (!GroundLocationOptional || GroundTestLocationOptional->Z - GroundLocationOptional->Z > ZAdjustThreshold)
 			{
@@ -329,6 +410,14 @@ void APaperGolfPawn::SnapToGround(bool bAdjustForClearance, bool bOnlyGroundTest
 		FColor::Green,
 		TEXT("SnapToGround")
 	);
+
+	UE_VLOG_ARROW(this, LogPGPawn, Log, GroundProbeResult->PlaneOrigin, GroundProbeResult->PlaneOrigin + 50 * GroundProbeResult->PlaneNormal, FColor::Blue,
+		TEXT("GroundNormal (%d/%d hits)"), GroundProbeResult->NumHits, GroundTestLocations.Num());
+
+	if (bAlignToGroundNormal)
+	{
+		ResetRotationToGround(GroundProbeResult->PlaneNormal);
+	}
 }
 
 void APaperGolfPawn::PopulateGroundPositions(GroundPositionArray& Positions, bool bOnlyGroundTestFlickLocation) const
@@ -370,46 +459,26 @@ void APaperGolfPawn::PopulateGroundPositions(GroundPositionArray& Positions, boo
 	}
 }
 
-TOptional<FVector> APaperGolfPawn::GetGroundLocation(const FGroundTraceParams& Params) const
+void APaperGolfPawn::ResetRotation()
 {
-	auto World = GetWorld();
-	check(World);
-
-	const auto& BoundsExtent = Params.Bounds.GetExtent();
-	const auto UpExtent = BoundsExtent * Params.ActorUpVector;
-
-	const auto StartLocation = Params.Location + UpExtent;
-	const auto EndLocation = Params.Location - 2000 * Params.ActorUpVector;
-
-	UE_VLOG_SEGMENT_THICK(this, LogPGPawn, Log, StartLocation, EndLocation, FColor::Yellow, 10.0, TEXT("GroundTrace"));
-
-	FCollisionQueryParams QueryParams;
-	QueryParams.AddIgnoredActor(this);
-
-	FHitResult HitResult;
-
-	if (!World->LineTraceSingleByChannel(
-		HitResult,
-		StartLocation,
-		EndLocation,
-		PG::CollisionChannel::FlickTraceType,
-		QueryParams))
-	{
-		return {};
-	}
+	SetResetRotation(InitialRotation);
+}
 
-	return { HitResult.Location };
+void APaperGolfPawn::ResetRotationToGround(const FVector& GroundNormal)
+{
+	// Keep the initial yaw and tilt the pawn up vector onto the ground normal
+	SetResetRotation(FRotationMatrix::MakeFromZX(GroundNormal, InitialRotation.Vector()).Rotator());
 }
 
-void APaperGolfPawn::ResetRotation()
+void APaperGolfPawn::SetResetRotation(const FRotator& Rotation)
 {
-	UE_VLOG_UELOG(this, LogPGPawn, Log, TEXT("%s: ResetRotation: %s -> %s"), *GetName(), *GetActorRotation().ToCompactString(), *InitialRotation.ToCompactString());
+	UE_VLOG_UELOG(this, LogPGPawn, Log, TEXT("%s: ResetRotation: %s -> %s"), *GetName(), *GetActorRotation().ToCompactString(), *Rotation.ToCompactString());
 
-	SetActorRotation(InitialRotation);
+	SetActorRotation(Rotation);
 
 	check(_PaperGolfMesh);
 
-	_PaperGolfMesh->SetWorldRotation(InitialRotation);
+	_PaperGolfMesh->SetWorldRotation(Rotation);
 
 	ResetCameraForShotSetup();
 }
@@ -476,6 +545,16 @@ bool APaperGolfPawn::IsAtRest() const
 	return IsStuckInPerpetualMotion();
 }
 
+FBodyInstance* APaperGolfPawn::GetPhysicsBodyInstance() const
+{
+	if (!ensure(_PaperGolfMesh))
+	{
+		return nullptr;
+	}
+
+	return _PaperGolfMesh->GetBodyInstance();
+}
+
 void APaperGolfPawn::ShotFinished()
 {
 	check(HasAuthority());
@@ -483,10 +562,13 @@ void APaperGolfPawn::ShotFinished()
 	UE_VLOG_UELOG(this, LogPGPawn, Log, TEXT("%s: ShotFinished"), *GetName());
 
 	CollisionDampeningComponent->OnShotFinished();
+	PredictedFlightComponent->EndServerFlight(TEXT("ShotFinished"));
 
 	ResetPhysicsState();
 	SetCollisionEnabled(false);
 
+	EndFlightReplication();
+
 	OnShotFinished();
 }
 
@@ -537,28 +619,97 @@ void APaperGolfPawn::SetCollisionEnabled(bool bEnabled)
 	{
 		_PaperGolfMesh->SetSimulatePhysics(false);
 	}
+	else if (bParked)
+	{
+		SetParked(false);
+	}
 	// Will explicitly opt-in to physics simulation when flicking
 	
 	_PaperGolfMesh->SetCollisionEnabled(bEnabled ? ECollisionEnabled::QueryAndPhysics : ECollisionEnabled::NoCollision);
 }
 
+void APaperGolfPawn::SetParked(bool bInParked)
+{
+	check(_PaperGolfMesh);
+
+	if (bInParked == bParked || !HasAuthority())
+	{
+		return;
+	}
+
+	if (bInParked && (!bParkWhenInactive || bReadyForShot || !IsAtRest()))
+	{
+		UE_VLOG_UELOG(this, LogPGPawn, Log, TEXT("%s: SetParked - Skip - bParkWhenInactive=%s; bReadyForShot=%s; bAtRest=%s"),
+			*GetName(), LoggingUtils::GetBoolString(bParkWhenInactive), LoggingUtils::GetBoolString(bReadyForShot), LoggingUtils::GetBoolString(IsAtRest()));
+		return;
+	}
+
+	UE_VLOG_UELOG(this, LogPGPawn, Log, TEXT("%s: SetParked - bParked=%s"), *GetName(), LoggingUtils::GetBoolString(bInParked));
+
+	bParked = bInParked;
+
+	if (bParked)
+	{
+		SetCollisionEnabled(false);
+
+		bUnparkedNotifyRigidBodyCollision = _PaperGolfMesh->BodyInstance.bNotifyRigidBodyCollision;
+		_PaperGolfMesh->SetNotifyRigidBodyCollision(false);
+
+		// Collision is already off between turns but the body would otherwise stay in the physics scene
+		_PaperGolfMesh->DestroyPhysicsState();
+
+		// Includes the pawn audio component, which also stops any flight audio
+		ForEachComponent<UPGHitSfxComponent>(false, [](auto Component)
+		{
+			Component->Deactivate();
+		});
+
+		DEC_DWORD_STAT(STAT_PGActivePawnBodies);
+		INC_DWORD_STAT(STAT_PGParkedPawnBodies);
+	}
+	else
+	{
+		_PaperGolfMesh->SetNotifyRigidBodyCollision(bUnparkedNotifyRigidBodyCollision);
+
+		if (!_PaperGolfMesh->IsPhysicsStateCreated())
+		{
+			_PaperGolfMesh->RecreatePhysicsState();
+		}
+
+		ForEachComponent<UPGHitSfxComponent>(false, [](auto Component)
+		{
+			Component->Activate();
+		});
+
+		DEC_DWORD_STAT(STAT_PGParkedPawnBodies);
+		INC_DWORD_STAT(STAT_PGActivePawnBodies);
+	}
+
+	CollisionDampeningComponent->SetParked(bParked);
+}
+
 void APaperGolfPawn::Flick(const FFlickParams& FlickParams)
 {
-	DoFlick(FlickParams);
+	// Flick with the quantized params so that the local shot matches what everyone else receives
+	const auto NetworkParams = ToNetworkParams(FlickParams);
+
+	const auto Launch = DoNetworkFlick(NetworkParams);
 
 	if (HasAuthority())
 	{
-		// Broadcast to other clients for SFX
-		MulticastFlick(ToNetworkParams(FlickParams));
+		// Broadcast to other clients for SFX and so they can simulate the flight
+		MulticastFlick(NetworkParams, Launch);
 	}
 	else
 	{
 		// Send to server
-		ServerFlick(ToNetworkParams(FlickParams));
+		ServerFlick(NetworkParams);
 	}
 
 	// Wait until next shot to be able to hit again
 	bReadyForShot = false;
+
+	InvalidateFlickPredictionCache(TEXT("Flick"));
 }
 
 void APaperGolfPawn::AddDeltaRotation(const FRotator& DeltaRotation)
@@ -584,14 +735,73 @@ void APaperGolfPawn::AddDeltaRotation(const FRotator& DeltaRotation)
 
 FNetworkFlickParams APaperGolfPawn::ToNetworkParams(const FFlickParams& Params) const
 {
-	return FNetworkFlickParams
+	FNetworkFlickParams NetworkParams
 	{
 		.FlickParams = Params,
 		.Rotation = GetActorRotation()
 	};
+
+	NetworkParams.FlickParams.Clamp();
+	NetworkParams.Quantize();
+
+	return NetworkParams;
 }
 
-void APaperGolfPawn::DoFlick(FFlickParams FlickParams)
+void APaperGolfPawn::BeginFlightReplication()
+{
+	check(HasAuthority());
+
+	SetNetDormancy(ENetDormancy::DORM_Awake);
+
+	UpdateFlightNetUpdateFrequency();
+	GetWorldTimerManager().SetTimer(FlightNetUpdateTimerHandle, this, &ThisClass::UpdateFlightNetUpdateFrequency, FlightNetUpdateFrequencyInterval, true);
+}
+
+void APaperGolfPawn::EndFlightReplication()
+{
+	check(HasAuthority());
+
+	GetWorldTimerManager().ClearTimer(FlightNetUpdateTimerHandle);
+
+	NetUpdateFrequency = DefaultNetUpdateFrequency;
+
+	// Make sure the rest state goes out promptly rather than waiting for the next scheduled update
+	ForceNetUpdate();
+
+	if (bDormantWhenAtRest)
+	{
+		// The channel replicates the final state before closing
+		SetNetDormancy(ENetDormancy::DORM_DormantAll);
+	}
+
+	UE_VLOG_UELOG(this, LogPGPawn, Log, TEXT("%s: EndFlightReplication - NetUpdateFrequency=%f; NetDormancy=%s"),
+		*GetName(), NetUpdateFrequency, *UEnum::GetValueAsString(NetDormancy.GetValue()));
+}
+
+void APaperGolfPawn::UpdateFlightNetUpdateFrequency()
+{
+	const auto LinearSpeed = GetLinearVelocity().Size();
+	const auto SpinSpeed = GetAngularVelocity().Size() * Width * 0.5f;
+
+	NetUpdateFrequency = FMath::GetMappedRangeValueClamped(
+		FVector2f{ 0.0f, FlightMaxNetUpdateSpeed },
+		FVector2f{ FlightMinNetUpdateFrequency, FMath::Max(FlightMinNetUpdateFrequency, FlightMaxNetUpdateFrequency) },
+		static_cast<float>(FMath::Max(LinearSpeed, SpinSpeed)));
+
+	UE_VLOG_UELOG(this, LogPGPawn, VeryVerbose, TEXT("%s: UpdateFlightNetUpdateFrequency - LinearSpeed=%f; SpinSpeed=%f; NetUpdateFrequency=%f"),
+		*GetName(), LinearSpeed, SpinSpeed, NetUpdateFrequency);
+}
+
+void APaperGolfPawn::OnRootTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	// Shot setup moves the pawn while it is dormant. Flushing replicates the move and then lets it go dormant again
+	if (NetDormancy > ENetDormancy::DORM_Awake)
+	{
+		FlushNetDormancy();
+	}
+}
+
+FNetworkFlightLaunch APaperGolfPawn::DoFlick(FFlickParams FlickParams)
 {
 	UE_VLOG_UELOG(this, LogPGPawn, Log,
 		TEXT("%s: DoFlick - ShotType=%s; LocalZOffset=%f; PowerFraction=%f; Accuracy=%f"),
@@ -609,9 +819,14 @@ void APaperGolfPawn::DoFlick(FFlickParams FlickParams)
 	// Turn off physics at first so can move the actor
 	_PaperGolfMesh->SetSimulatePhysics(true);
 
+	FNetworkFlightLaunch Launch;
+
 	if (HasAuthority())
 	{
 		CollisionDampeningComponent->OnFlick();
+		BeginFlightReplication();
+
+		Launch = PredictedFlightComponent->BeginServerFlight(GetFlickTrajectoryParams(FlickParams, PredictedFlightComponent->GetPredictParams()));
 	}
 
 	const auto& Impulse = GetFlickForce(FlickParams.ShotType, FlickParams.Accuracy, FlickParams.PowerFraction);
@@ -634,9 +849,11 @@ void APaperGolfPawn::DoFlick(FFlickParams FlickParams)
 	OnFlick.Broadcast();
 
 	PawnAudioComponent->PlayFlick(FlickParams, Impulse);
+
+	return Launch;
 }
 
-void APaperGolfPawn::DoNetworkFlick(const FNetworkFlickParams& Params)
+FNetworkFlightLaunch APaperGolfPawn::DoNetworkFlick(const FNetworkFlickParams& Params)
 {
 	UE_VLOG_UELOG(this, LogPGPawn, Log,
 		TEXT("%s: DoNetworkFlick - Rotation=%s; LocalZOffset=%f; PowerFraction=%f; Accuracy=%f"),
@@ -645,7 +862,7 @@ void APaperGolfPawn::DoNetworkFlick(const FNetworkFlickParams& Params)
 
 	SetActorRotation(Params.Rotation);
 
-	DoFlick(Params.FlickParams);
+	return DoFlick(Params.FlickParams);
 }
 
 void APaperGolfPawn::ServerFlick_Implementation(const FNetworkFlickParams& Params)
@@ -655,13 +872,13 @@ void APaperGolfPawn::ServerFlick_Implementation(const FNetworkFlickParams& Param
 		*GetName(), *Params.Rotation.ToCompactString(), Params.FlickParams.LocalZOffset, Params.FlickParams.PowerFraction, Params.FlickParams.Accuracy
 	);
 
-	DoNetworkFlick(Params);
+	const auto Launch = DoNetworkFlick(Params);
 
 	// Broadcast to other clients
-	MulticastFlick(Params);
+	MulticastFlick(Params, Launch);
 }
 
-void APaperGolfPawn::MulticastFlick_Implementation(const FNetworkFlickParams& Params)
+void APaperGolfPawn::MulticastFlick_Implementation(const FNetworkFlickParams& Params, const FNetworkFlightLaunch& Launch)
 {
 	if (GetLocalRole() != ENetRole::ROLE_SimulatedProxy)
 	{
@@ -674,13 +891,25 @@ void APaperGolfPawn::MulticastFlick_Implementation(const FNetworkFlickParams& Pa
 	}
 
 	UE_VLOG_UELOG(this, LogPGPawn, Log,
-		TEXT("%s: MulticastFlick_Implementation - Rotation=%s; LocalZOffset=%f; PowerFraction=%f; Accuracy=%f"),
-		*GetName(), *Params.Rotation.ToCompactString(), Params.FlickParams.LocalZOffset, Params.FlickParams.PowerFraction, Params.FlickParams.Accuracy
+		TEXT("%s: MulticastFlick_Implementation - Rotation=%s; LocalZOffset=%f; PowerFraction=%f; Accuracy=%f; LaunchLocation=%s; FlightId=%d; bPredicted=%s"),
+		*GetName(), *Params.Rotation.ToCompactString(), Params.FlickParams.LocalZOffset, Params.FlickParams.PowerFraction, Params.FlickParams.Accuracy,
+		*Launch.Location.ToCompactString(), Launch.FlightId, LoggingUtils::GetBoolString(Launch.bPredicted)
 	);
 
 	// Reset camera for spectators
 	SetCameraForFlick();
 
+	if (Launch.bPredicted)
+	{
+		// Start from exactly where the server flicked so that both simulations match
+		SetActorLocationAndRotation(Launch.Location, Params.Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+
+		FFlickParams FlickParams{ Params.FlickParams };
+		FlickParams.Clamp();
+
+		PredictedFlightComponent->BeginClientFlight(Launch, GetFlickTrajectoryParams(FlickParams, PredictedFlightComponent->GetPredictParams()));
+	}
+
 	OnFlick.Broadcast();
 
 	// recalculate Flick Impulse for pawn audio component
@@ -883,45 +1112,81 @@ float APaperGolfPawn::ClampFlickZ(float OriginalZOffset, float DeltaZ) const
 
 bool APaperGolfPawn::PredictFlick(const FFlickParams& FlickParams, const FFlickPredictParams& FlickPredictParams, FPredictProjectilePathResult& Result) const
 {
-	// Rotate flick impulse by AdditionalWorldRotation
-	const auto FlickImpulse = FlickPredictParams.AdditionalWorldRotation.RotateVector(GetFlickForce(FlickParams.ShotType, FlickParams.Accuracy, FlickParams.PowerFraction));
+	const auto TrajectoryParams = GetFlickTrajectoryParams(FlickParams, FlickPredictParams);
 
-	const auto DragForceMultiplier = GetFlickDragForceMultiplier(FlickImpulse.Size());
-	const auto DragAdjustedFlickImpulse = FlickImpulse * DragForceMultiplier;
+	// Size the path once for the max number of points and then trim to what the solver wrote
+	auto& PathData = Result.PathData;
+	PathData.SetNumUninitialized(TrajectoryParams.GetMaxNumPoints(), EAllowShrinking::No);
 
-	const auto& FlickDirection = FlickImpulse.GetSafeNormal();
+	FPaperGolfTrajectoryResult TrajectoryResult;
+	const bool bHit = PredictFlick(TrajectoryParams, PathData, TrajectoryResult);
+
+	PathData.SetNum(TrajectoryResult.NumPoints, EAllowShrinking::No);
 
-	FPredictProjectilePathParams Params;
-	// Offset start location a bit so that we don't collide with walls so that edge of sphere is on the flick location
-	Params.StartLocation = GetFlickLocation(FlickParams.LocalZOffset) + FlickDirection * FlickPredictParams.CollisionRadius;
-	Params.ActorsToIgnore.Add(const_cast<APaperGolfPawn*>(this));
-	Params.bTraceWithCollision = true;
-	Params.bTraceWithChannel = true;
-	Params.TraceChannel = PG::CollisionChannel::FlickTraceType;
-	Params.ProjectileRadius = FlickPredictParams.CollisionRadius;
-	Params.MaxSimTime = FlickPredictParams.MaxSimTime;
-	Params.SimFrequency = FlickPredictParams.SimFrequency;
+	Result.HitResult = TrajectoryResult.HitResult;
+	Result.LastTraceDestination.Set(TrajectoryResult.LastLocation, TrajectoryResult.LastVelocity, TrajectoryResult.SimTime);
 
-	// Impulse = change in momentum
-	Params.LaunchVelocity = DragAdjustedFlickImpulse / GetMass();
+	return bHit;
+}
 
-	// TODO: Later toggle with console variable
-	//Params.DrawDebugType = EDrawDebugTrace::ForDuration;
-	//Params.DrawDebugTime = 10.0f;
+bool APaperGolfPawn::PredictFlick(const FFlickParams& FlickParams, const FFlickPredictParams& FlickPredictParams, TArrayView<FPredictProjectilePathPointData> OutPath, FPaperGolfTrajectoryResult& Result) const
+{
+	return PredictFlick(GetFlickTrajectoryParams(FlickParams, FlickPredictParams), OutPath, Result);
+}
 
-	UE_VLOG_UELOG(this, LogPGPawn, Log, 
-		TEXT("%s: PredictFlick - FlickDirection=%s; FlickForceMagnitude=%.1f; DragForceMultiplier=%.1f; StartLocation=%s; LaunchVelocity=%scm/s"),
-		*GetName(),
-		*FlickDirection.ToCompactString(),
-		DragAdjustedFlickImpulse.Size(),
-		DragForceMultiplier,
-		*Params.StartLocation.ToCompactString(),
-		*Params.LaunchVelocity.ToCompactString());
+bool APaperGolfPawn::PredictFlick(const FPaperGolfTrajectoryParams& TrajectoryParams, TArrayView<FPredictProjectilePathPointData> OutPath, FPaperGolfTrajectoryResult& Result) const
+{
+	return DoPredictFlick(TrajectoryParams, nullptr, OutPath, Result);
+}
+
+bool APaperGolfPawn::PredictFlick(const FFlickParams& FlickParams, const FFlickPredictParams& FlickPredictParams, FPaperGolfTrajectoryScratch& Scratch, FPaperGolfTrajectoryResult& Result) const
+{
+	return PredictFlick(GetFlickTrajectoryParams(FlickParams, FlickPredictParams), Scratch, Result);
+}
+
+bool APaperGolfPawn::PredictFlick(const FPaperGolfTrajectoryParams& TrajectoryParams, FPaperGolfTrajectoryScratch& Scratch, FPaperGolfTrajectoryResult& Result) const
+{
+	const auto OutPath = Scratch.Prepare(TrajectoryParams);
+
+	return DoPredictFlick(TrajectoryParams, &Scratch.QueryParams, OutPath, Result);
+}
 
-	const bool bHit = UGameplayStatics::PredictProjectilePath(
-		GetWorld(),
-		Params,
-		Result);
+bool APaperGolfPawn::DoPredictFlick(const FPaperGolfTrajectoryParams& TrajectoryParams, const FCollisionQueryParams* QueryParams,
+	TArrayView<FPredictProjectilePathPointData> OutPath, FPaperGolfTrajectoryResult& Result) const
+{
+	auto World = GetWorld();
+	if (!ensure(World))
+	{
+		Result = {};
+		return false;
+	}
+
+	// Worker threads bypass the cache as it is not thread safe.
+	// The ignored components aren't part of the key as they are only set for predictions that are checked against the moving obstacles
+	const bool bUseCache = bEnableFlickPredictionCache && IsInGameThread() && TrajectoryParams.IgnoreComponents.IsEmpty();
+	if (bUseCache)
+	{
+		if (FlickPredictionCache.ResetIfMoved(GetActorTransform()))
+		{
+			UE_VLOG_UELOG(this, LogPGPawn, Verbose, TEXT("%s: PredictFlick - Cleared flick prediction cache as pawn moved; %s"),
+				*GetName(), *FlickPredictionCache.GetStats().ToString());
+		}
+
+		if (FlickPredictionCache.Find(TrajectoryParams, World->GetTimeSeconds(), OutPath, Result))
+		{
+			UE_VLOG_UELOG(this, LogPGPawn, VeryVerbose, TEXT("%s: PredictFlick - Cache hit: %s"), *GetName(), *Result.ToString());
+			return Result.bHit;
+		}
+	}
+
+	const bool bHit = QueryParams ?
+		FPaperGolfTrajectorySolver::Solve(*World, TrajectoryParams, *QueryParams, OutPath, Result) :
+		FPaperGolfTrajectorySolver::Solve(*World, TrajectoryParams, OutPath, Result);
+
+	if (bUseCache)
+	{
+		FlickPredictionCache.Add(TrajectoryParams, World->GetTimeSeconds(), OutPath, Result);
+	}
 
 #if ENABLE_VISUAL_LOG
 	if (FVisualLogger::IsRecording())
@@ -940,11 +1205,10 @@ bool APaperGolfPawn::PredictFlick(const FFlickParams& FlickParams, const FFlickP
 			UE_VLOG_UELOG(this, LogPGPawn, Log, TEXT("%s: PredictFlick - No hit found"), *GetName());
 		}
 
-		for (int32 i = 0; const auto & PathDatum : Result.PathData)
+		for (int32 i = 0; i < Result.NumPoints; ++i)
 		{
 			UE_VLOG_LOCATION(
-				this, LogPGPawn, Verbose, PathDatum.Location, Params.ProjectileRadius, FColor::Green, TEXT("P%d"), i);
-			++i;
+				this, LogPGPawn, Verbose, OutPath[i].Location, TrajectoryParams.CollisionRadius, FColor::Green, TEXT("P%d"), i);
 		}
 	}
 #endif
@@ -952,6 +1216,96 @@ bool APaperGolfPawn::PredictFlick(const FFlickParams& FlickParams, const FFlickP
 	return bHit;
 }
 
+FFlickPredictionCacheStats APaperGolfPawn::GetFlickPredictionCacheStats() const
+{
+	return FlickPredictionCache.GetStats();
+}
+
+void APaperGolfPawn::InvalidateFlickPredictionCache(const TCHAR* Reason) const
+{
+	UE_VLOG_UELOG(this, LogPGPawn, Log, TEXT("%s: InvalidateFlickPredictionCache - Reason=%s; %s"),
+		*GetName(), Reason, *FlickPredictionCache.GetStats().ToString());
+
+	FlickPredictionCache.Invalidate();
+}
+
+FPaperGolfTrajectoryParams APaperGolfPawn::GetFlickTrajectoryParams(const FFlickParams& FlickParams, const FFlickPredictParams& FlickPredictParams) const
+{
+	check(_PaperGolfMesh);
+
+	const FQuat AdditionalRotation = FlickPredictParams.AdditionalWorldRotation.Quaternion();
+
+	const auto UnrotatedFlickImpulse = GetFlickForce(FlickParams.ShotType, FlickParams.Accuracy, FlickParams.PowerFraction);
+
+	// Rotate flick impulse by AdditionalWorldRotation
+	const auto FlickImpulse = AdditionalRotation.RotateVector(UnrotatedFlickImpulse);
+
+	const auto DragForceMultiplier = GetFlickDragForceMultiplier(FlickImpulse.Size());
+	const auto DragAdjustedFlickImpulse = FlickImpulse * DragForceMultiplier;
+
+	const auto& FlickDirection = FlickImpulse.GetSafeNormal();
+	const auto FlickImpulseLocation = GetFlickLocation(FlickParams.LocalZOffset);
+
+	// Spin from flicking off center: angular impulse = r x J and w = I^-1 * L with the inertia tensor diagonal in the body's local space
+	// Calculate with the current pawn orientation and then apply the additional rotation
+	FVector AngularVelocity{ EForceInit::ForceInitToZero };
+	if (const auto Body = _PaperGolfMesh->GetBodyInstance(); Body)
+	{
+		const auto BodyRotation = Body->GetUnrealWorldTransform().GetRotation();
+		const auto AngularImpulse = (FlickImpulseLocation - Body->GetCOMPosition()) ^ (UnrotatedFlickImpulse * DragForceMultiplier);
+		const auto LocalAngularImpulse = BodyRotation.UnrotateVector(AngularImpulse);
+		const auto LocalInertia = Body->GetBodyInertiaTensor();
+
+		const FVector LocalAngularVelocity
+		{
+			LocalInertia.X > UE_SMALL_NUMBER ? LocalAngularImpulse.X / LocalInertia.X : 0.0,
+			LocalInertia.Y > UE_SMALL_NUMBER ? LocalAngularImpulse.Y / LocalInertia.Y : 0.0,
+			LocalInertia.Z > UE_SMALL_NUMBER ? LocalAngularImpulse.Z / LocalInertia.Z : 0.0
+		};
+
+		AngularVelocity = AdditionalRotation.RotateVector(BodyRotation.RotateVector(LocalAngularVelocity));
+	}
+
+	FPaperGolfTrajectoryParams Params
+	{
+		// Offset start location a bit so that we don't collide with walls so that edge of sphere is on the flick location
+		.StartLocation = FlickImpulseLocation + FlickDirection * FlickPredictParams.CollisionRadius,
+		// Impulse = change in momentum
+		.LaunchVelocity = DragAdjustedFlickImpulse / GetMass(),
+		.AngularVelocity = AngularVelocity,
+		.IgnoreActor = this,
+		.LinearDamping = _PaperGolfMesh->GetLinearDamping(),
+		.AngularDamping = _PaperGolfMesh->GetAngularDamping(),
+		.SpinLiftCoefficient = FlickSpinLiftCoefficient,
+		.CollisionRadius = FlickPredictParams.CollisionRadius,
+		.MaxSimTime = FlickPredictParams.MaxSimTime,
+		.SimFrequency = FlickPredictParams.SimFrequency,
+		.TraceChannel = PG::CollisionChannel::FlickTraceType
+	};
+
+	if (auto World = GetWorld(); World)
+	{
+		Params.GravityZ = World->GetGravityZ();
+
+		if (const auto WorldSettings = World->GetWorldSettings(); WorldSettings && WorldSettings->bEnableWorldBoundsChecks)
+		{
+			Params.KillZ = WorldSettings->KillZ;
+		}
+	}
+
+	UE_VLOG_UELOG(this, LogPGPawn, Log, 
+		TEXT("%s: GetFlickTrajectoryParams - FlickDirection=%s; FlickForceMagnitude=%.1f; DragForceMultiplier=%.1f; StartLocation=%s; LaunchVelocity=%scm/s; AngularVelocity=%srad/s"),
+		*GetName(),
+		*FlickDirection.ToCompactString(),
+		DragAdjustedFlickImpulse.Size(),
+		DragForceMultiplier,
+		*Params.StartLocation.ToCompactString(),
+		*Params.LaunchVelocity.ToCompactString(),
+		*Params.AngularVelocity.ToCompactString());
+
+	return Params;
+}
+
 ELifetimeCondition APaperGolfPawn::AllowActorComponentToReplicate(const UActorComponent* ComponentToReplicate) const
 {
 	if(ShouldReplicateComponent(ComponentToReplicate))
@@ -1062,7 +1416,30 @@ void APaperGolfPawn::BeginPlay()
 
 	SetReplicateMovement(true);
 
-	States.Reserve(NumSamples);
+	if (HasAuthority())
+	{
+		// Flight adapts the frequency and then restores this one
+		DefaultNetUpdateFrequency = NetUpdateFrequency;
+
+		INC_DWORD_STAT(STAT_PGActivePawnBodies);
+
+		if (auto Root = GetRootComponent(); ensure(Root))
+		{
+			Root->TransformUpdated.AddUObject(this, &ThisClass::OnRootTransformUpdated);
+		}
+	}
+
+	MotionHistory.ClearAndResize(NumSamples);
+	FlickPredictionCache.Configure(FlickPredictionCacheMaxEntries, FlickPredictionCacheMaxAge);
+
+	// Anything cached for the previous hole is stale once the course changes around the pawn
+	if (auto World = GetWorld(); ensure(World))
+	{
+		if (auto GolfEventsSubsystem = World->GetSubsystem<UGolfEventsSubsystem>(); ensure(GolfEventsSubsystem))
+		{
+			GolfEventsSubsystem->OnPaperGolfStartHole.AddUniqueDynamic(this, &ThisClass::OnStartHole);
+		}
+	}
 
 	Init();
 }
@@ -1096,6 +1473,11 @@ void APaperGolfPawn::Init()
 	InitDebugDraw();
 }
 
+void APaperGolfPawn::OnStartHole(int32 HoleNumber)
+{
+	InvalidateFlickPredictionCache(*FString::Printf(TEXT("StartHole %d"), HoleNumber));
+}
+
 float APaperGolfPawn::CalculateWidth() const
 {
 	// Use the CDO so that local rotations do not affect the result
@@ -1144,8 +1526,35 @@ void APaperGolfPawn::EndPlay(const EEndPlayReason::Type EndPlayReason)
 
 	Super::EndPlay(EndPlayReason);
 
-	States.Reset();
-	StateIndex = 0;
+	MotionHistory.Clear();
+	FlickPredictionCache.Invalidate();
+
+	GetWorldTimerManager().ClearTimer(FlightNetUpdateTimerHandle);
+
+	if (HasAuthority())
+	{
+		if (bParked)
+		{
+			DEC_DWORD_STAT(STAT_PGParkedPawnBodies);
+		}
+		else
+		{
+			DEC_DWORD_STAT(STAT_PGActivePawnBodies);
+		}
+	}
+
+	if (auto Root = GetRootComponent(); Root)
+	{
+		Root->TransformUpdated.RemoveAll(this);
+	}
+
+	if (auto World = GetWorld(); World)
+	{
+		if (auto GolfEventsSubsystem = World->GetSubsystem<UGolfEventsSubsystem>(); GolfEventsSubsystem)
+		{
+			GolfEventsSubsystem->OnPaperGolfStartHole.RemoveDynamic(this, &ThisClass::OnStartHole);
+		}
+	}
 
 	CleanupDebugDraw();
 }
@@ -1180,6 +1589,8 @@ void APaperGolfPawn::PostInitializeComponents()
 		_PaperGolfMesh->SetIsReplicated(true);
 		_PaperGolfMesh->bReplicatePhysicsToAutonomousProxy = true;
 
+		PredictedFlightComponent->Initialize(*_PaperGolfMesh);
+
 		PaperGolfMeshInitialTransform = _PaperGolfMesh->GetRelativeTransform();
 
 		TArray<USceneComponent*> Components;
@@ -1254,6 +1665,15 @@ void APaperGolfPawn::SetReadyForShot(bool bReady)
 
 	if (bReady)
 	{
+		// The owning client can only send ServerFlick while the actor channel is open
+		if (HasAuthority())
+		{
+			GetWorldTimerManager().ClearTimer(FlightNetUpdateTimerHandle);
+			NetUpdateFrequency = DefaultNetUpdateFrequency;
+
+			SetNetDormancy(ENetDormancy::DORM_Awake);
+		}
+
 		PawnAudioComponent->PlayTurnStart();
 	}
 }
@@ -1353,20 +1773,11 @@ void APaperGolfPawn::SampleState()
 {
 	if (!RootComponent->IsSimulatingPhysics())
 	{
-		States.Reset();
-		StateIndex = -1;
-		return;
-	}
-
-	StateIndex = (StateIndex + 1) % NumSamples;
-
-	if (States.Num() < NumSamples)
-	{
-		States.Emplace(*this);
+		MotionHistory.Clear();
 		return;
 	}
 
-	States[StateIndex] = *this;
+	MotionHistory.Add(GetActorLocation(), GetLinearVelocity(), GetAngularVelocity());
 }
 
 float APaperGolfPawn::CalculateMass() const
@@ -1419,12 +1830,6 @@ float APaperGolfPawn::CalculateMass() const
 	return CalculatedMass;
 }
 
-APaperGolfPawn::FState::FState(const APaperGolfPawn& Pawn) : 
-	Position(Pawn.GetActorLocation())
-{
-
-}
-
 #pragma region Visual Logger
 
 #if ENABLE_VISUAL_LOG
@@ -1442,6 +1847,7 @@ void APaperGolfPawn::GrabDebugSnapshot(FVisualLogEntry* Snapshot) const
 
 	Category.Add(TEXT("FocusActor"), *LoggingUtils::GetName(FocusActor));
 	Category.Add(TEXT("InPerpetualMotion"), LoggingUtils::GetBoolString(IsStuckInPerpetualMotion()));
+	Category.Add(TEXT("MotionMode"), LoggingUtils::GetName(GetMotionMode()));
 	Category.Add(TEXT("FlickLocation"), FlickLocation.ToCompactString());
 	Category.Add(TEXT("Location"), GetActorLocation().ToCompactString());
 	Category.Add(TEXT("Rotation"), GetActorRotation().ToCompactString());
@@ -1530,3 +1936,47 @@ void APaperGolfPawn::CleanupDebugDraw() {}
 #endif
 
 #pragma endregion Visual Logger
+
+namespace
+{
+	uint32 QuantizeFlickPower(float PowerFraction)
+	{
+		return FMath::RoundToInt32(FMath::Clamp(PowerFraction, 0.0f, 1.0f) * FlickPowerMaxValue);
+	}
+
+	float DequantizeFlickPower(uint32 Value)
+	{
+		return static_cast<float>(Value) / FlickPowerMaxValue;
+	}
+
+	uint32 QuantizeFlickAccuracy(float Accuracy)
+	{
+		return FMath::RoundToInt32(FMath::Clamp(Accuracy, -1.0f, 1.0f) * FlickAccuracyHalfRange) + FlickAccuracyHalfRange;
+	}
+
+	float DequantizeFlickAccuracy(uint32 Value)
+	{
+		return static_cast<float>(static_cast<int32>(Value) - FlickAccuracyHalfRange) / FlickAccuracyHalfRange;
+	}
+
+	int16 QuantizeFlickZOffset(float LocalZOffset)
+	{
+		return static_cast<int16>(FMath::Clamp(FMath::RoundToInt32(LocalZOffset / FlickZOffsetQuantum), MIN_int16, MAX_int16));
+	}
+
+	float DequantizeFlickZOffset(int16 Value)
+	{
+		return Value * FlickZOffsetQuantum;
+	}
+
+	FRotator QuantizeFlickRotation(const FRotator& Rotation)
+	{
+		// Same compression as FRotator::SerializeCompressedShort
+		return FRotator
+		{
+			FRotator::DecompressAxisFromShort(FRotator::CompressAxisToShort(Rotation.Pitch)),
+			FRotator::DecompressAxisFromShort(FRotator::CompressAxisToShort(Rotation.Yaw)),
+			FRotator::DecompressAxisFromShort(FRotator::CompressAxisToShort(Rotation.Roll))
+		};
+	}
+}
@@ -0,0 +1,166 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+
+#include "Pawn/PawnMotionHistory.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(PawnMotionHistory)
+
+FPawnMotionHistory::FPawnMotionHistory(int32 NumSamples) :
+	Positions(NumSamples),
+	LinearVelocities(NumSamples),
+	AngularVelocities(NumSamples),
+	StepLengths(NumSamples)
+{
+}
+
+void FPawnMotionHistory::Add(const FVector& Position, const FVector& LinearVelocity, const FVector& AngularVelocity)
+{
+	if (IsEmpty())
+	{
+		Origin = Position;
+	}
+
+	const auto RelativePosition = Position - Origin;
+	const double StepLength = IsEmpty() ? 0.0 : FVector::Dist(RelativePosition, Positions.Newest());
+
+	if (IsFull())
+	{
+		const auto& EvictedPosition = Positions.Oldest();
+
+		PositionSum -= EvictedPosition;
+		PositionSquaredSizeSum -= EvictedPosition.SizeSquared();
+		StepLengthSum -= StepLengths.Oldest();
+		SpeedStats.Remove(LinearVelocities.Oldest().Size());
+		AngularSpeedStats.Remove(AngularVelocities.Oldest().Size());
+	}
+
+	Positions.Add(RelativePosition);
+	LinearVelocities.Add(LinearVelocity);
+	AngularVelocities.Add(AngularVelocity);
+	StepLengths.Add(StepLength);
+
+	PositionSum += RelativePosition;
+	PositionSquaredSizeSum += RelativePosition.SizeSquared();
+	StepLengthSum += StepLength;
+	SpeedStats.Add(LinearVelocity.Size());
+	AngularSpeedStats.Add(AngularVelocity.Size());
+}
+
+void FPawnMotionHistory::Clear()
+{
+	Positions.Clear();
+	LinearVelocities.Clear();
+	AngularVelocities.Clear();
+	StepLengths.Clear();
+
+	Origin = PositionSum = FVector::ZeroVector;
+	PositionSquaredSizeSum = StepLengthSum = 0.0;
+	SpeedStats = {};
+	AngularSpeedStats = {};
+}
+
+void FPawnMotionHistory::ClearAndResize(int32 NewNumSamples)
+{
+	Positions.ClearAndResize(NewNumSamples);
+	LinearVelocities.ClearAndResize(NewNumSamples);
+	AngularVelocities.ClearAndResize(NewNumSamples);
+	StepLengths.ClearAndResize(NewNumSamples);
+
+	Clear();
+}
+
+FVector FPawnMotionHistory::GetDisplacement() const
+{
+	if (IsEmpty())
+	{
+		return FVector::ZeroVector;
+	}
+
+	return Positions.Newest() - Positions.Oldest();
+}
+
+double FPawnMotionHistory::GetPathLength() const
+{
+	if (IsEmpty())
+	{
+		return 0.0;
+	}
+
+	// The oldest step is from a sample that is no longer in the history
+	return FMath::Max(0.0, StepLengthSum - StepLengths.Oldest());
+}
+
+FVector FPawnMotionHistory::GetMeanPosition() const
+{
+	const auto N = Num();
+	if (N == 0)
+	{
+		return FVector::ZeroVector;
+	}
+
+	return Origin + PositionSum / N;
+}
+
+double FPawnMotionHistory::GetPositionVariance() const
+{
+	const auto N = Num();
+	if (N == 0)
+	{
+		return 0.0;
+	}
+
+	const auto MeanRelativePosition = PositionSum / N;
+
+	return FMath::Max(0.0, PositionSquaredSizeSum / N - MeanRelativePosition.SizeSquared());
+}
+
+EPawnMotionMode FPawnMotionHistory::Classify(const FPawnMotionClassifierParams& Params) const
+{
+	if (Num() < FMath::Max(Params.MinSamples, 2))
+	{
+		return EPawnMotionMode::Unknown;
+	}
+
+	const auto PositionStdDev = FMath::Sqrt(GetPositionVariance());
+	const auto Displacement = GetDisplacement().Size();
+	const auto PathLength = GetPathLength();
+	const auto MeanSpeed = GetMeanSpeed();
+
+	if (IsFull())
+	{
+		if (PositionStdDev <= Params.JitterMaxPositionStdDev && Displacement <= 2 * Params.JitterMaxPositionStdDev && MeanSpeed <= Params.JitterMaxMeanSpeed)
+		{
+			return EPawnMotionMode::Jitter;
+		}
+
+		// Compare against the jitter amplitude rather than zero displacement so returning to the exact start isn't required
+		if (PositionStdDev <= Params.OscillationMaxPositionStdDev && Displacement <= Params.OscillationMaxDisplacement && MeanSpeed <= Params.OscillationMaxMeanSpeed &&
+			PathLength >= Params.OscillationMinPathRatio * FMath::Max<double>(Displacement, Params.JitterMaxPositionStdDev))
+		{
+			return EPawnMotionMode::Oscillating;
+		}
+	}
+
+	if (GetMeanAngularSpeed() >= Params.RollingMinAngularSpeed && PathLength > UE_KINDA_SMALL_NUMBER &&
+		Displacement / PathLength >= Params.RollingMinStraightness)
+	{
+		return EPawnMotionMode::Rolling;
+	}
+
+	return EPawnMotionMode::Moving;
+}
+
+bool FPawnMotionHistory::IsInPerpetualMotion(const FPawnMotionClassifierParams& Params, double MaxDisplacement) const
+{
+	if (!IsFull() || GetMeanSpeed() > Params.OscillationMaxMeanSpeed)
+	{
+		return false;
+	}
+
+	if (const auto MotionMode = Classify(Params); MotionMode == EPawnMotionMode::Oscillating || MotionMode == EPawnMotionMode::Jitter)
+	{
+		return true;
+	}
+
+	return GetDisplacement().Size() < MaxDisplacement;
+}
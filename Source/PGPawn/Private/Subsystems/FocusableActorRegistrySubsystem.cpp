@@ -0,0 +1,266 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+
+#include "Subsystems/FocusableActorRegistrySubsystem.h"
+
+#include "Interfaces/FocusableActor.h"
+
+#include "Engine/Level.h"
+#include "Engine/World.h"
+
+#include "Logging/LoggingUtils.h"
+#include "VisualLogger/VisualLogger.h"
+#include "PGPawnLogging.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(FocusableActorRegistrySubsystem)
+
+void UFocusableActorRegistrySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &ThisClass::OnLevelAdded);
+}
+
+void UFocusableActorRegistrySubsystem::Deinitialize()
+{
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	LevelAddedHandle.Reset();
+
+	if (auto World = GetWorld(); World)
+	{
+		World->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+	}
+	ActorSpawnedHandle.Reset();
+
+	for (const auto& [ActorKey, HoleNumber] : HoleNumbersByActor)
+	{
+		if (auto Actor = ActorKey.ResolveObjectPtr(); Actor)
+		{
+			Actor->OnEndPlay.RemoveDynamic(this, &ThisClass::OnFocusableActorEndPlay);
+		}
+	}
+
+	HoleBuckets.Empty();
+	HoleNumbersByActor.Empty();
+
+	Super::Deinitialize();
+}
+
+void UFocusableActorRegistrySubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Blueprint focusables have no C++ base to register from so pick up everything already in the world once
+	for (const auto Level : InWorld.GetLevels())
+	{
+		if (Level)
+		{
+			RegisterLevelActors(*Level);
+		}
+	}
+
+	ActorSpawnedHandle = InWorld.AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &ThisClass::OnActorSpawned));
+
+	UE_VLOG_UELOG(this, LogPGPawn, Log, TEXT("%s: OnWorldBeginPlay - Registered %d focusable actor%s across %d hole%s"),
+		*GetName(), HoleNumbersByActor.Num(), LoggingUtils::Pluralize(HoleNumbersByActor.Num()), HoleBuckets.Num(), LoggingUtils::Pluralize(HoleBuckets.Num()));
+}
+
+void UFocusableActorRegistrySubsystem::RegisterFocusableActor(AActor& Actor)
+{
+	check(IsInGameThread());
+
+	if (!ensureMsgf(Actor.Implements<UFocusableActor>(), TEXT("%s: RegisterFocusableActor - %s does not implement IFocusableActor"), *GetName(), *Actor.GetName()))
+	{
+		return;
+	}
+
+	const auto HoleNumber = IFocusableActor::Execute_GetHoleNumber(&Actor);
+
+	if (const auto ExistingHoleNumber = HoleNumbersByActor.Find(&Actor); ExistingHoleNumber && *ExistingHoleNumber != HoleNumber)
+	{
+		RemoveFromBucket(*ExistingHoleNumber, &Actor);
+	}
+
+	HoleNumbersByActor.Add(&Actor, HoleNumber);
+
+	auto& Bucket = HoleBuckets.FindOrAdd(HoleNumber);
+	auto Entry = CaptureEntry(Actor);
+
+	if (auto ExistingEntry = Bucket.Entries.FindByPredicate([&](const auto& Candidate) { return Candidate.Actor == &Actor; }); ExistingEntry)
+	{
+		*ExistingEntry = MoveTemp(Entry);
+	}
+	else
+	{
+		if (Entry.bHole && Bucket.HoleEntryIndex != INDEX_NONE)
+		{
+			UE_VLOG_UELOG(this, LogPGPawn, Error, TEXT("%s: RegisterFocusableActor - Found multiple golf holes for hole number %d: %s and %s"),
+				*GetName(), HoleNumber, *LoggingUtils::GetName(Bucket.Entries[Bucket.HoleEntryIndex].Actor.Get()), *Actor.GetName());
+		}
+
+		Bucket.Entries.Add(MoveTemp(Entry));
+	}
+
+	RebuildFocusableActors(Bucket);
+
+	Actor.OnEndPlay.AddUniqueDynamic(this, &ThisClass::OnFocusableActorEndPlay);
+
+	UE_VLOG_UELOG(this, LogPGPawn, Verbose, TEXT("%s: RegisterFocusableActor - Actor=%s; HoleNumber=%d; NumEntries=%d"),
+		*GetName(), *Actor.GetName(), HoleNumber, Bucket.Entries.Num());
+}
+
+void UFocusableActorRegistrySubsystem::UnregisterFocusableActor(AActor& Actor)
+{
+	check(IsInGameThread());
+
+	Actor.OnEndPlay.RemoveDynamic(this, &ThisClass::OnFocusableActorEndPlay);
+
+	int32 HoleNumber;
+	if (!HoleNumbersByActor.RemoveAndCopyValue(&Actor, HoleNumber))
+	{
+		return;
+	}
+
+	RemoveFromBucket(HoleNumber, &Actor);
+
+	UE_VLOG_UELOG(this, LogPGPawn, Verbose, TEXT("%s: UnregisterFocusableActor - Actor=%s; HoleNumber=%d"), *GetName(), *Actor.GetName(), HoleNumber);
+}
+
+AActor* UFocusableActorRegistrySubsystem::GetHole(int32 HoleNumber) const
+{
+	const auto Bucket = HoleBuckets.Find(HoleNumber);
+	if (!Bucket || Bucket->HoleEntryIndex == INDEX_NONE)
+	{
+		return nullptr;
+	}
+
+	return Bucket->Entries[Bucket->HoleEntryIndex].Actor.Get();
+}
+
+TConstArrayView<AActor*> UFocusableActorRegistrySubsystem::GetFocusableActors(int32 HoleNumber) const
+{
+	const auto Bucket = HoleBuckets.Find(HoleNumber);
+	return Bucket ? TConstArrayView<AActor*>(Bucket->FocusableActors) : TConstArrayView<AActor*>{};
+}
+
+TConstArrayView<FFocusableActorEntry> UFocusableActorRegistrySubsystem::GetEntries(int32 HoleNumber) const
+{
+	const auto Bucket = HoleBuckets.Find(HoleNumber);
+	return Bucket ? TConstArrayView<FFocusableActorEntry>(Bucket->Entries) : TConstArrayView<FFocusableActorEntry>{};
+}
+
+const FFocusableActorEntry* UFocusableActorRegistrySubsystem::FindEntry(int32 HoleNumber, const AActor* Actor) const
+{
+	const auto Bucket = HoleBuckets.Find(HoleNumber);
+	if (!Bucket || !Actor)
+	{
+		return nullptr;
+	}
+
+	// Holes only have a handful of focusables so a linear search of the flat array beats hashing
+	return Bucket->Entries.FindByPredicate([Actor](const auto& Entry) { return Entry.Actor.Get() == Actor; });
+}
+
+int32 UFocusableActorRegistrySubsystem::GetNumFocusableActors() const
+{
+	return HoleNumbersByActor.Num();
+}
+
+void UFocusableActorRegistrySubsystem::RegisterLevelActors(const ULevel& Level)
+{
+	for (auto Actor : Level.Actors)
+	{
+		if (IsValid(Actor) && Actor->Implements<UFocusableActor>())
+		{
+			RegisterFocusableActor(*Actor);
+		}
+	}
+}
+
+void UFocusableActorRegistrySubsystem::OnLevelAdded(ULevel* Level, UWorld* InWorld)
+{
+	if (Level && InWorld == GetWorld() && InWorld->HasBegunPlay())
+	{
+		UE_VLOG_UELOG(this, LogPGPawn, Log, TEXT("%s: OnLevelAdded - Level=%s"), *GetName(), *LoggingUtils::GetName(Level));
+
+		RegisterLevelActors(*Level);
+	}
+}
+
+void UFocusableActorRegistrySubsystem::OnActorSpawned(AActor* Actor)
+{
+	if (Actor && Actor->Implements<UFocusableActor>())
+	{
+		RegisterFocusableActor(*Actor);
+	}
+}
+
+void UFocusableActorRegistrySubsystem::OnFocusableActorEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason)
+{
+	if (Actor)
+	{
+		UnregisterFocusableActor(*Actor);
+	}
+}
+
+void UFocusableActorRegistrySubsystem::RemoveFromBucket(int32 HoleNumber, const AActor* Actor)
+{
+	auto Bucket = HoleBuckets.Find(HoleNumber);
+	if (!Bucket)
+	{
+		return;
+	}
+
+	Bucket->Entries.RemoveAll([Actor](const auto& Entry) { return Entry.Actor.Get() == Actor || Entry.Actor.IsStale(); });
+
+	if (Bucket->Entries.IsEmpty())
+	{
+		HoleBuckets.Remove(HoleNumber);
+		return;
+	}
+
+	RebuildFocusableActors(*Bucket);
+}
+
+void UFocusableActorRegistrySubsystem::RebuildFocusableActors(FHoleBucket& Bucket)
+{
+	Bucket.FocusableActors.Reset();
+	Bucket.HoleEntryIndex = INDEX_NONE;
+
+	for (int32 i = 0; i < Bucket.Entries.Num(); ++i)
+	{
+		const auto& Entry = Bucket.Entries[i];
+
+		auto Actor = Entry.Actor.Get();
+		if (!Actor)
+		{
+			continue;
+		}
+
+		if (Entry.bHole && Bucket.HoleEntryIndex == INDEX_NONE)
+		{
+			Bucket.HoleEntryIndex = i;
+		}
+
+		// The hole is only a regular focus candidate if it isn't already tried first as the preferred focus
+		if (!Entry.bHole || !Entry.bPreferredFocus)
+		{
+			Bucket.FocusableActors.Add(Actor);
+		}
+	}
+}
+
+FFocusableActorEntry UFocusableActorRegistrySubsystem::CaptureEntry(AActor& Actor)
+{
+	return FFocusableActorEntry
+	{
+		.Actor = &Actor,
+		.Location = Actor.GetActorLocation(),
+		.ForwardVector = Actor.GetActorForwardVector(),
+		.MinDistance2D = IFocusableActor::Execute_GetMinDistance2D(&Actor),
+		.MinCosAngle = IFocusableActor::Execute_GetMinCosAngle(&Actor),
+		.FocusTraceEndOffset = IFocusableActor::Execute_GetFocusTraceEndOffset(&Actor),
+		.bHole = IFocusableActor::Execute_IsHole(&Actor),
+		.bPreferredFocus = IFocusableActor::Execute_IsPreferredFocus(&Actor)
+	};
+}
@@ -0,0 +1,587 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+
+#include "Subsystems/HazardSpatialIndexSubsystem.h"
+
+#include "Subsystems/GolfEventsSubsystem.h"
+
+#include "Components/PrimitiveComponent.h"
+#include "EngineUtils.h"
+#include "PhysicsEngine/BodySetup.h"
+
+#include "Utils/CollisionUtils.h"
+
+#include "Logging/LoggingUtils.h"
+#include "VisualLogger/VisualLogger.h"
+#include "PGPawnLogging.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HazardSpatialIndexSubsystem)
+
+namespace
+{
+	// Hazard volumes are large relative to a shot landing so a coarse cell keeps the number of cells per hazard down
+	constexpr float HazardCellSize = 2000.0f;
+	constexpr int32 MaxCellsPerHazard = 1024;
+
+	bool PlanesOverlapBox(TConstArrayView<FPlane> Planes, const FVector& Center, const FVector& Extent);
+}
+
+void UHazardSpatialIndexSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (auto GolfEventsSubsystem = Collection.InitializeDependency<UGolfEventsSubsystem>(); ensure(GolfEventsSubsystem))
+	{
+		GolfEventsSubsystem->OnPaperGolfStartHole.AddUniqueDynamic(this, &ThisClass::OnStartHole);
+	}
+}
+
+void UHazardSpatialIndexSubsystem::Deinitialize()
+{
+	for (const auto& Entry : Entries)
+	{
+		if (auto Actor = Entry.Actor.Get(); Actor && Actor->GetRootComponent())
+		{
+			Actor->GetRootComponent()->TransformUpdated.RemoveAll(this);
+		}
+	}
+
+	{
+		FWriteScopeLock WriteLock(IndexLock);
+
+		Entries.Empty();
+		EntryIndicesByActor.Empty();
+		Cells.Empty();
+		OversizedEntries.Empty();
+		UnindexedHazardBounds.Empty();
+		bScannedForUnindexedHazards = false;
+	}
+
+	Super::Deinitialize();
+}
+
+void UHazardSpatialIndexSubsystem::RegisterHazard(AActor& HazardActor, EHazardType HazardType, bool bPenaltyOnImpact, TConstArrayView<UPrimitiveComponent*> HazardComponents)
+{
+	check(IsInGameThread());
+
+	FHazardEntry Entry
+	{
+		.Actor = &HazardActor,
+		.ActorKey = &HazardActor,
+		.HazardType = HazardType,
+		.bPenaltyOnImpact = bPenaltyOnImpact
+	};
+
+	for (auto Component : HazardComponents)
+	{
+		if (Component)
+		{
+			Entry.Components.Add(Component);
+		}
+	}
+
+	CaptureGeometry(HazardActor, Entry);
+
+	UE_VLOG_UELOG(this, LogPGPawn, Log, TEXT("%s: RegisterHazard - HazardActor=%s; HazardType=%s; bPenaltyOnImpact=%s; Shapes=%d; Bounds=%s"),
+		*GetName(), *HazardActor.GetName(), *LoggingUtils::GetName(HazardType), LoggingUtils::GetBoolString(bPenaltyOnImpact), Entry.Shapes.Num(), *Entry.Bounds.ToString());
+
+	{
+		FWriteScopeLock WriteLock(IndexLock);
+
+		if (const auto ExistingIndex = EntryIndicesByActor.Find(&HazardActor); ExistingIndex)
+		{
+			RemoveEntry(*ExistingIndex);
+			Entries.RemoveAt(*ExistingIndex);
+		}
+
+		const auto EntryIndex = Entries.Add(MoveTemp(Entry));
+		EntryIndicesByActor.Add(&HazardActor, EntryIndex);
+
+		InsertEntry(EntryIndex);
+	}
+
+	// Only movable hazards need to be re-inserted after the initial capture
+	if (auto RootComponent = HazardActor.GetRootComponent(); RootComponent && RootComponent->Mobility == EComponentMobility::Movable)
+	{
+		RootComponent->TransformUpdated.AddUObject(this, &ThisClass::OnHazardTransformUpdated);
+	}
+}
+
+void UHazardSpatialIndexSubsystem::UnregisterHazard(AActor& HazardActor)
+{
+	check(IsInGameThread());
+
+	if (auto RootComponent = HazardActor.GetRootComponent(); RootComponent)
+	{
+		RootComponent->TransformUpdated.RemoveAll(this);
+	}
+
+	FWriteScopeLock WriteLock(IndexLock);
+
+	int32 EntryIndex;
+	if (!EntryIndicesByActor.RemoveAndCopyValue(&HazardActor, EntryIndex))
+	{
+		return;
+	}
+
+	RemoveEntry(EntryIndex);
+	Entries.RemoveAt(EntryIndex);
+
+	UE_VLOG_UELOG(this, LogPGPawn, Log, TEXT("%s: UnregisterHazard - HazardActor=%s"), *GetName(), *HazardActor.GetName());
+}
+
+void UHazardSpatialIndexSubsystem::UpdateHazard(const AActor& HazardActor)
+{
+	check(IsInGameThread());
+
+	// Only the game thread writes to the index so it can be read here without the lock
+	const auto EntryIndex = EntryIndicesByActor.Find(&HazardActor);
+	if (!EntryIndex)
+	{
+		return;
+	}
+
+	// Capture outside the lock so queries are only blocked for the re-insert
+	FHazardEntry Updated
+	{
+		.Components = Entries[*EntryIndex].Components
+	};
+	CaptureGeometry(HazardActor, Updated);
+
+	FWriteScopeLock WriteLock(IndexLock);
+
+	auto& Entry = Entries[*EntryIndex];
+
+	RemoveEntry(*EntryIndex);
+
+	Entry.Bounds = Updated.Bounds;
+	Entry.Shapes = MoveTemp(Updated.Shapes);
+	Entry.Planes = MoveTemp(Updated.Planes);
+
+	InsertEntry(*EntryIndex);
+
+	UE_VLOG_UELOG(this, LogPGPawn, Verbose, TEXT("%s: UpdateHazard - HazardActor=%s; Bounds=%s"), *GetName(), *HazardActor.GetName(), *Entry.Bounds.ToString());
+}
+
+void UHazardSpatialIndexSubsystem::Rebuild()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("UHazardSpatialIndexSubsystem::Rebuild");
+
+	check(IsInGameThread());
+
+	const auto StartTimeSeconds = FPlatformTime::Seconds();
+
+	auto UnindexedBounds = ScanUnindexedHazards();
+
+	FWriteScopeLock WriteLock(IndexLock);
+
+	Cells.Reset();
+	OversizedEntries.Reset();
+
+	UnindexedHazardBounds = MoveTemp(UnindexedBounds);
+	bScannedForUnindexedHazards = true;
+
+	for (auto It = Entries.CreateIterator(); It; ++It)
+	{
+		auto& Entry = *It;
+		Entry.bInserted = false;
+
+		auto Actor = Entry.Actor.Get();
+		if (!Actor)
+		{
+			EntryIndicesByActor.Remove(Entry.ActorKey);
+			It.RemoveCurrent();
+			continue;
+		}
+
+		Entry.Shapes.Reset();
+		Entry.Planes.Reset();
+		CaptureGeometry(*Actor, Entry);
+
+		InsertEntry(It.GetIndex());
+	}
+
+	UE_VLOG_UELOG(this, LogPGPawn, Log, TEXT("%s: Rebuild - Indexed %d hazard%s in %d cell%s with %d oversized and %d unindexed in %.2fms"),
+		*GetName(), Entries.Num(), LoggingUtils::Pluralize(Entries.Num()), Cells.Num(), LoggingUtils::Pluralize(Cells.Num()), OversizedEntries.Num(),
+		UnindexedHazardBounds.Num(), (FPlatformTime::Seconds() - StartTimeSeconds) * 1000);
+
+#if ENABLE_VISUAL_LOG
+	if (FVisualLogger::IsRecording())
+	{
+		for (const auto& Entry : Entries)
+		{
+			UE_VLOG_BOX(this, LogPGPawn, Log, Entry.Bounds, Entry.bPenaltyOnImpact ? FColor::Red : FColor::Orange, TEXT("%s"), *LoggingUtils::GetName(Entry.HazardType));
+		}
+
+		for (const auto& Bounds : UnindexedHazardBounds)
+		{
+			UE_VLOG_BOX(this, LogPGPawn, Log, Bounds, FColor::Magenta, TEXT("Unindexed"));
+		}
+	}
+#endif
+}
+
+FHazardQueryResult UHazardSpatialIndexSubsystem::QueryPoint(const FVector& Location) const
+{
+	FReadScopeLock ReadLock(IndexLock);
+
+	return QueryBoxLocked(FBox{ Location, Location });
+}
+
+FHazardQueryResult UHazardSpatialIndexSubsystem::QueryBox(const FBox& Box) const
+{
+	FReadScopeLock ReadLock(IndexLock);
+
+	return QueryBoxLocked(Box);
+}
+
+void UHazardSpatialIndexSubsystem::QueryPoints(TConstArrayView<FVector> Locations, TArrayView<FHazardQueryResult> OutResults) const
+{
+	check(Locations.Num() == OutResults.Num());
+
+	FReadScopeLock ReadLock(IndexLock);
+
+	for (int32 i = 0; i < Locations.Num(); ++i)
+	{
+		OutResults[i] = QueryBoxLocked(FBox{ Locations[i], Locations[i] });
+	}
+}
+
+void UHazardSpatialIndexSubsystem::QueryBoxes(TConstArrayView<FBox> Boxes, TArrayView<FHazardQueryResult> OutResults) const
+{
+	check(Boxes.Num() == OutResults.Num());
+
+	FReadScopeLock ReadLock(IndexLock);
+
+	for (int32 i = 0; i < Boxes.Num(); ++i)
+	{
+		OutResults[i] = QueryBoxLocked(Boxes[i]);
+	}
+}
+
+bool UHazardSpatialIndexSubsystem::NeedsPhysicsQuery(const FBox& Box) const
+{
+	FReadScopeLock ReadLock(IndexLock);
+
+	if (!bScannedForUnindexedHazards)
+	{
+		return true;
+	}
+
+	return UnindexedHazardBounds.ContainsByPredicate([&Box](const FBox& Bounds) { return Bounds.Intersect(Box); });
+}
+
+int32 UHazardSpatialIndexSubsystem::GetNumHazards() const
+{
+	FReadScopeLock ReadLock(IndexLock);
+
+	return Entries.Num();
+}
+
+void UHazardSpatialIndexSubsystem::OnStartHole(int32 HoleNumber)
+{
+	UE_VLOG_UELOG(this, LogPGPawn, Log, TEXT("%s: OnStartHole - HoleNumber=%d"), *GetName(), HoleNumber);
+
+	// Picks up any hazards that were changed or streamed in since the last hole
+	Rebuild();
+}
+
+void UHazardSpatialIndexSubsystem::OnHazardTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	if (auto Actor = UpdatedComponent ? UpdatedComponent->GetOwner() : nullptr; Actor)
+	{
+		UpdateHazard(*Actor);
+	}
+}
+
+void UHazardSpatialIndexSubsystem::CaptureGeometry(const AActor& HazardActor, FHazardEntry& Entry)
+{
+	Entry.Bounds.Init();
+
+	if (!Entry.Components.IsEmpty())
+	{
+		for (const auto& Component : Entry.Components)
+		{
+			if (auto Primitive = Component.Get(); Primitive)
+			{
+				CapturePrimitiveGeometry(*Primitive, Entry);
+			}
+		}
+		return;
+	}
+
+	HazardActor.ForEachComponent<UPrimitiveComponent>(false, [&](const UPrimitiveComponent* Primitive)
+	{
+		if (Primitive->GetCollisionObjectType() == PG::CollisionObjectType::Hazard)
+		{
+			CapturePrimitiveGeometry(*Primitive, Entry);
+		}
+	});
+}
+
+void UHazardSpatialIndexSubsystem::CapturePrimitiveGeometry(const UPrimitiveComponent& Primitive, FHazardEntry& Entry)
+{
+	const auto ComponentTransform = Primitive.GetComponentTransform();
+	const auto BodySetup = Primitive.GetBodySetup();
+
+	// Brush volumes are made up of convex elements which can be tested exactly
+	if (BodySetup && !BodySetup->AggGeom.ConvexElems.IsEmpty())
+	{
+		TArray<FPlane> LocalPlanes;
+
+		for (const auto& ConvexElem : BodySetup->AggGeom.ConvexElems)
+		{
+			const auto ElemTransform = ConvexElem.GetTransform() * ComponentTransform;
+			const auto ElemMatrix = ElemTransform.ToMatrixWithScale();
+			const auto ElemBounds = ConvexElem.ElemBox.TransformBy(ElemTransform);
+			const auto ElemCenter = ElemBounds.GetCenter();
+
+			LocalPlanes.Reset();
+			ConvexElem.GetPlanes(LocalPlanes);
+
+			FHazardShape Shape
+			{
+				.Bounds = ElemBounds,
+				.FirstPlane = Entry.Planes.Num(),
+				.NumPlanes = LocalPlanes.Num()
+			};
+
+			for (const auto& LocalPlane : LocalPlanes)
+			{
+				auto WorldPlane = LocalPlane.TransformBy(ElemMatrix);
+
+				// The query test assumes outward facing normals
+				if (WorldPlane.PlaneDot(ElemCenter) > 0)
+				{
+					WorldPlane = WorldPlane.Flip();
+				}
+
+				Entry.Planes.Add(WorldPlane);
+			}
+
+			Entry.Shapes.Add(Shape);
+			Entry.Bounds += ElemBounds;
+		}
+	}
+	else
+	{
+		const auto ComponentBounds = Primitive.Bounds.GetBox();
+
+		Entry.Shapes.Add(FHazardShape{ .Bounds = ComponentBounds });
+		Entry.Bounds += ComponentBounds;
+	}
+}
+
+TArray<FBox> UHazardSpatialIndexSubsystem::ScanUnindexedHazards() const
+{
+	TArray<FBox> UnindexedBounds;
+
+	auto World = GetWorld();
+	if (!World)
+	{
+		return UnindexedBounds;
+	}
+
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		const auto Actor = *It;
+		if (EntryIndicesByActor.Contains(Actor))
+		{
+			continue;
+		}
+
+		Actor->ForEachComponent<UPrimitiveComponent>(false, [&](const UPrimitiveComponent* Primitive)
+		{
+			if (Primitive->GetCollisionObjectType() != PG::CollisionObjectType::Hazard || !Primitive->IsCollisionEnabled())
+			{
+				return;
+			}
+
+			// Movable geometry may be anywhere by the time of the query
+			if (Primitive->Mobility == EComponentMobility::Movable)
+			{
+				UnindexedBounds.Add(FBox{ FVector{ -UE_BIG_NUMBER }, FVector{ UE_BIG_NUMBER } });
+			}
+			else
+			{
+				UnindexedBounds.Add(Primitive->Bounds.GetBox());
+			}
+
+			UE_VLOG_UELOG(this, LogPGPawn, Log, TEXT("%s: ScanUnindexedHazards - %s on %s did not register with the index"),
+				*GetName(), *Primitive->GetName(), *Actor->GetName());
+		});
+	}
+
+	return UnindexedBounds;
+}
+
+void UHazardSpatialIndexSubsystem::InsertEntry(int32 EntryIndex)
+{
+	auto& Entry = Entries[EntryIndex];
+
+	if (!Entry.Bounds.IsValid)
+	{
+		Entry.bInserted = false;
+		return;
+	}
+
+	Entry.MinCell = GetCellCoordinates(Entry.Bounds.Min);
+	Entry.MaxCell = GetCellCoordinates(Entry.Bounds.Max);
+
+	const auto CellExtent = Entry.MaxCell - Entry.MinCell + FIntPoint{ 1, 1 };
+	Entry.bOversized = static_cast<int64>(CellExtent.X) * CellExtent.Y > MaxCellsPerHazard;
+	Entry.bInserted = true;
+
+	if (Entry.bOversized)
+	{
+		OversizedEntries.Add(EntryIndex);
+		return;
+	}
+
+	for (int32 Y = Entry.MinCell.Y; Y <= Entry.MaxCell.Y; ++Y)
+	{
+		for (int32 X = Entry.MinCell.X; X <= Entry.MaxCell.X; ++X)
+		{
+			Cells.FindOrAdd(FIntPoint{ X, Y }).Add(EntryIndex);
+		}
+	}
+}
+
+void UHazardSpatialIndexSubsystem::RemoveEntry(int32 EntryIndex)
+{
+	auto& Entry = Entries[EntryIndex];
+
+	if (!Entry.bInserted)
+	{
+		return;
+	}
+
+	Entry.bInserted = false;
+
+	if (Entry.bOversized)
+	{
+		OversizedEntries.RemoveSingleSwap(EntryIndex);
+		return;
+	}
+
+	for (int32 Y = Entry.MinCell.Y; Y <= Entry.MaxCell.Y; ++Y)
+	{
+		for (int32 X = Entry.MinCell.X; X <= Entry.MaxCell.X; ++X)
+		{
+			const FIntPoint Coordinates{ X, Y };
+			if (auto CellEntries = Cells.Find(Coordinates); CellEntries)
+			{
+				CellEntries->RemoveSingleSwap(EntryIndex);
+				if (CellEntries->IsEmpty())
+				{
+					Cells.Remove(Coordinates);
+				}
+			}
+		}
+	}
+}
+
+FHazardQueryResult UHazardSpatialIndexSubsystem::QueryBoxLocked(const FBox& Box) const
+{
+	const auto ToResult = [](const FHazardEntry& Entry)
+	{
+		return FHazardQueryResult
+		{
+			.HazardActor = Entry.ActorKey,
+			.HazardType = Entry.HazardType,
+			.bPenaltyOnImpact = Entry.bPenaltyOnImpact
+		};
+	};
+
+	for (const auto EntryIndex : OversizedEntries)
+	{
+		if (const auto& Entry = Entries[EntryIndex]; EntryOverlaps(Entry, Box))
+		{
+			return ToResult(Entry);
+		}
+	}
+
+	if (Cells.IsEmpty())
+	{
+		return {};
+	}
+
+	const auto MinCell = GetCellCoordinates(Box.Min);
+	const auto MaxCell = GetCellCoordinates(Box.Max);
+
+	for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+	{
+		for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+		{
+			const auto CellEntries = Cells.Find(FIntPoint{ X, Y });
+			if (!CellEntries)
+			{
+				continue;
+			}
+
+			for (const auto EntryIndex : *CellEntries)
+			{
+				if (const auto& Entry = Entries[EntryIndex]; EntryOverlaps(Entry, Box))
+				{
+					return ToResult(Entry);
+				}
+			}
+		}
+	}
+
+	return {};
+}
+
+bool UHazardSpatialIndexSubsystem::EntryOverlaps(const FHazardEntry& Entry, const FBox& Box)
+{
+	if (!Entry.Bounds.Intersect(Box))
+	{
+		return false;
+	}
+
+	FVector Center, Extent;
+	Box.GetCenterAndExtents(Center, Extent);
+
+	for (const auto& Shape : Entry.Shapes)
+	{
+		if (!Shape.Bounds.Intersect(Box))
+		{
+			continue;
+		}
+
+		if (PlanesOverlapBox(MakeArrayView(Entry.Planes.GetData() + Shape.FirstPlane, Shape.NumPlanes), Center, Extent))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+FIntPoint UHazardSpatialIndexSubsystem::GetCellCoordinates(const FVector& Location)
+{
+	return FIntPoint
+	{
+		FMath::FloorToInt32(Location.X / HazardCellSize),
+		FMath::FloorToInt32(Location.Y / HazardCellSize)
+	};
+}
+
+namespace
+{
+	bool PlanesOverlapBox(TConstArrayView<FPlane> Planes, const FVector& Center, const FVector& Extent)
+	{
+		// The box is outside the convex shape if it is entirely in front of any face.
+		// This is conservative for boxes near an edge, which is the safe direction for hazard avoidance
+		for (const auto& Plane : Planes)
+		{
+			const auto ProjectedExtent = Extent | Plane.GetNormal().GetAbs();
+			if (Plane.PlaneDot(Center) - ProjectedExtent > 0)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,465 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+
+#include "Subsystems/PawnRestDetectionSubsystem.h"
+
+#include "Pawn/PaperGolfPawn.h"
+
+#include "Engine/World.h"
+#include "TimerManager.h"
+
+#include "Chaos/SimCallbackObject.h"
+#include "Chaos/SimCallbackInput.h"
+#include "PBDRigidsSolver.h"
+#include "Physics/Experimental/PhysScene_Chaos.h"
+#include "PhysicsProxy/SingleParticlePhysicsProxy.h"
+
+#include "Logging/LoggingUtils.h"
+#include "VisualLogger/VisualLogger.h"
+#include "PGPawnLogging.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(PawnRestDetectionSubsystem)
+
+namespace
+{
+	// The physics callback reports almost every rest so the watchdog only needs to catch the stragglers and repeat latched rests
+	constexpr float WatchdogInterval = 0.5f;
+
+	// A pawn passing through zero velocity, such as at the top of a bounce, is only at rest for a single sample
+	constexpr int32 MinWatchdogRestSamples = 2;
+
+	Chaos::FSingleParticlePhysicsProxy* GetPhysicsProxy(const APaperGolfPawn& Pawn);
+}
+
+struct FPawnRestSimInput : public Chaos::FSimCallbackInput
+{
+	struct FCommand
+	{
+		Chaos::FSingleParticlePhysicsProxy* Proxy{};
+		float MinTrackingTime{};
+		float RestTime{};
+		float LinearVelocitySquaredMax{};
+		float AngularVelocitySquaredMax{};
+		bool bTrack{};
+	};
+
+	TArray<FCommand> Commands;
+
+	void Reset()
+	{
+		Commands.Reset();
+	}
+};
+
+struct FPawnRestSimOutput : public Chaos::FSimCallbackOutput
+{
+	TArray<Chaos::FSingleParticlePhysicsProxy*, TInlineAllocator<4>> RestedProxies;
+
+	// Bodies that went back over the rest thresholds after coming to rest
+	TArray<Chaos::FSingleParticlePhysicsProxy*, TInlineAllocator<4>> WokenProxies;
+
+	void Reset()
+	{
+		RestedProxies.Reset();
+		WokenProxies.Reset();
+	}
+};
+
+class FPawnRestSimCallback : public Chaos::TSimCallbackObject<FPawnRestSimInput, FPawnRestSimOutput, Chaos::ESimCallbackOptions::Presimulate>
+{
+public:
+	void AddCommand_External(const FPawnRestSimInput::FCommand& Command)
+	{
+		GetProducerInputData_External()->Commands.Add(Command);
+	}
+
+private:
+	virtual void OnPreSimulate_Internal() override;
+
+	void ApplyCommands_Internal(const FPawnRestSimInput& Input);
+
+private:
+	struct FTrackedBody
+	{
+		float MinTrackingTime{};
+		float RestTime{};
+		float LinearVelocitySquaredMax{};
+		float AngularVelocitySquaredMax{};
+
+		float ElapsedTime{};
+		float RestElapsedTime{};
+		bool bReported{};
+	};
+
+	// Only accessed on the physics thread
+	TMap<Chaos::FSingleParticlePhysicsProxy*, FTrackedBody> TrackedBodies;
+};
+
+void FPawnRestSimCallback::OnPreSimulate_Internal()
+{
+	if (const auto Input = GetConsumerInput_Internal(); Input)
+	{
+		ApplyCommands_Internal(*Input);
+	}
+
+	const auto DeltaTime = static_cast<float>(GetDeltaTime_Internal());
+	FPawnRestSimOutput* Output{};
+
+	const auto GetOutput = [&]() -> FPawnRestSimOutput&
+	{
+		if (!Output)
+		{
+			Output = &GetProducerOutputData_Internal();
+		}
+		return *Output;
+	};
+
+	for (auto& [Proxy, Body] : TrackedBodies)
+	{
+		const auto Handle = Proxy->GetPhysicsThreadAPI();
+		if (!Handle)
+		{
+			continue;
+		}
+
+		Body.ElapsedTime += DeltaTime;
+
+		const bool bSleeping = Handle->ObjectState() == Chaos::EObjectStateType::Sleeping;
+		const bool bUnderThresholds = bSleeping ||
+			(Handle->V().SizeSquared() <= Body.LinearVelocitySquaredMax && Handle->W().SizeSquared() <= Body.AngularVelocitySquaredMax);
+
+		Body.RestElapsedTime = bUnderThresholds ? Body.RestElapsedTime + DeltaTime : 0.0f;
+
+		// Keep watching after the rest is reported so that the game thread drops the latched rest if the body is knocked moving again
+		if (Body.bReported)
+		{
+			if (!bUnderThresholds)
+			{
+				Body.bReported = false;
+				GetOutput().WokenProxies.Add(Proxy);
+			}
+			continue;
+		}
+
+		if (Body.ElapsedTime < Body.MinTrackingTime || (!bSleeping && Body.RestElapsedTime < Body.RestTime))
+		{
+			continue;
+		}
+
+		Body.bReported = true;
+		GetOutput().RestedProxies.Add(Proxy);
+	}
+}
+
+void FPawnRestSimCallback::ApplyCommands_Internal(const FPawnRestSimInput& Input)
+{
+	for (const auto& Command : Input.Commands)
+	{
+		if (!Command.bTrack)
+		{
+			TrackedBodies.Remove(Command.Proxy);
+			continue;
+		}
+
+		TrackedBodies.Add(Command.Proxy, FTrackedBody
+		{
+			.MinTrackingTime = Command.MinTrackingTime,
+			.RestTime = Command.RestTime,
+			.LinearVelocitySquaredMax = Command.LinearVelocitySquaredMax,
+			.AngularVelocitySquaredMax = Command.AngularVelocitySquaredMax
+		});
+	}
+}
+
+void UPawnRestDetectionSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &ThisClass::OnWorldPostActorTick);
+}
+
+void UPawnRestDetectionSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	PostActorTickHandle.Reset();
+
+	TrackedPawns.Empty();
+	UnregisterSimCallback();
+
+	Super::Deinitialize();
+}
+
+void UPawnRestDetectionSubsystem::TrackPawn(APaperGolfPawn& Pawn, const FPawnRestTrackingParams& Params, FSimpleDelegate&& OnCameToRest)
+{
+	check(IsInGameThread());
+
+	auto World = GetWorld();
+	check(World);
+
+	const auto Proxy = GetPhysicsProxy(Pawn);
+
+	UE_VLOG_UELOG(this, LogPGPawn, Log, TEXT("%s: TrackPawn - Pawn=%s; MinTrackingTime=%.2f; RestTime=%.2f; bHasProxy=%s"),
+		*GetName(), *Pawn.GetName(), Params.MinTrackingTime, Params.RestTime, LoggingUtils::GetBoolString(Proxy != nullptr));
+
+	// Re-tracking replaces the physics thread state so the rest can be reported again
+	if (const auto ExistingEntry = TrackedPawns.Find(&Pawn); ExistingEntry && ExistingEntry->Proxy && ExistingEntry->Proxy != Proxy && SimCallback)
+	{
+		SimCallback->AddCommand_External({ .Proxy = ExistingEntry->Proxy });
+	}
+
+	TrackedPawns.Add(&Pawn, FTrackedPawn
+	{
+		.Pawn = &Pawn,
+		.OnCameToRest = MoveTemp(OnCameToRest),
+		.Proxy = Proxy,
+		.TrackingStartTimeSeconds = World->GetTimeSeconds(),
+		.MinTrackingTime = Params.MinTrackingTime,
+		.RestTime = Params.RestTime
+	});
+
+	Pawn.OnEndPlay.AddUniqueDynamic(this, &ThisClass::OnPawnEndPlay);
+
+	if (Proxy && EnsureSimCallback())
+	{
+		SimCallback->AddCommand_External(
+		{
+			.Proxy = Proxy,
+			.MinTrackingTime = Params.MinTrackingTime,
+			.RestTime = Params.RestTime,
+			.LinearVelocitySquaredMax = Pawn.GetRestLinearVelocitySquaredMax(),
+			.AngularVelocitySquaredMax = Pawn.GetRestAngularVelocityRadsSquaredMax(),
+			.bTrack = true
+		});
+	}
+
+	UpdateWatchdog();
+}
+
+void UPawnRestDetectionSubsystem::UntrackPawn(const APaperGolfPawn& Pawn)
+{
+	FTrackedPawn Entry;
+	if (!TrackedPawns.RemoveAndCopyValue(&Pawn, Entry))
+	{
+		return;
+	}
+
+	UE_VLOG_UELOG(this, LogPGPawn, Log, TEXT("%s: UntrackPawn - Pawn=%s"), *GetName(), *Pawn.GetName());
+
+	if (Entry.Proxy && SimCallback)
+	{
+		SimCallback->AddCommand_External({ .Proxy = Entry.Proxy });
+	}
+
+	if (auto MutablePawn = Entry.Pawn.Get(); MutablePawn)
+	{
+		MutablePawn->OnEndPlay.RemoveDynamic(this, &ThisClass::OnPawnEndPlay);
+	}
+
+	UpdateWatchdog();
+}
+
+bool UPawnRestDetectionSubsystem::IsTracking(const APaperGolfPawn& Pawn) const
+{
+	return TrackedPawns.Contains(&Pawn);
+}
+
+bool UPawnRestDetectionSubsystem::EnsureSimCallback()
+{
+	if (SimCallback)
+	{
+		return true;
+	}
+
+	auto World = GetWorld();
+	check(World);
+
+	auto PhysicsScene = World->GetPhysicsScene();
+	if (!PhysicsScene)
+	{
+		return false;
+	}
+
+	auto Solver = PhysicsScene->GetSolver();
+	if (!ensure(Solver))
+	{
+		return false;
+	}
+
+	SimCallback = Solver->CreateAndRegisterSimCallbackObject_External<FPawnRestSimCallback>();
+
+	UE_VLOG_UELOG(this, LogPGPawn, Log, TEXT("%s: EnsureSimCallback - Registered physics thread rest callback"), *GetName());
+
+	return SimCallback != nullptr;
+}
+
+void UPawnRestDetectionSubsystem::UnregisterSimCallback()
+{
+	if (!SimCallback)
+	{
+		return;
+	}
+
+	if (auto World = GetWorld(); World && World->GetPhysicsScene())
+	{
+		if (auto Solver = World->GetPhysicsScene()->GetSolver(); Solver)
+		{
+			Solver->UnregisterAndFreeSimCallbackObject_External(SimCallback);
+		}
+	}
+
+	SimCallback = nullptr;
+}
+
+void UPawnRestDetectionSubsystem::OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+	if (InWorld != GetWorld() || !SimCallback)
+	{
+		return;
+	}
+
+	// Outputs can arrive for bodies that were untracked or re-tracked while the step was in flight so look each one up
+	while (const auto Output = SimCallback->PopOutputData_External())
+	{
+		for (const auto Proxy : Output->WokenProxies)
+		{
+			if (const auto Entry = TrackedPawns.Find(FindPawnKey(Proxy)); Entry)
+			{
+				Entry->bPhysicsRest = false;
+			}
+		}
+
+		for (const auto Proxy : Output->RestedProxies)
+		{
+			const auto PawnKey = FindPawnKey(Proxy);
+			if (const auto Entry = TrackedPawns.Find(PawnKey); Entry)
+			{
+				Entry->bPhysicsRest = true;
+				NotifyCameToRest(PawnKey, TEXT("Physics"));
+			}
+		}
+	}
+}
+
+void UPawnRestDetectionSubsystem::OnWatchdog()
+{
+	auto World = GetWorld();
+	check(World);
+
+	const auto CurrentTimeSeconds = World->GetTimeSeconds();
+
+	TArray<TObjectKey<APaperGolfPawn>, TInlineAllocator<8>> RestedPawns;
+
+	for (auto& [PawnKey, Entry] : TrackedPawns)
+	{
+		if (CurrentTimeSeconds - Entry.TrackingStartTimeSeconds < Entry.MinTrackingTime)
+		{
+			continue;
+		}
+
+		if (SampleWatchdogRest(Entry, CurrentTimeSeconds))
+		{
+			RestedPawns.Add(PawnKey);
+		}
+	}
+
+	// Delegates may untrack pawns so notify outside of the iteration
+	for (const auto& PawnKey : RestedPawns)
+	{
+		NotifyCameToRest(PawnKey, TEXT("Watchdog"));
+	}
+}
+
+void UPawnRestDetectionSubsystem::OnPawnEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason)
+{
+	// Must untrack before the body is destroyed so that the physics thread drops the proxy in the same frame
+	if (const auto Pawn = Cast<APaperGolfPawn>(Actor); Pawn)
+	{
+		UntrackPawn(*Pawn);
+	}
+}
+
+TObjectKey<APaperGolfPawn> UPawnRestDetectionSubsystem::FindPawnKey(const Chaos::FSingleParticlePhysicsProxy* Proxy) const
+{
+	for (const auto& [PawnKey, Entry] : TrackedPawns)
+	{
+		if (Entry.Proxy == Proxy)
+		{
+			return PawnKey;
+		}
+	}
+
+	return {};
+}
+
+bool UPawnRestDetectionSubsystem::SampleWatchdogRest(FTrackedPawn& Entry, double CurrentTimeSeconds) const
+{
+	// Repeat the physics thread rest until the pawn is untracked in case the consumer was not ready for it
+	if (Entry.bPhysicsRest)
+	{
+		return true;
+	}
+
+	const auto Pawn = Entry.Pawn.Get();
+	if (!Pawn || !Pawn->IsAtRest())
+	{
+		Entry.NumWatchdogRestSamples = 0;
+		return false;
+	}
+
+	if (Entry.NumWatchdogRestSamples++ == 0)
+	{
+		Entry.WatchdogRestStartTimeSeconds = CurrentTimeSeconds;
+	}
+
+	// At rest for the rest time like the physics thread check and across more than a single sample
+	return Entry.NumWatchdogRestSamples >= MinWatchdogRestSamples && CurrentTimeSeconds - Entry.WatchdogRestStartTimeSeconds >= Entry.RestTime;
+}
+
+void UPawnRestDetectionSubsystem::NotifyCameToRest(const TObjectKey<APaperGolfPawn>& PawnKey, const TCHAR* Source)
+{
+	const auto Entry = TrackedPawns.Find(PawnKey);
+	if (!Entry)
+	{
+		return;
+	}
+
+	UE_VLOG_UELOG(this, LogPGPawn, Log, TEXT("%s: NotifyCameToRest - Pawn=%s; Source=%s"), *GetName(), *LoggingUtils::GetName(Entry->Pawn.Get()), Source);
+
+	// Copy as the delegate may untrack the pawn
+	const auto OnCameToRest = Entry->OnCameToRest;
+	OnCameToRest.ExecuteIfBound();
+}
+
+void UPawnRestDetectionSubsystem::UpdateWatchdog()
+{
+	auto World = GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	auto& TimerManager = World->GetTimerManager();
+
+	if (TrackedPawns.IsEmpty())
+	{
+		TimerManager.ClearTimer(WatchdogTimerHandle);
+	}
+	else if (!TimerManager.IsTimerActive(WatchdogTimerHandle))
+	{
+		TimerManager.SetTimer(WatchdogTimerHandle, this, &ThisClass::OnWatchdog, WatchdogInterval, true);
+	}
+}
+
+namespace
+{
+	Chaos::FSingleParticlePhysicsProxy* GetPhysicsProxy(const APaperGolfPawn& Pawn)
+	{
+		const auto BodyInstance = Pawn.GetPhysicsBodyInstance();
+		if (!BodyInstance)
+		{
+			return nullptr;
+		}
+
+		return BodyInstance->GetPhysicsActorHandle();
+	}
+}
@@ -0,0 +1,430 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+#include "Library/PaperGolfTrajectorySolver.h"
+#include "Pawn/FlickPredictionCache.h"
+#include "Pawn/PaperGolfPawn.h"
+
+#include "PGConstants.h"
+#include "Utils/PGTestUtils.h"
+
+#include "Camera/CameraComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "GameFramework/SpringArmComponent.h"
+
+#include "HAL/MemoryBase.h"
+
+#include <atomic>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	constexpr int32 MaxCacheEntries = PG::TestUtils::Defaults::FlickPredictionCacheMaxEntries;
+	constexpr float MaxCacheEntryAge = PG::TestUtils::Defaults::FlickPredictionCacheMaxAge;
+
+	constexpr int32 NumIterations = 100;
+
+	/*
+	* Forwards everything to the allocator it wraps and counts the allocations made from the thread that is counting.
+	* Other threads keep allocating through it while it is installed so it is never destroyed and only the counting thread is recorded.
+	*/
+	class FCountingMalloc final : public FMalloc
+	{
+	public:
+		void Start(FMalloc* InInnerMalloc)
+		{
+			InnerMalloc = InInnerMalloc;
+			NumAllocations = 0;
+			CountingThreadId = FPlatformTLS::GetCurrentThreadId();
+		}
+
+		void Stop()
+		{
+			CountingThreadId = 0;
+		}
+
+		FMalloc* GetInnerMalloc() const { return InnerMalloc; }
+
+		int32 GetNumAllocations() const { return NumAllocations; }
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			Record();
+			return InnerMalloc->Malloc(Count, Alignment);
+		}
+
+		virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override
+		{
+			Record();
+			return InnerMalloc->TryMalloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			if (Count > 0)
+			{
+				Record();
+			}
+			return InnerMalloc->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			if (Count > 0)
+			{
+				Record();
+			}
+			return InnerMalloc->TryRealloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override
+		{
+			InnerMalloc->Free(Original);
+		}
+
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+		{
+			return InnerMalloc->QuantizeSize(Count, Alignment);
+		}
+
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+		{
+			return InnerMalloc->GetAllocationSize(Original, SizeOut);
+		}
+
+		virtual void Trim(bool bTrimThreadCaches) override
+		{
+			InnerMalloc->Trim(bTrimThreadCaches);
+		}
+
+		virtual void SetupTLSCachesOnCurrentThread() override
+		{
+			InnerMalloc->SetupTLSCachesOnCurrentThread();
+		}
+
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override
+		{
+			InnerMalloc->ClearAndDisableTLSCachesOnCurrentThread();
+		}
+
+		virtual bool IsInternallyThreadSafe() const override
+		{
+			return InnerMalloc->IsInternallyThreadSafe();
+		}
+
+		virtual bool ValidateHeap() override
+		{
+			return InnerMalloc->ValidateHeap();
+		}
+
+		virtual const TCHAR* GetDescriptiveName() override
+		{
+			return InnerMalloc->GetDescriptiveName();
+		}
+
+	private:
+		void Record()
+		{
+			if (CountingThreadId == FPlatformTLS::GetCurrentThreadId())
+			{
+				++NumAllocations;
+			}
+		}
+
+	private:
+		FMalloc* InnerMalloc{};
+		std::atomic<uint32> CountingThreadId{};
+
+		// Only touched by the counting thread
+		int32 NumAllocations{};
+	};
+
+	FCountingMalloc CountingMalloc;
+
+	/*
+	* Counts the heap allocations made by the current thread while in scope by putting FCountingMalloc in front of GMalloc.
+	* Allocations from other threads, e.g. the physics and task graph threads, pass through uncounted.
+	*/
+	class FScopedAllocationCounter
+	{
+	public:
+		FScopedAllocationCounter()
+		{
+			check(IsInGameThread());
+			check(GMalloc != &CountingMalloc);
+
+			CountingMalloc.Start(GMalloc);
+			GMalloc = &CountingMalloc;
+		}
+
+		~FScopedAllocationCounter()
+		{
+			GMalloc = CountingMalloc.GetInnerMalloc();
+			CountingMalloc.Stop();
+		}
+
+		int32 GetNumAllocations() const { return CountingMalloc.GetNumAllocations(); }
+	};
+
+	FPaperGolfTrajectoryParams MakeTrajectoryParams(int32 Index, float MaxSimTime)
+	{
+		return FPaperGolfTrajectoryParams
+		{
+			.StartLocation = { 100.0 * Index, 0.0, 0.0 },
+			.LaunchVelocity = { 500.0, 0.0, 500.0 },
+			.MaxSimTime = MaxSimTime
+		};
+	}
+
+	/*
+	* Game world with a flat ground for the predictions to land on and a pawn assembled from the components that APaperGolfPawn looks up
+	* in PostInitializeComponents. BeginPlay is never called so nothing in the world ticks on its own.
+	*/
+	class FScopedPredictionWorld
+	{
+	public:
+		FScopedPredictionWorld()
+		{
+			World = UWorld::CreateWorld(EWorldType::Game, false);
+			check(World);
+
+			auto& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+			WorldContext.SetCurrentWorld(World);
+
+			Cube = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+
+			SpawnGround();
+			SpawnPawn();
+		}
+
+		~FScopedPredictionWorld()
+		{
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(false);
+		}
+
+		bool IsValid() const { return Cube && Pawn; }
+
+		const APaperGolfPawn* GetPawn() const { return Pawn; }
+
+		FPaperGolfTrajectoryParams MakeFlickParams(int32 Index) const
+		{
+			// Vary the launch so that every prediction misses the cache and runs the solver
+			return FPaperGolfTrajectoryParams
+			{
+				.StartLocation = { 0.0, 0.0, 100.0 },
+				.LaunchVelocity = { 400.0 + 5.0 * Index, 10.0 * (Index % 7), 500.0 },
+				.IgnoreActor = Pawn,
+				.GravityZ = World->GetGravityZ(),
+				.MaxSimTime = 10.0f,
+				.TraceChannel = PG::CollisionChannel::FlickTraceType
+			};
+		}
+
+	private:
+		void SpawnGround()
+		{
+			FActorSpawnParameters SpawnParams;
+			SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+			// Top of the 1m cube is at z = 0
+			const FTransform GroundTransform{ FQuat::Identity, FVector{ 0.0, 0.0, -50.0 }, FVector{ 1000.0, 1000.0, 1.0 } };
+
+			auto Ground = World->SpawnActor<AStaticMeshActor>(AStaticMeshActor::StaticClass(), GroundTransform, SpawnParams);
+			if (!Ground || !Cube)
+			{
+				return;
+			}
+
+			auto GroundComponent = Ground->GetStaticMeshComponent();
+			GroundComponent->SetStaticMesh(Cube);
+			GroundComponent->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+			GroundComponent->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Block);
+		}
+
+		void SpawnPawn()
+		{
+			FActorSpawnParameters SpawnParams;
+			SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+			SpawnParams.bDeferConstruction = true;
+
+			Pawn = World->SpawnActor<APaperGolfPawn>(FVector{ 0.0, 0.0, 100.0 }, FRotator::ZeroRotator, SpawnParams);
+			if (!Pawn || !Cube)
+			{
+				return;
+			}
+
+			auto Pivot = NewObject<USceneComponent>(Pawn, TEXT("Pivot"));
+			Pawn->SetRootComponent(Pivot);
+
+			auto Mesh = NewObject<UStaticMeshComponent>(Pawn, TEXT("Mesh"));
+			Mesh->SetStaticMesh(Cube);
+			Mesh->SetRelativeScale3D(FVector{ 0.1 });
+			Mesh->SetMassOverrideInKg(NAME_None, 0.1f, true);
+			Mesh->SetupAttachment(Pivot);
+
+			auto SpringArm = NewObject<USpringArmComponent>(Pawn, TEXT("SpringArm"));
+			SpringArm->SetupAttachment(Mesh);
+
+			auto Camera = NewObject<UCameraComponent>(Pawn, TEXT("Camera"));
+			Camera->SetupAttachment(SpringArm);
+
+			auto FlickReference = NewObject<USceneComponent>(Pawn, TEXT("FlickReference"));
+			FlickReference->SetupAttachment(Mesh);
+
+			for (USceneComponent* Component : { Pivot, static_cast<USceneComponent*>(Mesh), static_cast<USceneComponent*>(SpringArm),
+				static_cast<USceneComponent*>(Camera), FlickReference })
+			{
+				Pawn->AddInstanceComponent(Component);
+				Component->RegisterComponent();
+			}
+
+			Pawn->FinishSpawning(FTransform{ FVector{ 0.0, 0.0, 100.0 } });
+		}
+
+	private:
+		UWorld* World{};
+		UStaticMesh* Cube{};
+		APaperGolfPawn* Pawn{};
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlickPredictionScratchAllocationsTest, "PaperGolf.Pawn.FlickPrediction.ScratchAllocations", PG::TestUtils::AutomationTestFlags)
+
+bool FFlickPredictionScratchAllocationsTest::RunTest(const FString& Parameters)
+{
+	FPaperGolfTrajectoryScratch Scratch;
+
+	// Grow to the longest prediction
+	Scratch.Prepare(MakeTrajectoryParams(0, 10.0f));
+
+	// Read the counts before testing them as a failed test allocates its message
+	int32 NumWarmedUpAllocations;
+	{
+		FScopedAllocationCounter AllocationCounter;
+
+		for (int32 i = 0; i < NumIterations; ++i)
+		{
+			Scratch.Prepare(MakeTrajectoryParams(i, i % 2 ? 2.0f : 10.0f));
+		}
+
+		NumWarmedUpAllocations = AllocationCounter.GetNumAllocations();
+	}
+
+	TestEqual(TEXT("Warmed up: Allocations"), NumWarmedUpAllocations, 0);
+
+	// Also checks that the counter sees the allocations
+	int32 NumGrowAllocations;
+	{
+		FScopedAllocationCounter AllocationCounter;
+
+		Scratch.Prepare(MakeTrajectoryParams(0, 20.0f));
+
+		NumGrowAllocations = AllocationCounter.GetNumAllocations();
+	}
+
+	TestTrue(TEXT("Longer prediction: Allocations"), NumGrowAllocations > 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlickPredictionCacheAllocationsTest, "PaperGolf.Pawn.FlickPrediction.CacheAllocations", PG::TestUtils::AutomationTestFlags)
+
+bool FFlickPredictionCacheAllocationsTest::RunTest(const FString& Parameters)
+{
+	constexpr float MaxSimTime = 10.0f;
+
+	FFlickPredictionCache Cache;
+	Cache.Configure(MaxCacheEntries, MaxCacheEntryAge);
+
+	TArray<FPredictProjectilePathPointData> Path, OutPath;
+	Path.SetNum(MakeTrajectoryParams(0, MaxSimTime).GetMaxNumPoints());
+	OutPath.SetNum(Path.Num());
+
+	const FPaperGolfTrajectoryResult Result{ .NumPoints = Path.Num() };
+	FPaperGolfTrajectoryResult OutResult;
+
+	// Adds more predictions than fit so that entries are evicted as well as reused
+	const auto AddPredictions = [&](int32 Round, double TimeSeconds)
+	{
+		for (int32 i = 0; i < 2 * MaxCacheEntries; ++i)
+		{
+			const auto Params = MakeTrajectoryParams(Round * 2 * MaxCacheEntries + i, MaxSimTime);
+
+			Cache.Add(Params, TimeSeconds + i * 1e-3, Path, Result);
+			Cache.Find(Params, TimeSeconds + i * 1e-3, OutPath, OutResult);
+		}
+
+		Cache.Invalidate();
+	};
+
+	// Every entry gets a full path buffer
+	AddPredictions(0, 0.0);
+
+	int32 NumWarmedUpAllocations;
+	{
+		FScopedAllocationCounter AllocationCounter;
+
+		for (int32 Round = 1; Round <= NumIterations; ++Round)
+		{
+			AddPredictions(Round, Round);
+		}
+
+		NumWarmedUpAllocations = AllocationCounter.GetNumAllocations();
+	}
+
+	TestEqual(TEXT("Warmed up: Allocations"), NumWarmedUpAllocations, 0);
+
+	TestEqual(TEXT("Hits"), Cache.GetStats().Hits, (NumIterations + 1) * 2 * MaxCacheEntries);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlickPredictionPawnAllocationsTest, "PaperGolf.Pawn.FlickPrediction.PawnAllocations", PG::TestUtils::AutomationTestFlags)
+
+bool FFlickPredictionPawnAllocationsTest::RunTest(const FString& Parameters)
+{
+	FScopedPredictionWorld PredictionWorld;
+	if (!TestTrue(TEXT("World"), PredictionWorld.IsValid()))
+	{
+		return false;
+	}
+
+	const auto Pawn = PredictionWorld.GetPawn();
+
+	FPaperGolfTrajectoryScratch Scratch;
+	FPaperGolfTrajectoryResult Result;
+
+	// Enough predictions to fill the pawn's flick prediction cache so that the counted ones evict and reuse its entries
+	int32 NumWarmUpHits{};
+	for (int32 i = 0; i < 2 * MaxCacheEntries; ++i)
+	{
+		NumWarmUpHits += Pawn->PredictFlick(PredictionWorld.MakeFlickParams(i), Scratch, Result);
+	}
+
+	int32 NumHits{}, NumWarmedUpAllocations;
+	{
+		FScopedAllocationCounter AllocationCounter;
+
+		for (int32 i = 0; i < NumIterations; ++i)
+		{
+			NumHits += Pawn->PredictFlick(PredictionWorld.MakeFlickParams(2 * MaxCacheEntries + i), Scratch, Result);
+		}
+
+		NumWarmedUpAllocations = AllocationCounter.GetNumAllocations();
+	}
+
+	TestEqual(TEXT("Warmed up: Allocations"), NumWarmedUpAllocations, 0);
+
+	// Every flight lands on the ground so the hit path of the solver is covered
+	TestEqual(TEXT("Warm up: Hits"), NumWarmUpHits, 2 * MaxCacheEntries);
+	TestEqual(TEXT("Warmed up: Hits"), NumHits, NumIterations);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,222 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+#include "Pawn/PawnMotionHistory.h"
+
+#include "Utils/PGTestUtils.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	// Sampled at a 60Hz tick
+	constexpr int32 HistorySamples = PG::TestUtils::Defaults::MotionHistorySamples;
+	constexpr double SampleDeltaTime = 1 / 60.0;
+
+	constexpr double Gravity = 980.0;
+
+	struct FMotionSample
+	{
+		FVector Position{ EForceInit::ForceInitToZero };
+		FVector LinearVelocity{ EForceInit::ForceInitToZero };
+		FVector AngularVelocity{ EForceInit::ForceInitToZero };
+	};
+
+	using FMotionTrace = TArray<FMotionSample>;
+
+	struct FExpectedMotion
+	{
+		EPawnMotionMode MotionMode{};
+		bool bPerpetualMotion{};
+	};
+
+	/*
+	* Synthetic motion traces sampled at the tick rate. Each one is generated from a simple motion model of a case the classifier must tell apart
+	* rather than captured from a flight, so they check the classifier against those models and not against the physics simulation.
+	*/
+	namespace SyntheticTraces
+	{
+		// Settled on the ground with the solver nudging it by a fraction of a centimeter
+		FMotionTrace RestingJitter()
+		{
+			FRandomStream Random(1);
+			const FVector Location{ 100.0, 50.0, 10.0 };
+
+			FMotionTrace Trace;
+			for (int32 i = 0; i < 40; ++i)
+			{
+				Trace.Add(FMotionSample
+				{
+					.Position = Location + FVector{ Random.FRandRange(-0.2, 0.2), Random.FRandRange(-0.2, 0.2), Random.FRandRange(-0.2, 0.2) },
+					.LinearVelocity = { Random.FRandRange(-2.0, 2.0), Random.FRandRange(-2.0, 2.0), Random.FRandRange(-2.0, 2.0) },
+					.AngularVelocity = { 0.0, 0.0, Random.FRandRange(0.0, 0.2) }
+				});
+			}
+
+			return Trace;
+		}
+
+		// Rocking up and down a slope in place. The trace ends on whole periods of the rocking
+		FMotionTrace SlopeRocking()
+		{
+			constexpr double Amplitude = 1.5;
+			constexpr double Frequency = UE_DOUBLE_TWO_PI / 0.2;
+
+			FMotionTrace Trace;
+			for (int32 i = 0; i <= 2 * (HistorySamples - 1); ++i)
+			{
+				double Sin, Cos;
+				FMath::SinCos(&Sin, &Cos, Frequency * i * SampleDeltaTime);
+
+				Trace.Add(FMotionSample
+				{
+					.Position = { Amplitude * Sin, 0.0, 0.3 * Amplitude * Sin },
+					.LinearVelocity = { Amplitude * Frequency * Cos, 0.0, 0.3 * Amplitude * Frequency * Cos },
+					.AngularVelocity = { 0.0, 3.0 * Cos, 0.0 }
+				});
+			}
+
+			return Trace;
+		}
+
+		// Pushed around in a small circle by a fan
+		FMotionTrace FanWobble()
+		{
+			constexpr double Amplitude = 1.0;
+			constexpr double Frequency = UE_DOUBLE_TWO_PI / 0.2;
+
+			FMotionTrace Trace;
+			for (int32 i = 0; i <= 2 * (HistorySamples - 1); ++i)
+			{
+				double Sin, Cos;
+				FMath::SinCos(&Sin, &Cos, Frequency * i * SampleDeltaTime);
+
+				Trace.Add(FMotionSample
+				{
+					.Position = { Amplitude * Sin, Amplitude * Cos, 0.0 },
+					.LinearVelocity = { Amplitude * Frequency * Cos, -Amplitude * Frequency * Sin, 0.0 },
+					.AngularVelocity = { 0.0, 0.0, 0.5 }
+				});
+			}
+
+			return Trace;
+		}
+
+		// Hop with a little forward speed where the samples are centered on the apex
+		FMotionTrace HopApex(int32 SamplesEachSide)
+		{
+			FMotionTrace Trace;
+			for (int32 i = -SamplesEachSide; i <= SamplesEachSide; ++i)
+			{
+				const auto Time = i * SampleDeltaTime;
+
+				Trace.Add(FMotionSample
+				{
+					.Position = { 10.0 * Time, 0.0, -0.5 * Gravity * Time * Time },
+					.LinearVelocity = { 10.0, 0.0, -Gravity * Time }
+				});
+			}
+
+			return Trace;
+		}
+
+		// Rocks on the edge of a ledge for a moment and then tips over and slides off
+		FMotionTrace LedgeTeeter(int32 NumSamples)
+		{
+			constexpr int32 TipSample = 12;
+			constexpr double Amplitude = 0.5;
+			constexpr double Frequency = UE_DOUBLE_TWO_PI / 0.2;
+
+			FMotionTrace Trace;
+			for (int32 i = 0; i < NumSamples; ++i)
+			{
+				if (i <= TipSample)
+				{
+					double Sin, Cos;
+					FMath::SinCos(&Sin, &Cos, Frequency * i * SampleDeltaTime);
+
+					Trace.Add(FMotionSample
+					{
+						.Position = { Amplitude * Sin, 0.0, 0.0 },
+						.LinearVelocity = { Amplitude * Frequency * Cos, 0.0, 0.0 },
+						.AngularVelocity = { 0.0, 2.0, 0.0 }
+					});
+				}
+				else
+				{
+					const auto Time = (i - TipSample) * SampleDeltaTime;
+
+					Trace.Add(FMotionSample
+					{
+						.Position = { 300.0 * Time * Time, 0.0, -200.0 * Time * Time },
+						.LinearVelocity = { 600.0 * Time, 0.0, -400.0 * Time },
+						.AngularVelocity = { 0.0, 2.0, 0.0 }
+					});
+				}
+			}
+
+			return Trace;
+		}
+
+		// Rolling steadily down the fairway
+		FMotionTrace Rolling()
+		{
+			FMotionTrace Trace;
+			for (int32 i = 0; i < 30; ++i)
+			{
+				Trace.Add(FMotionSample
+				{
+					.Position = { 50.0 * i * SampleDeltaTime, 0.0, 0.0 },
+					.LinearVelocity = { 50.0, 0.0, 0.0 },
+					.AngularVelocity = { 0.0, 5.0, 0.0 }
+				});
+			}
+
+			return Trace;
+		}
+	}
+
+	void TestTrace(FAutomationTestBase& Test, const FString& TraceName, const FMotionTrace& Trace, const FExpectedMotion& Expected)
+	{
+		FPawnMotionHistory MotionHistory(HistorySamples);
+		for (const auto& Sample : Trace)
+		{
+			MotionHistory.Add(Sample.Position, Sample.LinearVelocity, Sample.AngularVelocity);
+		}
+
+		const FPawnMotionClassifierParams Params;
+
+		Test.TestEqual(FString::Printf(TEXT("%s: MotionMode"), *TraceName),
+			static_cast<int32>(MotionHistory.Classify(Params)), static_cast<int32>(Expected.MotionMode));
+		Test.TestEqual(FString::Printf(TEXT("%s: PerpetualMotion"), *TraceName),
+			MotionHistory.IsInPerpetualMotion(Params, PG::TestUtils::Defaults::PerpetualMotionMaxDisplacement), Expected.bPerpetualMotion);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPawnMotionHistoryAtRestTest, "PaperGolf.Pawn.MotionHistory.AtRest", PG::TestUtils::AutomationTestFlags)
+
+bool FPawnMotionHistoryAtRestTest::RunTest(const FString& Parameters)
+{
+	TestTrace(*this, TEXT("RestingJitter"), SyntheticTraces::RestingJitter(), { .MotionMode = EPawnMotionMode::Jitter, .bPerpetualMotion = true });
+	TestTrace(*this, TEXT("SlopeRocking"), SyntheticTraces::SlopeRocking(), { .MotionMode = EPawnMotionMode::Oscillating, .bPerpetualMotion = true });
+	TestTrace(*this, TEXT("FanWobble"), SyntheticTraces::FanWobble(), { .MotionMode = EPawnMotionMode::Oscillating, .bPerpetualMotion = true });
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPawnMotionHistoryInMotionTest, "PaperGolf.Pawn.MotionHistory.InMotion", PG::TestUtils::AutomationTestFlags)
+
+bool FPawnMotionHistoryInMotionTest::RunTest(const FString& Parameters)
+{
+	// The hop apex is in place and symmetric so only the speed over the full window tells it apart from rest
+	TestTrace(*this, TEXT("HopApex_Partial"), SyntheticTraces::HopApex(6), { .MotionMode = EPawnMotionMode::Moving, .bPerpetualMotion = false });
+	TestTrace(*this, TEXT("HopApex_Full"), SyntheticTraces::HopApex(HistorySamples / 2), { .MotionMode = EPawnMotionMode::Moving, .bPerpetualMotion = false });
+
+	TestTrace(*this, TEXT("LedgeTeeter_Partial"), SyntheticTraces::LedgeTeeter(13), { .MotionMode = EPawnMotionMode::Moving, .bPerpetualMotion = false });
+	TestTrace(*this, TEXT("LedgeTeeter_Full"), SyntheticTraces::LedgeTeeter(HistorySamples), { .MotionMode = EPawnMotionMode::Rolling, .bPerpetualMotion = false });
+
+	TestTrace(*this, TEXT("Rolling"), SyntheticTraces::Rolling(), { .MotionMode = EPawnMotionMode::Rolling, .bPerpetualMotion = false });
+
+	return true;
+}
+
+#endif
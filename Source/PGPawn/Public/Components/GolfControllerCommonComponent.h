@@ -11,6 +11,10 @@
 
 class APaperGolfPawn;
 class IGolfController;
+class UGolfFocusVisibilityField;
+struct FGolfFocusVisibilityHole;
+struct FGolfFocusTraceParams;
+struct FCollisionQueryParams;
 
 USTRUCT(BlueprintType)
 struct PGPAWN_API FShotHistory
@@ -46,6 +50,8 @@ public:
 
 	EShotType DetermineShotType(EShotFocusType FocusType = EShotFocusType::Hole);
 
+	EShotType GetShotTypeForDistance(float ShotDistance) const;
+
 	void AddToShotHistory(APaperGolfPawn* PaperGolfPawn);
 
 	// PositionOverride used by clients to avoid replication delay issues
@@ -85,6 +91,21 @@ public:
 
 	void SyncHoleChanged(const FSimpleDelegate& InHoleSyncedDelegate);
 
+	FGolfFocusTraceParams GetFocusTraceParams() const;
+
+	/*
+	* Baked line of sight between two focus actors of the current hole. Unset if there is no baked data for either of them.
+	*/
+	TOptional<bool> GetBakedLOSBetweenFocusActors(const AActor* FromFocusActor, const AActor* ToFocusActor) const;
+
+	/*
+	* Tries a direct trace to the focus actor and then one offset above both ends. Shared with UGolfFocusVisibilityFieldCommandlet so the bake matches focus selection.
+	* 
+	* @param FocusEndOffset The focus actor's IFocusableActor::GetFocusTraceEndOffset.
+	*/
+	static bool TestLOSToFocus(const UWorld& World, const FVector& Position, const FVector& FocusActorLocation, float FocusEndOffset,
+		const FGolfFocusTraceParams& TraceParams, const FCollisionQueryParams& QueryParams);
+
 protected:
 	virtual void BeginPlay() override;
 
@@ -92,15 +113,22 @@ private:
 
 	AActor* GetShotFocusActor(EShotFocusType ShotFocusType) const;
 
-	void RegisterShotFinishedTimer();
-	void UnregisterShotFinishedTimer();
+	void RegisterShotFinishedListener();
+	void UnregisterShotFinishedListener();
+
+	void OnPawnFlicked();
 
+	// Invoked by the rest detection subsystem once the flicked pawn has come to rest
 	void CheckForNextShot();
 
 	void InitFocusableActors();
 
 	bool HasLOSToFocus(const FVector& Position, const AActor* FocusActor) const;
 
+	void LoadFocusVisibilityField();
+	void InitFocusVisibility(int32 HoleNumber);
+	TOptional<bool> GetBakedLOSToFocus(const FVector& Position, const AActor* FocusActor) const;
+
 	void OnHoleChanged(int32 HoleNumber);
 
 private:
@@ -115,9 +143,9 @@ private:
 	UPROPERTY(Transient)
 	TScriptInterface<IGolfController> GolfController{};
 
-	UPROPERTY(EditDefaultsOnly, Category = "Timer")
-	float RestCheckTickRate{ 0.5f };
-
+	/*
+	* How long the pawn must stay under the rest velocity thresholds before the shot is finished.
+	*/
 	UPROPERTY(EditDefaultsOnly, Category = "Timer")
 	float RestCheckTriggerDelay{ 0.2f };
 
@@ -155,13 +183,34 @@ private:
 	UPROPERTY(EditDefaultsOnly, Category = "Shot | Focus", meta=(ClampMin="1.0"))
 	float FocusMisalignmentPenaltyScoreFactor{ 10.0f };
 
+	/*
+	* Baked line of sight to the focus actors for each course map. See UGolfFocusVisibilityFieldCommandlet.
+	* Without a field for the map, outside the baked cells, and for focus actors that moved since the bake, line of sight is traced live.
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = "Shot | Focus | Performance")
+	TMap<TSoftObjectPtr<UWorld>, TSoftObjectPtr<UGolfFocusVisibilityField>> FocusVisibilityFields{};
+
+	/*
+	* The baked value of the nearest cell is only used if the pawn was baked within this height of the current position.
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = "Shot | Focus | Performance", meta = (ClampMin = "0.0"))
+	float FocusVisibilityMaxHeightDifference{ 50.0f };
+
+	UPROPERTY(Transient)
+	TObjectPtr<UGolfFocusVisibilityField> FocusVisibilityField{};
+
+	// Hole of FocusVisibilityField for the current hole number
+	const FGolfFocusVisibilityHole* FocusVisibilityHole{};
+
+	// Bit index in FocusVisibilityHole of each focus actor of the current hole that matches the bake
+	TMap<TObjectKey<AActor>, int32> FocusVisibilityIndices{};
+
 	int32 LastHoleNumber{};
 	float LastFlickTime{};
-	float FirstRestCheckPassTime{ -1.0f };
 	bool bOnHoleChangedTriggered{};
+	bool bShotFinishedListenerRegistered{};
 
 	TWeakObjectPtr<APaperGolfPawn> WeakPaperGolfPawn{};
-	FTimerHandle NextShotTimerHandle{};
 	FDelegateHandle OnFlickHandle{};
 
 	FSimpleDelegate OnControllerShotFinished{};
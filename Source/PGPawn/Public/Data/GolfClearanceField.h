@@ -0,0 +1,115 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+
+#include "GolfClearanceField.generated.h"
+
+struct FGolfClearanceFieldSample
+{
+	// Distance to the nearest static obstacle in the clearance band above the ground. Negative inside an obstacle
+	float ObstacleDistance{};
+
+	// Direction of increasing obstacle distance, i.e. away from the nearest obstacle. Zero if flat
+	FVector2D ObstacleGradient{ EForceInit::ForceInitToZero };
+
+	// Distance to the nearest hazard at ground level. Negative inside a hazard
+	float HazardDistance{};
+
+	// Ground height at the nearest cell if there was ground there
+	TOptional<float> GroundZ{};
+};
+
+/*
+* 2.5D signed distance grid for a single hole. Each cell stores its ground height and the 2D distances to static obstacles and hazards at that height.
+* Values are quantized to whole centimeters to keep the cooked asset small.
+*/
+USTRUCT()
+struct PGPAWN_API FGolfClearanceFieldHole
+{
+	GENERATED_BODY()
+
+	static constexpr int16 NoGround = MIN_int16;
+
+	UPROPERTY(VisibleAnywhere)
+	int32 HoleNumber{};
+
+	// World XY of the center of cell (0, 0)
+	UPROPERTY(VisibleAnywhere)
+	FVector2D Origin{ EForceInit::ForceInitToZero };
+
+	UPROPERTY(VisibleAnywhere)
+	float CellSize{};
+
+	UPROPERTY(VisibleAnywhere)
+	FIntPoint Size{ EForceInit::ForceInitToZero };
+
+	// Ground heights are relative to this
+	UPROPERTY(VisibleAnywhere)
+	float BaseZ{};
+
+	UPROPERTY()
+	TArray<int16> ObstacleDistances{};
+
+	UPROPERTY()
+	TArray<int16> HazardDistances{};
+
+	// NoGround where the ground trace missed
+	UPROPERTY()
+	TArray<int16> GroundHeights{};
+
+	bool Contains(const FVector& Location) const;
+
+	/*
+	* Bilinearly interpolates the distances at Location. Location must be contained in the field.
+	*/
+	FGolfClearanceFieldSample Sample(const FVector& Location) const;
+
+	int32 GetNumCells() const { return Size.X * Size.Y; }
+	int32 GetCellIndex(int32 X, int32 Y) const { return Y * Size.X + X; }
+	FVector2D GetCellCenter(int32 X, int32 Y) const { return Origin + FVector2D{ X * CellSize, Y * CellSize }; }
+
+	bool IsValid() const;
+};
+
+/*
+* Baked offline for each hole of a course by UGolfClearanceFieldCommandlet so that UGolfShotClearanceComponent can check
+* for nearby static obstacles and hazards without running physics queries. Only static geometry is baked.
+*/
+UCLASS()
+class PGPAWN_API UGolfClearanceField : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	virtual void PostLoad() override;
+
+	/*
+	* Finds the hole field that contains the location. Holes should not overlap but if they do the first containing hole is returned.
+	*/
+	const FGolfClearanceFieldHole* FindHole(const FVector& Location) const;
+
+	void SetHole(FGolfClearanceFieldHole&& Hole);
+
+	int32 GetNumCells() const;
+
+	float GetProbeHalfHeight() const { return ProbeHalfHeight; }
+	void SetProbeHalfHeight(float InProbeHalfHeight) { ProbeHalfHeight = InProbeHalfHeight; }
+
+	float GetMaxDistance() const { return MaxDistance; }
+	void SetMaxDistance(float InMaxDistance) { MaxDistance = InMaxDistance; }
+
+private:
+	UPROPERTY(VisibleAnywhere)
+	TArray<FGolfClearanceFieldHole> Holes{};
+
+	// Half height of the obstacle band the field was baked with. Must match the clearance component for the field to be used
+	UPROPERTY(VisibleAnywhere)
+	float ProbeHalfHeight{};
+
+	// Distances are clamped to this
+	UPROPERTY(VisibleAnywhere)
+	float MaxDistance{};
+};
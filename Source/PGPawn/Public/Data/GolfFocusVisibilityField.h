@@ -0,0 +1,142 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+
+#include "GolfFocusVisibilityField.generated.h"
+
+/*
+* Offsets of the line of sight traces from a pawn position to a focus actor. See UGolfControllerCommonComponent::HasLOSToFocus.
+*/
+USTRUCT()
+struct PGPAWN_API FGolfFocusTraceParams
+{
+	GENERATED_BODY()
+
+	// Height above the pawn position that the offset trace starts at
+	UPROPERTY(VisibleAnywhere)
+	float StartOffset{};
+
+	// Minimum height above the focus actor that the offset trace ends at unless the focus actor overrides it
+	UPROPERTY(VisibleAnywhere)
+	float EndOffset{};
+
+	UPROPERTY(VisibleAnywhere)
+	float MaxEndOffset{};
+
+	/*
+	* End offset of the offset trace. It is raised by how far the pawn is above the focus actor but kept under MaxEndOffset to avoid tracing into ceilings.
+	*
+	* @param ElevationDiff Pawn height above the focus actor.
+	* @param FocusEndOffset The focus actor's own end offset. Used instead of EndOffset when at least 1.
+	*/
+	float GetSelectedEndOffset(float ElevationDiff, float FocusEndOffset) const;
+
+	bool Equals(const FGolfFocusTraceParams& Other, float Tolerance = UE_KINDA_SMALL_NUMBER) const;
+};
+
+/*
+* Line of sight from a grid of pawn positions to the focus actors of a single hole along with the line of sight between the focus actors themselves.
+* Each focus actor is a bit in the visibility masks so a hole can have at most MaxFocusActors including the golf hole.
+*/
+USTRUCT()
+struct PGPAWN_API FGolfFocusVisibilityHole
+{
+	GENERATED_BODY()
+
+	static constexpr int32 MaxFocusActors = 64;
+	static constexpr int16 NoGround = MIN_int16;
+
+	UPROPERTY(VisibleAnywhere)
+	int32 HoleNumber{};
+
+	// World XY of the center of cell (0, 0)
+	UPROPERTY(VisibleAnywhere)
+	FVector2D Origin{ EForceInit::ForceInitToZero };
+
+	UPROPERTY(VisibleAnywhere)
+	float CellSize{};
+
+	UPROPERTY(VisibleAnywhere)
+	FIntPoint Size{ EForceInit::ForceInitToZero };
+
+	// Pawn heights are relative to this
+	UPROPERTY(VisibleAnywhere)
+	float BaseZ{};
+
+	// Bit index of each focus actor in the visibility masks
+	UPROPERTY(VisibleAnywhere)
+	TArray<FName> FocusActorNames{};
+
+	// Focus actors that have moved since the bake are traced live
+	UPROPERTY()
+	TArray<FVector> FocusActorLocations{};
+
+	// For each focus actor, the focus actors that are in view when the pawn is at it
+	UPROPERTY()
+	TArray<uint64> FocusVisibility{};
+
+	// Snapped pawn height at each cell or NoGround where the pawn cannot rest
+	UPROPERTY()
+	TArray<int16> PawnHeights{};
+
+	UPROPERTY()
+	TArray<uint64> CellVisibility{};
+
+	// Focus actors whose traces from the cell passed close to movable geometry so the baked value can't be trusted
+	UPROPERTY()
+	TArray<uint64> CellDynamic{};
+
+	int32 FindFocusIndex(FName FocusActorName, const FVector& FocusActorLocation, float MaxMoveDistance) const;
+
+	/*
+	* Nearest cell to Location or INDEX_NONE if outside the field or if the pawn was baked more than MaxHeightDifference above or below it.
+	*/
+	int32 FindCellIndex(const FVector& Location, float MaxHeightDifference) const;
+
+	/*
+	* Baked line of sight from the cell to the focus actor. Unset if it must be checked live.
+	*/
+	TOptional<bool> HasLOSToFocus(int32 CellIndex, int32 FocusIndex) const;
+
+	bool HasLOSBetweenFocusActors(int32 FromFocusIndex, int32 ToFocusIndex) const;
+
+	int32 GetNumFocusActors() const { return FocusActorNames.Num(); }
+	int32 GetNumCells() const { return Size.X * Size.Y; }
+	int32 GetCellIndex(int32 X, int32 Y) const { return Y * Size.X + X; }
+	FVector2D GetCellCenter(int32 X, int32 Y) const { return Origin + FVector2D{ X * CellSize, Y * CellSize }; }
+
+	bool IsValid() const;
+};
+
+/*
+* Baked offline for each hole of a course by UGolfFocusVisibilityFieldCommandlet so that focus selection in UGolfControllerCommonComponent
+* can look up line of sight instead of tracing to every focus candidate. Only static geometry is baked.
+*/
+UCLASS()
+class PGPAWN_API UGolfFocusVisibilityField : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	virtual void PostLoad() override;
+
+	const FGolfFocusVisibilityHole* FindHole(int32 HoleNumber) const;
+
+	void SetHole(FGolfFocusVisibilityHole&& Hole);
+
+	int32 GetNumCells() const;
+
+	const FGolfFocusTraceParams& GetTraceParams() const { return TraceParams; }
+	void SetTraceParams(const FGolfFocusTraceParams& InTraceParams) { TraceParams = InTraceParams; }
+
+private:
+	UPROPERTY(VisibleAnywhere)
+	TArray<FGolfFocusVisibilityHole> Holes{};
+
+	// Must match the controller for the field to be used
+	UPROPERTY(VisibleAnywhere)
+	FGolfFocusTraceParams TraceParams{};
+};
@@ -0,0 +1,74 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Library/PaperGolfTrajectorySolver.h"
+
+class UWorld;
+class FPaperGolfSurfaceMaterialCache;
+
+namespace PG::Trajectory
+{
+	// Upper bound on bounces so that the contacts fit in the result's inline storage
+	inline constexpr int32 MaxBounces = 8;
+}
+
+struct PGPAWN_API FPaperGolfBounceParams
+{
+	int32 MaxBounces{ 4 };
+
+	// Once the rebound speed off a surface drops below this the pawn slides to a stop instead of bouncing again
+	float RestSpeed{ 100.0f };
+
+	// Used when the surface has no physical material
+	float DefaultRestitution{ 0.25f };
+	float DefaultFriction{ 0.7f };
+
+	// Resolves the surface materials without a scene query when the hits do not have a physical material. Optional
+	FPaperGolfSurfaceMaterialCache* SurfaceMaterialCache{};
+
+	// Simulation time limit for each bounce arc
+	float MaxBounceSimTime{ 3.0f };
+
+	// Caps the final slide for near frictionless surfaces
+	float MaxSlideDistance{ 1000.0f };
+};
+
+struct PGPAWN_API FPaperGolfBounceContact
+{
+	FVector Location{ EForceInit::ForceInitToZero };
+	FVector ImpactNormal{ EForceInit::ForceInitToZero };
+
+	// Incoming velocity at the contact
+	FVector Velocity{ EForceInit::ForceInitToZero };
+};
+
+struct PGPAWN_API FPaperGolfBounceResult
+{
+	// The initial landing followed by each bounce
+	TArray<FPaperGolfBounceContact, TInlineAllocator<PG::Trajectory::MaxBounces + 1>> Contacts{};
+
+	FVector RestLocation{ EForceInit::ForceInitToZero };
+
+	int32 NumBounces{};
+
+	// False if the bounce limit was reached or a bounce did not come down again within the simulation time
+	bool bAtRest{};
+
+	FString ToString() const;
+};
+
+/*
+* Rolls out the bounces that follow the landing of a trajectory from FPaperGolfTrajectorySolver.
+* Each contact reflects the velocity using the restitution and friction of the surface's physical material and the following arc is integrated with the same
+* solver without recording a path. Once the rebound is too slow to bounce again the remaining tangential speed is slid off against surface friction.
+* Surface properties come from the hit's physical material when the trajectory params have bReturnPhysicalMaterial set and otherwise from the surface material cache.
+*/
+class PGPAWN_API FPaperGolfBounceSolver
+{
+public:
+	static bool Solve(const UWorld& World, const FPaperGolfTrajectoryParams& Params, const FPaperGolfTrajectoryResult& Landing, const FPaperGolfBounceParams& BounceParams,
+		FPaperGolfBounceResult& OutResult);
+};
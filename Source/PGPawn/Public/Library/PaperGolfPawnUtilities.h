@@ -40,9 +40,20 @@ public:
 	static bool TraceShotAngle(const UObject* WorldContextObject, const APaperGolfPawn* PlayerPawn,
 		const FVector& TraceStart, const FVector& FlickDirection, float FlickSpeed, float FlickAngleDegrees, float MinTraceDistance = 1000.0f);
 
+	/*
+	* Calculates the end point of the trace used by TraceShotAngle without performing the trace so that callers can batch the scene queries.
+	*/
+	static FVector GetShotAngleTraceEnd(const UObject* WorldContextObject, const APaperGolfPawn& PlayerPawn,
+		const FVector& TraceStart, const FVector& FlickDirection, float FlickSpeed, float FlickAngleDegrees, float MinTraceDistance = 1000.0f);
+
+	/*
+	* Traces a straight line from the flick location along the flick direction pitched up by FlickAngleDegrees and returns true if it is clear.
+	* If bSimulateTrajectory is true the rising arc of the flick is simulated with the pawn's trajectory solver up to MinTraceDistance horizontally
+	* instead. Landing on a walkable surface along the way then counts as clear. Flat shots always use the straight trace.
+	*/
 	UFUNCTION(BlueprintCallable, Category = "Math")
 	static bool TraceCurrentShotWithParameters(const UObject* WorldContextObject, const APaperGolfPawn* PlayerPawn,
-		const FFlickParams& FlickParams, float FlickAngleDegrees, float MinTraceDistance = 1000.0f);
+		const FFlickParams& FlickParams, float FlickAngleDegrees, float MinTraceDistance = 1000.0f, bool bSimulateTrajectory = false);
 
 	/*
 	* Determines if the shot will reach the destination based on the input parameters. An optional focus actor can be provided to override the default focus.
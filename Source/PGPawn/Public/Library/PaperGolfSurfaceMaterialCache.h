@@ -0,0 +1,44 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "UObject/ObjectKey.h"
+
+class UPrimitiveComponent;
+struct FHitResult;
+
+struct PGPAWN_API FPaperGolfSurfaceResponse
+{
+	float Restitution{};
+	float Friction{};
+};
+
+/*
+* Restitution and friction of the surfaces hit by predicted trajectories keyed by component and collision face.
+* Misses are resolved from the component's physical materials directly so no scene query is needed to find the material of a hit.
+* Not thread safe and should be reset whenever the level geometry may have changed, such as when starting a new hole.
+*/
+class PGPAWN_API FPaperGolfSurfaceMaterialCache
+{
+public:
+	/*
+	* Surface response of the hit. Uses the hit's physical material when the query returned one and Default if no material could be found.
+	*/
+	FPaperGolfSurfaceResponse Get(const FHitResult& HitResult, const FPaperGolfSurfaceResponse& Default);
+
+	void Reset();
+
+	int32 Num() const { return Entries.Num(); }
+	int32 GetNumHits() const { return NumHits; }
+	int32 GetNumMisses() const { return NumMisses; }
+
+private:
+	using FKey = TPair<TObjectKey<UPrimitiveComponent>, int32>;
+
+	TMap<FKey, FPaperGolfSurfaceResponse> Entries{};
+
+	int32 NumHits{};
+	int32 NumMisses{};
+};
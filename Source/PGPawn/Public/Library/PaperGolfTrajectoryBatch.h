@@ -0,0 +1,72 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Engine/EngineTypes.h"
+
+class UWorld;
+
+struct PGPAWN_API FPaperGolfTrajectoryLane
+{
+	FVector StartLocation{ EForceInit::ForceInitToZero };
+	FVector LaunchVelocity{ EForceInit::ForceInitToZero };
+};
+
+struct PGPAWN_API FPaperGolfTrajectoryLaneResult
+{
+	// Hit or landing location, or where the lane was when the simulation stopped
+	FVector Location{ EForceInit::ForceInitToZero };
+	FVector Velocity{ EForceInit::ForceInitToZero };
+	FVector ImpactNormal{ EForceInit::ForceInitToZero };
+
+	float SimTime{};
+
+	int32 NumSceneQueries{};
+
+	// Blocking hit from a scene query
+	bool bHit{};
+
+	// Descended through LandingZ without hitting anything
+	bool bLanded{};
+};
+
+/*
+* Shared inputs for all lanes of FPaperGolfTrajectoryBatchSolver.
+*/
+struct PGPAWN_API FPaperGolfTrajectoryBatchParams
+{
+	// Lanes only run scene queries for steps that overlap these bounds. If invalid every step is queried
+	FBox BroadPhaseBounds{ EForceInit::ForceInit };
+
+	const AActor* IgnoreActor{};
+
+	float GravityZ{ -980.0f };
+	float LinearDamping{};
+
+	float CollisionRadius{ 3.0f };
+	float MaxSimTime{ 30.0f };
+	float SimFrequency{ 30.0f };
+
+	// Lanes stop once they are descending below this height
+	float LandingZ{ TNumericLimits<float>::Lowest() };
+
+	ECollisionChannel TraceChannel{ ECollisionChannel::ECC_WorldDynamic };
+
+	bool bTraceWithCollision{ true };
+};
+
+/*
+* Advances many ballistic trajectories in lockstep using a structure of arrays layout and vector registers, LaneWidth lanes at a time.
+* Each step does a broad-phase box test per lane and only sweeps the lanes that might hit something, so the parts of the arcs above the
+* static geometry are never queried. Spin is not modeled. FPaperGolfTrajectorySolver remains the reference for a single trajectory.
+*/
+class PGPAWN_API FPaperGolfTrajectoryBatchSolver
+{
+public:
+	static constexpr int32 LaneWidth = 4;
+
+	static void Solve(const UWorld& World, const FPaperGolfTrajectoryBatchParams& Params,
+		TConstArrayView<FPaperGolfTrajectoryLane> Lanes, TArrayView<FPaperGolfTrajectoryLaneResult> OutResults);
+};
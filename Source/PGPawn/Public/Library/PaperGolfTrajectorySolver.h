@@ -0,0 +1,153 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Engine/EngineTypes.h"
+#include "Engine/HitResult.h"
+#include "CollisionQueryParams.h"
+#include "Kismet/GameplayStaticsTypes.h"
+
+class UWorld;
+class UPrimitiveComponent;
+
+namespace PG::Trajectory
+{
+	// Approximately the default walkable floor angle
+	inline constexpr float LandingMinNormalZ = 0.7f;
+
+	/*
+	* Coming down on to a walkable surface is the shot landing rather than an obstacle in the way.
+	*/
+	bool IsLandingHit(const FVector& Velocity, const FVector& ImpactNormal);
+}
+
+/*
+* Inputs for FPaperGolfTrajectorySolver. All values are in world space.
+*/
+struct PGPAWN_API FPaperGolfTrajectoryParams
+{
+	FVector StartLocation{ EForceInit::ForceInitToZero };
+	FVector LaunchVelocity{ EForceInit::ForceInitToZero };
+
+	// Angular velocity in rad/s imparted by an off-center flick
+	FVector AngularVelocity{ EForceInit::ForceInitToZero };
+
+	const AActor* IgnoreActor{};
+
+	// Passed through by the trace, e.g. moving obstacles that are swept separately at the time the trajectory reaches them. Must outlive the solve
+	TConstArrayView<const UPrimitiveComponent*> IgnoreComponents{};
+
+	float GravityZ{ -980.0f };
+
+	// Same per-second damping values as the body instance so velocity decays like it does in the physics simulation
+	float LinearDamping{};
+	float AngularDamping{};
+
+	// Acceleration applied along AngularVelocity x Velocity. Chaos does not apply any lift so this is zero unless configured on the pawn
+	float SpinLiftCoefficient{};
+
+	float CollisionRadius{ 3.0f };
+	float MaxSimTime{ 30.0f };
+	float SimFrequency{ 30.0f };
+
+	// Stop integrating once the horizontal distance from the start location reaches this value. Not used if <= 0
+	float MaxHorizontalDistance{};
+
+	// Stop integrating once below this height
+	float KillZ{ TNumericLimits<float>::Lowest() };
+
+	ECollisionChannel TraceChannel{ ECollisionChannel::ECC_WorldDynamic };
+
+	bool bTraceWithCollision{ true };
+
+	// Needed to resolve the surface restitution and friction of the hit
+	bool bReturnPhysicalMaterial{};
+
+	int32 GetMaxNumPoints() const;
+};
+
+struct PGPAWN_API FPaperGolfTrajectoryResult
+{
+	FHitResult HitResult{};
+
+	// State at the hit point or when the simulation stopped
+	FVector LastLocation{ EForceInit::ForceInitToZero };
+	FVector LastVelocity{ EForceInit::ForceInitToZero };
+	FVector LastAngularVelocity{ EForceInit::ForceInitToZero };
+
+	float SimTime{};
+
+	// Number of points written to the caller supplied path buffer
+	int32 NumPoints{};
+	int32 NumSteps{};
+
+	bool bHit{};
+
+	FString ToString() const;
+};
+
+/*
+* Caller owned state for making many predictions without allocating. The query params ignore list uses an inline allocator and the path buffer
+* only grows until it fits the longest prediction so nothing is allocated per prediction once warmed up.
+*/
+struct PGPAWN_API FPaperGolfTrajectoryScratch
+{
+	FPaperGolfTrajectoryScratch();
+
+	FCollisionQueryParams QueryParams;
+
+	TArray<FPredictProjectilePathPointData> Path{};
+
+	// Only the landing is needed when false
+	bool bRecordPath{ true };
+
+	/*
+	* Points the query params at the trajectory and sizes the path buffer without shrinking. Returns the buffer the solver should write the path to.
+	*/
+	TArrayView<FPredictProjectilePathPointData> Prepare(const FPaperGolfTrajectoryParams& Params);
+
+	/*
+	* Points written by the last prediction.
+	*/
+	TConstArrayView<FPredictProjectilePathPointData> GetPath(const FPaperGolfTrajectoryResult& Result) const;
+};
+
+/*
+* Allocation free replacement for UGameplayStatics::PredictProjectilePath. Integrates gravity and the body's linear and angular damping the same way
+* Chaos does, sweeping the collision sphere each step and stopping at the first blocking hit.
+* Path points are written to a caller supplied buffer so there are no allocations. If the buffer fills up the remaining steps are still simulated
+* and the final slot is replaced with the end point so the path always ends at the landing location.
+*/
+class PGPAWN_API FPaperGolfTrajectorySolver
+{
+public:
+	static bool Solve(const UWorld& World, const FPaperGolfTrajectoryParams& Params, TArrayView<FPredictProjectilePathPointData> OutPath, FPaperGolfTrajectoryResult& OutResult);
+
+	/*
+	* Uses the caller's query params, which must ignore Params.IgnoreActor and Params.IgnoreComponents, instead of building them for each solve.
+	*/
+	static bool Solve(const UWorld& World, const FPaperGolfTrajectoryParams& Params, const FCollisionQueryParams& QueryParams,
+		TArrayView<FPredictProjectilePathPointData> OutPath, FPaperGolfTrajectoryResult& OutResult);
+};
+
+#pragma region Inline Definitions
+
+FORCEINLINE bool PG::Trajectory::IsLandingHit(const FVector& Velocity, const FVector& ImpactNormal)
+{
+	return Velocity.Z < 0 && ImpactNormal.Z >= LandingMinNormalZ;
+}
+
+FORCEINLINE int32 FPaperGolfTrajectoryParams::GetMaxNumPoints() const
+{
+	// Includes the start point
+	return FMath::Max(1, FMath::CeilToInt32(MaxSimTime * SimFrequency) + 1);
+}
+
+FORCEINLINE TConstArrayView<FPredictProjectilePathPointData> FPaperGolfTrajectoryScratch::GetPath(const FPaperGolfTrajectoryResult& Result) const
+{
+	return MakeArrayView(Path.GetData(), FMath::Min(Result.NumPoints, Path.Num()));
+}
+
+#pragma endregion Inline Definitions
@@ -0,0 +1,123 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Library/PaperGolfTrajectorySolver.h"
+
+struct PGPAWN_API FFlickPredictionCacheStats
+{
+	int32 Hits{};
+	int32 Misses{};
+	int32 NumEntries{};
+
+	float GetHitRate() const;
+
+	FString ToString() const;
+};
+
+/*
+* Memoizes the flick trajectory predictions of a single pawn. The preview, AI and shot utilities all end up predicting the same flicks from the
+* same pawn transform so repeated predictions are served from here instead of sweeping the trajectory again.
+* Entries are keyed by the solver inputs with the vectors quantized so that the same flick reconstructed from the pawn transform still matches.
+* Everything is dropped when the pawn moves and entries expire after a short time so that moving obstacles are not missed for long.
+* Entries are pooled and keep their path buffers when evicted so the cache stops allocating once warmed up.
+* Not thread safe so only use from the game thread.
+*/
+class PGPAWN_API FFlickPredictionCache
+{
+public:
+	void Configure(int32 InMaxEntries, float InMaxEntryAge);
+
+	/*
+	* Clears the cache if the pawn is not at the transform of the cached entries. Returns true if the cache was cleared.
+	*/
+	bool ResetIfMoved(const FTransform& PawnTransform);
+
+	/*
+	* Copies a cached result for the params if there is one that is still fresh. If OutPath is not empty the entry must have been added
+	* with a path buffer of the same size.
+	*/
+	bool Find(const FPaperGolfTrajectoryParams& Params, double TimeSeconds, TArrayView<FPredictProjectilePathPointData> OutPath, FPaperGolfTrajectoryResult& OutResult);
+
+	void Add(const FPaperGolfTrajectoryParams& Params, double TimeSeconds, TConstArrayView<FPredictProjectilePathPointData> Path, const FPaperGolfTrajectoryResult& Result);
+
+	void Invalidate();
+
+	FFlickPredictionCacheStats GetStats() const;
+
+private:
+	struct FKey
+	{
+		FIntVector StartLocation{ EForceInit::ForceInitToZero };
+		FIntVector LaunchVelocity{ EForceInit::ForceInitToZero };
+		FIntVector AngularVelocity{ EForceInit::ForceInitToZero };
+
+		// Scalars come straight from config so are compared exactly
+		float GravityZ{};
+		float LinearDamping{};
+		float AngularDamping{};
+		float SpinLiftCoefficient{};
+		float CollisionRadius{};
+		float MaxSimTime{};
+		float SimFrequency{};
+		float MaxHorizontalDistance{};
+		float KillZ{};
+
+		// Only compared and never dereferenced
+		const void* IgnoreActor{};
+
+		ECollisionChannel TraceChannel{};
+		bool bTraceWithCollision{};
+		bool bReturnPhysicalMaterial{};
+
+		explicit FKey(const FPaperGolfTrajectoryParams& Params);
+
+		bool operator==(const FKey& Other) const = default;
+
+		uint32 GetHash() const;
+
+		friend uint32 GetTypeHash(const FKey& Key) { return Key.GetHash(); }
+	};
+
+	struct FEntry
+	{
+		FPaperGolfTrajectoryResult Result{};
+
+		// Only the points the solver wrote
+		TArray<FPredictProjectilePathPointData> Path{};
+
+		// Size of the path buffer the prediction was made with as the solver replaces the final slot when the buffer fills up
+		int32 PathCapacity{};
+
+		double TimeSeconds{};
+	};
+
+	int32 AllocateEntry();
+	void ReleaseEntry(const FKey& Key, int32 EntryIndex);
+	int32 EvictOldest();
+
+private:
+	TArray<FEntry> Entries{};
+	TArray<int32> FreeEntryIndices{};
+	TMap<FKey, int32> EntryIndices{};
+
+	TOptional<FTransform> PawnTransform{};
+
+	int32 MaxEntries{ 64 };
+	float MaxEntryAge{ 0.5f };
+
+	int32 Hits{};
+	int32 Misses{};
+};
+
+#pragma region Inline Definitions
+
+FORCEINLINE float FFlickPredictionCacheStats::GetHitRate() const
+{
+	const auto Total = Hits + Misses;
+	return Total > 0 ? static_cast<float>(Hits) / Total : 0.0f;
+}
+
+#pragma endregion Inline Definitions
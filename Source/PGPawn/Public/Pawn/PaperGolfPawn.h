@@ -8,9 +8,13 @@
 #include "PaperGolfTypes.h"
 
 #include "VisualLogger/VisualLoggerDebugSnapshotInterface.h"
+#include "Engine/NetSerialization.h"
 
 #include "Interfaces/PawnCameraLook.h"
 
+#include "Pawn/PawnMotionHistory.h"
+#include "Pawn/FlickPredictionCache.h"
+
 #include "PaperGolfPawn.generated.h"
 
 class USpringArmComponent;
@@ -19,8 +23,13 @@ class UPaperGolfPawnAudioComponent;
 class UPawnCameraLookComponent;
 class UCollisionDampeningComponent;
 class UGolfShotClearanceComponent;
+class UPredictedFlightComponent;
 
 struct FPredictProjectilePathResult;
+struct FPredictProjectilePathPointData;
+struct FPaperGolfTrajectoryParams;
+struct FPaperGolfTrajectoryResult;
+struct FBodyInstance;
 class UCurveFloat;
 
 
@@ -34,6 +43,45 @@ struct PGPAWN_API FNetworkFlickParams
 
 	UPROPERTY(Transient)
 	FRotator Rotation { EForceInit::ForceInitToZero };
+
+	/*
+	* Rounds to the precision that is sent over the network so that a flick simulated locally matches the one received by the server and other clients.
+	*/
+	void Quantize();
+
+	/*
+	* Power and accuracy are sent as 12 bit fractions, the z offset to 0.1mm in 16 bits and the rotation as 16 bits per axis.
+	*/
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FNetworkFlickParams> : public TStructOpsTypeTraitsBase2<FNetworkFlickParams>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
+/*
+* Launch state multicast with a flick so that clients can run the same flight simulation as the server.
+*/
+USTRUCT()
+struct PGPAWN_API FNetworkFlightLaunch
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Transient)
+	FVector_NetQuantize100 Location{};
+
+	// The simulation has no randomness so along with the flick params this identifies the flight that keyframes belong to
+	UPROPERTY(Transient)
+	uint8 FlightId{};
+
+	// Clients simulate the flight instead of waiting for replicated movement
+	UPROPERTY(Transient)
+	bool bPredicted{};
 };
 
 UCLASS(Abstract)
@@ -64,6 +112,8 @@ public:
 	UFUNCTION(BlueprintPure)
 	bool IsStuckInPerpetualMotion() const;
 
+	EPawnMotionMode GetMotionMode() const;
+
 	void SetFocusActor(AActor* Focus, const TOptional<FVector>& PositionOverride = {});
 
 	float GetRotationYawToFocusActor(AActor* InFocusActor, const TOptional<FVector>& LocationOverride = {}) const;
@@ -74,6 +124,11 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void ResetRotation();
 
+	/*
+	* Resets to the initial yaw with the pawn tilted to sit on the ground plane with the given normal.
+	*/
+	void ResetRotationToGround(const FVector& GroundNormal);
+
 	UFUNCTION(BlueprintCallable)
 	void SetActorHiddenInGameNoRep(bool bInHidden);
 
@@ -104,6 +159,14 @@ public:
 	UFUNCTION(BlueprintPure)
 	bool IsAtRest() const;
 
+	float GetRestLinearVelocitySquaredMax() const;
+	float GetRestAngularVelocityRadsSquaredMax() const;
+
+	/*
+	* Body of the simulated paper golf mesh or null if it has no physics state.
+	*/
+	FBodyInstance* GetPhysicsBodyInstance() const;
+
 	UFUNCTION(BlueprintCallable)
 	void SetUpForNextShot();
 
@@ -117,6 +180,13 @@ public:
 
 	void SetCollisionEnabled(bool bEnabled);
 
+	/*
+	* Parks a pawn that is waiting for its turn by removing its body from the physics scene and turning off its hit notifications.
+	* Only parks if the pawn is at rest. Enabling collision for the next shot unparks it. Server only.
+	*/
+	void SetParked(bool bInParked);
+	bool IsParked() const;
+
 	UFUNCTION(BlueprintCallable)
 	float ClampFlickZ(float OriginalZOffset, float DeltaZ) const;
 
@@ -132,6 +202,32 @@ public:
 
 	bool PredictFlick(const FFlickParams& FlickParams, const FFlickPredictParams& FlickPredictParams, FPredictProjectilePathResult& Result) const;
 
+	/*
+	* Allocation free version of PredictFlick that writes the path into a caller supplied buffer. OutPath may be empty if only the landing is needed.
+	*/
+	bool PredictFlick(const FFlickParams& FlickParams, const FFlickPredictParams& FlickPredictParams, TArrayView<FPredictProjectilePathPointData> OutPath, FPaperGolfTrajectoryResult& Result) const;
+
+	/*
+	* Trajectory solver inputs for the given flick including the drag adjusted launch velocity, spin from the flick offset and the body damping.
+	*/
+	FPaperGolfTrajectoryParams GetFlickTrajectoryParams(const FFlickParams& FlickParams, const FFlickPredictParams& FlickPredictParams) const;
+
+	/*
+	* Identical predictions from the same pawn transform are served from the flick prediction cache when called from the game thread.
+	*/
+	bool PredictFlick(const FPaperGolfTrajectoryParams& TrajectoryParams, TArrayView<FPredictProjectilePathPointData> OutPath, FPaperGolfTrajectoryResult& Result) const;
+
+	/*
+	* Predicts with caller owned scratch so that repeated predictions do not allocate. The path is left in the scratch.
+	*/
+	bool PredictFlick(const FFlickParams& FlickParams, const FFlickPredictParams& FlickPredictParams, FPaperGolfTrajectoryScratch& Scratch, FPaperGolfTrajectoryResult& Result) const;
+
+	bool PredictFlick(const FPaperGolfTrajectoryParams& TrajectoryParams, FPaperGolfTrajectoryScratch& Scratch, FPaperGolfTrajectoryResult& Result) const;
+
+	FFlickPredictionCacheStats GetFlickPredictionCacheStats() const;
+
+	void InvalidateFlickPredictionCache(const TCHAR* Reason) const;
+
 	UFUNCTION(BlueprintPure)
 	AActor* GetFocusActor() const;
 
@@ -198,15 +294,6 @@ private:
 
 	void PopulateGroundPositions(GroundPositionArray& Positions, bool bOnlyGroundTestFlickLocation) const;
 
-	struct FGroundTraceParams
-	{
-		FVector Location; 
-		FVector ActorUpVector;
-		FBox Bounds;
-	};
-
-	TOptional<FVector> GetGroundLocation(const FGroundTraceParams& Params) const;
-
 	bool ShouldReplicateComponent(const UActorComponent* ComponentToReplicate) const;
 
 	void InitDebugDraw();
@@ -219,11 +306,14 @@ private:
 
 	// Used to trigger SFX
 	UFUNCTION(NetMulticast, Reliable)
-	void MulticastFlick(const FNetworkFlickParams& Params);
+	void MulticastFlick(const FNetworkFlickParams& Params, const FNetworkFlightLaunch& Launch);
+
+	// Making a copy as need to clamp. Returns the launch state when flicking on the server
+	FNetworkFlightLaunch DoFlick(FFlickParams FlickParams);
 
-	// Making a copy as need to clamp
-	void DoFlick(FFlickParams FlickParams);
-	void DoNetworkFlick(const FNetworkFlickParams& Params);
+	bool DoPredictFlick(const FPaperGolfTrajectoryParams& TrajectoryParams, const FCollisionQueryParams* QueryParams,
+		TArrayView<FPredictProjectilePathPointData> OutPath, FPaperGolfTrajectoryResult& Result) const;
+	FNetworkFlightLaunch DoNetworkFlick(const FNetworkFlickParams& Params);
 
 #if ENABLE_VISUAL_LOG
 	void DrawPawn(const FColor& Color, FVisualLogEntry* Snapshot = nullptr) const;
@@ -234,6 +324,14 @@ private:
 
 	FNetworkFlickParams ToNetworkParams(const FFlickParams& Params) const;
 
+	void BeginFlightReplication();
+	void EndFlightReplication();
+	void UpdateFlightNetUpdateFrequency();
+
+	void OnRootTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
+
+	void SetResetRotation(const FRotator& Rotation);
+
 	void SampleState();
 
 	float CalculateMass() const;
@@ -249,21 +347,31 @@ private:
 
 	float CalculateWidth() const;
 
+	UFUNCTION()
+	void OnStartHole(int32 HoleNumber);
+
 private:
 
 #if ENABLE_VISUAL_LOG
 	FTimerHandle VisualLoggerTimer{};
 #endif
 
-	struct FState
-	{
-		FVector Position{ EForceInit::ForceInitToZero };
+	FPawnMotionHistory MotionHistory{};
 
-		FState(const APaperGolfPawn& Pawn);
-	};
+	// Caching is transparent to the callers of the const prediction functions
+	mutable FFlickPredictionCache FlickPredictionCache{};
+
+	UPROPERTY(EditDefaultsOnly, Category = "Shot | Prediction")
+	bool bEnableFlickPredictionCache{ true };
 
-	TArray<FState> States;
-	int32 StateIndex{};
+	UPROPERTY(EditDefaultsOnly, Category = "Shot | Prediction", meta = (ClampMin = "1"))
+	int32 FlickPredictionCacheMaxEntries{ 64 };
+
+	/*
+	* Cached predictions older than this are recalculated so that moving obstacles are accounted for.
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = "Shot | Prediction", meta = (ClampMin = "0.0"))
+	float FlickPredictionCacheMaxAge{ 0.5f };
 
 	/*
 	* Number of samples for checking if stuck in perpetual motion sampled at the tick rate.
@@ -274,6 +382,12 @@ private:
 	UPROPERTY(EditDefaultsOnly, Category = "Stuck")
 	float MinDistanceThreshold{ 10.0 };
 
+	/*
+	* Detects oscillation and jitter, e.g. rocking on a slope or wobbling in a fan, before the full sample history has elapsed.
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = "Stuck")
+	FPawnMotionClassifierParams MotionClassifierParams{};
+
 	UPROPERTY(EditDefaultsOnly, Category = "Shot | Force")
 	float FlickMaxForce { 330.f };
 
@@ -290,6 +404,12 @@ private:
 	UPROPERTY(EditDefaultsOnly, Category = "Shot")
 	float RestAngularVelocityRadsSquaredMax{ 0.001f };
 
+	/*
+	* Whether SnapToGround tilts the pawn onto the ground plane fitted under its contact points rather than keeping it upright.
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = "Shot")
+	bool bAlignToGroundNormal{};
+
 	UPROPERTY(Transient, ReplicatedUsing = OnRep_FocusActor)
 	TObjectPtr<AActor> FocusActor{};
 
@@ -299,9 +419,18 @@ private:
 	UPROPERTY(EditDefaultsOnly, Category = "Shot | Force")
 	float FlickMaxForceMediumShot{ 200.f };
 
+	/*
+	* Multiplier on the launch impulse when predicting the flick trajectory, keyed by the impulse magnitude. It is applied once at launch rather than integrated over the flight.
+	*/
 	UPROPERTY(EditDefaultsOnly, Category = "Shot | Force")
 	TObjectPtr<UCurveFloat> FlickDragForceCurve{};
 
+	/*
+	* Lift from spin used when predicting the flick trajectory. Physics does not apply any lift in flight so this should stay zero unless that changes.
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = "Shot | Force")
+	float FlickSpinLiftCoefficient{ 0.0f };
+
 	UPROPERTY(EditDefaultsOnly, Category = "Shot | Difficulty", meta = (ClampMin = "0.0"))
 	float PowerAccuracyDampenExp{ 0.25f };
 
@@ -317,6 +446,43 @@ private:
 	UPROPERTY(EditDefaultsOnly, Category = "Camera | Spectator", meta = (ClampMin = "0.0"))
 	float SpectatorCameraRotationLag{ 1.0f };
 
+	/*
+	* Net update frequency while in flight is scaled between these by the speed of the pawn so that it is only high while moving quickly.
+	* The actor's own net update frequency is restored when the flight ends or the next turn starts.
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = "Network", meta = (ClampMin = "1.0"))
+	float FlightMinNetUpdateFrequency{ 10.0f };
+
+	UPROPERTY(EditDefaultsOnly, Category = "Network", meta = (ClampMin = "1.0"))
+	float FlightMaxNetUpdateFrequency{ 60.0f };
+
+	/*
+	* Speed in cm/s at which the flight net update frequency reaches the max. Spin counts as the surface speed of the pawn.
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = "Network", meta = (ClampMin = "1.0"))
+	float FlightMaxNetUpdateSpeed{ 1500.0f };
+
+	UPROPERTY(EditDefaultsOnly, Category = "Network", meta = (ClampMin = "0.01"))
+	float FlightNetUpdateFrequencyInterval{ 0.1f };
+
+	/*
+	* Stops replicating once the shot is finished until the next turn starts. Moving the pawn or changing its focus while dormant flushes it
+	* so that the change still replicates.
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = "Network")
+	bool bDormantWhenAtRest{ true };
+
+	FTimerHandle FlightNetUpdateTimerHandle{};
+
+	// Net update frequency outside of flight
+	float DefaultNetUpdateFrequency{ 100.0f };
+
+	/*
+	* Park the pawn while other players take their turns. Turn off to keep the physics body of every pawn in the scene.
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = "Physics")
+	bool bParkWhenInactive{ true };
+
 	float OriginalCameraRotationLag{};
 
 	float Mass{};
@@ -328,6 +494,10 @@ private:
 	TOptional<FVector> FlickContactPoint{};
 
 	bool bReadyForShot{};
+	bool bParked{};
+
+	// Hit notification setting of the mesh to restore when unparking
+	bool bUnparkedNotifyRigidBodyCollision{};
 
 	/*
 	* 1 for right handed and -1 for left handed.  Will be set on the pawn by APaperGolfGameModeBase::SpawnDefaultPawnAtTransform_Implementation from player preferences
@@ -364,10 +534,18 @@ private:
 
 	UPROPERTY(VisibleDefaultsOnly, Category = "Components")
 	TObjectPtr<UGolfShotClearanceComponent> GolfShotClearanceComponent{};
+
+	UPROPERTY(VisibleDefaultsOnly, Category = "Components")
+	TObjectPtr<UPredictedFlightComponent> PredictedFlightComponent{};
 };
 
 #pragma region Inline Definitions
 
+FORCEINLINE bool APaperGolfPawn::IsParked() const
+{
+	return bParked;
+}
+
 FORCEINLINE FVector APaperGolfPawn::GetLinearVelocity() const
 {
 	check(_PaperGolfMesh);
@@ -382,6 +560,21 @@ FORCEINLINE FVector APaperGolfPawn::GetAngularVelocity() const
 	return _PaperGolfMesh->GetPhysicsAngularVelocityInRadians();
 }
 
+FORCEINLINE EPawnMotionMode APaperGolfPawn::GetMotionMode() const
+{
+	return MotionHistory.Classify(MotionClassifierParams);
+}
+
+FORCEINLINE float APaperGolfPawn::GetRestLinearVelocitySquaredMax() const
+{
+	return RestLinearVelocitySquaredMax;
+}
+
+FORCEINLINE float APaperGolfPawn::GetRestAngularVelocityRadsSquaredMax() const
+{
+	return RestAngularVelocityRadsSquaredMax;
+}
+
 FORCEINLINE float APaperGolfPawn::GetFlickOffsetZTraceSize() const
 {
 	return FlickOffsetZTraceSize;
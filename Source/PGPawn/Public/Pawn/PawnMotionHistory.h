@@ -0,0 +1,235 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Containers/TimedCircularBuffer.h"
+
+#include "PawnMotionHistory.generated.h"
+
+UENUM(BlueprintType)
+enum class EPawnMotionMode : uint8
+{
+	// Not enough samples to classify
+	Unknown,
+	Moving,
+	// Spinning while travelling consistently in one direction
+	Rolling,
+	// Rocking back and forth in place, e.g. on a slope or pushed by a fan
+	Oscillating,
+	// Solver noise around a fixed position
+	Jitter
+};
+
+USTRUCT()
+struct PGPAWN_API FPawnMotionClassifierParams
+{
+	GENERATED_BODY()
+
+	/*
+	* Samples required before classifying rolling and moving. Jitter and oscillation always need the full history
+	* as a pawn at the top of a hop or teetering on an edge looks the same over a shorter window.
+	*/
+	UPROPERTY(EditDefaultsOnly)
+	int32 MinSamples{ 12 };
+
+	UPROPERTY(EditDefaultsOnly)
+	float JitterMaxPositionStdDev{ 0.5f };
+
+	UPROPERTY(EditDefaultsOnly)
+	float JitterMaxMeanSpeed{ 5.0f };
+
+	UPROPERTY(EditDefaultsOnly)
+	float OscillationMaxPositionStdDev{ 5.0f };
+
+	UPROPERTY(EditDefaultsOnly)
+	float OscillationMaxDisplacement{ 5.0f };
+
+	/*
+	* Also caps the mean speed of a pawn that barely moved over the history for it to be considered stuck in perpetual motion.
+	*/
+	UPROPERTY(EditDefaultsOnly)
+	float OscillationMaxMeanSpeed{ 40.0f };
+
+	/*
+	* Path length travelled over the history relative to the net displacement. A pawn going back and forth travels much further than it moves.
+	*/
+	UPROPERTY(EditDefaultsOnly)
+	float OscillationMinPathRatio{ 3.0f };
+
+	UPROPERTY(EditDefaultsOnly)
+	float RollingMinAngularSpeed{ 1.0f };
+
+	/*
+	* Net displacement relative to path length for the motion to be considered travelling in one direction.
+	*/
+	UPROPERTY(EditDefaultsOnly)
+	float RollingMinStraightness{ 0.8f };
+};
+
+/*
+* Fixed size history of pawn position and velocities stored as a structure of arrays.
+* Running sums are updated as samples are added and evicted so the statistics are O(1) to query.
+* Positions are stored relative to the first sample after a clear to keep the sums of squares well conditioned.
+* The sums are never rebuilt as the drift at double precision is negligible over the length of a shot and the history is cleared between shots.
+*/
+class PGPAWN_API FPawnMotionHistory
+{
+public:
+	explicit FPawnMotionHistory(int32 NumSamples = 1);
+
+	void Add(const FVector& Position, const FVector& LinearVelocity, const FVector& AngularVelocity);
+	void Clear();
+	void ClearAndResize(int32 NewNumSamples);
+
+	int32 Num() const;
+	int32 Capacity() const;
+	bool IsEmpty() const;
+	bool IsFull() const;
+
+	/*
+	* Newest minus oldest position.
+	*/
+	FVector GetDisplacement() const;
+
+	/*
+	* Distance travelled between consecutive samples.
+	*/
+	double GetPathLength() const;
+
+	FVector GetMeanPosition() const;
+
+	/*
+	* Mean squared distance of the positions from the mean position.
+	*/
+	double GetPositionVariance() const;
+
+	double GetMeanSpeed() const;
+	double GetSpeedVariance() const;
+
+	double GetMeanAngularSpeed() const;
+	double GetAngularSpeedVariance() const;
+
+	EPawnMotionMode Classify(const FPawnMotionClassifierParams& Params) const;
+
+	/*
+	* True once the full history is slow and either oscillating, jittering or displaced less than MaxDisplacement, so the pawn can be treated as at rest.
+	*/
+	bool IsInPerpetualMotion(const FPawnMotionClassifierParams& Params, double MaxDisplacement) const;
+
+private:
+	struct FScalarStats
+	{
+		double Sum{};
+		double SumSquares{};
+
+		void Add(double Value);
+		void Remove(double Value);
+		double Mean(int32 N) const;
+		double Variance(int32 N) const;
+	};
+
+	struct FZeroVectorFunc
+	{
+		FVector operator()() const { return FVector::ZeroVector; }
+	};
+
+	struct FVectorSizeFunc
+	{
+		double operator()(const FVector& Value) const { return Value.Size(); }
+	};
+
+	using FVectorBuffer = PG::TTimedCircularBuffer<FVector, FZeroVectorFunc, FVectorSizeFunc>;
+
+private:
+	FVectorBuffer Positions;
+	FVectorBuffer LinearVelocities;
+	FVectorBuffer AngularVelocities;
+
+	// Distance from the previous sample, which may have since been evicted
+	PG::TTimedCircularBuffer<double> StepLengths;
+
+	FVector Origin{ EForceInit::ForceInitToZero };
+
+	FVector PositionSum{ EForceInit::ForceInitToZero };
+	double PositionSquaredSizeSum{};
+	double StepLengthSum{};
+
+	FScalarStats SpeedStats{};
+	FScalarStats AngularSpeedStats{};
+};
+
+#pragma region Inline Definitions
+
+FORCEINLINE int32 FPawnMotionHistory::Num() const
+{
+	return static_cast<int32>(Positions.Size());
+}
+
+FORCEINLINE int32 FPawnMotionHistory::Capacity() const
+{
+	return static_cast<int32>(Positions.Capacity());
+}
+
+FORCEINLINE bool FPawnMotionHistory::IsEmpty() const
+{
+	return Positions.IsEmpty();
+}
+
+FORCEINLINE bool FPawnMotionHistory::IsFull() const
+{
+	return Positions.IsFull();
+}
+
+FORCEINLINE double FPawnMotionHistory::GetMeanSpeed() const
+{
+	return SpeedStats.Mean(Num());
+}
+
+FORCEINLINE double FPawnMotionHistory::GetSpeedVariance() const
+{
+	return SpeedStats.Variance(Num());
+}
+
+FORCEINLINE double FPawnMotionHistory::GetMeanAngularSpeed() const
+{
+	return AngularSpeedStats.Mean(Num());
+}
+
+FORCEINLINE double FPawnMotionHistory::GetAngularSpeedVariance() const
+{
+	return AngularSpeedStats.Variance(Num());
+}
+
+FORCEINLINE void FPawnMotionHistory::FScalarStats::Add(double Value)
+{
+	Sum += Value;
+	SumSquares += Value * Value;
+}
+
+FORCEINLINE void FPawnMotionHistory::FScalarStats::Remove(double Value)
+{
+	Sum -= Value;
+	SumSquares -= Value * Value;
+}
+
+FORCEINLINE double FPawnMotionHistory::FScalarStats::Mean(int32 N) const
+{
+	return N > 0 ? Sum / N : 0.0;
+}
+
+FORCEINLINE double FPawnMotionHistory::FScalarStats::Variance(int32 N) const
+{
+	if (N <= 0)
+	{
+		return 0.0;
+	}
+
+	const auto MeanValue = Sum / N;
+
+	// Clamp as cancellation can make this slightly negative
+	return FMath::Max(0.0, SumSquares / N - MeanValue * MeanValue);
+}
+
+#pragma endregion Inline Definitions
@@ -0,0 +1,97 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineTypes.h"
+
+#include "FocusableActorRegistrySubsystem.generated.h"
+
+class ULevel;
+
+/*
+* IFocusableActor values captured at registration so that focus selection does not go through the Blueprint interface thunks.
+*/
+struct PGPAWN_API FFocusableActorEntry
+{
+	TWeakObjectPtr<AActor> Actor{};
+
+	FVector Location{ EForceInit::ForceInitToZero };
+	FVector ForwardVector{ EForceInit::ForceInitToZero };
+
+	float MinDistance2D{};
+	float MinCosAngle{};
+	float FocusTraceEndOffset{};
+
+	bool bHole{};
+	bool bPreferredFocus{};
+};
+
+/**
+ * Registry of the focusable actors of each hole so that controllers do not scan the world for them on every hole change.
+ * Golf holes register themselves on BeginPlay. Blueprint focusables are picked up once when the world begins play, when a level is streamed in
+ * and when they are spawned, and everything is unregistered on EndPlay.
+ * Focusables are bucketed by hole number with their focus values cached in a flat array.
+ */
+UCLASS()
+class PGPAWN_API UFocusableActorRegistrySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/*
+	* Registers an actor implementing IFocusableActor. Registering again refreshes the cached values.
+	*/
+	void RegisterFocusableActor(AActor& Actor);
+	void UnregisterFocusableActor(AActor& Actor);
+
+	/*
+	* The hole actor of the hole or null if none has registered.
+	*/
+	AActor* GetHole(int32 HoleNumber) const;
+
+	/*
+	* Focus candidates of the hole. This is the non-hole focusables plus the hole itself if it is not the preferred focus.
+	*/
+	TConstArrayView<AActor*> GetFocusableActors(int32 HoleNumber) const;
+
+	TConstArrayView<FFocusableActorEntry> GetEntries(int32 HoleNumber) const;
+
+	const FFocusableActorEntry* FindEntry(int32 HoleNumber, const AActor* Actor) const;
+
+	int32 GetNumFocusableActors() const;
+
+protected:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+private:
+	struct FHoleBucket
+	{
+		TArray<FFocusableActorEntry> Entries{};
+		TArray<AActor*> FocusableActors{};
+		int32 HoleEntryIndex{ INDEX_NONE };
+	};
+
+	void RegisterLevelActors(const ULevel& Level);
+
+	void OnLevelAdded(ULevel* Level, UWorld* InWorld);
+	void OnActorSpawned(AActor* Actor);
+
+	UFUNCTION()
+	void OnFocusableActorEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason);
+
+	void RemoveFromBucket(int32 HoleNumber, const AActor* Actor);
+	static void RebuildFocusableActors(FHoleBucket& Bucket);
+
+	static FFocusableActorEntry CaptureEntry(AActor& Actor);
+
+private:
+	TMap<int32, FHoleBucket> HoleBuckets{};
+	TMap<TObjectKey<AActor>, int32> HoleNumbersByActor{};
+
+	FDelegateHandle LevelAddedHandle{};
+	FDelegateHandle ActorSpawnedHandle{};
+};
@@ -0,0 +1,143 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Subsystems/GolfEvents.h"
+
+#include "HazardSpatialIndexSubsystem.generated.h"
+
+class USceneComponent;
+class UPrimitiveComponent;
+enum class EUpdateTransformFlags : int32;
+enum class ETeleportType : uint8;
+
+struct PGPAWN_API FHazardQueryResult
+{
+	// Identifies the hazard. Queries may run off the game thread so only dereference this on the game thread
+	const AActor* HazardActor{};
+
+	EHazardType HazardType{ EHazardType::OutOfBounds };
+	bool bPenaltyOnImpact{};
+
+	bool IsHit() const { return HazardActor != nullptr; }
+};
+
+/**
+ * Spatial index of the penalty hazard volumes so that hazard point and box queries do not need to go through the physics scene.
+ * Hazards register themselves and the geometry is captured from their hazard collision primitives into a 2D spatial hash on the XY plane.
+ * The index is rebuilt at the start of each hole and movable hazards are re-inserted individually whenever they move.
+ * Hazard geometry in the physics scene that was not registered is tracked by its bounds so callers know where they still need a physics query.
+ * Queries are safe to call from any thread.
+ */
+UCLASS()
+class PGPAWN_API UHazardSpatialIndexSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/*
+	* Adds the hazard to the index. If HazardComponents is empty the geometry is captured from the components with the hazard collision object type,
+	* otherwise from the given components regardless of their collision so that hazards can register where their collision is disabled.
+	*/
+	void RegisterHazard(AActor& HazardActor, EHazardType HazardType, bool bPenaltyOnImpact, TConstArrayView<UPrimitiveComponent*> HazardComponents = {});
+	void UnregisterHazard(AActor& HazardActor);
+
+	/*
+	* Re-captures the geometry of a single hazard after it has moved.
+	*/
+	void UpdateHazard(const AActor& HazardActor);
+
+	void Rebuild();
+
+	FHazardQueryResult QueryPoint(const FVector& Location) const;
+	FHazardQueryResult QueryBox(const FBox& Box) const;
+
+	void QueryPoints(TConstArrayView<FVector> Locations, TArrayView<FHazardQueryResult> OutResults) const;
+	void QueryBoxes(TConstArrayView<FBox> Boxes, TArrayView<FHazardQueryResult> OutResults) const;
+
+	/*
+	* True if hazard geometry that is not in the index may overlap the box, so the caller must also query the physics scene.
+	* Always true until the first rebuild has scanned the world.
+	*/
+	bool NeedsPhysicsQuery(const FBox& Box) const;
+
+	int32 GetNumHazards() const;
+	bool IsEmpty() const { return GetNumHazards() == 0; }
+
+protected:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+private:
+	struct FHazardShape
+	{
+		FBox Bounds{ EForceInit::ForceInit };
+		int32 FirstPlane{};
+		int32 NumPlanes{};
+	};
+
+	struct FHazardEntry
+	{
+		TWeakObjectPtr<AActor> Actor{};
+		const AActor* ActorKey{};
+
+		// Explicit hazard geometry. Empty to use the components with the hazard collision object type
+		TArray<TWeakObjectPtr<const UPrimitiveComponent>, TInlineAllocator<1>> Components{};
+
+		FBox Bounds{ EForceInit::ForceInit };
+
+		// Outward facing planes of each convex shape. Shapes without planes are tested by their bounds only
+		TArray<FHazardShape, TInlineAllocator<1>> Shapes{};
+		TArray<FPlane> Planes{};
+
+		// Inclusive range of hash cells the bounds were inserted into
+		FIntPoint MinCell{ EForceInit::ForceInitToZero };
+		FIntPoint MaxCell{ EForceInit::ForceInitToZero };
+
+		EHazardType HazardType{ EHazardType::OutOfBounds };
+		bool bPenaltyOnImpact{};
+		bool bInserted{};
+		bool bOversized{};
+	};
+
+	UFUNCTION()
+	void OnStartHole(int32 HoleNumber);
+
+	void OnHazardTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
+
+	static void CaptureGeometry(const AActor& HazardActor, FHazardEntry& Entry);
+	static void CapturePrimitiveGeometry(const UPrimitiveComponent& Primitive, FHazardEntry& Entry);
+
+	/*
+	* Finds hazard collision in the world that belongs to actors that did not register.
+	*/
+	TArray<FBox> ScanUnindexedHazards() const;
+
+	// Must be called with the write lock held
+	void InsertEntry(int32 EntryIndex);
+	void RemoveEntry(int32 EntryIndex);
+
+	// Must be called with the read lock held
+	FHazardQueryResult QueryBoxLocked(const FBox& Box) const;
+
+	static bool EntryOverlaps(const FHazardEntry& Entry, const FBox& Box);
+
+	static FIntPoint GetCellCoordinates(const FVector& Location);
+
+private:
+	TSparseArray<FHazardEntry> Entries{};
+	TMap<const AActor*, int32> EntryIndicesByActor{};
+
+	TMap<FIntPoint, TArray<int32, TInlineAllocator<4>>> Cells{};
+
+	// Hazards covering too many cells, like a course wide out of bounds volume, are always tested instead of being hashed
+	TArray<int32> OversizedEntries{};
+
+	// Bounds of hazard collision that is not in the index. Unbounded for movable geometry
+	TArray<FBox> UnindexedHazardBounds{};
+	bool bScannedForUnindexedHazards{};
+
+	mutable FRWLock IndexLock{};
+};
@@ -0,0 +1,97 @@
+// Copyright 2024 Game Salutes and HomeTeam GameDev contributors under GPL-3.0-only.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineTypes.h"
+
+#include "PawnRestDetectionSubsystem.generated.h"
+
+class APaperGolfPawn;
+class FPawnRestSimCallback;
+
+namespace Chaos
+{
+	class FSingleParticlePhysicsProxy;
+}
+
+struct PGPAWN_API FPawnRestTrackingParams
+{
+	// Rest is not reported until the pawn has been tracked this long so the flick impulse has time to be applied
+	float MinTrackingTime{ 1.0f };
+
+	// How long the pawn must stay under the rest velocity thresholds. A sleeping body is at rest immediately
+	float RestTime{ 0.2f };
+};
+
+/**
+ * Reports when flicked pawns come to rest without polling each pawn from the game thread.
+ * A physics thread callback watches the tracked bodies every step for Chaos sleep or velocities under the pawn's rest thresholds
+ * and marshals each body coming to rest, or moving again after it, back to the game thread, where the pawn's delegate is invoked.
+ * A single low frequency watchdog falls back to APaperGolfPawn::IsAtRest, which includes the perpetual motion check, for pawns that
+ * never settle or have no physics proxy, such as on clients. The pawn must be at rest for consecutive watchdog samples.
+ * Rest is latched and the watchdog invokes the delegate again until the pawn is untracked so that a consumer that is not ready
+ * when first notified still finishes the shot.
+ */
+UCLASS()
+class PGPAWN_API UPawnRestDetectionSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void TrackPawn(APaperGolfPawn& Pawn, const FPawnRestTrackingParams& Params, FSimpleDelegate&& OnCameToRest);
+	void UntrackPawn(const APaperGolfPawn& Pawn);
+
+	bool IsTracking(const APaperGolfPawn& Pawn) const;
+
+protected:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+private:
+	struct FTrackedPawn
+	{
+		TWeakObjectPtr<APaperGolfPawn> Pawn{};
+		FSimpleDelegate OnCameToRest{};
+
+		// Identifies the body in the physics thread outputs. Never dereferenced on the game thread
+		Chaos::FSingleParticlePhysicsProxy* Proxy{};
+
+		double TrackingStartTimeSeconds{};
+		float MinTrackingTime{};
+		float RestTime{};
+
+		// Start of the consecutive watchdog samples that found the pawn at rest
+		double WatchdogRestStartTimeSeconds{};
+		int32 NumWatchdogRestSamples{};
+
+		// Latched until the physics thread reports the body moving again
+		bool bPhysicsRest{};
+	};
+
+	bool EnsureSimCallback();
+	void UnregisterSimCallback();
+
+	void OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+	void OnWatchdog();
+
+	UFUNCTION()
+	void OnPawnEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason);
+
+	TObjectKey<APaperGolfPawn> FindPawnKey(const Chaos::FSingleParticlePhysicsProxy* Proxy) const;
+
+	bool SampleWatchdogRest(FTrackedPawn& Entry, double CurrentTimeSeconds) const;
+
+	void NotifyCameToRest(const TObjectKey<APaperGolfPawn>& PawnKey, const TCHAR* Source);
+
+	void UpdateWatchdog();
+
+private:
+	TMap<TObjectKey<APaperGolfPawn>, FTrackedPawn> TrackedPawns{};
+
+	FPawnRestSimCallback* SimCallback{};
+
+	FDelegateHandle PostActorTickHandle{};
+	FTimerHandle WatchdogTimerHandle{};
+};
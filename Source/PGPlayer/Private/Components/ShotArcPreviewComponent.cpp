@@ -9,6 +9,8 @@
 
 #include "Library/PaperGolfPawnUtilities.h"
 
+#include "Subsystems/MovingObstacleSubsystem.h"
+
 #include "PGPlayerLogging.h"
 #include "Logging/LoggingUtils.h"
 #include "VisualLogger/VisualLogger.h"
@@ -20,6 +22,7 @@
 #include "Kismet/GameplayStatics.h"
 
 #include "Components/TextRenderComponent.h"
+#include "Components/StaticMeshComponent.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(ShotArcPreviewComponent)
 
@@ -72,10 +75,34 @@ void UShotArcPreviewComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 
 bool UShotArcPreviewComponent::NeedsToRecalculateArc(const APaperGolfPawn& Pawn, const FFlickParams& FlickParams) const
 {
-	return ShotType != FlickParams.ShotType ||
-		   !FMath::IsNearlyEqual(LocalZOffset, FlickParams.LocalZOffset) ||
-		   !FMath::IsNearlyEqual(PowerFraction, FlickParams.PowerFraction) ||
-		   !Pawn.GetActorTransform().EqualsNoScale(LastCalculatedTransform);
+	if (ShotType != FlickParams.ShotType ||
+		!FMath::IsNearlyEqual(LocalZOffset, FlickParams.LocalZOffset) ||
+		!FMath::IsNearlyEqual(PowerFraction, FlickParams.PowerFraction) ||
+		!Pawn.GetActorTransform().EqualsNoScale(LastCalculatedTransform))
+	{
+		return true;
+	}
+
+	// The obstacles keep moving while the shot is lined up
+	const auto MovingObstacleSubsystem = GetMovingObstacleSubsystem();
+	return MovingObstacleSubsystem && MovingObstacleSubsystem->GetObstacleTime() - LastCalculatedTime >= ObstaclePreviewRefreshInterval;
+}
+
+const UMovingObstacleSubsystem* UShotArcPreviewComponent::GetMovingObstacleSubsystem() const
+{
+	auto World = GetWorld();
+	if (!World)
+	{
+		return nullptr;
+	}
+
+	const auto MovingObstacleSubsystem = World->GetSubsystem<UMovingObstacleSubsystem>();
+	if (!MovingObstacleSubsystem || MovingObstacleSubsystem->GetNumObstacles() == 0)
+	{
+		return nullptr;
+	}
+
+	return MovingObstacleSubsystem;
 }
 
 void UShotArcPreviewComponent::HidePowerText() const
@@ -184,24 +211,63 @@ void UShotArcPreviewComponent::CalculateShotArc(const APaperGolfPawn& Pawn, cons
 		.CollisionRadius = CollisionRadius
 	};
 
-	FPredictProjectilePathResult Result;
+	const auto MovingObstacleSubsystem = GetMovingObstacleSubsystem();
+
+	auto TrajectoryParams = Pawn.GetFlickTrajectoryParams(FlickParams, PredictParams);
 
-	const bool bLastPointIsHit = Pawn.PredictFlick(FlickParams, PredictParams, Result);
+	// The moving obstacles are swept separately at the time the shot would reach them
+	if (MovingObstacleSubsystem)
+	{
+		TrajectoryParams.IgnoreComponents = MovingObstacleSubsystem->GetObstacleComponents();
+	}
+
+	bool bLastPointIsHit = Pawn.PredictFlick(TrajectoryParams, PredictionScratch, PredictResult);
+	auto Path = PredictionScratch.GetPath(PredictResult);
 	LastCalculatedTransform = Pawn.GetActorTransform();
 
+	FHitResult HitResult = PredictResult.HitResult;
+	TOptional<FMovingObstacleSweepHit> ObstacleHit;
+
+	if (MovingObstacleSubsystem)
+	{
+		LastCalculatedTime = MovingObstacleSubsystem->GetObstacleTime();
+		ObstacleHit = MovingObstacleSubsystem->SweepPath(Path, LastCalculatedTime, TrajectoryParams.CollisionRadius);
+	}
+
+	if (ObstacleHit)
+	{
+		// Stop the arc at the obstacle and put the landing indicator on it
+		Path = Path.Left(ObstacleHit->PathIndex + 1);
+
+		HitResult.Location = ObstacleHit->Location;
+		HitResult.ImpactPoint = ObstacleHit->ImpactPoint;
+		HitResult.ImpactNormal = ObstacleHit->ImpactNormal;
+		bLastPointIsHit = true;
+	}
+
 	ShotArc = SpawnShotArcActor(Pawn);
 	if (!ShotArc)
 	{
 		return;
 	}
 
-	ShotArc->SetData(Result, bLastPointIsHit);
+	ShotArc->SetData(Path, HitResult, bLastPointIsHit);
+
+	// Show where the obstacle will be when the shot gets there rather than where it is now
+	if (auto ObstacleMesh = ObstacleHit ? Cast<UStaticMeshComponent>(ObstacleHit->Component.Get()) : nullptr; ObstacleMesh)
+	{
+		ShotArc->SetObstaclePreview(ObstacleMesh->GetStaticMesh(), ObstacleHit->ObstacleTransform);
+	}
+	else
+	{
+		ShotArc->ClearObstaclePreview();
+	}
 
 	ShotType = FlickParams.ShotType;
 	LocalZOffset = FlickParams.LocalZOffset;
 	PowerFraction = FlickParams.PowerFraction;
 
-	UpdatePowerText(Pawn, Result);
+	UpdatePowerText(Pawn, Path);
 }
 
 AShotArc* UShotArcPreviewComponent::SpawnShotArcActor(const APaperGolfPawn& Pawn)
@@ -213,7 +279,7 @@ AShotArc* UShotArcPreviewComponent::SpawnShotArcActor(const APaperGolfPawn& Pawn
 
 	if (ShotArc)
 	{
-		UE_VLOG_UELOG(GetOwner(), LogPGPlayer, Log, TEXT("%s: SpawnShotArcActor: Shot arc actor already exists, returning existing"), *GetName());
+		UE_VLOG_UELOG(GetOwner(), LogPGPlayer, Verbose, TEXT("%s: SpawnShotArcActor: Shot arc actor already exists, returning existing"), *GetName());
 		return ShotArc;
 	}
 
@@ -245,9 +311,8 @@ void UShotArcPreviewComponent::DestroyShotArcActor()
 	}
 }
 
-FVector UShotArcPreviewComponent::GetPowerFractionTextLocation(const APaperGolfPawn& Pawn, const FPredictProjectilePathResult& PredictResult) const
+FVector UShotArcPreviewComponent::GetPowerFractionTextLocation(const APaperGolfPawn& Pawn, TConstArrayView<FPredictProjectilePathPointData> PathData) const
 {
-	const auto& PathData = PredictResult.PathData;
 	const auto& PawnLocation = Pawn.GetActorLocation();
 
 	const auto CameraZ = [&]()
@@ -281,11 +346,11 @@ FVector UShotArcPreviewComponent::GetPowerFractionTextLocation(const APaperGolfP
 	return Location;
 }
 
-void UShotArcPreviewComponent::UpdatePowerText(const APaperGolfPawn& Pawn, const FPredictProjectilePathResult& PredictResult)
+void UShotArcPreviewComponent::UpdatePowerText(const APaperGolfPawn& Pawn, TConstArrayView<FPredictProjectilePathPointData> Path)
 {
 	RegisterPowerText(Pawn);
 
-	const auto Location = GetPowerFractionTextLocation(Pawn, PredictResult);
+	const auto Location = GetPowerFractionTextLocation(Pawn, Path);
 
 	// Face Camera
 	if (auto CameraLocationOptional = GetCameraLocation(Pawn); CameraLocationOptional)
@@ -1757,12 +1757,13 @@ float AGolfPlayerController::CalculateIdealPitchAngle() const
 		return DefaultPitchAngle;
 	}
 
+	// Simulate the arc so that clearing an obstacle on the way up isn't mistaken for hitting it
 	const auto bPassed = UPaperGolfPawnUtilities::TraceCurrentShotWithParameters(
 		this, PaperGolfPawn,
 		FFlickParams {
 			.ShotType = ShotType
 		},
-		DefaultPitchAngle);
+		DefaultPitchAngle, 1000.0f, true);
 
 	const float IdealPitchAngle = bPassed ? DefaultPitchAngle : 0.0f;
 
@@ -29,6 +29,12 @@ AShotArc::AShotArc()
 	LandingMeshComponent->SetupAttachment(RootComponent);
 
 	SetStaticMeshProperties(*LandingMeshComponent);
+
+	ObstaclePreviewMeshComponent = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("ObstaclePreviewMesh"));
+	ObstaclePreviewMeshComponent->SetupAttachment(RootComponent);
+	ObstaclePreviewMeshComponent->SetVisibility(false);
+
+	SetStaticMeshProperties(*ObstaclePreviewMeshComponent);
 }
 
 void AShotArc::SetStaticMeshProperties(UStaticMeshComponent& MeshComponent)
@@ -45,6 +51,39 @@ void AShotArc::ClearPreviousState()
 	SplineComponent->ClearSplinePoints();
 	ClearSplineMeshes();
 	LandingMeshComponent->SetVisibility(false);
+	ClearObstaclePreview();
+}
+
+void AShotArc::SetObstaclePreview(UStaticMesh* Mesh, const FTransform& WorldTransform)
+{
+	if (!Mesh)
+	{
+		ClearObstaclePreview();
+		return;
+	}
+
+	if (ObstaclePreviewMeshComponent->GetStaticMesh() != Mesh)
+	{
+		UE_VLOG_UELOG(GetVisualLoggerContextObject(), LogPGPlayer, Log, TEXT("%s: SetObstaclePreview: Mesh=%s"), *GetName(), *Mesh->GetName());
+
+		ObstaclePreviewMeshComponent->SetStaticMesh(Mesh);
+
+		if (ObstaclePreviewMaterial)
+		{
+			for (int32 i = 0, NumMaterials = ObstaclePreviewMeshComponent->GetNumMaterials(); i < NumMaterials; ++i)
+			{
+				ObstaclePreviewMeshComponent->SetMaterial(i, ObstaclePreviewMaterial);
+			}
+		}
+	}
+
+	ObstaclePreviewMeshComponent->SetWorldTransform(WorldTransform);
+	ObstaclePreviewMeshComponent->SetVisibility(true);
+}
+
+void AShotArc::ClearObstaclePreview()
+{
+	ObstaclePreviewMeshComponent->SetVisibility(false);
 }
 
 float AShotArc::CalculateMeshSize() const
@@ -88,10 +127,10 @@ void AShotArc::ClearSplineMeshes()
 	}
 }
 
-void AShotArc::SetData(const FPredictProjectilePathResult& Path, bool bDrawHit)
+void AShotArc::SetData(TConstArrayView<FPredictProjectilePathPointData> PathData, const FHitResult& HitResult, bool bDrawHit)
 {
 	UE_VLOG_UELOG(GetVisualLoggerContextObject(), LogPGPlayer, Log, TEXT("%s: SetData: NumPoints=%d; bDrawHit=%s"),
-		*GetName(), Path.PathData.Num(), LoggingUtils::GetBoolString(bDrawHit));
+		*GetName(), PathData.Num(), LoggingUtils::GetBoolString(bDrawHit));
 
 	if (!ensureMsgf(SplineMesh, TEXT("Spline Mesh is not set")))
 	{
@@ -103,7 +142,6 @@ void AShotArc::SetData(const FPredictProjectilePathResult& Path, bool bDrawHit)
 
 	ClearPreviousState();
 
-	const auto& PathData = Path.PathData;
 	if (PathData.IsEmpty())
 	{
 		UE_VLOG_UELOG(GetVisualLoggerContextObject(), LogPGPlayer, Warning, TEXT("%s: SetData: PathData is empty"), *GetName());
@@ -114,7 +152,7 @@ void AShotArc::SetData(const FPredictProjectilePathResult& Path, bool bDrawHit)
 	SetActorLocation(PathData[0].Location);
 
 	// All locations will then be relative to that first point
-	CalculateArcPoints(Path, bDrawHit);
+	CalculateArcPoints(PathData, HitResult, bDrawHit);
 	BuildSpline();
 	BuildMeshAlongSpline();
 
@@ -135,26 +173,26 @@ void AShotArc::BeginPlay()
 	Super::BeginPlay();
 }
 
-void AShotArc::CalculateArcPoints(const FPredictProjectilePathResult& Path, bool bDrawHit)
+void AShotArc::CalculateArcPoints(TConstArrayView<FPredictProjectilePathPointData> PathData, const FHitResult& HitResult, bool bDrawHit)
 {
-	ArcPoints.Reserve(Path.PathData.Num() + (bDrawHit ? 1 : 0));
+	ArcPoints.Reserve(PathData.Num() + (bDrawHit ? 1 : 0));
 
 	// Path data relative to actor location which is the first point
 	const auto& ReferencePoint = GetActorLocation();
 
-	for (const auto& PathDatum : Path.PathData)
+	for (const auto& PathDatum : PathData)
 	{
 		ArcPoints.Add(PathDatum.Location - ReferencePoint);
 	}
 
 	if (bDrawHit)
 	{
-		const auto LandingRelativeLocation = Path.HitResult.ImpactPoint - ReferencePoint;
+		const auto LandingRelativeLocation = HitResult.ImpactPoint - ReferencePoint;
 		
 		LandingData = FLandingInfo
 		{
 			.Location = LandingRelativeLocation,
-			.Normal = Path.HitResult.ImpactNormal
+			.Normal = HitResult.ImpactNormal
 		};
 	}
 }
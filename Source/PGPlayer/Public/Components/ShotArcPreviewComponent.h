@@ -4,16 +4,19 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+
+#include "Library/PaperGolfTrajectorySolver.h"
+
 #include "ShotArcPreviewComponent.generated.h"
 
 class APaperGolfPawn;
 enum class EShotType : uint8;
 struct FFlickParams;
 class UTextRenderComponent;
-struct FPredictProjectilePathResult;
 class UMaterialInterface;
 class AShotArc;
 class APlayerCameraManager;
+class UMovingObstacleSubsystem;
 
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class PGPLAYER_API UShotArcPreviewComponent : public UActorComponent
@@ -39,6 +42,8 @@ protected:
 private:
 	void CalculateShotArc(const APaperGolfPawn& Pawn, const FFlickParams& FlickParams);
 
+	const UMovingObstacleSubsystem* GetMovingObstacleSubsystem() const;
+
 	AShotArc* SpawnShotArcActor(const APaperGolfPawn& Pawn);
 	void DestroyShotArcActor();
 
@@ -46,9 +51,9 @@ private:
 
 	bool NeedsToRecalculateArc(const APaperGolfPawn& Pawn, const FFlickParams& FlickParams) const;
 
-	FVector GetPowerFractionTextLocation(const APaperGolfPawn& Pawn, const FPredictProjectilePathResult& PredictResult) const;
+	FVector GetPowerFractionTextLocation(const APaperGolfPawn& Pawn, TConstArrayView<FPredictProjectilePathPointData> Path) const;
 
-	void UpdatePowerText(const APaperGolfPawn& Pawn, const FPredictProjectilePathResult& PredictResult);
+	void UpdatePowerText(const APaperGolfPawn& Pawn, TConstArrayView<FPredictProjectilePathPointData> Path);
 	void HidePowerText() const;
 	void ShowPowerText() const;
 
@@ -62,6 +67,12 @@ private:
 private:
 
 	FTransform LastCalculatedTransform{};
+	double LastCalculatedTime{};
+
+	// Reused between calculations so that the path buffer is only allocated once
+	FPaperGolfTrajectoryScratch PredictionScratch{};
+	FPaperGolfTrajectoryResult PredictResult{};
+
 	EShotType ShotType{};
 	float LocalZOffset{};
 	float PowerFraction{};
@@ -83,6 +94,12 @@ private:
 	UPROPERTY(Category = "Shot Arc", EditDefaultsOnly)
 	float TextHorizontalOffset{ 100.0f };
 
+	/*
+	* Seconds between recalculating an unchanged shot while there are moving obstacles so the arc follows them.
+	*/
+	UPROPERTY(Category = "Shot Arc", EditDefaultsOnly, meta = (ClampMin = "0"))
+	float ObstaclePreviewRefreshInterval{ 0.1f };
+
 	UPROPERTY(Category = "Text", EditDefaultsOnly)
 	TObjectPtr<UMaterialInterface> TextMaterial{};
 
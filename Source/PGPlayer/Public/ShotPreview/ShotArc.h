@@ -9,11 +9,12 @@
 
 #include "ShotArc.generated.h"
 
-struct FPredictProjectilePathResult;
+struct FPredictProjectilePathPointData;
 class USplineComponent;
 class UStaticMesh;
 class UStaticMeshComponent;
 class USplineMeshComponent;
+class UMaterialInterface;
 
 
 USTRUCT()
@@ -33,13 +34,19 @@ class PGPLAYER_API AShotArc : public AActor
 public:	
 	AShotArc();
 
-	void SetData(const FPredictProjectilePathResult& Path, bool bDrawHit);
+	void SetData(TConstArrayView<FPredictProjectilePathPointData> PathData, const FHitResult& HitResult, bool bDrawHit);
+
+	/*
+	* Draws a copy of a moving obstacle's mesh where the shot will meet it.
+	*/
+	void SetObstaclePreview(UStaticMesh* Mesh, const FTransform& WorldTransform);
+	void ClearObstaclePreview();
 
 protected:
 	virtual void BeginPlay() override;
 
 private:
-	void CalculateArcPoints(const FPredictProjectilePathResult& Path, bool bDrawHit);
+	void CalculateArcPoints(TConstArrayView<FPredictProjectilePathPointData> PathData, const FHitResult& HitResult, bool bDrawHit);
 
 	void BuildSpline();
 	void BuildMeshAlongSpline();
@@ -75,6 +82,15 @@ private:
 	UPROPERTY(VisibleDefaultsOnly, Category = "Components")
 	TObjectPtr<UStaticMeshComponent> LandingMeshComponent{};
 
+	UPROPERTY(VisibleDefaultsOnly, Category = "Components")
+	TObjectPtr<UStaticMeshComponent> ObstaclePreviewMeshComponent{};
+
+	/*
+	* Optional override for all the materials of the obstacle preview so it reads as a ghost of the obstacle.
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = "Mesh")
+	TObjectPtr<UMaterialInterface> ObstaclePreviewMaterial{};
+
 	UPROPERTY(EditDefaultsOnly, Category = "Mesh")
 	TEnumAsByte<ESplineMeshAxis::Type> MeshForwardAxis{ ESplineMeshAxis::Type::X };
 
@@ -478,6 +478,30 @@ void UGolfTurnBasedDirectorComponent::DoNextTurn()
 	ActivateNextPlayer();
 }
 
+void UGolfTurnBasedDirectorComponent::ParkInactivePlayers(const IGolfController* ActivePlayer)
+{
+	int32 NumParked{};
+
+	for (const auto& Player : Players)
+	{
+		auto PaperGolfPawn = Player ? Player->GetPaperGolfPawn() : nullptr;
+		if (!PaperGolfPawn)
+		{
+			continue;
+		}
+
+		PaperGolfPawn->SetParked(Player.GetInterface() != ActivePlayer);
+
+		if (PaperGolfPawn->IsParked())
+		{
+			++NumParked;
+		}
+	}
+
+	UE_VLOG_UELOG(GetOwner(), LogPaperGolfGame, Log, TEXT("%s: ParkInactivePlayers - ActivePlayer=%s; NumParked=%d"),
+		*GetName(), *PG::StringUtils::ToString(ActivePlayer), NumParked);
+}
+
 void UGolfTurnBasedDirectorComponent::ActivateNextPlayer()
 {
 	UE_VLOG_UELOG(GetOwner(), LogPaperGolfGame, Log, TEXT("%s: ActivateNextPlayer - ActivePlayerIndex=%d"), *GetName(), ActivePlayerIndex);
@@ -547,6 +571,8 @@ void UGolfTurnBasedDirectorComponent::ActivatePlayer(IGolfController* Player)
 		Player->StartHole(bNewHole ? EHoleStartType::Start : EHoleStartType::InProgress);
 	}
 
+	ParkInactivePlayers(Player);
+
 	UE_VLOG_UELOG(GetOwner(), LogPaperGolfGame, Log, TEXT("%s: ActivatePlayer - Player=%s - starting turn; bNewHole=%s; bNewPlayer=%s"),
 		*GetName(), *PG::StringUtils::ToString(Player), LoggingUtils::GetBoolString(bNewHole), LoggingUtils::GetBoolString(bNewPlayer));
 
@@ -65,6 +65,11 @@ private:
 	void ActivateNextPlayer();
 	void ActivatePlayer(IGolfController* Player);
 
+	/*
+	* Moves the pawns of the players waiting for their turn out of the physics scene and makes sure the active player's pawn is back in it.
+	*/
+	void ParkInactivePlayers(const IGolfController* ActivePlayer);
+
 	void DoReplacePlayer(AController* PlayerToRemove, AController* PlayerToAdd);
 
 	void NextHole();
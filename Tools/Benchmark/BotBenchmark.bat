@@ -0,0 +1,12 @@
+Rem Plays each course headless with bots only and writes <Map>_Seed<Seed>.csv and .json to Saved\Benchmarks
+Rem Usage: BotBenchmark.bat [Seed] [TimeDilation]
+
+set SEED=%1
+if "%SEED%"=="" set SEED=1
+
+set DILATION=%2
+if "%DILATION%"=="" set DILATION=4
+
+for %%M in (House School) do (
+	"C:\Program Files\Epic Games\UE_5.4\Engine\Binaries\Win64\UnrealEditor-Cmd.exe" "%CD%\..\..\PaperGolf.uproject" "/Game/Maps/Final/%%M?numPlayers=1?numBots=3" -game -nullrhi -nosound -unattended -log -benchmark -fps=30 -dpcvars="pg.mode.skipHumans=1" -ExecCmds="pg.vislog.autorecord false" -PGBotBenchmark -PGBotBenchmarkSeed=%SEED% -PGBotBenchmarkTimeDilation=%DILATION%
+)
@@ -0,0 +1,22 @@
+#!/bin/bash
+
+# Plays each course headless with bots only and writes <Map>_Seed<Seed>.csv and .json to Saved/Benchmarks
+# Usage: BotBenchmark.sh <UnrealEditor-Cmd path> [Seed] [TimeDilation]
+
+editor=$1
+seed=${2:-1}
+dilation=${3:-4}
+
+if [ -z "$editor" ]; then
+   echo "Argument is path to UnrealEditor-Cmd"
+   exit 1
+fi
+
+project="$(cd "$(dirname "$0")/../.." && pwd)/PaperGolf.uproject"
+
+for map in House School; do
+   echo "Benchmarking $map with seed $seed and time dilation $dilation"
+   "$editor" "$project" "/Game/Maps/Final/$map?numPlayers=1?numBots=3" -game -nullrhi -nosound -unattended -log -benchmark -fps=30 \
+      -dpcvars="pg.mode.skipHumans=1" -ExecCmds="pg.vislog.autorecord false" \
+      -PGBotBenchmark -PGBotBenchmarkSeed=$seed -PGBotBenchmarkTimeDilation=$dilation || exit 1
+done
@@ -0,0 +1,19 @@
+Rem Runs a headless listen server with bots and a headless client over an emulated lossy connection with predicted flight enabled
+Rem Client divergence per flight is logged as EndClientFlight lines in Saved\Logs\PredictedFlightClient.log
+Rem Usage: PredictedFlightTest.bat [Map] [PktLag]
+
+set MAP=%1
+if "%MAP%"=="" set MAP=House
+
+set LAG=%2
+if "%LAG%"=="" set LAG=150
+
+set EDITOR="C:\Program Files\Epic Games\UE_5.4\Engine\Binaries\Win64\UnrealEditor-Cmd.exe"
+
+start "PredictedFlightServer" %EDITOR% "%CD%\..\..\PaperGolf.uproject" "/Game/Maps/Final/%MAP%?listen?numPlayers=2?numBots=2" -game -nullrhi -nosound -unattended -log -abslog="%CD%\..\..\Saved\Logs\PredictedFlightServer.log" -dpcvars="pg.net.predictedFlight=1" -ExecCmds="pg.vislog.autorecord false"
+
+timeout /t 20
+
+%EDITOR% "%CD%\..\..\PaperGolf.uproject" 127.0.0.1 -game -nullrhi -nosound -unattended -log -abslog="%CD%\..\..\Saved\Logs\PredictedFlightClient.log" -ExecCmds="NetEmulation.PktLag %LAG%, NetEmulation.PktLagVariance 30, NetEmulation.PktLoss 1, pg.vislog.autorecord false"
+
+findstr /C:"EndClientFlight - FlightId=" "%CD%\..\..\Saved\Logs\PredictedFlightClient.log"
@@ -0,0 +1,53 @@
+#!/bin/bash
+
+# Runs a headless listen server with bots and a headless client over an emulated lossy connection with predicted flight enabled,
+# then summarizes how far the client simulation diverged from the server keyframes on each flight
+# Usage: PredictedFlightTest.sh <UnrealEditor-Cmd path> [Map] [DurationSeconds] [PktLag]
+
+editor=$1
+map=${2:-House}
+duration=${3:-300}
+lag=${4:-150}
+
+if [ -z "$editor" ]; then
+   echo "Argument is path to UnrealEditor-Cmd"
+   exit 1
+fi
+
+root="$(cd "$(dirname "$0")/../.." && pwd)"
+project="$root/PaperGolf.uproject"
+logdir="$root/Saved/Logs"
+serverlog="$logdir/PredictedFlightServer.log"
+clientlog="$logdir/PredictedFlightClient.log"
+
+mkdir -p "$logdir"
+
+echo "Starting listen server on $map"
+"$editor" "$project" "/Game/Maps/Final/$map?listen?numPlayers=2?numBots=2" -game -nullrhi -nosound -unattended -log -abslog="$serverlog" \
+   -dpcvars="pg.net.predictedFlight=1" -ExecCmds="pg.vislog.autorecord false" &
+server=$!
+
+# Give the server time to load the map before connecting
+sleep 20
+
+echo "Starting client with ${lag}ms packet lag for ${duration}s"
+timeout "$duration" "$editor" "$project" 127.0.0.1 -game -nullrhi -nosound -unattended -log -abslog="$clientlog" \
+   -ExecCmds="NetEmulation.PktLag $lag, NetEmulation.PktLagVariance 30, NetEmulation.PktLoss 1, pg.vislog.autorecord false"
+
+kill $server 2>/dev/null
+wait $server 2>/dev/null
+
+grep "EndClientFlight - FlightId=.*MeanError=" "$clientlog" | awk '
+   {
+      for (i = 1; i <= NF; ++i)
+      {
+         if ($i ~ /^MeanError=/) { split($i, kv, "="); mean = kv[2] + 0 }
+         if ($i ~ /^MaxError=/) { split($i, kv, "="); max = kv[2] + 0 }
+      }
+      ++flights; totalMean += mean
+      if (max > worst) worst = max
+   }
+   END {
+      if (flights == 0) { print "No predicted flights were played back"; exit 1 }
+      printf "Flights=%d; MeanError=%.2f; MaxError=%.2f\n", flights, totalMean / flights, worst
+   }'